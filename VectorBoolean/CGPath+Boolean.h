@@ -8,8 +8,91 @@
 
 #import <Foundation/Foundation.h>
 #import <CoreGraphics/CoreGraphics.h>
+#import "FBTypes.h"
+#import "FBStatistics.h"
 
 extern CGPathRef CGPathUnion(CGPathRef path1, CGPathRef path2);
 extern CGPathRef CGPathIntersect(CGPathRef path1, CGPathRef path2);
 extern CGPathRef CGPathDifference(CGPathRef path1, CGPathRef path2);
 extern CGPathRef CGPathXOR(CGPathRef path1, CGPathRef path2);
+
+// A quicker, approximate operation for when the result only has to look right, like
+//  a preview while editing. The curves are cut into lines first, so the result is all
+//  lines, and nothing in it is wrong by more than tolerance, in the units of the paths:
+//  for a preview, pass the size of a pixel, or less. A tolerance of 0 is the exact
+//  operation. Paths with curves that would take too many lines get the exact operation too.
+extern CGPathRef CGPathPerformBooleanOperationWithTolerance(CGPathRef path1, CGPathRef path2, FBBooleanOperation operation, CGFloat tolerance);
+
+// The operation for paths of nothing but lines that are too big to combine in one go,
+//  like maps with millions of points. The paths are cut into a grid of square tiles,
+//  tileSize across, in the units of the paths, which are combined on all processors and
+//  stitched back together. Only the crossings and the sweep, the biggest part of the
+//  operation, are bounded by the size of the tiles; the paths, the tiles' results and the
+//  stitching still take memory in proportion to the paths. Paths with curves, or a
+//  tileSize of 0, get the regular operation.
+extern CGPathRef CGPathPerformBooleanOperationInTiles(CGPathRef path1, CGPathRef path2, FBBooleanOperation operation, CGFloat tileSize);
+
+// Computes all the requested operations on the two paths, but finds where they cross
+//  only once. That's most of the work, so this is much faster than calling the two path
+//  functions above one after the other. results is indexed by FBBooleanOperation, the
+//  results of operations that weren't requested are set to NULL. The caller owns the results.
+extern void CGPathPerformBooleanOperations(CGPathRef path1, CGPathRef path2, FBBooleanOperations operations, CGPathRef results[4]);
+
+// Combines any number of paths with one operation. Union, intersect and XOR apply
+//  to all the paths; difference subtracts all the other paths from the first one.
+//  This is much faster than chaining the two path functions above over many paths.
+extern CGPathRef CGPathCombine(const CGPathRef *paths, size_t count, FBBooleanOperation operation);
+
+// One independent two path operation for CGPathPerformBooleanJobs(). The result, the
+//  duration and the statistics are filled in when the job has run. The caller owns the result.
+typedef struct FBBooleanJob {
+    CGPathRef path1;
+    CGPathRef path2;
+    FBBooleanOperation operation;
+    CGPathRef result;
+    CFTimeInterval duration;
+    FBStatistics statistics; // all zero when built without FB_STATISTICS
+} FBBooleanJob;
+
+// Runs all the jobs, spread over threadCount threads including the calling one, and
+//  returns when they're all done. Pass zero to use one thread per processor.
+extern void CGPathPerformBooleanJobs(FBBooleanJob *jobs, size_t count, size_t threadCount);
+
+// The same two path operations, for paths that aren't CGPaths. The operands are read
+//  in place from the element arrays and the result is streamed to the function, one
+//  element at a time, contour by contour. No CGPath is made on the way in or out.
+extern void FBPathElementsPerformBooleanOperation(const FBPathElement *elements1, size_t count1, const FBPathElement *elements2, size_t count2, FBBooleanOperation operation, FBPathElementFunction function, void *context);
+
+// A path that's combined with lots of other paths, like a mask cut out of thousands of
+//  shapes. Preparing it works out once what every operation would otherwise work out
+//  about it again, so each operation only costs about as much as the other path. The
+//  prepared path is the first operand. Use it from one thread at a time.
+typedef struct FBPreparedPath *FBPreparedPathRef;
+
+extern FBPreparedPathRef FBPreparedPathCreate(CGPathRef path);
+extern void FBPreparedPathRelease(FBPreparedPathRef preparedPath);
+extern CGPathRef FBPreparedPathPerformBooleanOperation(FBPreparedPathRef preparedPath, CGPathRef path, FBBooleanOperation operation);
+
+// Hit testing against the prepared path: for each of the points, the closest point on
+//  its outline and how far away that is. Answering lots of points in one call is much
+//  faster than one at a time. Returns NO, without filling anything in, if the path is empty.
+extern BOOL FBPreparedPathGetClosestPoints(FBPreparedPathRef preparedPath, const CGPoint *points, size_t count, CGPoint *closestPoints, CGFloat *distances);
+
+// Whether each of the points is inside the prepared path, by the fill rule. Meant for
+//  sampling lots of points, like a hatch fill or a mask lookup does.
+extern void FBPreparedPathContainsPoints(FBPreparedPathRef preparedPath, const CGPoint *points, size_t count, FBFillRule fillRule, BOOL *results);
+
+// Recomputes one operation on two paths that keep changing a little, like the shapes
+//  in an editor while a point is dragged. Only the contours near the ones that were
+//  added, removed or changed since the last update are combined again; the results for
+//  all the others are kept from the last update. The caller owns the result.
+typedef struct FBIncrementalBoolean *FBIncrementalBooleanRef;
+
+extern FBIncrementalBooleanRef FBIncrementalBooleanCreate(FBBooleanOperation operation);
+extern void FBIncrementalBooleanRelease(FBIncrementalBooleanRef incrementalBoolean);
+extern CGPathRef FBIncrementalBooleanUpdate(FBIncrementalBooleanRef incrementalBoolean, CGPathRef path1, CGPathRef path2);
+
+// How many clusters of contours that don't touch each other the last result was made of,
+//  and how many of those were kept from the update before
+extern size_t FBIncrementalBooleanGetClusterCount(FBIncrementalBooleanRef incrementalBoolean);
+extern size_t FBIncrementalBooleanGetReusedClusterCount(FBIncrementalBooleanRef incrementalBoolean);
@@ -9,6 +9,10 @@
 #import "CGPath+Boolean.h"
 #import "CGPath+Utilities.h"
 #import "FBBezierGraph.h"
+#import "FBBezierCurve.h"
+#import "FBCurveLocation.h"
+#import "FBThreadPool.h"
+#import "FBIncrementalBooleanOperation.h"
 
 CGPathRef CGPathUnion(CGPathRef path1, CGPathRef path2) {
 	FBBezierGraph *thisGraph = [FBBezierGraph bezierGraphWithPath:path1];
@@ -38,3 +42,134 @@ CGPathRef CGPathXOR(CGPathRef path1, CGPathRef path2) {
 	CGPathRef result = [[thisGraph xorWithBezierGraph:otherGraph] path];
 	return result;
 }
+
+CGPathRef CGPathPerformBooleanOperationWithTolerance(CGPathRef path1, CGPathRef path2, FBBooleanOperation operation, CGFloat tolerance) {
+	FBBezierGraph *thisGraph = [FBBezierGraph bezierGraphWithPath:path1];
+	FBBezierGraph *otherGraph = [FBBezierGraph bezierGraphWithPath:path2];
+	CGPathRef result = [[thisGraph bezierGraphWithOperation:operation bezierGraph:otherGraph tolerance:tolerance] path];
+	return result;
+}
+
+CGPathRef CGPathPerformBooleanOperationInTiles(CGPathRef path1, CGPathRef path2, FBBooleanOperation operation, CGFloat tileSize) {
+	FBBezierGraph *thisGraph = [FBBezierGraph bezierGraphWithPath:path1];
+	FBBezierGraph *otherGraph = [FBBezierGraph bezierGraphWithPath:path2];
+	CGPathRef result = [[thisGraph bezierGraphWithOperation:operation bezierGraph:otherGraph tileSize:tileSize] path];
+	return result;
+}
+
+void CGPathPerformBooleanOperations(CGPathRef path1, CGPathRef path2, FBBooleanOperations operations, CGPathRef results[4]) {
+	FBBezierGraph *thisGraph = [FBBezierGraph bezierGraphWithPath:path1];
+	FBBezierGraph *otherGraph = [FBBezierGraph bezierGraphWithPath:path2];
+	NSDictionary *graphs = [thisGraph bezierGraphsWithOperations:operations bezierGraph:otherGraph];
+	for (FBBooleanOperation operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+		FBBezierGraph *graph = graphs[@(operation)];
+		results[operation] = graph != nil ? [graph path] : NULL;
+	}
+}
+
+CGPathRef CGPathCombine(const CGPathRef *paths, size_t count, FBBooleanOperation operation) {
+	NSMutableArray *graphs = [NSMutableArray arrayWithCapacity:count];
+	for (size_t i = 0; i < count; i++)
+		[graphs addObject:[FBBezierGraph bezierGraphWithPath:paths[i]]];
+	CGPathRef result = [[FBBezierGraph bezierGraphByCombiningGraphs:graphs operation:operation] path];
+	return result;
+}
+
+static void FBPerformBooleanJob(NSUInteger iteration, NSUInteger threadIndex, void *context) {
+	FBBooleanJob *job = &((FBBooleanJob *)context)[iteration];
+	// A job stays on its thread from start to end, so that thread's counters see all of it
+	FBStatistics startStatistics = {};
+	FBStatisticsGetThreadSnapshot(&startStatistics);
+	CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+	@autoreleasepool {
+		FBBezierGraph *thisGraph = [FBBezierGraph bezierGraphWithPath:job->path1];
+		FBBezierGraph *otherGraph = [FBBezierGraph bezierGraphWithPath:job->path2];
+		job->result = [[thisGraph bezierGraphWithOperation:job->operation bezierGraph:otherGraph] path];
+	}
+	job->duration = CFAbsoluteTimeGetCurrent() - startTime;
+	FBStatistics endStatistics = {};
+	FBStatisticsGetThreadSnapshot(&endStatistics);
+	FBStatisticsSubtract(&endStatistics, &startStatistics, &job->statistics);
+}
+
+void CGPathPerformBooleanJobs(FBBooleanJob *jobs, size_t count, size_t threadCount) {
+	// Each job runs on one thread, with that thread's scratch arena. The crossing
+	//  search inside a job doesn't spread out any further, all the threads are busy already,
+	//  and with one thread, or one job, that one thread is all there is to use.
+	FBThreadPoolRef pool = threadCount == 0 ? FBThreadPoolGetShared() : FBThreadPoolCreate(threadCount - 1);
+	FBThreadPoolApply(pool, count, FBPerformBooleanJob, jobs);
+	if ( pool != FBThreadPoolGetShared() )
+		FBThreadPoolRelease(pool);
+}
+
+void FBPathElementsPerformBooleanOperation(const FBPathElement *elements1, size_t count1, const FBPathElement *elements2, size_t count2, FBBooleanOperation operation, FBPathElementFunction function, void *context) {
+	@autoreleasepool {
+		FBBezierGraph *thisGraph = [FBBezierGraph bezierGraphWithPathElements:elements1 count:count1];
+		FBBezierGraph *otherGraph = [FBBezierGraph bezierGraphWithPathElements:elements2 count:count2];
+		[[thisGraph bezierGraphWithOperation:operation bezierGraph:otherGraph] enumeratePathElementsUsingFunction:function context:context];
+	}
+}
+
+FBPreparedPathRef FBPreparedPathCreate(CGPathRef path) {
+	// The prepared path is the graph itself, kept alive until it's released
+	FBBezierGraph *graph = [FBBezierGraph bezierGraphWithPath:path];
+	[graph prepare];
+	return (FBPreparedPathRef)(__bridge_retained void *)graph;
+}
+
+void FBPreparedPathRelease(FBPreparedPathRef preparedPath) {
+	if ( preparedPath != NULL )
+		CFRelease((CFTypeRef)preparedPath);
+}
+
+CGPathRef FBPreparedPathPerformBooleanOperation(FBPreparedPathRef preparedPath, CGPathRef path, FBBooleanOperation operation) {
+	FBBezierGraph *thisGraph = (__bridge FBBezierGraph *)(void *)preparedPath;
+	FBBezierGraph *otherGraph = [FBBezierGraph bezierGraphWithPath:path];
+	CGPathRef result = [[thisGraph bezierGraphWithOperation:operation bezierGraph:otherGraph] path];
+	return result;
+}
+
+BOOL FBPreparedPathGetClosestPoints(FBPreparedPathRef preparedPath, const CGPoint *points, size_t count, CGPoint *closestPoints, CGFloat *distances) {
+	FBBezierGraph *graph = (__bridge FBBezierGraph *)(void *)preparedPath;
+	NSArray *locations = [graph closestLocationsToPoints:points count:count];
+	if ( locations == nil )
+		return NO;
+	for (size_t i = 0; i < count; i++) {
+		FBCurveLocation *location = locations[i];
+		closestPoints[i] = [location.edge pointAtParameter:location.parameter leftBezierCurve:nil rightBezierCurve:nil];
+		distances[i] = location.distance;
+	}
+	return YES;
+}
+
+void FBPreparedPathContainsPoints(FBPreparedPathRef preparedPath, const CGPoint *points, size_t count, FBFillRule fillRule, BOOL *results) {
+	FBBezierGraph *graph = (__bridge FBBezierGraph *)(void *)preparedPath;
+	[graph containsPoints:points count:count fillRule:fillRule results:results];
+}
+
+FBIncrementalBooleanRef FBIncrementalBooleanCreate(FBBooleanOperation operation) {
+	FBIncrementalBooleanOperation *incrementalOperation = [[FBIncrementalBooleanOperation alloc] initWithOperation:operation];
+	return (FBIncrementalBooleanRef)(__bridge_retained void *)incrementalOperation;
+}
+
+void FBIncrementalBooleanRelease(FBIncrementalBooleanRef incrementalBoolean) {
+	if ( incrementalBoolean != NULL )
+		CFRelease((CFTypeRef)incrementalBoolean);
+}
+
+CGPathRef FBIncrementalBooleanUpdate(FBIncrementalBooleanRef incrementalBoolean, CGPathRef path1, CGPathRef path2) {
+	FBIncrementalBooleanOperation *incrementalOperation = (__bridge FBIncrementalBooleanOperation *)(void *)incrementalBoolean;
+	CGPathRef result = NULL;
+	@autoreleasepool {
+		result = [incrementalOperation resultWithPath:path1 path:path2];
+	}
+	return result;
+}
+
+size_t FBIncrementalBooleanGetClusterCount(FBIncrementalBooleanRef incrementalBoolean) {
+	return ((__bridge FBIncrementalBooleanOperation *)(void *)incrementalBoolean).clusterCount;
+}
+
+size_t FBIncrementalBooleanGetReusedClusterCount(FBIncrementalBooleanRef incrementalBoolean) {
+	return ((__bridge FBIncrementalBooleanOperation *)(void *)incrementalBoolean).reusedClusterCount;
+}
@@ -0,0 +1,163 @@
+//
+//  FBArena.c
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include "FBArena.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const size_t FBArenaDefaultBlockSize = 64 * 1024;
+static const size_t FBArenaAlignment = 16;
+
+typedef struct FBArenaBlock {
+    struct FBArenaBlock *previous;
+    size_t size;
+    size_t used;
+    size_t padding; // keeps the data that follows aligned
+} FBArenaBlock;
+
+struct FBArena {
+    FBArenaBlock *currentBlock;
+    size_t blockSize;
+    NSUInteger blockCount;
+    void *lastAllocation;
+};
+
+static size_t FBArenaAlignSize(size_t size)
+{
+    return (size + FBArenaAlignment - 1) & ~(FBArenaAlignment - 1);
+}
+
+static unsigned char *FBArenaBlockGetData(FBArenaBlock *block)
+{
+    return (unsigned char *)(block + 1);
+}
+
+static FBArenaBlock *FBArenaAddBlock(FBArenaRef arena, size_t minimumSize)
+{
+    size_t size = MAX(arena->blockSize, minimumSize);
+    FBArenaBlock *block = malloc(sizeof(FBArenaBlock) + size);
+    if ( block == NULL )
+        return NULL;
+    block->previous = arena->currentBlock;
+    block->size = size;
+    block->used = 0;
+    arena->currentBlock = block;
+    arena->blockCount++;
+    return block;
+}
+
+FBArenaRef FBArenaCreate(size_t blockSize)
+{
+    FBArenaRef arena = calloc(1, sizeof(struct FBArena));
+    if ( arena == NULL )
+        return NULL;
+    arena->blockSize = FBArenaAlignSize(blockSize > 0 ? blockSize : FBArenaDefaultBlockSize);
+    return arena;
+}
+
+void FBArenaRelease(FBArenaRef arena)
+{
+    if ( arena == NULL )
+        return;
+    
+    FBArenaBlock *block = arena->currentBlock;
+    while ( block != NULL ) {
+        FBArenaBlock *previous = block->previous;
+        free(block);
+        block = previous;
+    }
+    free(arena);
+}
+
+void *FBArenaAllocate(FBArenaRef arena, size_t size)
+{
+    size = FBArenaAlignSize(MAX(size, 1));
+    
+    FBArenaBlock *block = arena->currentBlock;
+    if ( block == NULL || block->size - block->used < size ) {
+        block = FBArenaAddBlock(arena, size);
+        if ( block == NULL )
+            return NULL;
+    }
+    
+    void *memory = FBArenaBlockGetData(block) + block->used;
+    block->used += size;
+    memset(memory, 0, size);
+    arena->lastAllocation = memory;
+    return memory;
+}
+
+void *FBArenaReallocate(FBArenaRef arena, void *memory, size_t oldSize, size_t newSize)
+{
+    if ( memory == NULL )
+        return FBArenaAllocate(arena, newSize);
+    if ( newSize <= oldSize )
+        return memory;
+    
+    // If this was the last thing allocated and there's room after it, just extend it
+    FBArenaBlock *block = arena->currentBlock;
+    size_t alignedOldSize = FBArenaAlignSize(MAX(oldSize, 1));
+    size_t alignedNewSize = FBArenaAlignSize(newSize);
+    if ( memory == arena->lastAllocation && block->size - block->used + alignedOldSize >= alignedNewSize ) {
+        memset((unsigned char *)memory + oldSize, 0, alignedNewSize - oldSize);
+        block->used += alignedNewSize - alignedOldSize;
+        return memory;
+    }
+    
+    void *newMemory = FBArenaAllocate(arena, newSize);
+    if ( newMemory != NULL )
+        memcpy(newMemory, memory, oldSize);
+    return newMemory;
+}
+
+void FBArenaReset(FBArenaRef arena)
+{
+    // Free everything but the oldest block, which is the one a steady state
+    //  operation is most likely to fit in.
+    FBArenaBlock *block = arena->currentBlock;
+    while ( block != NULL && block->previous != NULL ) {
+        FBArenaBlock *previous = block->previous;
+        free(block);
+        arena->blockCount--;
+        block = previous;
+    }
+    if ( block != NULL )
+        block->used = 0;
+    arena->currentBlock = block;
+    arena->lastAllocation = NULL;
+}
+
+NSUInteger FBArenaGetBlockCount(FBArenaRef arena)
+{
+    return arena->blockCount;
+}
+
+static pthread_key_t FBArenaThreadKey;
+static pthread_once_t FBArenaThreadKeyOnce = PTHREAD_ONCE_INIT;
+
+static void FBArenaReleaseThreadArena(void *arena)
+{
+    FBArenaRelease(arena);
+}
+
+static void FBArenaCreateThreadKey(void)
+{
+    pthread_key_create(&FBArenaThreadKey, FBArenaReleaseThreadArena);
+}
+
+FBArenaRef FBArenaGetForCurrentThread(void)
+{
+    pthread_once(&FBArenaThreadKeyOnce, FBArenaCreateThreadKey);
+    FBArenaRef arena = pthread_getspecific(FBArenaThreadKey);
+    if ( arena == NULL ) {
+        arena = FBArenaCreate(0);
+        pthread_setspecific(FBArenaThreadKey, arena);
+    }
+    return arena;
+}
@@ -0,0 +1,51 @@
+//
+//  FBArena.h
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#ifndef FBARENA_H
+#define FBARENA_H
+
+#include "FBTypes.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Arena
+//
+// FBArena is a bump allocator for the scratch data of one boolean operation.
+//  Allocations are carved out of large blocks, are never freed individually,
+//  and all go away together when the arena is released. That turns the many
+//  small allocations an operation makes into a handful of block allocations.
+//
+
+typedef struct FBArena *FBArenaRef;
+
+// Creates an arena. The block size is only a hint, allocations larger than
+//  a block get a block of their own. Pass zero for a reasonable default.
+extern FBArenaRef FBArenaCreate(size_t blockSize);
+extern void FBArenaRelease(FBArenaRef arena);
+
+// Returns zeroed memory aligned for any type. It stays valid until the arena is
+//  reset or released.
+extern void *FBArenaAllocate(FBArenaRef arena, size_t size);
+
+// Grows the last allocation in place if possible, otherwise makes a new allocation
+//  and copies the old contents over. The old memory isn't reclaimed until the
+//  arena is reset, so growing arrays should grow geometrically.
+extern void *FBArenaReallocate(FBArenaRef arena, void *memory, size_t oldSize, size_t newSize);
+
+// Forgets all the allocations, but keeps the first block around for reuse.
+extern void FBArenaReset(FBArenaRef arena);
+
+// An arena that belongs to the calling thread, created on first use and released
+//  when the thread exits. Code using it must reset it when done, and must not
+//  call anything else that uses it in the meantime.
+extern FBArenaRef FBArenaGetForCurrentThread(void);
+
+// The number of blocks the arena got from malloc, which is what it's trying
+//  to keep small.
+extern NSUInteger FBArenaGetBlockCount(FBArenaRef arena);
+
+#endif
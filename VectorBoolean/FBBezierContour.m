@@ -17,6 +17,7 @@
 #import "CGPath+Utilities.h"
 #import "FBCurveLocation.h"
 #import "FBBezierIntersectRange.h"
+#import "FBStatistics.h"
 
 @interface FBBezierContour ()
 
@@ -188,6 +189,7 @@
     //  the graph, if even, outside.
     CGPoint lineEndPoint = CGPointMake(testPoint.x > NSMinX(self.bounds) ? NSMinX(self.bounds) - 10 : NSMaxX(self.bounds) + 10, testPoint.y); /* just move us outside the bounds of the graph */
     FBBezierCurve *testCurve = [FBBezierCurve bezierCurveWithLineStartPoint:testPoint endPoint:lineEndPoint];
+    FBStatisticsIncrement(FBStatisticRaysCast);
     
     NSUInteger intersectCount = [self numberOfIntersectionsWithRay:testCurve];
     return (intersectCount & 1) == 1;
@@ -212,7 +214,7 @@
     for (FBBezierCurve *edge in _edges) {
         // Check for intersections between our test ray and the rest of the bezier graph
         FBBezierIntersectRange *intersectRange = nil;
-        [testEdge intersectionsWithBezierCurve:edge overlapRange:&intersectRange withBlock:^(FBBezierIntersection *intersection, BOOL *stop) {
+        [testEdge rayIntersectionsWithBezierCurve:edge overlapRange:&intersectRange withBlock:^(FBBezierIntersection *intersection, BOOL *stop) {
             // Make sure this is a proper crossing
             if ( ![testEdge crossesEdge:edge atIntersection:intersection] || edge.isPoint ) // don't count tangents
                 return;
@@ -578,6 +580,10 @@
     FBBezierCurveLocation location = {};
     
     for (FBBezierCurve *edge in _edges) {
+        // An edge lies inside its bounds, so if those are already farther away than the
+        //  closest edge so far, don't bother projecting the point onto it.
+        if ( closestEdge != nil && FBDistancePointToRect(point, edge.boundingRect) > location.distance )
+            continue;
         FBBezierCurveLocation edgeLocation = [edge closestLocationToPoint:point];
         if ( closestEdge == nil || edgeLocation.distance < location.distance ) {
             closestEdge = edge;
@@ -134,6 +134,8 @@ static void FBComputeEdge2RangeTangentCurves(FBBezierCurve *edge, FBBezierInters
 
 - (void) removeAllCrossings
 {
+    for (FBEdgeCrossing *crossing in _crossings)
+        crossing.edge = nil;
     [_crossings removeAllObjects];
 }
 
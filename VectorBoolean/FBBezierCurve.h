@@ -9,32 +9,18 @@
 #import <Foundation/Foundation.h>
 #import <CoreGraphics/CoreGraphics.h>
 #import "FBGeometry.h"
+#import "FBBezierCurveData.h"
 
 @class FBBezierIntersectRange, FBBezierIntersection, FBBezierContour;
+struct FBBezierCurveLengthTable;
 
 typedef void (^FBCurveIntersectionBlock)(FBBezierIntersection *intersection, BOOL *stop);
 
-typedef struct FBBezierCurveLocation {
-    CGFloat parameter;
-    CGFloat distance;
-} FBBezierCurveLocation;
-
-typedef struct FBBezierCurveData {
-    CGPoint endPoint1;
-    CGPoint controlPoint1;
-    CGPoint controlPoint2;
-    CGPoint endPoint2;
-	BOOL isStraightLine;		// GPC: flag when curve came from a straight line segment
-    CGFloat length; // cached value
-    CGRect bounds; // cached value
-    BOOL isPoint; // cached value
-    CGRect boundingRect; // cached value
-} FBBezierCurveData;
-
 // FBBezierCurve is one cubic 2D bezier curve. It represents one segment of a bezier path, and is where
 //  the intersection calculation happens
 @interface FBBezierCurve : NSObject {
     FBBezierCurveData _data;
+    struct FBBezierCurveLengthTable *_lengthTable; // built the first time the curve is measured
     
     NSMutableArray *_crossings; // sorted by parameter of the intersection
     FBBezierContour *_contour;
@@ -45,28 +31,35 @@ typedef struct FBBezierCurveData {
 + (NSArray *) bezierCurvesFromPath:(CGPathRef)path;
 
 + (instancetype) bezierCurveWithLineStartPoint:(CGPoint)startPoint endPoint:(CGPoint)endPoint;
++ (instancetype) bezierCurveWithQuadraticStartPoint:(CGPoint)startPoint controlPoint:(CGPoint)controlPoint endPoint:(CGPoint)endPoint;
 + (instancetype) bezierCurveWithEndPoint1:(CGPoint)endPoint1 controlPoint1:(CGPoint)controlPoint1 controlPoint2:(CGPoint)controlPoint2 endPoint2:(CGPoint)endPoint2;
++ (instancetype) bezierCurveWithBezierCurveData:(FBBezierCurveData)data;
 
 - (instancetype) initWithEndPoint1:(CGPoint)endPoint1 controlPoint1:(CGPoint)controlPoint1 controlPoint2:(CGPoint)controlPoint2 endPoint2:(CGPoint)endPoint2 contour:(FBBezierContour *)contour;
 - (instancetype) initWithLineStartPoint:(CGPoint)startPoint endPoint:(CGPoint)endPoint contour:(FBBezierContour *)contour;
+- (instancetype) initWithBezierCurveData:(FBBezierCurveData)data;
 
 @property (readonly) CGPoint endPoint1;
 @property (readonly) CGPoint controlPoint1;
 @property (readonly) CGPoint controlPoint2;
 @property (readonly) CGPoint endPoint2;
 @property (readonly) BOOL isStraightLine;
+@property (readonly) FBBezierCurveKind kind;
 @property (readonly) CGRect bounds;
 @property (readonly) CGRect boundingRect;
 @property (readonly, getter = isPoint) BOOL point;
+@property (readonly) FBBezierCurveData data;
 
 - (BOOL) doesHaveIntersectionsWithBezierCurve:(FBBezierCurve *)curve;
 - (void) intersectionsWithBezierCurve:(FBBezierCurve *)curve overlapRange:(FBBezierIntersectRange **)intersectRange withBlock:(FBCurveIntersectionBlock)block;
+- (void) rayIntersectionsWithBezierCurve:(FBBezierCurve *)curve overlapRange:(FBBezierIntersectRange **)intersectRange withBlock:(FBCurveIntersectionBlock)block; // receiver is a horizontal or vertical ray
 
 - (CGPoint) pointAtParameter:(CGFloat)parameter leftBezierCurve:(FBBezierCurve **)leftBezierCurve rightBezierCurve:(FBBezierCurve **)rightBezierCurve;
 - (FBBezierCurve *) subcurveWithRange:(FBRange)range;
 - (void) splitSubcurvesWithRange:(FBRange)range left:(FBBezierCurve **)leftCurve middle:(FBBezierCurve **)middleCurve right:(FBBezierCurve **)rightCurve;
 
 - (CGFloat) lengthAtParameter:(CGFloat)parameter;
+- (CGFloat) parameterAtLength:(CGFloat)length;
 @property (nonatomic, readonly) CGFloat length;
 
 - (CGPoint) pointFromRightOffset:(CGFloat)offset;
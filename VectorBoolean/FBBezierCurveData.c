@@ -0,0 +1,1427 @@
+//
+//  FBBezierCurveData.c
+//  VectorBoolean
+//
+//  Created by Andrew Finnell on 6/6/11.
+//  Copyright 2011 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include "FBBezierCurveData.h"
+#include "FBGeometry.h"
+#include "FBBezierCurveLength.h"
+#include "FBNormalizedLine.h"
+#include "FBConvexHull.h"
+#include "FBBezierCurveHelper.h"
+#include "FBVectorKernels.h"
+#include "FBStatistics.h"
+#include <string.h>
+
+static const CGFloat FBBezierCurveDataInvalidLength = -1.0;
+static const BOOL FBBezierCurveDataInvalidIsPoint = -1;
+
+static FBBezierCurveData FBBezierCurveDataMakeWithKind(CGPoint endPoint1, CGPoint controlPoint1, CGPoint controlPoint2, CGPoint endPoint2, FBBezierCurveKind kind)
+{
+    FBBezierCurveData data = {endPoint1, controlPoint1, controlPoint2, endPoint2, kind, FBBezierCurveDataInvalidLength, CGRectZero, FBBezierCurveDataInvalidIsPoint, CGRectZero };
+    return data;
+}
+
+FBBezierCurveData FBBezierCurveDataMake(CGPoint endPoint1, CGPoint controlPoint1, CGPoint controlPoint2, CGPoint endPoint2, BOOL isStraightLine)
+{
+    return FBBezierCurveDataMakeWithKind(endPoint1, controlPoint1, controlPoint2, endPoint2, isStraightLine ? FBBezierCurveKindLine : FBBezierCurveKindCubic);
+}
+
+FBBezierCurveData FBBezierCurveDataMakeWithLine(CGPoint startPoint, CGPoint endPoint)
+{
+    // Convert the line into a bezier curve to keep our intersection algorithm general (i.e. only
+    //  has to deal with curves, not lines). As long as the control points are colinear with the
+    //  end points, it'll be a line. But for consistency sake, we put the control points inside
+    //  the end points, 1/3 of the total distance away from their respective end point.
+    CGFloat distance = FBDistanceBetweenPoints(startPoint, endPoint);
+    CGPoint leftTangent = FBNormalizePoint(FBSubtractPoint(endPoint, startPoint));
+    
+    return FBBezierCurveDataMake(startPoint, FBAddPoint(startPoint, FBUnitScalePoint(leftTangent, distance / 3.0)), FBAddPoint(startPoint, FBUnitScalePoint(leftTangent, 2.0 * distance / 3.0)), endPoint, YES);
+}
+
+FBBezierCurveData FBBezierCurveDataMakeWithQuadratic(CGPoint startPoint, CGPoint controlPoint, CGPoint endPoint)
+{
+    // Raise the quadratic to a cubic, which traces exactly the same curve: each cubic control
+    //  point lies two thirds of the way from its end point to the quadratic control point.
+    CGPoint controlPoint1 = FBAddPoint(startPoint, FBScalePoint(FBSubtractPoint(controlPoint, startPoint), 2.0 / 3.0));
+    CGPoint controlPoint2 = FBAddPoint(endPoint, FBScalePoint(FBSubtractPoint(controlPoint, endPoint), 2.0 / 3.0));
+    return FBBezierCurveDataMakeWithKind(startPoint, controlPoint1, controlPoint2, endPoint, FBBezierCurveKindQuadratic);
+}
+
+CGFloat FBBezierCurveDataGetLengthAtParameter(FBBezierCurveData* me, CGFloat parameter)
+{
+    // Use the cached value if at all possible
+    if ( parameter == 1.0 && me->length != FBBezierCurveDataInvalidLength )
+        return me->length;
+    
+    // If it's a line, use that equation instead
+    CGFloat length = FBBezierCurveDataInvalidLength;
+    if ( me->kind == FBBezierCurveKindLine )
+        length = FBDistanceBetweenPoints(me->endPoint1, me->endPoint2) * parameter;
+    else
+        length = FBGaussQuadratureComputeCurveLengthForCubic(parameter, 12, me->endPoint1, me->controlPoint1, me->controlPoint2, me->endPoint2);
+    
+    // If possible, update our cache
+    if ( parameter == 1.0 )
+        me->length = length;
+    
+    return length;
+}
+
+CGFloat FBBezierCurveDataGetLength(FBBezierCurveData* me)
+{
+    return FBBezierCurveDataGetLengthAtParameter(me, 1.0);
+}
+
+CGPoint FBBezierCurveDataPointAtParameter(FBBezierCurveData me, CGFloat parameter, FBBezierCurveData *leftBezierCurve, FBBezierCurveData *rightBezierCurve)
+{
+    // This method is a simple wrapper around the BezierWithPoints() helper function. It computes the 2D point at the given parameter,
+    //  and (optionally) the resulting curves that splitting at the parameter would create.
+    
+    CGPoint points[4] = { me.endPoint1, me.controlPoint1, me.controlPoint2, me.endPoint2 };
+    CGPoint leftCurve[4] = {};
+    CGPoint rightCurve[4] = {};
+    
+    CGPoint point = FBVectorSplitCubic(points, parameter, leftBezierCurve != NULL ? leftCurve : NULL, rightBezierCurve != NULL ? rightCurve : NULL);
+    
+    if ( leftBezierCurve != NULL ) {
+        *leftBezierCurve = FBBezierCurveDataMakeWithKind(leftCurve[0], leftCurve[1], leftCurve[2], leftCurve[3], me.kind);
+	}
+    if ( rightBezierCurve != NULL ) {
+        *rightBezierCurve = FBBezierCurveDataMakeWithKind(rightCurve[0], rightCurve[1], rightCurve[2], rightCurve[3], me.kind);
+	}
+    return point;
+}
+
+FBBezierCurveData FBBezierCurveDataSubcurveWithRange(FBBezierCurveData me, FBRange range)
+{
+    // Return a bezier curve representing the parameter range specified. We do this by splitting
+    //  twice: once on the minimum, the splitting the result of that on the maximum.
+    FBBezierCurveData upperCurve = {};
+    FBBezierCurveDataPointAtParameter(me, range.minimum, NULL, &upperCurve);
+    if ( range.minimum == 1.0 )
+        return upperCurve; // avoid the divide by zero below
+    // We need to adjust the maximum parameter to fit on the new curve before we split again
+    CGFloat adjustedMaximum = (range.maximum - range.minimum) / (1.0 - range.minimum);
+    
+    FBBezierCurveData lowerCurve = {};
+    FBBezierCurveDataPointAtParameter(upperCurve, adjustedMaximum, &lowerCurve, NULL);
+    return lowerCurve;
+}
+
+NSUInteger FBBezierCurveDataSplitIntoMonotonePieces(FBBezierCurveData me, FBBezierCurveData pieces[5], FBRange ranges[5])
+{
+    // Pieces shorter than this aren't worth splitting off, the clipping handles them fine
+    static const CGFloat FBMinimumPieceSize = 1e-3;
+    
+    // Lines are monotone already
+    CGFloat splits[6] = { 0.0 };
+    NSUInteger splitCount = 1;
+    if ( me.kind != FBBezierCurveKindLine ) {
+        // The extrema in x and y are the roots of the derivatives. Missing roots come back
+        //  as NaN, which fails the range test.
+        CGFloat roots[4] = {};
+        NSUInteger xRootsCount = 0;
+        NSUInteger yRootsCount = 0;
+        FBComputeCubicFirstDerivativeRoots(me.endPoint1.x, me.controlPoint1.x, me.controlPoint2.x, me.endPoint2.x, &roots[0], &xRootsCount);
+        FBComputeCubicFirstDerivativeRoots(me.endPoint1.y, me.controlPoint1.y, me.controlPoint2.y, me.endPoint2.y, &roots[xRootsCount], &yRootsCount);
+        
+        // Insertion sort, dropping anything too close to the previous split or the end
+        for (NSUInteger i = 0; i < xRootsCount + yRootsCount; i++) {
+            CGFloat root = roots[i];
+            if ( !(root > FBMinimumPieceSize && root < 1.0 - FBMinimumPieceSize) )
+                continue;
+            NSUInteger position = splitCount;
+            while ( position > 1 && splits[position - 1] > root )
+                position--;
+            if ( (position > 0 && root - splits[position - 1] < FBMinimumPieceSize) || (position < splitCount && splits[position] - root < FBMinimumPieceSize) )
+                continue;
+            memmove(&splits[position + 1], &splits[position], (splitCount - position) * sizeof(CGFloat));
+            splits[position] = root;
+            splitCount++;
+        }
+    }
+    splits[splitCount++] = 1.0;
+    
+    NSUInteger pieceCount = splitCount - 1;
+    for (NSUInteger i = 0; i < pieceCount; i++) {
+        ranges[i] = FBRangeMake(splits[i], splits[i + 1]);
+        pieces[i] = pieceCount == 1 ? me : FBBezierCurveDataSubcurveWithRange(me, ranges[i]);
+    }
+    return pieceCount;
+}
+
+static const CGFloat FBFatLineRoundingThreshold = FBPrecisionThreshold(3e-7, 0.0, 0.0); // relative to the coordinates, how far rounding can move a distance from the fat line
+
+// The distances to the fat line are rounded off, and in single precision that's enough
+//  for the other curve to be clipped away right where it touches. So widen the bounds by
+//  how far off the distances can be. Double and extended precision don't need it.
+static FBRange FBBezierCurveDataWidenFatLineBounds(FBBezierCurveData me, CGFloat minimum, CGFloat maximum)
+{
+    CGFloat size = MAX(MAX(fabs(me.endPoint1.x), fabs(me.endPoint1.y)), MAX(fabs(me.endPoint2.x), fabs(me.endPoint2.y)));
+    CGFloat margin = FBFatLineRoundingThreshold * size;
+    return FBRangeMake(minimum - margin, maximum + margin);
+}
+
+static FBNormalizedLine FBBezierCurveDataRegularFatLineBounds(FBBezierCurveData me, FBRange *range)
+{
+    // Create the fat line based on the end points
+    FBNormalizedLine line = FBNormalizedLineMake(me.endPoint1, me.endPoint2);
+    
+    // Compute the bounds of the fat line. The fat line bounds should entirely encompass the
+    //  bezier curve. Since we know the convex hull entirely compasses the curve, just take
+    //  all four points that define this cubic bezier curve. Compute the signed distances of
+    //  each of the end and control points from the fat line, and that will give us the bounds.
+    
+    // In this case, we know that the end points are on the line, thus their distances will be 0.
+    //  So we can skip computing those and just use 0.
+    CGFloat controlPoint1Distance = FBNormalizedLineDistanceFromPoint(line, me.controlPoint1);
+    CGFloat controlPoint2Distance = FBNormalizedLineDistanceFromPoint(line, me.controlPoint2);
+    CGFloat min = MIN(controlPoint1Distance, MIN(controlPoint2Distance, 0.0));
+    CGFloat max = MAX(controlPoint1Distance, MAX(controlPoint2Distance, 0.0));
+    
+    *range = FBBezierCurveDataWidenFatLineBounds(me, min, max);
+    
+    return line;
+}
+
+static FBNormalizedLine FBBezierCurveDataPerpendicularFatLineBounds(FBBezierCurveData me, FBRange *range)
+{
+    // Create a fat line that's perpendicular to the line created by the two end points.
+    CGPoint normal = FBLineNormal(me.endPoint1, me.endPoint2);
+    CGPoint startPoint = FBLineMidpoint(me.endPoint1, me.endPoint2);
+    CGPoint endPoint = FBAddPoint(startPoint, normal);
+    FBNormalizedLine line = FBNormalizedLineMake(startPoint, endPoint);
+    
+    // Compute the bounds of the fat line. The fat line bounds should entirely encompass the
+    //  bezier curve. Since we know the convex hull entirely compasses the curve, just take
+    //  all four points that define this cubic bezier curve. Compute the signed distances of
+    //  each of the end and control points from the fat line, and that will give us the bounds.
+    CGPoint points[4] = { me.endPoint1, me.controlPoint1, me.controlPoint2, me.endPoint2 };
+    CGFloat distances[4] = {};
+    FBVectorDistancesFromLine(line, points, distances);
+    CGFloat point1Distance = distances[0];
+    CGFloat controlPoint1Distance = distances[1];
+    CGFloat controlPoint2Distance = distances[2];
+    CGFloat point2Distance = distances[3];
+    
+    CGFloat min = MIN(controlPoint1Distance, MIN(controlPoint2Distance, MIN(point1Distance, point2Distance)));
+    CGFloat max = MAX(controlPoint1Distance, MAX(controlPoint2Distance, MAX(point1Distance, point2Distance)));
+    
+    *range = FBBezierCurveDataWidenFatLineBounds(me, min, max);
+    
+    return line;
+}
+
+static FBRange FBBezierCurveDataClipWithFatLine(FBBezierCurveData me, FBNormalizedLine fatLine, FBRange bounds)
+{
+    // This method computes the range of self that could possibly intersect with the fat line passed in (and thus with the curve enclosed by the fat line).
+    //  To do that, we first compute the signed distance of all our points (end and control) from the fat line, and map those onto a bezier curve at
+    //  evenly spaced intervals from [0..1]. The parts of the distance bezier that fall inside of the fat line bounds, correspond to the parts of ourself
+    //  that could potentially intersect with the other curve. Ideally, we'd calculate where the distance bezier intersected the horizontal lines representing
+    //  the fat line bounds. However, computing those intersections is hard and costly. So instead we'll compute the convex hull, and intersect those lines
+    //  with the fat line bounds. The intersection with the lowest x coordinate will be the minimum, and the intersection with the highest x coordinate will
+    //  be the maximum.
+    
+    // The convex hull (for cubic beziers) is the four points that define the curve. A useful property of the convex hull is that the entire curve lies
+    //  inside of it.
+    
+    // First calculate bezier curve points distance from the fat line that's clipping us
+    CGPoint points[4] = { me.endPoint1, me.controlPoint1, me.controlPoint2, me.endPoint2 };
+    CGFloat distances[4] = {};
+    FBVectorDistancesFromLine(fatLine, points, distances);
+    CGPoint distanceBezierPoints[] = {
+        CGPointMake(0, distances[0]),
+        CGPointMake(1.0/3.0, distances[1]),
+        CGPointMake(2.0/3.0, distances[2]),
+        CGPointMake(1.0, distances[3])
+    };
+    
+    NSUInteger convexHullLength = 0;
+    CGPoint convexHull[8] = {};
+    FBConvexHullBuildFromPoints(distanceBezierPoints, convexHull, &convexHullLength);
+    
+    // Find intersections of convex hull with the fat line bounds
+    FBRange range = FBRangeMake(1.0, 0.0);
+    for (NSUInteger i = 0; i < convexHullLength; i++) {
+        // Pull out the current line on the convex hull
+        NSUInteger indexOfNext = i < (convexHullLength - 1) ? i + 1 : 0;
+        CGPoint startPoint = convexHull[i];
+        CGPoint endPoint = convexHull[indexOfNext];
+        CGPoint intersectionPoint = CGPointZero;
+        
+        // See if the segment of the convex hull intersects with the minimum fat line bounds
+        if ( LineIntersectsHorizontalLine(startPoint, endPoint, bounds.minimum, &intersectionPoint) ) {
+            if ( intersectionPoint.x < range.minimum )
+                range.minimum = intersectionPoint.x;
+            if ( intersectionPoint.x > range.maximum )
+                range.maximum = intersectionPoint.x;
+        }
+        
+        // See if this segment of the convex hull intersects with the maximum fat line bounds
+        if ( LineIntersectsHorizontalLine(startPoint, endPoint, bounds.maximum, &intersectionPoint) ) {
+            if ( intersectionPoint.x < range.minimum )
+                range.minimum = intersectionPoint.x;
+            if ( intersectionPoint.x > range.maximum )
+                range.maximum = intersectionPoint.x;
+        }
+        
+        // We want to be able to refine t even if the convex hull lies completely inside the bounds. This
+        //  also allows us to be able to use range of [1..0] as a sentinel value meaning the convex hull
+        //  lies entirely outside of bounds, and the curves don't intersect.
+        if ( startPoint.y < bounds.maximum && startPoint.y > bounds.minimum ) {
+            if ( startPoint.x < range.minimum )
+                range.minimum = startPoint.x;
+            if ( startPoint.x > range.maximum )
+                range.maximum = startPoint.x;
+        }
+    }
+    
+    // Check for bad values
+    if ( range.minimum == INFINITY || range.minimum == NAN || range.maximum == INFINITY || range.maximum == NAN )
+        range = FBRangeMake(0, 1); // equivalent to: something went wrong, so I don't know
+
+#if FB_PRECISION == FB_PRECISION_SINGLE
+    // Widened bounds can just miss a flat hull segment and get extended past the ends of the curve. Keep it
+    //  on the curve, which leaves the [1..0] sentinel alone.
+    range = FBRangeMake(MAX(range.minimum, 0.0), MIN(range.maximum, 1.0));
+#endif
+
+    return range;
+}
+
+static FBBezierCurveData FBBezierCurveDataBezierClipWithBezierCurve(FBBezierCurveData me, FBBezierCurveData curve, FBBezierCurveData originalCurve, FBRange *originalRange, BOOL *intersects)
+{
+    // This method does the clipping of self. It removes the parts of self that we can determine don't intersect
+    //  with curve. It'll return the clipped version of self, update originalRange which corresponds to the range
+    //  on the original curve that the return value represents. Finally, it'll set the intersects out parameter
+    //  to yes or no depending on if the curves intersect or not.
+    
+    // Clipping works as follows:
+    //  Draw a line through the two endpoints of the other curve, which we'll call the fat line. Measure the
+    //  signed distance between the control points on the other curve and the fat line. The distance from the line
+    //  will give us the fat line bounds. Any part of our curve that lies further away from the fat line than the
+    //  fat line bounds we know can't intersect with the other curve, and thus can be removed.
+    
+    // We actually use two different fat lines. The first one uses the end points of the other curve, and the second
+    //  one is perpendicular to the first. Most of the time, the first fat line will clip off more, but sometimes the
+    //  second proves to be a better fat line in that it clips off more. We use both in order to converge more quickly.
+    
+    // Compute the regular fat line using the end points, then compute the range that could still possibly intersect
+    //  with the other curve
+    FBRange fatLineBounds = {};
+    FBNormalizedLine fatLine = FBBezierCurveDataRegularFatLineBounds(curve, &fatLineBounds);
+    FBRange regularClippedRange = FBBezierCurveDataClipWithFatLine(me, fatLine, fatLineBounds);
+    // A range of [1, 0] is a special sentinel value meaning "they don't intersect". If they don't, bail early to save time
+    if ( regularClippedRange.minimum == 1.0 && regularClippedRange.maximum == 0.0 ) {
+        *intersects = NO;
+        return me;
+    }
+    
+    // Just in case the regular fat line isn't good enough, try the perpendicular one
+    FBRange perpendicularLineBounds = {};
+    FBNormalizedLine perpendicularLine = FBBezierCurveDataPerpendicularFatLineBounds(curve, &perpendicularLineBounds);
+    FBRange perpendicularClippedRange = FBBezierCurveDataClipWithFatLine(me, perpendicularLine, perpendicularLineBounds);
+    if ( perpendicularClippedRange.minimum == 1.0 && perpendicularClippedRange.maximum == 0.0 ) {
+        *intersects = NO;
+        return me;
+    }
+    
+    // Combine to form Voltron. Take the intersection of the regular fat line range and the perpendicular one.
+    FBRange clippedRange = FBRangeMake(MAX(regularClippedRange.minimum, perpendicularClippedRange.minimum), MIN(regularClippedRange.maximum, perpendicularClippedRange.maximum));
+    
+    // Right now the clipped range is relative to ourself, not the original curve. So map the newly clipped range onto the original range
+    FBRange newRange = FBRangeMake(FBRangeScaleNormalizedValue(*originalRange, clippedRange.minimum), FBRangeScaleNormalizedValue(*originalRange, clippedRange.maximum));
+    *originalRange = newRange;
+    *intersects = YES;
+    
+    // Actually divide the curve, but be sure to use the original curve. This helps with errors building up.
+    return FBBezierCurveDataSubcurveWithRange(originalCurve, *originalRange);
+}
+
+NSUInteger FBBezierCurveDataGetFlatteningSegmentCount(FBBezierCurveData *me, CGFloat tolerance)
+{
+    if ( me->kind == FBBezierCurveKindLine )
+        return 1;
+    
+    // A line between two points of the curve h apart in parameter strays at most M h^2 / 8
+    //  from it, where M bounds the second derivative. That's 6 (1 - t) d1 + 6 t d2 for the
+    //  second differences d1 and d2 of the control points, so M is 6 times the larger one.
+    CGPoint difference1 = FBAddPoint(FBSubtractPoint(me->endPoint1, FBScalePoint(me->controlPoint1, 2.0)), me->controlPoint2);
+    CGPoint difference2 = FBAddPoint(FBSubtractPoint(me->controlPoint1, FBScalePoint(me->controlPoint2, 2.0)), me->endPoint2);
+    CGFloat bound = 6.0 * MAX(FBPointLength(difference1), FBPointLength(difference2));
+    // Capped well inside what a count can hold, for tolerances of zero and the like
+    CGFloat count = ceil(sqrt(bound / (8.0 * tolerance)));
+    return count > 1.0 ? (NSUInteger)MIN(count, 1e9) : 1;
+}
+
+BOOL FBBezierCurveDataIsPoint(FBBezierCurveData *me)
+{
+    // If the two end points are close together, then we're a point. Ignore the control
+    //  points.
+    static const CGFloat FBClosenessThreshold = 1e-5;
+    
+    if ( me->isPoint != FBBezierCurveDataInvalidIsPoint )
+        return me->isPoint;
+    
+    me->isPoint = FBArePointsCloseWithOptions(me->endPoint1, me->endPoint2, FBClosenessThreshold)
+        && FBArePointsCloseWithOptions(me->endPoint1, me->controlPoint1, FBClosenessThreshold)
+        && FBArePointsCloseWithOptions(me->endPoint1, me->controlPoint2, FBClosenessThreshold);
+    
+    return me->isPoint;
+}
+
+CGRect FBBezierCurveDataBoundingRect(FBBezierCurveData *me)
+{
+    // Use the cache if we have one
+    if ( !CGRectEqualToRect(me->boundingRect, CGRectZero) )
+        return me->boundingRect;
+
+    CGFloat left = MIN(me->endPoint1.x, MIN(me->controlPoint1.x, MIN(me->controlPoint2.x, me->endPoint2.x)));
+    CGFloat top = MIN(me->endPoint1.y, MIN(me->controlPoint1.y, MIN(me->controlPoint2.y, me->endPoint2.y)));
+    CGFloat right = MAX(me->endPoint1.x, MAX(me->controlPoint1.x, MAX(me->controlPoint2.x, me->endPoint2.x)));
+    CGFloat bottom = MAX(me->endPoint1.y, MAX(me->controlPoint1.y, MAX(me->controlPoint2.y, me->endPoint2.y)));
+    
+    me->boundingRect = CGRectMake(left, top, right - left, bottom - top);
+    
+    return me->boundingRect;
+}
+
+CGRect FBBezierCurveDataBounds(FBBezierCurveData* me)
+{
+    // Use the cache if we have one
+    if ( !CGRectEqualToRect(me->bounds, CGRectZero) )
+        return me->bounds;
+    
+    CGRect bounds = CGRectZero;
+    
+    if ( me->kind == FBBezierCurveKindLine ) {
+        CGPoint topLeft = me->endPoint1;
+        CGPoint bottomRight = topLeft;
+        FBExpandBoundsByPoint(&topLeft, &bottomRight, me->endPoint2);
+
+        bounds = CGRectMake(topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y);
+    } else {
+        // Start with the end points, then add the extrema
+        CGPoint points[4] = { me->endPoint1, me->controlPoint1, me->controlPoint2, me->endPoint2 };
+        bounds = FBVectorCurveBounds(points);
+    }
+    
+    // Cache the value
+    me->bounds = bounds;
+    
+    return me->bounds;
+}
+
+static void FBBezierCurveDataRefineIntersectionsOverIterations(NSUInteger iterations, FBRange *usRange, FBRange *themRange, FBBezierCurveData originalUs, FBBezierCurveData originalThem, FBBezierCurveData us, FBBezierCurveData them, FBBezierCurveData nonpointUs, FBBezierCurveData nonpointThem)
+{
+    for (NSUInteger i = 0; i < iterations; i++) {
+        BOOL intersects = NO;
+        us = FBBezierCurveDataBezierClipWithBezierCurve(us, them, originalUs, usRange, &intersects);
+        if ( !intersects )
+            us = FBBezierCurveDataBezierClipWithBezierCurve(nonpointUs, nonpointThem, originalUs, usRange, &intersects);
+        them = FBBezierCurveDataBezierClipWithBezierCurve(them, us, originalThem, themRange, &intersects);
+        if ( !intersects )
+            them = FBBezierCurveDataBezierClipWithBezierCurve(nonpointThem, nonpointUs, originalThem, themRange, &intersects);
+        if ( !FBBezierCurveDataIsPoint(&them) )
+            nonpointThem = them;
+        if ( !FBBezierCurveDataIsPoint(&us) )
+            nonpointUs = us;
+    }
+}
+
+
+static FBBezierCurveData FBBezierCurveDataClipLineOriginalCurve(FBBezierCurveData me, FBBezierCurveData originalCurve, FBBezierCurveData curve, FBRange *originalRange, FBBezierCurveData otherCurve, BOOL *intersects)
+{
+    CGFloat themOnUs1 = FBParameterOfPointOnLine(curve.endPoint1, curve.endPoint2, otherCurve.endPoint1);
+    CGFloat themOnUs2 = FBParameterOfPointOnLine(curve.endPoint1, curve.endPoint2, otherCurve.endPoint2);
+    FBRange clippedRange = FBRangeMake(MAX(0, MIN(themOnUs1, themOnUs2)), MIN(1, MAX(themOnUs1, themOnUs2)));
+    if ( clippedRange.minimum > clippedRange.maximum ) {
+        *intersects = NO;
+        return curve; // No intersection
+    }
+    
+    // Right now the clipped range is relative to ourself, not the original curve. So map the newly clipped range onto the original range
+    FBRange newRange = FBRangeMake(FBRangeScaleNormalizedValue(*originalRange, clippedRange.minimum), FBRangeScaleNormalizedValue(*originalRange, clippedRange.maximum));
+    *originalRange = newRange;
+    *intersects = YES;
+    
+    // Actually divide the curve, but be sure to use the original curve. This helps with errors building up.
+    return FBBezierCurveDataSubcurveWithRange(originalCurve, *originalRange);
+}
+
+static BOOL FBBezierCurveDataCheckLinesForOverlap(FBBezierCurveData me, FBRange *usRange, FBRange *themRange, FBBezierCurveData originalUs, FBBezierCurveData originalThem, FBBezierCurveData *us, FBBezierCurveData *them)
+{
+    // First see if its possible for them to overlap at all
+    if ( !FBLineBoundsMightOverlap(FBBezierCurveDataBounds(us), FBBezierCurveDataBounds(them)) )
+        return NO;
+    
+    // Are all 4 points in a single line?
+    CGFloat errorThreshold = FBPrecisionThreshold(8e-4, 1e-7, 3e-9);
+    BOOL isColinear = FBAreValuesCloseWithOptions(CounterClockwiseTurn((*us).endPoint1, (*us).endPoint2, (*them).endPoint1), 0.0, errorThreshold)
+                    && FBAreValuesCloseWithOptions(CounterClockwiseTurn((*us).endPoint1, (*us).endPoint2, (*them).endPoint2), 0.0, errorThreshold);
+    if ( !isColinear )
+        return NO;
+    
+    BOOL intersects = NO;
+    *us = FBBezierCurveDataClipLineOriginalCurve(me, originalUs, *us, usRange, *them, &intersects);
+    if ( !intersects )
+        return NO;
+
+    *them = FBBezierCurveDataClipLineOriginalCurve(me, originalThem, *them, themRange, *us, &intersects);
+    
+    return intersects;
+}
+
+static void FBBezierCurveDataConvertSelfAndPoint(FBBezierCurveData me, CGPoint point, CGPoint *bezierPoints)
+{
+    CGPoint selfPoints[4] = { me.endPoint1, me.controlPoint1, me.controlPoint2, me.endPoint2 };
+    
+    // c[i] in the paper
+    CGPoint distanceFromPoint[4] = {};
+    for (NSUInteger i = 0; i < 4; i++)
+        distanceFromPoint[i] = FBSubtractPoint(selfPoints[i], point);
+        
+        // d[i] in the paper
+        CGPoint weightedDelta[3] = {};
+        for (NSUInteger i = 0; i < 3; i++)
+            weightedDelta[i] = FBScalePoint(FBSubtractPoint(selfPoints[i + 1], selfPoints[i]), 3);
+            
+            // Precompute the dot product of distanceFromPoint and weightedDelta in order to speed things up
+            CGFloat precomputedTable[3][4] = {};
+            for (NSUInteger row = 0; row < 3; row++) {
+                for (NSUInteger column = 0; column < 4; column++)
+                    precomputedTable[row][column] = FBDotMultiplyPoint(weightedDelta[row], distanceFromPoint[column]);
+            }
+    
+    // Precompute some of the values to speed things up
+    static const CGFloat FBZ[3][4] = {
+        {1.0, 0.6, 0.3, 0.1},
+        {0.4, 0.6, 0.6, 0.4},
+        {0.1, 0.3, 0.6, 1.0}
+    };
+    
+    // Set the x values of the bezier points
+    for (NSUInteger i = 0; i < 6; i++)
+        bezierPoints[i] = CGPointMake((CGFloat)i / 5.0, 0);
+        
+        // Finally set the y values of the bezier points
+        NSInteger n = 3;
+        NSInteger m = n - 1;
+        for (NSInteger k = 0; k <= (n + m); k++) {
+            NSInteger lowerBound = MAX(0, k - m);
+            NSInteger upperBound = MIN(k, n);
+            for (NSInteger i = lowerBound; i <= upperBound; i++) {
+                NSInteger j = k - i;
+                bezierPoints[i + j].y += precomputedTable[j][i] * FBZ[j][i];
+            }
+        }
+}
+
+typedef struct FBBezierCurveDataClosestRootContext {
+    FBBezierCurveData curve;
+    CGPoint point;
+    CGFloat distance;
+    CGFloat parameter;
+} FBBezierCurveDataClosestRootContext;
+
+static void FBBezierCurveDataTestClosestRoot(CGFloat root, void *context)
+{
+    FBBezierCurveDataClosestRootContext *rootContext = context;
+    CGPoint location = FBBezierCurveDataPointAtParameter(rootContext->curve, root, NULL, NULL);
+    CGFloat theDistance = FBDistanceBetweenPoints(location, rootContext->point);
+    if ( theDistance < rootContext->distance ) {
+        rootContext->distance = theDistance;
+        rootContext->parameter = root;
+    }
+}
+
+FBBezierCurveLocation FBBezierCurveDataClosestLocationToPoint(FBBezierCurveData me, CGPoint point)
+{
+    CGPoint bezierPoints[6] = {};
+    FBBezierCurveDataConvertSelfAndPoint(me, point, bezierPoints);
+    
+    FBBezierCurveDataClosestRootContext rootContext = { me, point, FBDistanceBetweenPoints(me.endPoint1, point), 0.0 };
+    FBFindBezierRoots(bezierPoints, 5, FBBezierCurveDataTestClosestRoot, &rootContext);
+        
+    CGFloat lastDistance = FBDistanceBetweenPoints(me.endPoint2, point);
+    if ( lastDistance < rootContext.distance ) {
+        rootContext.distance = lastDistance;
+        rootContext.parameter = 1.0;
+    }
+    
+    FBBezierCurveLocation location = {};
+    location.parameter = rootContext.parameter;
+    location.distance = rootContext.distance;
+    return location;
+}
+
+
+BOOL FBBezierCurveDataIsEqualWithOptions(FBBezierCurveData me, FBBezierCurveData other, CGFloat threshold)
+{
+    if ( FBBezierCurveDataIsPoint(&me) || FBBezierCurveDataIsPoint(&other) )
+        return NO;
+    if ( (me.kind == FBBezierCurveKindLine) != (other.kind == FBBezierCurveKindLine) )
+        return NO;
+    
+    if ( me.kind == FBBezierCurveKindLine )
+        return FBArePointsCloseWithOptions(me.endPoint1, other.endPoint1, threshold) && FBArePointsCloseWithOptions(me.endPoint2, other.endPoint2, threshold);
+    return FBArePointsCloseWithOptions(me.endPoint1, other.endPoint1, threshold) && FBArePointsCloseWithOptions(me.controlPoint1, other.controlPoint1, threshold) && FBArePointsCloseWithOptions(me.controlPoint2, other.controlPoint2, threshold) && FBArePointsCloseWithOptions(me.endPoint2, other.endPoint2, threshold);
+}
+
+static BOOL FBBezierCurveDataAreCurvesEqual(FBBezierCurveData me, FBBezierCurveData other)
+{
+    if ( FBBezierCurveDataIsPoint(&me) || FBBezierCurveDataIsPoint(&other) )
+        return NO;
+    if ( (me.kind == FBBezierCurveKindLine) != (other.kind == FBBezierCurveKindLine) )
+        return NO;
+
+    
+    static const CGFloat endPointThreshold = 1e-4;
+    static const CGFloat controlPointThreshold = 1e-1;
+    
+    if ( me.kind == FBBezierCurveKindLine )
+        return FBArePointsCloseWithOptions(me.endPoint1, other.endPoint1, endPointThreshold) && FBArePointsCloseWithOptions(me.endPoint2, other.endPoint2, endPointThreshold);
+
+    return FBArePointsCloseWithOptions(me.endPoint1, other.endPoint1, endPointThreshold)
+        && FBArePointsCloseWithOptions(me.controlPoint1, other.controlPoint1, controlPointThreshold)
+        && FBArePointsCloseWithOptions(me.controlPoint2, other.controlPoint2, controlPointThreshold)
+        && FBArePointsCloseWithOptions(me.endPoint2, other.endPoint2, endPointThreshold);
+}
+
+BOOL FBBezierCurveDataIsEqual(FBBezierCurveData me, FBBezierCurveData other)
+{
+    return FBBezierCurveDataIsEqualWithOptions(me, other, FBPrecisionThreshold(4e-5, 1e-10, 8e-13));
+}
+
+FBBezierCurveData FBBezierCurveDataReversed(FBBezierCurveData me)
+{
+    return FBBezierCurveDataMakeWithKind(me.endPoint2, me.controlPoint2, me.controlPoint1, me.endPoint1, me.kind);
+}
+
+static FBBezierCurveDataOverlap FBBezierCurveDataOverlapMake(FBRange parameterRange1, FBRange parameterRange2, BOOL reversed)
+{
+    FBBezierCurveDataOverlap overlap = { YES, parameterRange1, parameterRange2, reversed };
+    return overlap;
+}
+
+static void FBBezierCurveDataMergeOverlap(FBBezierCurveDataOverlap *overlap, FBBezierCurveDataOverlap *otherOverlap)
+{
+    if ( !otherOverlap->hasOverlap )
+        return;
+    
+    if ( !overlap->hasOverlap ) {
+        *overlap = *otherOverlap;
+        return;
+    }
+    
+    // We assume the caller already knows we're talking about the same curves
+    overlap->parameterRange1 = FBRangeUnion(overlap->parameterRange1, otherOverlap->parameterRange1);
+    overlap->parameterRange2 = FBRangeUnion(overlap->parameterRange2, otherOverlap->parameterRange2);
+}
+
+static BOOL FBBezierCurveDataCheckForOverlapRange(FBBezierCurveData me, FBBezierCurveDataOverlap *overlap, FBRange *usRange, FBRange *themRange, FBBezierCurveData *originalUs, FBBezierCurveData *originalThem, FBBezierCurveData us, FBBezierCurveData them)
+{
+    if ( FBBezierCurveDataAreCurvesEqual(us, them) ) {
+        FBStatisticsIncrement(FBStatisticOverlapRanges);
+        if ( overlap != NULL )
+            *overlap = FBBezierCurveDataOverlapMake(*usRange, *themRange, NO);
+        return YES;
+    } else if ( FBBezierCurveDataAreCurvesEqual(us, FBBezierCurveDataReversed(them)) ) {
+        FBStatisticsIncrement(FBStatisticOverlapRanges);
+        if ( overlap != NULL )
+            *overlap = FBBezierCurveDataOverlapMake(*usRange, *themRange, YES);
+        return YES;
+    }
+    return NO;
+}
+
+static FBBezierCurveData FBBezierCurveDataFindPossibleOverlap(FBBezierCurveData me, FBBezierCurveData originalUs, FBBezierCurveData them, FBRange *possibleRange)
+{
+    FBBezierCurveLocation themOnUs1 = FBBezierCurveDataClosestLocationToPoint(originalUs, them.endPoint1);
+    FBBezierCurveLocation themOnUs2 = FBBezierCurveDataClosestLocationToPoint(originalUs, them.endPoint2);
+    FBRange range = FBRangeMake(MIN(themOnUs1.parameter, themOnUs2.parameter), MAX(themOnUs1.parameter, themOnUs2.parameter));
+    *possibleRange = range;
+    return FBBezierCurveDataSubcurveWithRange(originalUs, range);
+}
+
+static BOOL FBBezierCurveDataCheckCurvesForOverlapRange(FBBezierCurveData me, FBBezierCurveDataOverlap *overlap, FBRange *usRange, FBRange *themRange, FBBezierCurveData *originalUs, FBBezierCurveData *originalThem, FBBezierCurveData us, FBBezierCurveData them)
+{
+    if ( FBBezierCurveDataCheckForOverlapRange(me, overlap, usRange, themRange, originalUs, originalThem, us, them) )
+        return YES;
+    
+    FBRange usSubcurveRange = {};
+    FBBezierCurveData usSubcurve = FBBezierCurveDataFindPossibleOverlap(me, *originalUs, them, &usSubcurveRange);
+
+    FBRange themSubcurveRange = {};
+    FBBezierCurveData themSubcurve = FBBezierCurveDataFindPossibleOverlap(me, *originalThem, us, &themSubcurveRange);
+
+    CGFloat threshold = 1e-4;
+    if ( FBBezierCurveDataIsEqualWithOptions(usSubcurve, themSubcurve, threshold) || FBBezierCurveDataIsEqualWithOptions(usSubcurve, FBBezierCurveDataReversed(themSubcurve), threshold) ) {
+        *usRange = usSubcurveRange;
+        *themRange = themSubcurveRange;
+        return FBBezierCurveDataCheckForOverlapRange(me, overlap, usRange, themRange, originalUs, originalThem, usSubcurve, themSubcurve);
+    }
+    
+    return NO;
+}
+
+static void FBBezierCurveDataCheckNoIntersectionsForOverlapRange(FBBezierCurveData me, FBBezierCurveDataOverlap *overlap, FBRange *usRange, FBRange *themRange, FBBezierCurveData *originalUs, FBBezierCurveData *originalThem, FBBezierCurveData us, FBBezierCurveData them, FBBezierCurveData nonpointUs, FBBezierCurveData nonpointThem)
+{
+    if ( us.kind == FBBezierCurveKindLine && them.kind == FBBezierCurveKindLine )
+        FBBezierCurveDataCheckLinesForOverlap(me, usRange, themRange, *originalUs, *originalThem, &us, &them);
+    
+    FBBezierCurveDataCheckForOverlapRange(me, overlap, usRange, themRange, originalUs, originalThem, us, them);    
+}
+
+static BOOL FBBezierCurveDataCheckForStraightLineOverlap(FBBezierCurveData me, FBBezierCurveDataOverlap *overlap, FBRange *usRange, FBRange *themRange, FBBezierCurveData *originalUs, FBBezierCurveData *originalThem, FBBezierCurveData us, FBBezierCurveData them, FBBezierCurveData nonpointUs, FBBezierCurveData nonpointThem)
+{
+    BOOL hasOverlap = NO;
+    
+    if ( us.kind == FBBezierCurveKindLine && them.kind == FBBezierCurveKindLine )
+        hasOverlap = FBBezierCurveDataCheckLinesForOverlap(me, usRange, themRange, *originalUs, *originalThem, &us, &them);
+    
+    if ( hasOverlap )
+        hasOverlap = FBBezierCurveDataCheckForOverlapRange(me, overlap, usRange, themRange, originalUs, originalThem, us, them);
+        
+    return hasOverlap;
+}
+
+CGFloat FBBezierCurveDataRefineParameter(FBBezierCurveData me, CGFloat parameter, CGPoint point)
+{
+    // Use Newton's Method to refine our parameter. In general, that formula is:
+    //
+    //  parameter = parameter - f(parameter) / f'(parameter)
+    //
+    // In our case:
+    //
+    //  f(parameter) = (Q(parameter) - point) * Q'(parameter) = 0
+    //
+    // Where Q'(parameter) is tangent to the curve at Q(parameter) and orthogonal to [Q(parameter) - P]
+    //
+    // Taking the derivative gives us:
+    //
+    //  f'(parameter) = (Q(parameter) - point) * Q''(parameter) + Q'(parameter) * Q'(parameter)
+    //
+    
+    CGPoint bezierPoints[4] = {me.endPoint1, me.controlPoint1, me.controlPoint2, me.endPoint2};
+    
+    // Compute Q(parameter)
+    CGPoint qAtParameter = BezierWithPoints(3, bezierPoints, parameter, NULL, NULL);
+    
+    // Compute Q'(parameter)
+    CGPoint qPrimePoints[3] = {};
+    for (NSUInteger i = 0; i < 3; i++) {
+        qPrimePoints[i].x = (bezierPoints[i + 1].x - bezierPoints[i].x) * 3.0;
+        qPrimePoints[i].y = (bezierPoints[i + 1].y - bezierPoints[i].y) * 3.0;
+    }
+    CGPoint qPrimeAtParameter = BezierWithPoints(2, qPrimePoints, parameter, NULL, NULL);
+    
+    // Compute Q''(parameter)
+    CGPoint qPrimePrimePoints[2] = {};
+    for (NSUInteger i = 0; i < 2; i++) {
+        qPrimePrimePoints[i].x = (qPrimePoints[i + 1].x - qPrimePoints[i].x) * 2.0;
+        qPrimePrimePoints[i].y = (qPrimePoints[i + 1].y - qPrimePoints[i].y) * 2.0;
+    }
+    CGPoint qPrimePrimeAtParameter = BezierWithPoints(1, qPrimePrimePoints, parameter, NULL, NULL);
+    
+    // Compute f(parameter) and f'(parameter)
+    CGPoint qMinusPoint = FBSubtractPoint(qAtParameter, point);
+    CGFloat fAtParameter = FBDotMultiplyPoint(qMinusPoint, qPrimeAtParameter);
+    CGFloat fPrimeAtParameter = FBDotMultiplyPoint(qMinusPoint, qPrimePrimeAtParameter) + FBDotMultiplyPoint(qPrimeAtParameter, qPrimeAtParameter);
+    
+    // Newton's method!
+    return parameter - (fAtParameter / fPrimeAtParameter);
+}
+
+static BOOL FBBezierCurveDataIntersectionsWithStraightLines(FBBezierCurveData me, FBBezierCurveData curve, FBRange *usRange, FBRange *themRange, FBBezierCurveData *originalUs, FBBezierCurveData *originalThem, FBBezierCurveDataIntersectionFunction function, void *context, BOOL *stop)
+{
+    if ( me.kind != FBBezierCurveKindLine || curve.kind != FBBezierCurveKindLine )
+        return NO;
+    
+    CGPoint intersectionPoint = CGPointZero;
+    BOOL intersects = FBLinesIntersect(me.endPoint1, me.endPoint2, curve.endPoint1, curve.endPoint2, &intersectionPoint);
+    if ( !intersects )
+        return NO;
+
+    CGFloat meParameter = FBParameterOfPointOnLine(me.endPoint1, me.endPoint2, intersectionPoint);
+    if ( FBIsValueLessThan(meParameter, 0.0) || FBIsValueGreaterThan(meParameter, 1.0) )
+        return NO;
+
+    CGFloat curveParameter = FBParameterOfPointOnLine(curve.endPoint1, curve.endPoint2, intersectionPoint);
+    if ( FBIsValueLessThan(curveParameter, 0.0) || FBIsValueGreaterThan(curveParameter, 1.0) )
+        return NO;
+    
+    function(meParameter, curveParameter, context, stop);
+
+    return YES;
+}
+
+static void FBBezierCurveDataIntersectionsWithBezierCurveAtDepth(FBBezierCurveData me, FBBezierCurveData curve, FBRange *usRange, FBRange *themRange, FBBezierCurveData *originalUs, FBBezierCurveData *originalThem, FBBezierCurveDataOverlap *overlap, NSUInteger depth, FBBezierCurveDataIntersectionFunction function, void *context, BOOL *stop)
+{
+    // This is the main work loop. At a high level this method sits in a loop and removes sections (ranges) of the two bezier curves that it knows
+    //  don't intersect (how it knows that is covered in the appropriate method). The idea is to whittle the curves down to the point where they
+    //  do intersect. When the range where they intersect converges (i.e. matches to 6 decimal places) or there are more than 500 attempts, the loop
+    //  stops. A special case is when we're not able to remove at least 20% of the curves on a given interation. In that case we assume there are likely
+    //  multiple intersections, so we divide one of curves in half, and recurse on the two halves.
+    
+#if FB_PRECISION == FB_PRECISION_SINGLE
+    static const NSUInteger places = 4; // single precision rounds off more than 6 places of the parameter
+#else
+    static const NSUInteger places = 6; // How many decimals place to calculate the solution out to
+#endif
+    static const NSUInteger maxIterations = 500; // how many iterations to allow before we just give up
+    static const NSUInteger maxDepth = 10; // how many recursive calls to allow before we just give up
+    static const CGFloat minimumChangeNeeded = 0.20; // how much to clip off for a given iteration minimum before we subdivide the curve
+    
+    FBBezierCurveData us = me; // us is self, but clipped down to where the intersection is
+    FBBezierCurveData them = curve; // them is the other curve we're intersecting with, but clipped down to where the intersection is
+    FBBezierCurveData nonpointUs = us;
+    FBBezierCurveData nonpointThem = them;
+    
+    
+    // Horizontal and vertical lines are somewhat special cases, and the math doesn't always work out that great. For example, two vertical lines
+    //  that overlap will kick out as intersecting at the endpoints. Try to detect that kind of overlap at the start.
+    if ( FBBezierCurveDataCheckForStraightLineOverlap(me, overlap, usRange, themRange, originalUs, originalThem, us, them, nonpointUs, nonpointThem) )
+        return;
+    if ( us.kind == FBBezierCurveKindLine && them.kind == FBBezierCurveKindLine ) {
+        FBBezierCurveDataIntersectionsWithStraightLines(me, curve, usRange, themRange, originalUs, originalThem, function, context, stop);
+        return;
+    }
+    
+    FBBezierCurveData originalUsData = *originalUs;
+    FBBezierCurveData originalThemData = *originalThem;
+    
+    // Don't check for convergence until we actually see if we intersect or not. i.e. Make sure we go through at least once, otherwise the results
+    //  don't mean anything. Be sure to stop as soon as either range converges, otherwise calculations for the other range goes funky because one
+    //  curve is essentially a point.
+    NSUInteger iterations = 0;
+    BOOL hadConverged = YES;
+    while ( iterations < maxIterations && ((iterations == 0) || (!FBRangeHasConverged(*usRange, places) || !FBRangeHasConverged(*themRange, places))) ) {
+        FBStatisticsIncrement(FBStatisticClipIterations);
+        
+        // Remember what the current range is so we can calculate how much it changed later
+        FBRange previousUsRange = *usRange;
+        FBRange previousThemRange = *themRange;
+        
+        // Remove the range from ourselves that doesn't intersect with them. If the other curve is already a point, use the previous iteration's
+        //  copy of them so calculations still work.
+        BOOL intersects = NO;
+        if ( !FBBezierCurveDataIsPoint(&them) )
+            nonpointThem = them;
+        us = FBBezierCurveDataBezierClipWithBezierCurve(nonpointUs, nonpointThem, originalUsData, usRange, &intersects);
+        if ( !intersects ) {
+            FBBezierCurveDataCheckNoIntersectionsForOverlapRange(me, overlap, usRange, themRange, originalUs, originalThem, us, them, nonpointUs, nonpointThem);
+            return; // If they don't intersect at all stop now
+        }
+        if ( iterations > 0 && (FBBezierCurveDataIsPoint(&us) || FBBezierCurveDataIsPoint(&them)) )
+            break;
+        
+        // Remove the range of them that doesn't intersect with us
+        if ( !FBBezierCurveDataIsPoint(&us) )
+            nonpointUs = us;
+        else if ( iterations == 0 )
+            // If the first time through us was reduced to a point, then we're never going to know if the curves actually intersect,
+            //  even if both ranges converge. The ranges can converge on the parameters on each respective curve that is closest to the
+            //  other. But without being clipped to a smaller range the algorithm won't necessarily detect that they don't actually intersect
+            hadConverged = NO;
+        them = FBBezierCurveDataBezierClipWithBezierCurve(nonpointThem, nonpointUs, originalThemData, themRange, &intersects);
+        if ( !intersects ) {
+            FBBezierCurveDataCheckNoIntersectionsForOverlapRange(me, overlap, usRange, themRange, originalUs, originalThem, us, them, nonpointUs, nonpointThem); 
+            return; // If they don't intersect at all stop now
+        }
+        if ( iterations > 0 && (FBBezierCurveDataIsPoint(&us) || FBBezierCurveDataIsPoint(&them)) )
+            break;
+        
+        // See if either of curves ranges is reduced by less than 20%.
+        CGFloat percentChangeInUs = (FBRangeGetSize(previousUsRange) - FBRangeGetSize(*usRange)) / FBRangeGetSize(previousUsRange);
+        CGFloat percentChangeInThem = (FBRangeGetSize(previousThemRange) - FBRangeGetSize(*themRange)) / FBRangeGetSize(previousThemRange);
+        BOOL didNotSplit = NO;
+        if ( percentChangeInUs < minimumChangeNeeded && percentChangeInThem < minimumChangeNeeded ) {
+            // We're not converging fast enough, likely because there are multiple intersections here.
+            //  Or the curves are the same, check for that first            
+            if ( FBBezierCurveDataCheckCurvesForOverlapRange(me, overlap, usRange, themRange, originalUs, originalThem, us, them) )
+                return;
+            
+            // Divide and conquer. Divide the longer curve in half, and recurse
+            if ( FBRangeGetSize(*usRange) > FBRangeGetSize(*themRange) ) {
+                // Since our remaining range is longer, split the remains of us in half at the midway point
+                FBRange usRange1 = FBRangeMake(usRange->minimum, (usRange->minimum + usRange->maximum) / 2.0);
+                FBBezierCurveData us1 = FBBezierCurveDataSubcurveWithRange(originalUsData, usRange1);
+                FBRange themRangeCopy1 = *themRange; // make a local copy because it'll get modified when we recurse
+                
+                FBRange usRange2 = FBRangeMake((usRange->minimum + usRange->maximum) / 2.0, usRange->maximum);
+                FBBezierCurveData us2 = FBBezierCurveDataSubcurveWithRange(originalUsData, usRange2);
+                FBRange themRangeCopy2 = *themRange; // make a local copy because it'll get modified when we recurse
+                
+                BOOL range1ConvergedAlready = FBRangeHasConverged(usRange1, places) && FBRangeHasConverged(*themRange, places);
+                BOOL range2ConvergedAlready = FBRangeHasConverged(usRange2, places) && FBRangeHasConverged(*themRange, places);
+                
+                if ( !range1ConvergedAlready && !range2ConvergedAlready && depth < maxDepth ) {
+                    FBStatisticsIncrement(FBStatisticSubdivisions);
+                    
+                    // Compute the intersections between the two halves of us and them
+                    FBBezierCurveDataOverlap leftOverlap = {};
+                    FBBezierCurveDataIntersectionsWithBezierCurveAtDepth(us1, them, &usRange1, &themRangeCopy1, originalUs, originalThem, &leftOverlap, depth + 1, function, context, stop);
+                    if ( overlap != NULL )
+                        FBBezierCurveDataMergeOverlap(overlap, &leftOverlap);
+                    if ( *stop )
+                        return;
+                    FBBezierCurveDataOverlap rightOverlap = {};
+                    FBBezierCurveDataIntersectionsWithBezierCurveAtDepth(us2, them, &usRange2, &themRangeCopy2, originalUs, originalThem, &rightOverlap, depth + 1, function, context, stop);
+                    if ( overlap != NULL )
+                        FBBezierCurveDataMergeOverlap(overlap, &rightOverlap);
+                    return;
+                } else
+                    didNotSplit = YES;
+            } else {
+                // Since their remaining range is longer, split the remains of them in half at the midway point
+                FBRange themRange1 = FBRangeMake(themRange->minimum, (themRange->minimum + themRange->maximum) / 2.0);
+                FBBezierCurveData them1 = FBBezierCurveDataSubcurveWithRange(originalThemData, themRange1);
+                FBRange usRangeCopy1 = *usRange;  // make a local copy because it'll get modified when we recurse
+                
+                FBRange themRange2 = FBRangeMake((themRange->minimum + themRange->maximum) / 2.0, themRange->maximum);
+                FBBezierCurveData them2 = FBBezierCurveDataSubcurveWithRange(originalThemData, themRange2);
+                FBRange usRangeCopy2 = *usRange;  // make a local copy because it'll get modified when we recurse
+                
+                BOOL range1ConvergedAlready = FBRangeHasConverged(themRange1, places) && FBRangeHasConverged(*usRange, places);
+                BOOL range2ConvergedAlready = FBRangeHasConverged(themRange2, places) && FBRangeHasConverged(*usRange, places);
+                
+                if ( !range1ConvergedAlready && !range2ConvergedAlready && depth < maxDepth ) {
+                    FBStatisticsIncrement(FBStatisticSubdivisions);
+                    
+                    // Compute the intersections between the two halves of them and us
+                    FBBezierCurveDataOverlap leftOverlap = {};
+                    FBBezierCurveDataIntersectionsWithBezierCurveAtDepth(us, them1, &usRangeCopy1, &themRange1, originalUs, originalThem, &leftOverlap, depth + 1, function, context, stop);
+                    if ( overlap != NULL )
+                        FBBezierCurveDataMergeOverlap(overlap, &leftOverlap);
+
+                    if ( *stop )
+                        return;
+                    FBBezierCurveDataOverlap rightOverlap = {};
+                    FBBezierCurveDataIntersectionsWithBezierCurveAtDepth(us, them2, &usRangeCopy2, &themRange2, originalUs, originalThem, &rightOverlap, depth + 1, function, context, stop);
+                    if ( overlap != NULL )
+                        FBBezierCurveDataMergeOverlap(overlap, &rightOverlap);
+
+                    return;
+                } else
+                    didNotSplit = YES;
+            }
+            
+            if ( didNotSplit && (FBRangeGetSize(previousUsRange) - FBRangeGetSize(*usRange) == 0) && (FBRangeGetSize(previousThemRange) - FBRangeGetSize(*themRange) == 0) ) {
+#if FB_PRECISION == FB_PRECISION_SINGLE
+                // We're not converging at _all_ and we can't split, so we need to bail out. Unless both ranges
+                //  are as narrow as the places asked for and just can't get any narrower, which happens in
+                //  single precision. Then make sure they actually intersect below.
+                CGFloat convergedSize = pow(10.0, -(CGFloat)places);
+                if ( FBRangeGetSize(*usRange) >= convergedSize || FBRangeGetSize(*themRange) >= convergedSize )
+                    return; // no intersections
+                hadConverged = NO;
+                break;
+#else
+                // We're not converging at _all_ and we can't split, so we need to bail out.
+                return; // no intersections
+#endif
+            }
+        }
+        
+        iterations++;
+    }
+    
+    
+    // It's possible that one of the curves has converged, but the other hasn't. Since the math becomes wonky once a curve becomes a point,
+    //  the loop stops as soon as either curve converges. However for our purposes we need _both_ curves to converge; that is we need
+    //  the parameter for each curve where they intersect. Fortunately, since one curve did converge we know the 2D point where they converge,
+    //  plus we have a reasonable approximation for the parameter for the curve that didn't. That means we can use Newton's method to refine
+    //  the parameter of the curve that did't converge.
+    if ( !FBRangeHasConverged(*usRange, places) || !FBRangeHasConverged(*themRange, places) ) {
+        // Maybe there's an overlap in here?
+        if ( FBBezierCurveDataCheckCurvesForOverlapRange(me, overlap, usRange, themRange, originalUs, originalThem, originalUsData, originalThemData) )
+            return;
+
+        // We bail out of the main loop as soon as we know things intersect, but before the math falls apart. Unfortunately sometimes this
+        //  means we don't always get the best estimate of the parameters. Below we fall back to Netwon's method, but it's accuracy is
+        //  dependant on our previous calculations. So here assume things intersect and just try to tighten up the parameters. If the
+        //  math falls apart because everything's a point, that's OK since we already have a "reasonable" estimation of the parameters.
+        FBBezierCurveDataRefineIntersectionsOverIterations(3, usRange, themRange, originalUsData, originalThemData, us, them, nonpointUs, nonpointThem);
+        // Sometimes we need a little more precision. Be careful though, in that in some cases trying for more makes the math fall apart
+        if ( !FBRangeHasConverged(*usRange, places) || !FBRangeHasConverged(*themRange, places) )
+            FBBezierCurveDataRefineIntersectionsOverIterations(4, usRange, themRange, originalUsData, originalThemData, us, them, nonpointUs, nonpointThem);
+    }    
+    if ( FBRangeHasConverged(*usRange, places) && !FBRangeHasConverged(*themRange, places) ) {
+        // Refine the them range since it didn't converge
+        CGPoint intersectionPoint = FBBezierCurveDataPointAtParameter(originalUsData, FBRangeAverage(*usRange), NULL, NULL);
+        CGFloat refinedParameter = FBRangeAverage(*themRange); // Although the range didn't converge, it should be a reasonable approximation which is all Newton needs
+        for (NSUInteger i = 0; i < 3; i++) {
+            refinedParameter = FBBezierCurveDataRefineParameter(originalThemData, refinedParameter, intersectionPoint);
+            refinedParameter = MIN(themRange->maximum, MAX(themRange->minimum, refinedParameter));
+        }
+        themRange->minimum = refinedParameter;
+        themRange->maximum = refinedParameter;
+        hadConverged = NO;
+    } else if ( !FBRangeHasConverged(*usRange, places) && FBRangeHasConverged(*themRange, places) ) {
+        // Refine the us range since it didn't converge
+        CGPoint intersectionPoint = FBBezierCurveDataPointAtParameter(originalThemData, FBRangeAverage(*themRange), NULL, NULL);
+        CGFloat refinedParameter = FBRangeAverage(*usRange); // Although the range didn't converge, it should be a reasonable approximation which is all Newton needs
+        for (NSUInteger i = 0; i < 3; i++) {
+            refinedParameter = FBBezierCurveDataRefineParameter(originalUsData, refinedParameter, intersectionPoint);
+            refinedParameter = MIN(usRange->maximum, MAX(usRange->minimum, refinedParameter));
+        }
+        usRange->minimum = refinedParameter;
+        usRange->maximum = refinedParameter;
+        hadConverged = NO;
+    }
+    
+    // If it never converged and we stopped because of our loop max, assume overlap or something else. Bail.
+    if ( (!FBRangeHasConverged(*usRange, places) || !FBRangeHasConverged(*themRange, places)) && iterations >= maxIterations ) {
+        FBStatisticsIncrement(FBStatisticClipIterationLimits);
+        FBBezierCurveDataCheckForOverlapRange(me, overlap, usRange, themRange, originalUs, originalThem, us, them);
+        return;
+    }
+    
+    if ( !hadConverged ) {
+        // Since one of them didn't converge, we need to make sure they actually intersect. Compute the point from both and compare
+        CGPoint intersectionPoint = FBBezierCurveDataPointAtParameter(originalUsData, FBRangeAverage(*usRange), NULL, NULL);
+        CGPoint checkPoint = FBBezierCurveDataPointAtParameter(originalThemData, FBRangeAverage(*themRange), NULL, NULL);
+        if ( !FBArePointsCloseWithOptions(intersectionPoint, checkPoint, 1e-3) )
+            return;
+    }
+    // Return the final intersection, which we represent by the original curves and the parameters where they intersect. The parameter values are useful
+    //  later in the boolean operations, plus it allows us to do lazy calculations.
+    function(FBRangeAverage(*usRange), FBRangeAverage(*themRange), context, stop);
+}
+
+static BOOL FBBezierCurveDataSolveIntersections(FBBezierCurveData *me, FBBezierCurveData *curve, FBBezierCurveDataIntersectionFunction function, void *context);
+
+static void FBBezierCurveDataClipIntersections(FBBezierCurveData *me, FBBezierCurveData *curve, FBBezierCurveDataOverlap *overlap, FBBezierCurveDataIntersectionFunction function, void *context)
+{
+    FBRange usRange = FBRangeMake(0, 1);
+    FBRange themRange = FBRangeMake(0, 1);
+    BOOL stop = NO;
+    FBBezierCurveDataIntersectionsWithBezierCurveAtDepth(*me, *curve, &usRange, &themRange, me, curve, overlap, 0, function, context, &stop);
+}
+
+void FBBezierCurveDataIntersectionsWithBezierCurve(FBBezierCurveData *me, FBBezierCurveData *curve, FBBezierCurveDataOverlap *overlap, FBBezierCurveDataIntersectionFunction function, void *context)
+{
+    FBStatisticsIncrement(FBStatisticEdgePairTests);
+    
+    // For performance reasons, do a quick bounds check to see if these even might intersect
+    if ( !FBLineBoundsMightOverlap(FBBezierCurveDataBoundingRect(me), FBBezierCurveDataBoundingRect(curve)) || !FBLineBoundsMightOverlap(FBBezierCurveDataBounds(me), FBBezierCurveDataBounds(curve)) ) {
+        FBStatisticsIncrement(FBStatisticBoundsRejections);
+        return;
+    }
+    
+    if ( FBBezierCurveDataSolveIntersections(me, curve, function, context) )
+        return;
+    FBBezierCurveDataClipIntersections(me, curve, overlap, function, context);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Axis aligned lines
+//
+// The containment tests cast horizontal and vertical rays through the graph.
+//  Intersecting those with the general bezier clipping code is overkill: if
+//  we only look at the coordinate across the ray, the curve is a cubic
+//  polynomial, and we just need its roots. Splitting the curve at the extrema
+//  of that polynomial leaves at most three pieces that are monotone, each of
+//  which crosses the ray at most once, so a bisection per piece finds them all.
+//
+
+static const CGFloat FBAxisCrossingThreshold = FBPrecisionThreshold(1e-4, 1e-9, 1e-11); // same as the bounds test, so touching counts the same
+static const CGFloat FBAxisFlatnessThreshold = FBPrecisionThreshold(2e-3, 1e-6, 5e-8); // curves flatter than this might overlap the ray
+static const CGFloat FBAxisCoefficientThreshold = FBPrecisionThreshold(5e-6, 1e-12, 3e-15); // coefficients of the derivative below this count as zero
+static const CGFloat FBAxisDoubleRootThreshold = FBPrecisionThreshold(1e-4, 1e-9, 1e-11); // extrema closer than this are one double root
+static const CGFloat FBBisectionThreshold = FBPrecisionThreshold(2e-7, 1e-15, 7e-19); // how narrow a bisection gets before it stops
+
+static CGFloat FBBezierCurveDataAxisValueAtParameter(const CGFloat values[4], CGFloat parameter)
+{
+    CGFloat oneMinus = 1.0 - parameter;
+    return oneMinus * oneMinus * oneMinus * values[0] + 3.0 * oneMinus * oneMinus * parameter * values[1] + 3.0 * oneMinus * parameter * parameter * values[2] + parameter * parameter * parameter * values[3];
+}
+
+static NSUInteger FBBezierCurveDataAxisExtrema(const CGFloat values[4], CGFloat extrema[2])
+{
+    // The derivative of the cubic is the quadratic 3(a t^2 + 2 b t + c). Return the roots that
+    //  lie strictly between the end points, in increasing order.
+    CGFloat a = -values[0] + 3.0 * values[1] - 3.0 * values[2] + values[3];
+    CGFloat b = values[0] - 2.0 * values[1] + values[2];
+    CGFloat c = values[1] - values[0];
+    
+    CGFloat roots[2] = {};
+    NSUInteger rootCount = 0;
+    if ( fabs(a) < FBAxisCoefficientThreshold ) {
+        if ( fabs(b) > FBAxisCoefficientThreshold )
+            roots[rootCount++] = -c / (2.0 * b);
+    } else {
+        CGFloat discriminant = b * b - a * c;
+        if ( discriminant >= 0.0 ) {
+#if FB_PRECISION == FB_PRECISION_SINGLE
+            // Written so nothing cancels out, which matters when a is barely above the
+            //  threshold, like for a quadratic raised to a cubic in single precision
+            CGFloat q = -(b + copysign(sqrt(discriminant), b));
+            roots[rootCount++] = q / a;
+            if ( q != 0.0 )
+                roots[rootCount++] = c / q;
+#else
+            CGFloat root = sqrt(discriminant);
+            roots[rootCount++] = (-b - root) / a;
+            roots[rootCount++] = (-b + root) / a;
+#endif
+        }
+    }
+    
+    NSUInteger count = 0;
+    for (NSUInteger i = 0; i < rootCount; i++) {
+        if ( roots[i] > 0.0 && roots[i] < 1.0 )
+            extrema[count++] = roots[i];
+    }
+    if ( count == 2 && extrema[0] > extrema[1] ) {
+        CGFloat swap = extrema[0];
+        extrema[0] = extrema[1];
+        extrema[1] = swap;
+    }
+    if ( count == 2 && extrema[1] - extrema[0] < FBAxisDoubleRootThreshold )
+        count = 1; // a double root is an inflection point, not two extrema
+    return count;
+}
+
+static CGFloat FBBezierCurveDataBisectAxisCrossing(const CGFloat values[4], CGFloat start, CGFloat stop, CGFloat startValue)
+{
+    // The piece is monotone and the values at the ends have different signs, so there is
+    //  exactly one root in between.
+    for (NSUInteger iteration = 0; iteration < 64 && stop - start > FBBisectionThreshold; iteration++) {
+        CGFloat middle = (start + stop) / 2.0;
+        CGFloat middleValue = FBBezierCurveDataAxisValueAtParameter(values, middle);
+        if ( (middleValue < 0.0) == (startValue < 0.0) ) {
+            start = middle;
+            startValue = middleValue;
+        } else
+            stop = middle;
+    }
+    return (start + stop) / 2.0;
+}
+
+static BOOL FBBezierCurveDataFindValueCrossings(const CGFloat values[4], CGFloat parameters[4], NSUInteger *count)
+{
+    // values are the distances of the control points from a line, so the curve meets
+    //  the line where the cubic they make is zero.
+    *count = 0;
+    
+    // If the curve runs along the line it might overlap it, which needs the general code
+    CGFloat minimum = MIN(MIN(values[0], values[1]), MIN(values[2], values[3]));
+    CGFloat maximum = MAX(MAX(values[0], values[1]), MAX(values[2], values[3]));
+    if ( maximum - minimum <= FBAxisFlatnessThreshold && minimum <= FBAxisCrossingThreshold && maximum >= -FBAxisCrossingThreshold )
+        return NO;
+    // Since the curve lies inside the hull of its control points, it can't reach the line if they're all on one side
+    if ( minimum > FBAxisCrossingThreshold || maximum < -FBAxisCrossingThreshold )
+        return YES;
+    
+    // Split the curve into monotone pieces. The pieces meet at the extrema, which is also
+    //  where the curve can touch the line without crossing it.
+    CGFloat bounds[4] = { 0.0 };
+    NSUInteger boundCount = 1 + FBBezierCurveDataAxisExtrema(values, &bounds[1]);
+    bounds[boundCount++] = 1.0;
+    
+    CGFloat startValue = values[0];
+    for (NSUInteger i = 0; i + 1 < boundCount; i++) {
+        CGFloat stopValue = i + 2 == boundCount ? values[3] : FBBezierCurveDataAxisValueAtParameter(values, bounds[i + 1]);
+        if ( fabs(startValue) <= FBAxisCrossingThreshold )
+            parameters[(*count)++] = bounds[i];
+        else if ( fabs(stopValue) > FBAxisCrossingThreshold && (startValue < 0.0) != (stopValue < 0.0) )
+            parameters[(*count)++] = FBBezierCurveDataBisectAxisCrossing(values, bounds[i], bounds[i + 1], startValue);
+        startValue = stopValue;
+    }
+    if ( fabs(startValue) <= FBAxisCrossingThreshold )
+        parameters[(*count)++] = 1.0;
+    
+    return YES;
+}
+
+BOOL FBBezierCurveDataFindAxisCrossings(FBBezierCurveData *me, BOOL horizontal, CGFloat value, CGFloat parameters[4], NSUInteger *count)
+{
+    CGFloat values[4] = {};
+    if ( horizontal ) {
+        values[0] = me->endPoint1.y - value;
+        values[1] = me->controlPoint1.y - value;
+        values[2] = me->controlPoint2.y - value;
+        values[3] = me->endPoint2.y - value;
+    } else {
+        values[0] = me->endPoint1.x - value;
+        values[1] = me->controlPoint1.x - value;
+        values[2] = me->controlPoint2.x - value;
+        values[3] = me->endPoint2.x - value;
+    }
+    
+    return FBBezierCurveDataFindValueCrossings(values, parameters, count);
+}
+
+void FBBezierCurveDataIntersectionsWithAxisAlignedLine(FBBezierCurveData *me, FBBezierCurveData *curve, FBBezierCurveDataOverlap *overlap, FBBezierCurveDataIntersectionFunction function, void *context)
+{
+    // Anything that isn't a horizontal or vertical line goes through the general code
+    BOOL horizontal = me->endPoint1.y == me->endPoint2.y;
+    BOOL vertical = me->endPoint1.x == me->endPoint2.x;
+    if ( me->kind != FBBezierCurveKindLine || horizontal == vertical ) {
+        FBBezierCurveDataIntersectionsWithBezierCurve(me, curve, overlap, function, context);
+        return;
+    }
+    
+    // Keep the same quick bounds check as the general code
+    FBStatisticsIncrement(FBStatisticEdgePairTests);
+    if ( !FBLineBoundsMightOverlap(FBBezierCurveDataBoundingRect(me), FBBezierCurveDataBoundingRect(curve)) || !FBLineBoundsMightOverlap(FBBezierCurveDataBounds(me), FBBezierCurveDataBounds(curve)) ) {
+        FBStatisticsIncrement(FBStatisticBoundsRejections);
+        return;
+    }
+    
+    CGFloat parameters[4] = {};
+    NSUInteger count = 0;
+    if ( !FBBezierCurveDataFindAxisCrossings(curve, horizontal, horizontal ? me->endPoint1.y : me->endPoint1.x, parameters, &count) ) {
+        FBBezierCurveDataClipIntersections(me, curve, overlap, function, context);
+        return;
+    }
+    
+    // Map the crossings back onto the line, dropping the ones that are past either end of it
+    CGFloat lineStart = horizontal ? me->endPoint1.x : me->endPoint1.y;
+    CGFloat lineLength = (horizontal ? me->endPoint2.x : me->endPoint2.y) - lineStart;
+    CGFloat threshold = FBAxisCrossingThreshold / fabs(lineLength);
+    BOOL stop = NO;
+    for (NSUInteger i = 0; i < count && !stop; i++) {
+        CGPoint point = FBBezierCurveDataPointAtParameter(*curve, parameters[i], NULL, NULL);
+        CGFloat lineParameter = ((horizontal ? point.x : point.y) - lineStart) / lineLength;
+        if ( lineParameter < -threshold || lineParameter > 1.0 + threshold )
+            continue;
+        function(MIN(MAX(lineParameter, 0.0), 1.0), parameters[i], context, &stop);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Solved intersections
+//
+// Lines and quadratics are simple enough that where they meet another curve
+//  can be solved for, instead of whittled down with bezier clipping.
+//
+// A line against a curve works like the axis aligned rays above, only with the
+//  distances measured across the line instead of along an axis: the distance of
+//  the curve from the line is a cubic, and its roots are the intersections.
+//
+// Two quadratics take a little more. In barycentric coordinates (b0, b1, b2) of
+//  its control points, every point of a quadratic has b1^2 = 4 b0 b2, because
+//  the coordinates are (1 - t)^2, 2t(1 - t) and t^2. They're affine in the point,
+//  so along the other quadratic they're quadratics as well, and b1^2 - 4 b0 b2 is
+//  a quartic whose roots are where the other quadratic meets the parabola of the
+//  first one. The parameter on the first one is then simply b1 / 2 + b2.
+//
+// Anything that might overlap, and quadratics so flat that the parabola is
+//  poorly defined, are left to the clipping.
+//
+
+static const CGFloat FBQuadraticFlatnessThreshold = 1e-3; // sine of the angle at the control point below which a quadratic is too flat to solve
+static const CGFloat FBQuadraticTouchThreshold = FBPrecisionThreshold(1e-4, 1e-9, 1e-11); // how close to zero the quartic has to come to count as touching
+static const CGFloat FBSolvedPointsThreshold = FBPrecisionThreshold(2e-3, 1e-6, 5e-8); // how far apart the two curves' points of a solved intersection may be
+
+static BOOL FBBezierCurveDataSolveLineIntersections(FBBezierCurveData *line, FBBezierCurveData *curve, BOOL isLineFirst, FBBezierCurveDataIntersectionFunction function, void *context)
+{
+    CGFloat lineLength = FBDistanceBetweenPoints(line->endPoint1, line->endPoint2);
+    if ( lineLength <= FBAxisCrossingThreshold )
+        return NO; // a point, which the clipping knows how to deal with
+    CGPoint direction = FBScalePoint(FBSubtractPoint(line->endPoint2, line->endPoint1), 1.0 / lineLength);
+    
+    CGPoint points[4] = { curve->endPoint1, curve->controlPoint1, curve->controlPoint2, curve->endPoint2 };
+    CGFloat values[4] = {};
+    for (NSUInteger i = 0; i < 4; i++) {
+        CGPoint offset = FBSubtractPoint(points[i], line->endPoint1);
+        values[i] = direction.x * offset.y - direction.y * offset.x;
+    }
+    CGFloat parameters[4] = {};
+    NSUInteger count = 0;
+    if ( !FBBezierCurveDataFindValueCrossings(values, parameters, &count) )
+        return NO;
+    
+    // Map the crossings back onto the line, dropping the ones that are past either end of it
+    CGFloat threshold = FBAxisCrossingThreshold / lineLength;
+    BOOL stop = NO;
+    for (NSUInteger i = 0; i < count && !stop; i++) {
+        CGPoint point = FBBezierCurveDataPointAtParameter(*curve, parameters[i], NULL, NULL);
+        CGFloat lineParameter = FBDotMultiplyPoint(FBSubtractPoint(point, line->endPoint1), direction) / lineLength;
+        if ( lineParameter < -threshold || lineParameter > 1.0 + threshold )
+            continue;
+        lineParameter = MIN(MAX(lineParameter, 0.0), 1.0);
+        if ( isLineFirst )
+            function(lineParameter, parameters[i], context, &stop);
+        else
+            function(parameters[i], lineParameter, context, &stop);
+    }
+    return YES;
+}
+
+static void FBBezierCurveDataGetQuadraticPoints(FBBezierCurveData *me, CGPoint points[3])
+{
+    // Lower the degree again from either end, and split the difference the rounding makes
+    CGPoint fromStart = FBAddPoint(me->endPoint1, FBScalePoint(FBSubtractPoint(me->controlPoint1, me->endPoint1), 1.5));
+    CGPoint fromEnd = FBAddPoint(me->endPoint2, FBScalePoint(FBSubtractPoint(me->controlPoint2, me->endPoint2), 1.5));
+    points[0] = me->endPoint1;
+    points[1] = FBLineMidpoint(fromStart, fromEnd);
+    points[2] = me->endPoint2;
+}
+
+static CGFloat FBBezierCurveDataCross(CGPoint vector1, CGPoint vector2)
+{
+    return vector1.x * vector2.y - vector1.y * vector2.x;
+}
+
+static CGFloat FBBezierCurveDataQuadraticRoundness(const CGPoint points[3])
+{
+    // The sine of the angle the quadratic turns through at its control point
+    CGPoint leg1 = FBSubtractPoint(points[1], points[0]);
+    CGPoint leg2 = FBSubtractPoint(points[2], points[1]);
+    CGFloat legs = FBPointLength(leg1) * FBPointLength(leg2);
+    return legs > 0.0 ? fabs(FBBezierCurveDataCross(leg1, leg2)) / legs : 0.0;
+}
+
+static void FBBezierCurveDataBarycentricCoordinates(const CGPoint triangle[3], CGFloat area, CGPoint point, CGFloat coordinates[3])
+{
+    coordinates[0] = FBBezierCurveDataCross(FBSubtractPoint(triangle[1], point), FBSubtractPoint(triangle[2], point)) / area;
+    coordinates[1] = FBBezierCurveDataCross(FBSubtractPoint(triangle[2], point), FBSubtractPoint(triangle[0], point)) / area;
+    coordinates[2] = FBBezierCurveDataCross(FBSubtractPoint(triangle[0], point), FBSubtractPoint(triangle[1], point)) / area;
+}
+
+static CGFloat FBBezierCurveDataQuarticValueAtParameter(const CGFloat coefficients[5], CGFloat parameter)
+{
+    CGFloat values[5] = { coefficients[0], coefficients[1], coefficients[2], coefficients[3], coefficients[4] };
+    for (NSUInteger level = 4; level > 0; level--) {
+        for (NSUInteger i = 0; i < level; i++)
+            values[i] += (values[i + 1] - values[i]) * parameter;
+    }
+    return values[0];
+}
+
+static CGFloat FBBezierCurveDataBisectQuarticRoot(const CGFloat coefficients[5], CGFloat start, CGFloat stop, CGFloat startValue)
+{
+    for (NSUInteger iteration = 0; iteration < 64 && stop - start > FBBisectionThreshold; iteration++) {
+        CGFloat middle = (start + stop) / 2.0;
+        CGFloat middleValue = FBBezierCurveDataQuarticValueAtParameter(coefficients, middle);
+        if ( (middleValue < 0.0) == (startValue < 0.0) ) {
+            start = middle;
+            startValue = middleValue;
+        } else
+            stop = middle;
+    }
+    return (start + stop) / 2.0;
+}
+
+static BOOL FBBezierCurveDataSolveQuadraticIntersections(FBBezierCurveData *me, FBBezierCurveData *curve, FBBezierCurveDataIntersectionFunction function, void *context)
+{
+    // The rounder of the two gives the parabola, the other one runs along it
+    CGPoint mePoints[3] = {};
+    CGPoint curvePoints[3] = {};
+    FBBezierCurveDataGetQuadraticPoints(me, mePoints);
+    FBBezierCurveDataGetQuadraticPoints(curve, curvePoints);
+    BOOL isSwapped = FBBezierCurveDataQuadraticRoundness(curvePoints) > FBBezierCurveDataQuadraticRoundness(mePoints);
+    FBBezierCurveData *parabola = isSwapped ? curve : me;
+    FBBezierCurveData *other = isSwapped ? me : curve;
+    const CGPoint *triangle = isSwapped ? curvePoints : mePoints;
+    const CGPoint *otherPoints = isSwapped ? mePoints : curvePoints;
+    if ( FBBezierCurveDataQuadraticRoundness(triangle) <= FBQuadraticFlatnessThreshold )
+        return NO;
+    CGFloat area = FBBezierCurveDataCross(FBSubtractPoint(triangle[1], triangle[0]), FBSubtractPoint(triangle[2], triangle[1]));
+    
+    // b1^2 - 4 b0 b2 along the other quadratic, as a quartic in bernstein form. Multiplying
+    //  two quadratics in bernstein form weighs each product of coefficients by binomials.
+    static const CGFloat FBProductWeights[3][3] = {
+        { 1.0, 1.0 / 2.0, 1.0 / 6.0 },
+        { 1.0 / 2.0, 2.0 / 3.0, 1.0 / 2.0 },
+        { 1.0 / 6.0, 1.0 / 2.0, 1.0 }
+    };
+    CGFloat coordinates[3][3] = {};
+    for (NSUInteger i = 0; i < 3; i++)
+        FBBezierCurveDataBarycentricCoordinates(triangle, area, otherPoints[i], coordinates[i]);
+    CGFloat coefficients[5] = {};
+    CGFloat largestCoefficient = 0.0;
+    for (NSUInteger i = 0; i < 3; i++) {
+        for (NSUInteger j = 0; j < 3; j++)
+            coefficients[i + j] += FBProductWeights[i][j] * (coordinates[i][1] * coordinates[j][1] - 4.0 * coordinates[i][0] * coordinates[j][2]);
+    }
+    for (NSUInteger i = 0; i < 5; i++)
+        largestCoefficient = MAX(largestCoefficient, fabs(coefficients[i]));
+    if ( largestCoefficient <= FBQuadraticTouchThreshold )
+        return NO; // both on the same parabola, so they might overlap
+    
+    // Split the quartic into monotone pieces at the roots of its derivative, and look for
+    //  the roots piece by piece, like the cubics of the lines.
+    CGFloat derivative[4] = {};
+    for (NSUInteger i = 0; i < 4; i++)
+        derivative[i] = coefficients[i + 1] - coefficients[i];
+    CGFloat extrema[4] = {};
+    NSUInteger extremaCount = 0;
+    if ( !FBBezierCurveDataFindValueCrossings(derivative, extrema, &extremaCount) )
+        return NO;
+    CGFloat bounds[6] = { 0.0 };
+    NSUInteger boundCount = 1;
+    for (NSUInteger i = 0; i < extremaCount; i++) {
+        if ( extrema[i] > bounds[boundCount - 1] && extrema[i] < 1.0 )
+            bounds[boundCount++] = extrema[i];
+    }
+    bounds[boundCount++] = 1.0;
+    
+    CGFloat roots[6] = {};
+    NSUInteger rootCount = 0;
+    CGFloat startValue = coefficients[0];
+    for (NSUInteger i = 0; i + 1 < boundCount; i++) {
+        CGFloat stopValue = i + 2 == boundCount ? coefficients[4] : FBBezierCurveDataQuarticValueAtParameter(coefficients, bounds[i + 1]);
+        if ( fabs(startValue) <= FBQuadraticTouchThreshold )
+            roots[rootCount++] = bounds[i];
+        else if ( fabs(stopValue) > FBQuadraticTouchThreshold && (startValue < 0.0) != (stopValue < 0.0) )
+            roots[rootCount++] = FBBezierCurveDataBisectQuarticRoot(coefficients, bounds[i], bounds[i + 1], startValue);
+        startValue = stopValue;
+    }
+    if ( fabs(startValue) <= FBQuadraticTouchThreshold )
+        roots[rootCount++] = 1.0;
+    
+    // Find the parameters on the parabola, dropping the roots on the part of it past either
+    //  end. If the two points don't agree, the numbers can't be trusted, and nothing has
+    //  been reported yet, so the clipping can still take over.
+    CGFloat parabolaParameters[6] = {};
+    CGFloat otherParameters[6] = {};
+    NSUInteger count = 0;
+    CGFloat threshold = FBAxisCrossingThreshold / MAX(FBDistanceBetweenPoints(triangle[0], triangle[2]), FBAxisCrossingThreshold);
+    for (NSUInteger i = 0; i < rootCount; i++) {
+        CGPoint point = FBBezierCurveDataPointAtParameter(*other, roots[i], NULL, NULL);
+        CGFloat pointCoordinates[3] = {};
+        FBBezierCurveDataBarycentricCoordinates(triangle, area, point, pointCoordinates);
+        CGFloat parameter = pointCoordinates[1] / 2.0 + pointCoordinates[2];
+        if ( parameter < -threshold || parameter > 1.0 + threshold )
+            continue;
+        parameter = MIN(MAX(parameter, 0.0), 1.0);
+        if ( FBDistanceBetweenPoints(FBBezierCurveDataPointAtParameter(*parabola, parameter, NULL, NULL), point) > FBSolvedPointsThreshold )
+            return NO;
+        parabolaParameters[count] = parameter;
+        otherParameters[count] = roots[i];
+        count++;
+    }
+    
+    BOOL stop = NO;
+    for (NSUInteger i = 0; i < count && !stop; i++) {
+        if ( isSwapped )
+            function(otherParameters[i], parabolaParameters[i], context, &stop);
+        else
+            function(parabolaParameters[i], otherParameters[i], context, &stop);
+    }
+    return YES;
+}
+
+static BOOL FBBezierCurveDataSolveIntersections(FBBezierCurveData *me, FBBezierCurveData *curve, FBBezierCurveDataIntersectionFunction function, void *context)
+{
+    // Two lines are left to the clipping, which has its own line code that also finds overlaps
+    BOOL solved = NO;
+    if ( me->kind == FBBezierCurveKindLine && curve->kind != FBBezierCurveKindLine )
+        solved = FBBezierCurveDataSolveLineIntersections(me, curve, YES, function, context);
+    else if ( me->kind != FBBezierCurveKindLine && curve->kind == FBBezierCurveKindLine )
+        solved = FBBezierCurveDataSolveLineIntersections(curve, me, NO, function, context);
+    else if ( me->kind == FBBezierCurveKindQuadratic && curve->kind == FBBezierCurveKindQuadratic )
+        solved = FBBezierCurveDataSolveQuadraticIntersections(me, curve, function, context);
+    if ( solved )
+        FBStatisticsIncrement(FBStatisticSolvedPairs);
+    return solved;
+}
@@ -0,0 +1,107 @@
+//
+//  FBBezierCurveData.h
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#ifndef FBBEZIERCURVEDATA_H
+#define FBBEZIERCURVEDATA_H
+
+#include "FBTypes.h"
+#include "FBGeometry.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Bezier curve data
+//
+// FBBezierCurveData is the plain C value behind FBBezierCurve. All the math
+//  (splitting, length, bounds, closest point, and the bezier clipping used to
+//  find intersections) works on these structs so it doesn't depend on
+//  Foundation. FBBezierCurve is a thin Objective-C wrapper around it.
+//
+
+typedef struct FBBezierCurveLocation {
+    CGFloat parameter;
+    CGFloat distance;
+} FBBezierCurveLocation;
+
+// The kind of path segment a curve came from. Every curve is kept as a cubic, so all the
+//  math below works the same on each, but lines and quadratics remember what they are,
+//  so intersecting them can be solved for directly instead of with bezier clipping.
+typedef enum FBBezierCurveKind {
+    FBBezierCurveKindCubic,
+    FBBezierCurveKindQuadratic, // the cubic is a quadratic raised by a degree
+    FBBezierCurveKindLine,      // GPC: the curve came from a straight line segment
+} FBBezierCurveKind;
+
+typedef struct FBBezierCurveData {
+    CGPoint endPoint1;
+    CGPoint controlPoint1;
+    CGPoint controlPoint2;
+    CGPoint endPoint2;
+    FBBezierCurveKind kind;
+    CGFloat length; // cached value
+    CGRect bounds; // cached value
+    BOOL isPoint; // cached value
+    CGRect boundingRect; // cached value
+} FBBezierCurveData;
+
+// Where two curves overlap instead of crossing, the parameter ranges of the overlap
+//  on each curve. This is the value version of FBBezierIntersectRange.
+typedef struct FBBezierCurveDataOverlap {
+    BOOL hasOverlap;
+    FBRange parameterRange1;
+    FBRange parameterRange2;
+    BOOL reversed;
+} FBBezierCurveDataOverlap;
+
+typedef void (*FBBezierCurveDataIntersectionFunction)(CGFloat parameter1, CGFloat parameter2, void *context, BOOL *stop);
+
+extern FBBezierCurveData FBBezierCurveDataMake(CGPoint endPoint1, CGPoint controlPoint1, CGPoint controlPoint2, CGPoint endPoint2, BOOL isStraightLine);
+extern FBBezierCurveData FBBezierCurveDataMakeWithLine(CGPoint startPoint, CGPoint endPoint);
+extern FBBezierCurveData FBBezierCurveDataMakeWithQuadratic(CGPoint startPoint, CGPoint controlPoint, CGPoint endPoint);
+
+extern CGFloat FBBezierCurveDataGetLengthAtParameter(FBBezierCurveData* me, CGFloat parameter);
+extern CGFloat FBBezierCurveDataGetLength(FBBezierCurveData* me);
+extern CGPoint FBBezierCurveDataPointAtParameter(FBBezierCurveData me, CGFloat parameter, FBBezierCurveData *leftBezierCurve, FBBezierCurveData *rightBezierCurve);
+extern FBBezierCurveData FBBezierCurveDataSubcurveWithRange(FBBezierCurveData me, FBRange range);
+extern FBBezierCurveData FBBezierCurveDataReversed(FBBezierCurveData me);
+
+// Splits the curve at its extrema in x and y, so each piece only ever moves in one direction
+//  along each axis. Returns the number of pieces (at most five), along with the range of the
+//  original curve each one covers.
+extern NSUInteger FBBezierCurveDataSplitIntoMonotonePieces(FBBezierCurveData me, FBBezierCurveData pieces[5], FBRange ranges[5]);
+
+// How many equal steps in parameter the curve has to be cut into for the lines between the
+//  cuts to stay within tolerance of it everywhere. Lines are one step, whatever the tolerance.
+extern NSUInteger FBBezierCurveDataGetFlatteningSegmentCount(FBBezierCurveData *me, CGFloat tolerance);
+
+extern BOOL FBBezierCurveDataIsPoint(FBBezierCurveData *me);
+extern CGRect FBBezierCurveDataBoundingRect(FBBezierCurveData *me);
+extern CGRect FBBezierCurveDataBounds(FBBezierCurveData* me);
+
+extern FBBezierCurveLocation FBBezierCurveDataClosestLocationToPoint(FBBezierCurveData me, CGPoint point);
+extern CGFloat FBBezierCurveDataRefineParameter(FBBezierCurveData me, CGFloat parameter, CGPoint point);
+
+extern BOOL FBBezierCurveDataIsEqual(FBBezierCurveData me, FBBezierCurveData other);
+extern BOOL FBBezierCurveDataIsEqualWithOptions(FBBezierCurveData me, FBBezierCurveData other, CGFloat threshold);
+
+// Calls the function with the parameters on each curve of every intersection. If the
+//  curves overlap, the overlap is reported through overlap instead (which can be NULL
+//  if the caller isn't interested). The function can set stop to end the search early.
+//  A line against anything but a line, and two quadratics, are solved for directly;
+//  everything else, and anything that might overlap, goes through bezier clipping.
+extern void FBBezierCurveDataIntersectionsWithBezierCurve(FBBezierCurveData *me, FBBezierCurveData *curve, FBBezierCurveDataOverlap *overlap, FBBezierCurveDataIntersectionFunction function, void *context);
+
+// Finds the parameters where the curve meets the horizontal line y = value (or the
+//  vertical line x = value), touching included, in increasing order. Returns NO if the
+//  curve runs along the line, because then it might overlap it instead.
+extern BOOL FBBezierCurveDataFindAxisCrossings(FBBezierCurveData *me, BOOL horizontal, CGFloat value, CGFloat parameters[4], NSUInteger *count);
+
+// Same as FBBezierCurveDataIntersectionsWithBezierCurve, but meant for the horizontal
+//  and vertical rays the containment tests use. If me is such a line, the intersections
+//  are solved for directly instead of with bezier clipping.
+extern void FBBezierCurveDataIntersectionsWithAxisAlignedLine(FBBezierCurveData *me, FBBezierCurveData *curve, FBBezierCurveDataOverlap *overlap, FBBezierCurveDataIntersectionFunction function, void *context);
+
+#endif
@@ -1,14 +1,14 @@
 //
-//  FBBezierCurveHelper.m
+//  FBBezierCurveHelper.c
 //  VectorBoolean
 //
 //  Created by Stephan Michels on 18.07.14.
 //  Copyright (c) 2014 Fortunate Bear, LLC. All rights reserved.
 //
 
-#import "FBBezierCurveHelper.h"
-#import "FBNormalizedLine.h"
-#import "FBGeometry.h"
+#include "FBBezierCurveHelper.h"
+#include "FBNormalizedLine.h"
+#include "FBGeometry.h"
 
 #pragma mark Helper functions
 
@@ -92,9 +92,9 @@ CGPoint BezierWithPoints(NSUInteger degree, CGPoint *bezierPoints, CGFloat param
         points[i] = bezierPoints[i];
     
     // If the caller is asking for the resulting bezier curves, start filling those in
-    if ( leftCurve != nil )
+    if ( leftCurve != NULL )
         leftCurve[0] = points[0];
-    if ( rightCurve != nil )
+    if ( rightCurve != NULL )
         rightCurve[degree] = points[degree];
     
     for (NSUInteger k = 1; k <= degree; k++) {
@@ -103,9 +103,9 @@ CGPoint BezierWithPoints(NSUInteger degree, CGPoint *bezierPoints, CGFloat param
             points[i].y = (1.0 - parameter) * points[i].y + parameter * points[i + 1].y;
         }
         
-        if ( leftCurve != nil )
+        if ( leftCurve != NULL )
             leftCurve[k] = points[0];
-        if ( rightCurve != nil )
+        if ( rightCurve != NULL )
             rightCurve[degree - k] = points[degree - k];
     }
     
@@ -190,7 +190,7 @@ BOOL FBIsControlPolygonFlatEnough(CGPoint *bezierPoints, NSUInteger degree, CGPo
     return NO;
 }
 
-void FBFindBezierRootsWithDepth(CGPoint *bezierPoints, NSUInteger degree, NSUInteger depth, void (^block)(CGFloat root))
+void FBFindBezierRootsWithDepth(CGPoint *bezierPoints, NSUInteger degree, NSUInteger depth, FBBezierRootFunction function, void *context)
 {
     NSUInteger crossingCount = FBCountBezierCrossings(bezierPoints, degree);
     if ( crossingCount == 0 )
@@ -198,12 +198,12 @@ void FBFindBezierRootsWithDepth(CGPoint *bezierPoints, NSUInteger degree, NSUInt
     else if ( crossingCount == 1 ) {
         if ( depth >= FBFindBezierRootsMaximumDepth ) {
             CGFloat root = (bezierPoints[0].x + bezierPoints[degree].x) / 2.0;
-            block(root);
+            function(root, context);
             return;
         }
         CGPoint intersectionPoint = CGPointZero;
         if ( FBIsControlPolygonFlatEnough(bezierPoints, degree, &intersectionPoint) ) {
-            block(intersectionPoint.x);
+            function(intersectionPoint.x, context);
             return;
         }
     }
@@ -212,11 +212,11 @@ void FBFindBezierRootsWithDepth(CGPoint *bezierPoints, NSUInteger degree, NSUInt
     CGPoint leftCurve[6] = {}; // assume 5th degree
     CGPoint rightCurve[6] = {};
     BezierWithPoints(degree, bezierPoints, 0.5, leftCurve, rightCurve);
-    FBFindBezierRootsWithDepth(leftCurve, degree, depth + 1, block);
-    FBFindBezierRootsWithDepth(rightCurve, degree, depth + 1, block);
+    FBFindBezierRootsWithDepth(leftCurve, degree, depth + 1, function, context);
+    FBFindBezierRootsWithDepth(rightCurve, degree, depth + 1, function, context);
 }
 
-void FBFindBezierRoots(CGPoint *bezierPoints, NSUInteger degree, void (^block)(CGFloat root))
+void FBFindBezierRoots(CGPoint *bezierPoints, NSUInteger degree, FBBezierRootFunction function, void *context)
 {
-    FBFindBezierRootsWithDepth(bezierPoints, degree, 0, block);
+    FBFindBezierRootsWithDepth(bezierPoints, degree, 0, function, context);
 }
@@ -6,7 +6,10 @@
 //  Copyright (c) 2014 Fortunate Bear, LLC. All rights reserved.
 //
 
-#import <Foundation/Foundation.h>
+#ifndef FBBEZIERCURVEHELPER_H
+#define FBBEZIERCURVEHELPER_H
+
+#include "FBTypes.h"
 
 extern CGFloat FBParameterOfPointOnLine(CGPoint lineStart, CGPoint lineEnd, CGPoint point);
 extern BOOL FBLinesIntersect(CGPoint line1Start, CGPoint line1End, CGPoint line2Start, CGPoint line2End, CGPoint *outIntersect);
@@ -20,5 +23,11 @@ extern NSInteger FBSign(CGFloat value);
 extern NSUInteger FBCountBezierCrossings(CGPoint *bezierPoints, NSUInteger degree);
 extern BOOL FBIsControlPolygonFlatEnough(CGPoint *bezierPoints, NSUInteger degree, CGPoint *intersectionPoint);
 
-extern void FBFindBezierRootsWithDepth(CGPoint *bezierPoints, NSUInteger degree, NSUInteger depth, void (^block)(CGFloat root));
-extern void FBFindBezierRoots(CGPoint *bezierPoints, NSUInteger degree, void (^block)(CGFloat root));
+// Called with each root found. The core is plain C, so this is a function plus a context
+//  pointer rather than a block.
+typedef void (*FBBezierRootFunction)(CGFloat root, void *context);
+
+extern void FBFindBezierRootsWithDepth(CGPoint *bezierPoints, NSUInteger degree, NSUInteger depth, FBBezierRootFunction function, void *context);
+extern void FBFindBezierRoots(CGPoint *bezierPoints, NSUInteger degree, FBBezierRootFunction function, void *context);
+
+#endif
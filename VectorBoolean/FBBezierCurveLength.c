@@ -1,12 +1,14 @@
 //
-//  FBBezierCurveLength.m
+//  FBBezierCurveLength.c
 //  VectorBoolean
 //
 //  Created by Stephan Michels on 18.07.14.
 //  Copyright (c) 2014 Fortunate Bear, LLC. All rights reserved.
 //
 
-#import "FBBezierCurveLength.h"
+#include "FBBezierCurveLength.h"
+#include "FBGeometry.h"
+#include <stdlib.h>
 
 // Legendre-Gauss abscissae (xi values, defined at i=n as the roots of the nth order Legendre polynomial Pn(x))
 static CGFloat FBLegendreGaussAbscissaeValues[][24] = {{},{},
@@ -80,11 +82,194 @@ static CGFloat FBGaussQuadratureFOfTForCubic(CGFloat t, CGPoint p1, CGPoint p2,
 
 CGFloat FBGaussQuadratureComputeCurveLengthForCubic(CGFloat z, NSUInteger steps, CGPoint p1, CGPoint p2, CGPoint p3, CGPoint p4)
 {
-    CGFloat z2 = z / 2.0;
+    return FBGaussQuadratureComputeCurveLengthForCubicInRange(0.0, z, steps, p1, p2, p3, p4);
+}
+
+CGFloat FBGaussQuadratureComputeCurveLengthForCubicInRange(CGFloat from, CGFloat to, NSUInteger steps, CGPoint p1, CGPoint p2, CGPoint p3, CGPoint p4)
+{
+    CGFloat halfSize = (to - from) / 2.0;
+    CGFloat middle = (to + from) / 2.0;
     CGFloat sum = 0.0;
     for (NSUInteger i = 0; i < steps; i++) {
-        CGFloat correctedT = z2 * FBLegendreGaussAbscissaeValues[steps][i] + z2;
+        CGFloat correctedT = halfSize * FBLegendreGaussAbscissaeValues[steps][i] + middle;
         sum += FBLegendreGaussWeightValues[steps][i] * FBGaussQuadratureFOfTForCubic(correctedT, p1, p2, p3, p4);
     }
-    return z2 * sum;
+    return halfSize * sum;
+}
+
+#pragma mark Length tables
+
+//////////////////////////////////////////////////////////////////////////////////
+// Length tables
+//
+// The table splits the curve into segments that the quadrature rule integrates
+//  to within the tolerance, and keeps the length up to the end of each one. A
+//  segment is accepted when integrating it whole and integrating its halves
+//  agree. Then the length up to any parameter is a lookup plus one integral
+//  over part of a segment, and the parameter at a length is a lookup plus a
+//  few Newton steps inside one segment, where the speed barely changes.
+//
+
+// Enough for the segments of a well behaved curve, so most tables never grow
+static const NSUInteger FBLengthTableInitialSegmentCount = 4;
+static const NSUInteger FBLengthTableInitialCapacity = 16;
+static const NSUInteger FBLengthTableMaximumDepth = 10;
+static const NSUInteger FBLengthTableQuadratureSteps = 8;
+
+// Relative to the length of the control polygon, which is at least the length of the curve
+static const CGFloat FBLengthTableRelativeTolerance = FBPrecisionThreshold(4e-5, 1e-10, 8e-13);
+
+static const CGFloat FBLengthTableParameterThreshold = FBPrecisionThreshold(5e-6, 1e-12, 3e-15);
+static const NSUInteger FBLengthTableMaximumIterations = 32;
+
+struct FBBezierCurveLengthTable {
+    CGPoint points[4];
+    NSUInteger count; // of segments
+    NSUInteger capacity;
+    CGFloat *parameters; // where the segments start and end, count + 1 of them
+    CGFloat *lengths; // up to each of the parameters
+    CGFloat tolerance;
+};
+
+static void FBBezierCurveLengthTableAddSegment(FBBezierCurveLengthTableRef table, CGFloat end, CGFloat length)
+{
+    if ( table->count + 1 == table->capacity ) {
+        table->capacity *= 2;
+        table->parameters = realloc(table->parameters, table->capacity * sizeof(CGFloat));
+        table->lengths = realloc(table->lengths, table->capacity * sizeof(CGFloat));
+    }
+    table->count++;
+    table->parameters[table->count] = end;
+    table->lengths[table->count] = table->lengths[table->count - 1] + length;
+}
+
+static void FBBezierCurveLengthTableAddSegments(FBBezierCurveLengthTableRef table, CGFloat from, CGFloat to, CGFloat length, NSUInteger depth)
+{
+    const CGPoint *points = table->points;
+    CGFloat middle = (from + to) / 2.0;
+    CGFloat firstLength = FBGaussQuadratureComputeCurveLengthForCubicInRange(from, middle, FBLengthTableQuadratureSteps, points[0], points[1], points[2], points[3]);
+    CGFloat secondLength = FBGaussQuadratureComputeCurveLengthForCubicInRange(middle, to, FBLengthTableQuadratureSteps, points[0], points[1], points[2], points[3]);
+
+    // The tolerance is shared out by size, so the whole table ends up within it
+    if ( depth >= FBLengthTableMaximumDepth || fabs(firstLength + secondLength - length) <= table->tolerance * (to - from) ) {
+        FBBezierCurveLengthTableAddSegment(table, middle, firstLength);
+        FBBezierCurveLengthTableAddSegment(table, to, secondLength);
+        return;
+    }
+    FBBezierCurveLengthTableAddSegments(table, from, middle, firstLength, depth + 1);
+    FBBezierCurveLengthTableAddSegments(table, middle, to, secondLength, depth + 1);
+}
+
+FBBezierCurveLengthTableRef FBBezierCurveLengthTableCreate(CGPoint p1, CGPoint p2, CGPoint p3, CGPoint p4)
+{
+    FBBezierCurveLengthTableRef table = calloc(1, sizeof(struct FBBezierCurveLengthTable));
+    table->points[0] = p1;
+    table->points[1] = p2;
+    table->points[2] = p3;
+    table->points[3] = p4;
+    table->capacity = FBLengthTableInitialCapacity;
+    table->parameters = malloc(table->capacity * sizeof(CGFloat));
+    table->lengths = malloc(table->capacity * sizeof(CGFloat));
+    table->parameters[0] = 0.0;
+    table->lengths[0] = 0.0;
+
+    CGFloat polygonLength = FBDistanceBetweenPoints(p1, p2) + FBDistanceBetweenPoints(p2, p3) + FBDistanceBetweenPoints(p3, p4);
+    table->tolerance = polygonLength * FBLengthTableRelativeTolerance;
+    for (NSUInteger i = 0; i < FBLengthTableInitialSegmentCount; i++) {
+        CGFloat from = (CGFloat)i / FBLengthTableInitialSegmentCount;
+        CGFloat to = (CGFloat)(i + 1) / FBLengthTableInitialSegmentCount;
+        CGFloat length = FBGaussQuadratureComputeCurveLengthForCubicInRange(from, to, FBLengthTableQuadratureSteps, p1, p2, p3, p4);
+        FBBezierCurveLengthTableAddSegments(table, from, to, length, 0);
+    }
+
+    return table;
+}
+
+void FBBezierCurveLengthTableRelease(FBBezierCurveLengthTableRef table)
+{
+    if ( table == NULL )
+        return;
+    free(table->parameters);
+    free(table->lengths);
+    free(table);
+}
+
+NSUInteger FBBezierCurveLengthTableGetSegmentCount(FBBezierCurveLengthTableRef table)
+{
+    return table->count;
+}
+
+CGFloat FBBezierCurveLengthTableGetLength(FBBezierCurveLengthTableRef table)
+{
+    return table->lengths[table->count];
+}
+
+// The last segment starting at or before the value
+static NSUInteger FBBezierCurveLengthTableFindSegment(const CGFloat *values, NSUInteger count, CGFloat value)
+{
+    NSUInteger low = 0;
+    NSUInteger high = count - 1;
+    while ( low < high ) {
+        NSUInteger middle = (low + high + 1) / 2;
+        if ( values[middle] <= value )
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    return low;
+}
+
+static CGFloat FBBezierCurveLengthTableGetLengthInSegment(FBBezierCurveLengthTableRef table, NSUInteger segment, CGFloat parameter)
+{
+    const CGPoint *points = table->points;
+    return table->lengths[segment] + FBGaussQuadratureComputeCurveLengthForCubicInRange(table->parameters[segment], parameter, FBLengthTableQuadratureSteps, points[0], points[1], points[2], points[3]);
+}
+
+CGFloat FBBezierCurveLengthTableGetLengthAtParameter(FBBezierCurveLengthTableRef table, CGFloat parameter)
+{
+    if ( parameter <= 0.0 )
+        return 0.0;
+    if ( parameter >= 1.0 )
+        return table->lengths[table->count];
+
+    NSUInteger segment = FBBezierCurveLengthTableFindSegment(table->parameters, table->count, parameter);
+    if ( parameter == table->parameters[segment] )
+        return table->lengths[segment];
+    return FBBezierCurveLengthTableGetLengthInSegment(table, segment, parameter);
+}
+
+CGFloat FBBezierCurveLengthTableGetParameterAtLength(FBBezierCurveLengthTableRef table, CGFloat length)
+{
+    if ( length <= 0.0 )
+        return 0.0;
+    if ( length >= table->lengths[table->count] )
+        return 1.0;
+
+    NSUInteger segment = FBBezierCurveLengthTableFindSegment(table->lengths, table->count, length);
+    CGFloat below = table->parameters[segment];
+    CGFloat above = table->parameters[segment + 1];
+    if ( length == table->lengths[segment] )
+        return below;
+
+    // Start from where the length would be if the speed were constant over the segment
+    const CGPoint *points = table->points;
+    CGFloat parameter = below + (above - below) * (length - table->lengths[segment]) / (table->lengths[segment + 1] - table->lengths[segment]);
+    for (NSUInteger i = 0; i < FBLengthTableMaximumIterations; i++) {
+        CGFloat difference = FBBezierCurveLengthTableGetLengthInSegment(table, segment, parameter) - length;
+        if ( difference == 0.0 )
+            return parameter;
+        if ( difference < 0.0 )
+            below = parameter;
+        else
+            above = parameter;
+
+        CGFloat speed = FBGaussQuadratureFOfTForCubic(parameter, points[0], points[1], points[2], points[3]);
+        CGFloat nextParameter = parameter - difference / speed;
+        if ( !(nextParameter > below && nextParameter < above) )
+            nextParameter = (below + above) / 2.0;
+        if ( fabs(nextParameter - parameter) < FBLengthTableParameterThreshold )
+            return nextParameter;
+        parameter = nextParameter;
+    }
+    return parameter;
 }
@@ -6,6 +6,35 @@
 //  Copyright (c) 2014 Fortunate Bear, LLC. All rights reserved.
 //
 
-#import <Foundation/Foundation.h>
+#ifndef FBBEZIERCURVELENGTH_H
+#define FBBEZIERCURVELENGTH_H
+
+#include "FBTypes.h"
 
 extern CGFloat FBGaussQuadratureComputeCurveLengthForCubic(CGFloat z, NSUInteger steps, CGPoint p1, CGPoint p2, CGPoint p3, CGPoint p4);
+extern CGFloat FBGaussQuadratureComputeCurveLengthForCubicInRange(CGFloat from, CGFloat to, NSUInteger steps, CGPoint p1, CGPoint p2, CGPoint p3, CGPoint p4);
+
+//////////////////////////////////////////////////////////////////////////
+// Length tables
+//
+// Measuring along a curve, like finding the point a given distance from
+//  its end, means integrating its speed, and with a fixed quadrature rule
+//  every query starts again from the start of the curve. A length table
+//  integrates the curve once, adaptively, to within a small tolerance, and
+//  after that answers the length up to a parameter, and the parameter at
+//  a length, from the part of the curve around it.
+//
+
+typedef struct FBBezierCurveLengthTable *FBBezierCurveLengthTableRef;
+
+extern FBBezierCurveLengthTableRef FBBezierCurveLengthTableCreate(CGPoint p1, CGPoint p2, CGPoint p3, CGPoint p4);
+extern void FBBezierCurveLengthTableRelease(FBBezierCurveLengthTableRef table);
+
+extern NSUInteger FBBezierCurveLengthTableGetSegmentCount(FBBezierCurveLengthTableRef table);
+extern CGFloat FBBezierCurveLengthTableGetLength(FBBezierCurveLengthTableRef table);
+extern CGFloat FBBezierCurveLengthTableGetLengthAtParameter(FBBezierCurveLengthTableRef table, CGFloat parameter);
+
+// The inverse of the above. Lengths outside the curve are clamped to its ends.
+extern CGFloat FBBezierCurveLengthTableGetParameterAtLength(FBBezierCurveLengthTableRef table, CGFloat length);
+
+#endif
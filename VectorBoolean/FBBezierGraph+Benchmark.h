@@ -0,0 +1,22 @@
+//
+//  FBBezierGraph+Benchmark.h
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#import "FBBezierGraph.h"
+
+// Switches that are only there to measure one part of the engine against another,
+//  for FBBooleanBenchmark. They apply to every graph in the process, so don't flip
+//  them while operations run.
+@interface FBBezierGraph (Benchmark)
+
+// Whether the regular operations between polygons go through FBPolygonClipper, so the
+//  two can be timed on the same input. Off by default: the clipper covers the same area,
+//  but its contours start at other points and come in another order. Prepared graphs
+//  take the curve code either way, since that's what they're prepared for.
+@property (class) BOOL usesPolygonClipper;
+
+@end
@@ -8,9 +8,15 @@
 
 #import <Foundation/Foundation.h>
 #import <CoreGraphics/CoreGraphics.h>
+#import "FBTypes.h"
 
 @class FBBezierContour;
 @class FBCurveLocation;
+struct FBEdgeIndex;
+struct FBArena;
+struct FBEdgeTable;
+struct FBBezierCurveData;
+struct FBScanlineIndex;
 
 // FBBezierGraph is more or less an exploded version of an CGPath, and
 //  the two can be converted between easily. FBBezierGraph allows boolean
@@ -19,24 +25,87 @@
 @interface FBBezierGraph : NSObject {
     NSMutableArray *_contours;
     CGRect _bounds;
+    struct FBEdgeIndex *_edgeIndex;
+    struct FBBezierCurveData *_edgeCurves;
+    NSUInteger *_edgeCurveOffsets;
+    NSUInteger _edgeCurveCount;
+    struct FBScanlineIndex *_scanlineIndex;
+    
+    // Only there while the graph is prepared
+    struct FBArena *_preparedArena;
+    struct FBEdgeTable *_preparedEdgeTable;
+    NSArray *_preparedSelfIntersections;
+    NSArray *_preparedSharedStarts;
+    NSArray *_preparedInsides;
 }
 
 + (instancetype) bezierGraph;
 + (instancetype) bezierGraphWithPath:(CGPathRef)path;
 - (instancetype) initWithPath:(CGPathRef)path;
 
+// Builds the graph straight from a flat array of path elements, which are read in place
++ (instancetype) bezierGraphWithPathElements:(const FBPathElement *)elements count:(NSUInteger)count;
+- (instancetype) initWithPathElements:(const FBPathElement *)elements count:(NSUInteger)count;
+
+// Combines all the graphs in one go. See CGPathCombine().
++ (FBBezierGraph *) bezierGraphByCombiningGraphs:(NSArray *)graphs operation:(FBBooleanOperation)operation;
+
 - (FBBezierGraph *) unionWithBezierGraph:(FBBezierGraph *)graph;
 - (FBBezierGraph *) intersectWithBezierGraph:(FBBezierGraph *)graph;
 - (FBBezierGraph *) differenceWithBezierGraph:(FBBezierGraph *)graph;
 - (FBBezierGraph *) xorWithBezierGraph:(FBBezierGraph *)graph;
+- (FBBezierGraph *) bezierGraphWithOperation:(FBBooleanOperation)operation bezierGraph:(FBBezierGraph *)graph;
+
+// Like the above, but the curves are flattened to lines within tolerance first and the
+//  polygons combined instead. The result is all lines and off by no more than tolerance.
+//  A tolerance of 0, or curves that would need too many lines, get the exact operation.
+- (FBBezierGraph *) bezierGraphWithOperation:(FBBooleanOperation)operation bezierGraph:(FBBezierGraph *)graph tolerance:(CGFloat)tolerance;
+
+// Like the above, for graphs of lines too big to combine in one go, like maps. Both are
+//  cut into square tiles tileSize across, the tiles are combined on all processors, and
+//  their results stitched back together. Graphs with curves get the regular operation.
+- (FBBezierGraph *) bezierGraphWithOperation:(FBBooleanOperation)operation bezierGraph:(FBBezierGraph *)graph tileSize:(CGFloat)tileSize;
+
+// Computes all the requested operations while finding where the graphs cross only once.
+//  The results are keyed by their FBBooleanOperation, wrapped in an NSNumber.
+- (NSDictionary *) bezierGraphsWithOperations:(FBBooleanOperations)operations bezierGraph:(FBBezierGraph *)graph;
+
+// Works out everything a boolean operation needs to know about this graph on its own,
+//  and keeps it for the operations to come: the edge index, the table of curves, where
+//  the graph crosses or touches itself, and which contours are holes. Then an operation
+//  with a small graph doesn't intersect this one with itself again, only the two with
+//  each other. Clearing the last operation's crossings and finding the contours without
+//  any still visit every edge of this graph, so that's what's left that grows with it.
+//  Worth it for a graph, like a mask, that's combined with lots of others. Adding a
+//  contour undoes the preparation.
+- (void) prepare;
+@property (readonly, getter = isPrepared) BOOL prepared;
+
+// Whether every edge is a straight line. The approximate and the tiled operations
+//  combine two polygons with FBPolygonClipper instead of the curve code.
+@property (readonly, getter = isPolygon) BOOL polygon;
 
 - (CGPathRef) path;
 
+// Hands out the elements of the path one at a time, contour by contour, without building a CGPath
+- (void) enumeratePathElementsUsingFunction:(FBPathElementFunction)function context:(void *)context;
+
 @property (readonly) NSArray* contours;
 @property (readonly) CGRect bounds;
 
 - (FBCurveLocation *) closestLocationToPoint:(CGPoint)point;
 
+// The closest locations to lots of points, in the same order as the points. The points
+//  are spread over the thread pool, and each one starts out from the edge closest to
+//  the point before it, so points near each other, like the positions of a dragged
+//  cursor, go fastest in order. Returns nil if the graph has no edges.
+- (NSArray *) closestLocationsToPoints:(const CGPoint *)points count:(NSUInteger)count;
+
+// Whether each of the points is inside the graph, by the fill rule. The first call
+//  sorts the edges into horizontal bands, after that a point costs about as much as
+//  the few edges level with it. The points are spread over the thread pool.
+- (void) containsPoints:(const CGPoint *)points count:(NSUInteger)count fillRule:(FBFillRule)fillRule results:(BOOL *)results;
+
 - (void) debuggingInsertCrossingsForUnionWithBezierGraph:(FBBezierGraph *)otherGraph;
 - (void) debuggingInsertCrossingsForIntersectWithBezierGraph:(FBBezierGraph *)otherGraph;
 - (void) debuggingInsertCrossingsForDifferenceWithBezierGraph:(FBBezierGraph *)otherGraph;
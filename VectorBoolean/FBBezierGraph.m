@@ -7,6 +7,7 @@
 //
 
 #import "FBBezierGraph.h"
+#import "FBBezierGraph+Benchmark.h"
 #import "FBBezierCurve.h"
 #import "CGPath+Utilities.h"
 #import "FBBezierContour.h"
@@ -17,6 +18,15 @@
 #import "FBCurveLocation.h"
 #import "FBDebug.h"
 #import "FBGeometry.h"
+#import "FBBezierIntersectRange.h"
+#import "FBEdgeIndex.h"
+#import "FBScanlineIndex.h"
+#import "FBPolygonClipper.h"
+#import "FBEdgeIntersections.h"
+#import "FBArena.h"
+#import "FBThreadPool.h"
+#import "FBProfile.h"
+#import "FBStatistics.h"
 #import <math.h>
 
 
@@ -33,19 +43,147 @@
 //  multiple contours intersecting other contours.
 //
 
+// Sorts edge pairs into the order the nested contour and edge loops visit them:
+//  our contours, their contours, our edges, then their edges.
+static int FBCompareEdgePairsByContour(const void *value1, const void *value2)
+{
+    const FBEdgeIndexPair *pair1 = value1;
+    const FBEdgeIndexPair *pair2 = value2;
+    if ( pair1->contourIndex1 != pair2->contourIndex1 )
+        return pair1->contourIndex1 < pair2->contourIndex1 ? -1 : 1;
+    if ( pair1->contourIndex2 != pair2->contourIndex2 )
+        return pair1->contourIndex2 < pair2->contourIndex2 ? -1 : 1;
+    if ( pair1->edgeIndex1 != pair2->edgeIndex1 )
+        return pair1->edgeIndex1 < pair2->edgeIndex1 ? -1 : 1;
+    if ( pair1->edgeIndex2 != pair2->edgeIndex2 )
+        return pair1->edgeIndex2 < pair2->edgeIndex2 ? -1 : 1;
+    return 0;
+}
+
+// Same as above, except self crossings start with the last contour and work backwards
+static int FBCompareEdgePairsBySelfContour(const void *value1, const void *value2)
+{
+    const FBEdgeIndexPair *pair1 = value1;
+    const FBEdgeIndexPair *pair2 = value2;
+    if ( pair1->contourIndex1 != pair2->contourIndex1 )
+        return pair1->contourIndex1 > pair2->contourIndex1 ? -1 : 1;
+    return FBCompareEdgePairsByContour(value1, value2);
+}
+
+// The state of building a graph from path elements, one element at a time
+typedef struct FBBezierGraphBuilder {
+    __unsafe_unretained FBBezierGraph *graph;
+    __unsafe_unretained FBBezierContour *contour;
+    CGPoint lastPoint;
+    BOOL wasClosed;
+} FBBezierGraphBuilder;
+
+static void FBBezierGraphAddCGPathElement(void *info, const CGPathElement *element);
+
+typedef struct FBBezierGraphRayContext {
+    __unsafe_unretained NSArray *contours;
+    __unsafe_unretained NSMutableSet *nearContours;
+} FBBezierGraphRayContext;
+
+static void FBBezierGraphCollectContourNearRay(const FBEdgeIndexEntry *entry, void *context)
+{
+    FBBezierGraphRayContext *rayContext = context;
+    [rayContext->nearContours addObject:rayContext->contours[entry->contourIndex]];
+}
+
+// The edge closest to a point, by contour index and edge index
+typedef struct FBBezierGraphClosestEdge {
+    NSUInteger contourIndex; // NSNotFound if there isn't one yet
+    NSUInteger edgeIndex;
+    FBBezierCurveLocation location;
+} FBBezierGraphClosestEdge;
+
+typedef struct FBBezierGraphClosestContext {
+    const FBBezierCurveData *curves;
+    const NSUInteger *curveOffsets; // where the edges of each contour start in curves
+    FBBezierGraphClosestEdge closestEdge;
+} FBBezierGraphClosestContext;
+
+static CGFloat FBBezierGraphDistanceToEdge(const FBEdgeIndexEntry *entry, CGPoint point, void *context)
+{
+    FBBezierGraphClosestContext *closestContext = context;
+    FBBezierGraphClosestEdge *closestEdge = &closestContext->closestEdge;
+    if ( entry->contourIndex == closestEdge->contourIndex && entry->edgeIndex == closestEdge->edgeIndex )
+        return closestEdge->location.distance; // projected already
+    
+    FBBezierCurveLocation location = FBBezierCurveDataClosestLocationToPoint(closestContext->curves[closestContext->curveOffsets[entry->contourIndex] + entry->edgeIndex], point);
+    // Break ties the way going through the contours and edges in order does, by keeping the first
+    BOOL isFirst = entry->contourIndex < closestEdge->contourIndex || (entry->contourIndex == closestEdge->contourIndex && entry->edgeIndex < closestEdge->edgeIndex);
+    if ( closestEdge->contourIndex == NSNotFound || location.distance < closestEdge->location.distance || (location.distance == closestEdge->location.distance && isFirst) ) {
+        closestEdge->contourIndex = entry->contourIndex;
+        closestEdge->edgeIndex = entry->edgeIndex;
+        closestEdge->location = location;
+    }
+    return location.distance;
+}
+
+static void FBBezierGraphFindClosestEdge(FBEdgeIndexRef index, CGPoint point, FBBezierGraphClosestContext *context)
+{
+    // If there's a closest edge from an earlier point, it's likely still close. Its distance
+    //  to this point is an upper bound that rules out most of the index right away.
+    CGFloat maximumDistance = INFINITY;
+    FBBezierGraphClosestEdge *closestEdge = &context->closestEdge;
+    if ( closestEdge->contourIndex != NSNotFound ) {
+        closestEdge->location = FBBezierCurveDataClosestLocationToPoint(context->curves[context->curveOffsets[closestEdge->contourIndex] + closestEdge->edgeIndex], point);
+        maximumDistance = closestEdge->location.distance;
+    }
+    FBEdgeIndexEnumerateNearestEntries(index, point, maximumDistance, FBBezierGraphDistanceToEdge, context);
+}
+
+// Past this many lines for a single curve, flattening costs more than the exact operation
+static const NSUInteger FBBezierGraphMaximumFlatteningSegmentCount = 1024;
+
+// Enough points to make an iteration worth handing to another thread
+static const NSUInteger FBBezierGraphClosestPointsPerIteration = 64;
+
+typedef struct FBBezierGraphClosestBatch {
+    FBEdgeIndexRef index;
+    const FBBezierCurveData *curves;
+    const NSUInteger *curveOffsets;
+    const CGPoint *points;
+    NSUInteger count;
+    FBBezierGraphClosestEdge *closestEdges;
+} FBBezierGraphClosestBatch;
+
+static void FBBezierGraphFindClosestEdges(NSUInteger iteration, NSUInteger threadIndex, void *context)
+{
+    FBBezierGraphClosestBatch *batch = context;
+    FBBezierGraphClosestContext closestContext = { batch->curves, batch->curveOffsets, { NSNotFound, NSNotFound, {} } };
+    NSUInteger end = MIN((iteration + 1) * FBBezierGraphClosestPointsPerIteration, batch->count);
+    for (NSUInteger i = iteration * FBBezierGraphClosestPointsPerIteration; i < end; i++) {
+        FBBezierGraphFindClosestEdge(batch->index, batch->points[i], &closestContext);
+        batch->closestEdges[i] = closestContext.closestEdge;
+    }
+}
+
 @interface FBBezierGraph ()
 
 - (void) removeCrossingsInOverlaps;
 - (void) removeDuplicateCrossings;
 - (void) insertCrossingsWithBezierGraph:(FBBezierGraph *)other;
-- (FBEdgeCrossing *) firstUnprocessedCrossing;
+- (NSArray *) nonselfCrossings;
 - (void) markCrossingsAsEntryOrExitWithBezierGraph:(FBBezierGraph *)otherGraph markInside:(BOOL)markInside;
 - (FBBezierGraph *) bezierGraphFromIntersections;
+- (void) insertCrossingsForOperationsWithBezierGraph:(FBBezierGraph *)graph;
+- (void) removeCrossingsForOperationsWithBezierGraph:(FBBezierGraph *)graph;
+- (FBBezierGraph *) unionFromCrossingsWithBezierGraph:(FBBezierGraph *)graph;
+- (FBBezierGraph *) intersectFromCrossingsWithBezierGraph:(FBBezierGraph *)graph;
+- (FBBezierGraph *) differenceFromCrossingsWithBezierGraph:(FBBezierGraph *)graph;
+- (FBBezierGraph *) xorWithUnion:(FBBezierGraph *)allParts intersect:(FBBezierGraph *)intersectingParts;
 - (void) removeCrossings;
 - (void) removeOverlaps;
+- (BOOL) hasOverlaps;
 - (void) cleanupCrossingsWithBezierGraph:(FBBezierGraph *)other;
 
 - (void) insertSelfCrossings;
+- (NSArray *) selfCrossingIntersections;
+- (void) addSelfCrossingsWithIntersections:(NSArray *)intersections;
+- (void) unprepare;
 - (void) markAllCrossingsAsUnprocessed;
 
 - (void) unionNonintersectingPartsIntoGraph:(FBBezierGraph *)result withGraph:(FBBezierGraph *)graph;
@@ -55,7 +193,20 @@
 - (void) differenceEquivalentNonintersectingContours:(NSMutableArray *)ourNonintersectingContours withContours:(NSMutableArray *)theirNonintersectingContours results:(NSMutableArray *)results;
 
 - (void) addContour:(FBBezierContour *)contour;
+- (void) addPathElement:(const FBPathElement *)element withBuilder:(FBBezierGraphBuilder *)builder;
+- (void) finishBuilding:(FBBezierGraphBuilder *)builder;
+- (FBEdgeIndexRef) edgeIndex;
+- (const FBBezierCurveData *) edgeCurves;
+- (FBScanlineIndexRef) scanlineIndex;
+- (BOOL) usesPolygonClipperWithBezierGraph:(FBBezierGraph *)graph;
+- (FBPolygonRef) createPolygon;
+- (FBPolygonRef) createPolygonWithTolerance:(CGFloat)tolerance;
++ (FBBezierGraph *) bezierGraphWithPolygon:(FBPolygonRef)polygon;
+- (NSDictionary *) polygonGraphsWithOperations:(FBBooleanOperations)operations bezierGraph:(FBBezierGraph *)graph;
+- (FBCurveLocation *) curveLocationWithClosestEdge:(FBBezierGraphClosestEdge)closestEdge;
+- (FBEdgeTable *) edgeTableInArena:(FBArenaRef)arena;
 - (FBContourInside) contourInsides:(FBBezierContour *)contour;
+- (NSSet *) contoursNearRay:(FBBezierCurve *)ray;
 
 - (NSArray *) nonintersectingContours;
 - (BOOL) containsContour:(FBBezierContour *)contour;
@@ -70,10 +221,59 @@
 
 - (void) debuggingInsertCrossingsWithBezierGraph:(FBBezierGraph *)otherGraph markInside:(BOOL)markInside markOtherInside:(BOOL)markOtherInside;
 
++ (FBBezierGraph *) bezierGraphByCombiningGraphs:(NSArray *)graphs inRange:(NSRange)range operation:(FBBooleanOperation)operation;
+
 //@property (readonly) NSArray *contours;
 
 @end
 
+static void FBBezierGraphAddCGPathElement(void *info, const CGPathElement *element)
+{
+    // CGPathElementType and FBPathElementType list the element types in the same order
+    static const NSUInteger FBPointCounts[] = { 1, 1, 2, 3, 0 };
+    FBPathElement pathElement = { (FBPathElementType)element->type };
+    for (NSUInteger i = 0; i < FBPointCounts[element->type]; i++)
+        pathElement.points[i] = element->points[i];
+    
+    FBBezierGraphBuilder *builder = info;
+    [builder->graph addPathElement:&pathElement withBuilder:builder];
+}
+
+static FBEdgeCrossing *FBNextUnprocessedCrossing(NSArray *crossings, NSUInteger *index)
+{
+    for (; *index < crossings.count; (*index)++) {
+        FBEdgeCrossing *crossing = crossings[*index];
+        if ( !crossing.isProcessed )
+            return crossing;
+    }
+    return nil;
+}
+
+static void FBBezierGraphAppendPathElementToCGPath(const FBPathElement *element, void *context)
+{
+    CGMutablePathRef path = context;
+    switch (element->type) {
+        case FBPathElementMoveToPoint:
+            CGPathMoveToPoint(path, NULL, element->points[0].x, element->points[0].y);
+            break;
+        case FBPathElementAddLineToPoint:
+            CGPathAddLineToPoint(path, NULL, element->points[0].x, element->points[0].y);
+            break;
+        case FBPathElementAddQuadCurveToPoint:
+            CGPathAddQuadCurveToPoint(path, NULL, element->points[0].x, element->points[0].y, element->points[1].x, element->points[1].y);
+            break;
+        case FBPathElementAddCurveToPoint:
+            CGPathAddCurveToPoint(path, NULL, element->points[0].x, element->points[0].y, element->points[1].x, element->points[1].y, element->points[2].x, element->points[2].y);
+            break;
+        case FBPathElementCloseSubpath:
+            CGPathCloseSubpath(path);
+            break;
+    }
+}
+
+// Whether operations between polygons go through the polygon clipper, see FBBezierGraph+Benchmark.h
+static BOOL FBBezierGraphUsesPolygonClipper = NO;
+
 @implementation FBBezierGraph
 
 @synthesize contours=_contours;
@@ -83,6 +283,11 @@
     return [[FBBezierGraph alloc] initWithPath:path];
 }
 
++ (instancetype) bezierGraphWithPathElements:(const FBPathElement *)elements count:(NSUInteger)count
+{
+    return [[FBBezierGraph alloc] initWithPathElements:elements count:count];
+}
+
 + (instancetype) bezierGraph
 {
     return [[FBBezierGraph alloc] init];
@@ -93,110 +298,136 @@
     self = [super init];
     
     if ( self != nil ) {
-        // A bezier graph is made up of contours, which are closed paths of curves. Anytime we
-        //  see a move to in the CGPath, that's a new contour.
-		
-        __block CGPoint lastPoint = CGPointZero;
-		__block BOOL	wasClosed = NO;
+        // Feed the elements straight from the path into the graph, without going through
+        //  a block or a copy of the path.
         _contours = [[NSMutableArray alloc] initWithCapacity:2];
-            
-        __block FBBezierContour *contour = nil;
-		CGPathEnumerateElementsUsingBlock(path, ^(const CGPathElement *element) {
-            switch (element->type) {
-                case kCGPathElementMoveToPoint:
-				{
-					CGPoint point = *(CGPoint *) element->points;
-                    // if previous contour wasn't closed, close it
-					
-					if( !wasClosed && contour != nil )
-						[contour close];
-					
-					wasClosed = NO;
-										
-					// Start a new contour
-                    contour = [[FBBezierContour alloc] init];
-                    [self addContour:contour];
-                    
-                    lastPoint = point;
-                    break;
-				}
-					
-                case kCGPathElementAddLineToPoint:
-				{
-					CGPoint point = *(CGPoint *) element->points;
-                    // [MO] skip degenerate line segments
-                    if (CGPointEqualToPoint(point, lastPoint))
-						return;
-					
-					// Convert lines to bezier curves as well. Just set control point to be in the line formed
-					//  by the end points
-					[contour addCurve:[FBBezierCurve bezierCurveWithLineStartPoint:lastPoint endPoint:point]];
-					
-					lastPoint = point;
-                    break;
-                }
-			
-				case kCGPathElementAddQuadCurveToPoint:
-				{
-					NSPoint controlPoint = *(NSPoint *) &element->points[0];
-					NSPoint point = *(NSPoint *) &element->points[1];
-					// GPC: skip degenerate case where all points are equal
-					
-					if( CGPointEqualToPoint( point, lastPoint ) && CGPointEqualToPoint( point, controlPoint ))
-						return;
-					
-					[contour addCurve:[FBBezierCurve bezierCurveWithEndPoint1:lastPoint controlPoint1:controlPoint controlPoint2:controlPoint endPoint2:point]];
-					
-					lastPoint = point;
-					break;
-				}
-					
-                case kCGPathElementAddCurveToPoint:
-				{
-					NSPoint controlPoint1 = *(NSPoint *) &element->points[0];
-					NSPoint controlPoint2 = *(NSPoint *) &element->points[1];
-					NSPoint point = *(NSPoint *) &element->points[2];
-                    // GPC: skip degenerate case where all points are equal
-					
-					if( CGPointEqualToPoint( point, lastPoint ) && CGPointEqualToPoint( point, controlPoint1 ) && CGPointEqualToPoint( point, controlPoint2 ))
-						return;
-
-					[contour addCurve:[FBBezierCurve bezierCurveWithEndPoint1:lastPoint controlPoint1:controlPoint1 controlPoint2:controlPoint2 endPoint2:point]];
-                    
-                    lastPoint = point;
-                    break;
-				}
-					
-                case kCGPathElementCloseSubpath:
-                    // [MO] attempt to close the bezier contour by
-                    // mapping closepaths to equivalent lineto operations,
-                    // though as with our kCGPathElementAddLineToPoint processing,
-                    // we check so as not to add degenerate line segments which 
-                    // blow up the clipping code.
-                    
-                    if (contour.edges.count) {
-                        FBBezierCurve *firstEdge = contour.edges[0];
-                        CGPoint firstPoint = firstEdge.endPoint1;
-                        
-                        // Skip degenerate line segments
-                        if ( !CGPointEqualToPoint(lastPoint, firstPoint) ) {
-                            [contour addCurve:[FBBezierCurve bezierCurveWithLineStartPoint:lastPoint endPoint:firstPoint]];
-							wasClosed = YES;
-                        }
-                    }
-                    lastPoint = CGPointZero;
-                    break;
-            }
-        });
-
-		if( !wasClosed && contour != nil )
-			[contour close];
+        FBProfileMark mark = FBProfileBeginPhase(FBProfilePhaseGraphConstruction);
+        FBBezierGraphBuilder builder = { self, nil, CGPointZero, NO };
+        CGPathApply(path, &builder, FBBezierGraphAddCGPathElement);
+        [self finishBuilding:&builder];
+        FBProfileEndPhase(FBProfilePhaseGraphConstruction, mark);
+    }
+    
+    return self;
+}
 
+- (instancetype) initWithPathElements:(const FBPathElement *)elements count:(NSUInteger)count
+{
+    self = [super init];
+    
+    if ( self != nil ) {
+        // The elements are read in place, so they can come from anywhere, e.g. a parser
+        //  or a memory mapped file, without ever being turned into a CGPath.
+        _contours = [[NSMutableArray alloc] initWithCapacity:2];
+        FBProfileMark mark = FBProfileBeginPhase(FBProfilePhaseGraphConstruction);
+        FBBezierGraphBuilder builder = { self, nil, CGPointZero, NO };
+        for (NSUInteger i = 0; i < count; i++)
+            [self addPathElement:&elements[i] withBuilder:&builder];
+        [self finishBuilding:&builder];
+        FBProfileEndPhase(FBProfilePhaseGraphConstruction, mark);
     }
     
     return self;
 }
 
+- (void) addPathElement:(const FBPathElement *)element withBuilder:(FBBezierGraphBuilder *)builder
+{
+    // A bezier graph is made up of contours, which are closed paths of curves. Anytime we
+    //  see a move to in the path, that's a new contour.
+    switch (element->type) {
+        case FBPathElementMoveToPoint:
+        {
+            CGPoint point = element->points[0];
+            // if previous contour wasn't closed, close it
+            
+            if( !builder->wasClosed && builder->contour != nil )
+                [builder->contour close];
+            
+            builder->wasClosed = NO;
+            
+            // Start a new contour
+            FBBezierContour *contour = [[FBBezierContour alloc] init];
+            [self addContour:contour];
+            builder->contour = contour; // the graph keeps it alive
+            
+            builder->lastPoint = point;
+            break;
+        }
+            
+        case FBPathElementAddLineToPoint:
+        {
+            CGPoint point = element->points[0];
+            // [MO] skip degenerate line segments
+            if (CGPointEqualToPoint(point, builder->lastPoint))
+                return;
+            
+            // Convert lines to bezier curves as well. Just set control point to be in the line formed
+            //  by the end points
+            [builder->contour addCurve:[FBBezierCurve bezierCurveWithLineStartPoint:builder->lastPoint endPoint:point]];
+            
+            builder->lastPoint = point;
+            break;
+        }
+            
+        case FBPathElementAddQuadCurveToPoint:
+        {
+            CGPoint controlPoint = element->points[0];
+            CGPoint point = element->points[1];
+            // GPC: skip degenerate case where all points are equal
+            
+            if( CGPointEqualToPoint( point, builder->lastPoint ) && CGPointEqualToPoint( point, controlPoint ))
+                return;
+            
+            [builder->contour addCurve:[FBBezierCurve bezierCurveWithQuadraticStartPoint:builder->lastPoint controlPoint:controlPoint endPoint:point]];
+            
+            builder->lastPoint = point;
+            break;
+        }
+            
+        case FBPathElementAddCurveToPoint:
+        {
+            CGPoint controlPoint1 = element->points[0];
+            CGPoint controlPoint2 = element->points[1];
+            CGPoint point = element->points[2];
+            // GPC: skip degenerate case where all points are equal
+            
+            if( CGPointEqualToPoint( point, builder->lastPoint ) && CGPointEqualToPoint( point, controlPoint1 ) && CGPointEqualToPoint( point, controlPoint2 ))
+                return;
+            
+            [builder->contour addCurve:[FBBezierCurve bezierCurveWithEndPoint1:builder->lastPoint controlPoint1:controlPoint1 controlPoint2:controlPoint2 endPoint2:point]];
+            
+            builder->lastPoint = point;
+            break;
+        }
+            
+        case FBPathElementCloseSubpath:
+            // [MO] attempt to close the bezier contour by
+            // mapping closepaths to equivalent lineto operations,
+            // though as with our kCGPathElementAddLineToPoint processing,
+            // we check so as not to add degenerate line segments which 
+            // blow up the clipping code.
+            
+            if (builder->contour.edges.count) {
+                FBBezierCurve *firstEdge = builder->contour.edges[0];
+                CGPoint firstPoint = firstEdge.endPoint1;
+                
+                // Skip degenerate line segments
+                if ( !CGPointEqualToPoint(builder->lastPoint, firstPoint) ) {
+                    [builder->contour addCurve:[FBBezierCurve bezierCurveWithLineStartPoint:builder->lastPoint endPoint:firstPoint]];
+                    builder->wasClosed = YES;
+                }
+            }
+            builder->lastPoint = CGPointZero;
+            break;
+    }
+}
+
+- (void) finishBuilding:(FBBezierGraphBuilder *)builder
+{
+    if( !builder->wasClosed && builder->contour != nil )
+        [builder->contour close];
+}
+
 - (instancetype) init
 {
     self = [super init];
@@ -208,6 +439,63 @@
     return self;
 }
 
+- (void) dealloc
+{
+    FBEdgeIndexRelease(_edgeIndex);
+    free(_edgeCurves);
+    free(_edgeCurveOffsets);
+    FBScanlineIndexRelease(_scanlineIndex);
+    FBArenaRelease(_preparedArena);
+}
+
+- (void) prepare
+{
+    if ( self.isPrepared )
+        return;
+    
+    // The table of curves goes into an arena of its own, which lives as long as the preparation
+    [self edgeIndex];
+    [self bounds];
+    _preparedArena = FBArenaCreate(0);
+    _preparedEdgeTable = [self edgeTableInArena:_preparedArena];
+    
+    // Telling holes from filled regions needs the self crossings in place. Finding them also
+    //  marks the edges that start where the graph touches itself, crossing there or not, and
+    //  removing the crossings clears those marks, so remember the edges to mark them again.
+    _preparedSelfIntersections = [self selfCrossingIntersections];
+    [self addSelfCrossingsWithIntersections:_preparedSelfIntersections];
+    NSMutableArray *sharedStarts = [NSMutableArray array];
+    for (FBBezierContour *contour in _contours) {
+        for (FBBezierCurve *edge in contour.edges) {
+            if ( edge.startShared )
+                [sharedStarts addObject:edge];
+        }
+    }
+    _preparedSharedStarts = sharedStarts;
+    NSMutableArray *insides = [NSMutableArray arrayWithCapacity:_contours.count];
+    for (FBBezierContour *contour in _contours) {
+        contour.inside = [self contourInsides:contour];
+        [insides addObject:@(contour.inside)];
+    }
+    _preparedInsides = insides;
+    [self removeCrossings];
+}
+
+- (void) unprepare
+{
+    FBArenaRelease(_preparedArena);
+    _preparedArena = NULL;
+    _preparedEdgeTable = NULL;
+    _preparedSelfIntersections = nil;
+    _preparedSharedStarts = nil;
+    _preparedInsides = nil;
+}
+
+- (BOOL) isPrepared
+{
+    return _preparedEdgeTable != NULL;
+}
+
 
 ////////////////////////////////////////////////////////////////////////
 // Boolean operations
@@ -225,37 +513,47 @@
 //  The last part of each boolean operation deals with what do with contours
 //  in each graph that don't intersect any other contours.
 //
-// The exclusive or boolean op is implemented in terms of union, intersect,
-//  and difference. More specifically it subtracts the intersection of both
-//  graphs from the union of both graphs.
+// The exclusive or boolean op is made from the union and the intersect of
+//  both graphs. Their contours are simply put together in one graph, so the
+//  intersect cuts holes into the union. That's only right under the even-odd
+//  fill rule, which is how the results are filled. Where the graphs overlap,
+//  the union and the intersect share edges, so the intersect is subtracted
+//  from the union with a real difference instead.
+//
+// Finding the crossings doesn't depend on the operation, so several operations
+//  on the same two graphs can share them, see bezierGraphsWithOperations:bezierGraph:.
 //
 
 - (FBBezierGraph *) unionWithBezierGraph:(FBBezierGraph *)graph
 {
-    // First insert FBEdgeCrossings into both graphs where the graphs
-    //  cross.
-    [self insertCrossingsWithBezierGraph:graph];
-    [self insertSelfCrossings];
-    [graph insertSelfCrossings];
-    [self cleanupCrossingsWithBezierGraph:graph];
+    if ( [self usesPolygonClipperWithBezierGraph:graph] )
+        return [self polygonGraphsWithOperations:FBBooleanOperationsUnion bezierGraph:graph][@(FBBooleanOperationUnion)];
     
+    [self insertCrossingsForOperationsWithBezierGraph:graph];
+    FBBezierGraph *result = [self unionFromCrossingsWithBezierGraph:graph];
+    [self removeCrossingsForOperationsWithBezierGraph:graph];
+    return result;
+}
+
+- (FBBezierGraph *) unionFromCrossingsWithBezierGraph:(FBBezierGraph *)graph
+{
     // Handle the parts of the graphs that intersect first. Mark the parts
     //  of the graphs that are outside the other for the final result.
+    FBProfileMark mark = FBProfileBeginPhase(FBProfilePhaseMarking);
     [self markCrossingsAsEntryOrExitWithBezierGraph:graph markInside:NO];
     [graph markCrossingsAsEntryOrExitWithBezierGraph:self markInside:NO];
+    FBProfileEndPhase(FBProfilePhaseMarking, mark);
 
     // Walk the crossings and actually compute the final result for the intersecting parts
+    mark = FBProfileBeginPhase(FBProfilePhaseExtraction);
     FBBezierGraph *result = [self bezierGraphFromIntersections];
+    FBProfileEndPhase(FBProfilePhaseExtraction, mark);
 
     // Finally, process the contours that don't cross anything else. They're either
     //  completely contained in another contour, or disjoint.
+    mark = FBProfileBeginPhase(FBProfilePhaseContainment);
     [self unionNonintersectingPartsIntoGraph:result withGraph:graph];
-
-    // Clean up crossings so the graphs can be reused, e.g. XOR will reuse graphs.
-    [self removeCrossings];
-    [graph removeCrossings];
-    [self removeOverlaps];
-    [graph removeOverlaps];
+    FBProfileEndPhase(FBProfilePhaseContainment, mark);
 
     return result;
 }
@@ -320,30 +618,35 @@
 
 - (FBBezierGraph *) intersectWithBezierGraph:(FBBezierGraph *)graph
 {
-    // First insert FBEdgeCrossings into both graphs where the graphs cross.
-    [self insertCrossingsWithBezierGraph:graph];
-    [self insertSelfCrossings];
-    [graph insertSelfCrossings];
-    [self cleanupCrossingsWithBezierGraph:graph];
+    if ( [self usesPolygonClipperWithBezierGraph:graph] )
+        return [self polygonGraphsWithOperations:FBBooleanOperationsIntersect bezierGraph:graph][@(FBBooleanOperationIntersect)];
+    
+    [self insertCrossingsForOperationsWithBezierGraph:graph];
+    FBBezierGraph *result = [self intersectFromCrossingsWithBezierGraph:graph];
+    [self removeCrossingsForOperationsWithBezierGraph:graph];
+    return result;
+}
 
+- (FBBezierGraph *) intersectFromCrossingsWithBezierGraph:(FBBezierGraph *)graph
+{
     // Handle the parts of the graphs that intersect first. Mark the parts
     //  of the graphs that are inside the other for the final result.
+    FBProfileMark mark = FBProfileBeginPhase(FBProfilePhaseMarking);
     [self markCrossingsAsEntryOrExitWithBezierGraph:graph markInside:YES];
     [graph markCrossingsAsEntryOrExitWithBezierGraph:self markInside:YES];
+    FBProfileEndPhase(FBProfilePhaseMarking, mark);
     
     // Walk the crossings and actually compute the final result for the intersecting parts
+    mark = FBProfileBeginPhase(FBProfilePhaseExtraction);
     FBBezierGraph *result = [self bezierGraphFromIntersections];
+    FBProfileEndPhase(FBProfilePhaseExtraction, mark);
     
     // Finally, process the contours that don't cross anything else. They're either
     //  completely contained in another contour, or disjoint.
+    mark = FBProfileBeginPhase(FBProfilePhaseContainment);
     [self intersectNonintersectingPartsIntoGraph:result withGraph:graph];
+    FBProfileEndPhase(FBProfilePhaseContainment, mark);
     
-    // Clean up crossings so the graphs can be reused, e.g. XOR will reuse graphs.
-    [self removeCrossings];
-    [graph removeCrossings];
-    [self removeOverlaps];
-    [graph removeOverlaps];
-
     return result;
 }
 
@@ -412,23 +715,33 @@
 
 - (FBBezierGraph *) differenceWithBezierGraph:(FBBezierGraph *)graph
 {
-    // First insert FBEdgeCrossings into both graphs where the graphs cross.
-    [self insertCrossingsWithBezierGraph:graph];
-    [self insertSelfCrossings];
-    [graph insertSelfCrossings];
-    [self cleanupCrossingsWithBezierGraph:graph];
+    if ( [self usesPolygonClipperWithBezierGraph:graph] )
+        return [self polygonGraphsWithOperations:FBBooleanOperationsDifference bezierGraph:graph][@(FBBooleanOperationDifference)];
+    
+    [self insertCrossingsForOperationsWithBezierGraph:graph];
+    FBBezierGraph *result = [self differenceFromCrossingsWithBezierGraph:graph];
+    [self removeCrossingsForOperationsWithBezierGraph:graph];
+    return result;
+}
 
+- (FBBezierGraph *) differenceFromCrossingsWithBezierGraph:(FBBezierGraph *)graph
+{
     // Handle the parts of the graphs that intersect first. We're subtracting
     //  graph from outselves. Mark the outside parts of ourselves, and the inside
     //  parts of them for the final result.
+    FBProfileMark mark = FBProfileBeginPhase(FBProfilePhaseMarking);
     [self markCrossingsAsEntryOrExitWithBezierGraph:graph markInside:NO];
     [graph markCrossingsAsEntryOrExitWithBezierGraph:self markInside:YES];
+    FBProfileEndPhase(FBProfilePhaseMarking, mark);
     
     // Walk the crossings and actually compute the final result for the intersecting parts
+    mark = FBProfileBeginPhase(FBProfilePhaseExtraction);
     FBBezierGraph *result = [self bezierGraphFromIntersections];
+    FBProfileEndPhase(FBProfilePhaseExtraction, mark);
     
     // Finally, process the contours that don't cross anything else. They're either
     //  completely contained in another contour, or disjoint.
+    mark = FBProfileBeginPhase(FBProfilePhaseContainment);
     NSMutableArray *ourNonintersectingContours = [[self nonintersectingContours] mutableCopy];
     NSMutableArray *theirNonintersectinContours = [[graph nonintersectingContours] mutableCopy];
     NSMutableArray *finalNonintersectingContours = [NSMutableArray arrayWithCapacity:ourNonintersectingContours.count + theirNonintersectinContours.count];
@@ -452,14 +765,9 @@
     // Append the final nonintersecting contours
     for (FBBezierContour *contour in finalNonintersectingContours)
         [result addContour:contour];
+    FBProfileEndPhase(FBProfilePhaseContainment, mark);
     
-    // Clean up crossings so the graphs can be reused
-    [self removeCrossings];
-    [graph removeCrossings];
-    [self removeOverlaps];
-    [graph removeOverlaps];
-
-    return result;  
+    return result;
 }
 
 - (void) differenceEquivalentNonintersectingContours:(NSMutableArray *)ourNonintersectingContours withContours:(NSMutableArray *)theirNonintersectingContours results:(NSMutableArray *)results
@@ -513,142 +821,484 @@
 
 - (FBBezierGraph *) xorWithBezierGraph:(FBBezierGraph *)graph
 {
-    // XOR is done by combing union (OR), intersect (AND) and difference. Specifically
-    //  we compute the union of the two graphs, the intersect of them, then subtract
-    //  the intersect from the union.
-    // Note that we reuse the resulting graphs, which is why it is important that operations
-    //  clean up any crossings when their done, otherwise they could interfere with subsequent
-    //  operations.
-    
-    // First insert FBEdgeCrossings into both graphs where the graphs
-    //  cross.
-    [self insertCrossingsWithBezierGraph:graph];
-    [self insertSelfCrossings];
-    [graph insertSelfCrossings];
-    [self cleanupCrossingsWithBezierGraph:graph];
+    NSDictionary *results = [self bezierGraphsWithOperations:FBBooleanOperationsXOR bezierGraph:graph];
+    return results[@(FBBooleanOperationXOR)];
+}
 
-    // Handle the parts of the graphs that intersect first. Mark the parts
-    //  of the graphs that are outside the other for the final result.
-    [self markCrossingsAsEntryOrExitWithBezierGraph:graph markInside:NO];
-    [graph markCrossingsAsEntryOrExitWithBezierGraph:self markInside:NO];
+- (FBBezierGraph *) xorWithUnion:(FBBezierGraph *)allParts intersect:(FBBezierGraph *)intersectingParts
+{
+    // XOR is the union with the intersect cut out of it. Every edge of the two graphs
+    //  ends up either on the union or on the intersect, so the two results only touch
+    //  at the crossings, and the intersect lies inside the union. Subtracting it would
+    //  find no crossings and keep every contour of both, with the intersect's contours
+    //  becoming holes under the even-odd rule. So just add them, instead of intersecting
+    //  the freshly built curves all over again.
+    // The union and the intersect are handed out too, so add copies of their contours,
+    //  not the contours themselves, or changing one result would change the other.
+    FBBezierGraph *result = [FBBezierGraph bezierGraph];
+    for (FBBezierGraph *parts in @[allParts, intersectingParts]) {
+        for (FBBezierContour *contour in parts.contours) {
+            FBBezierContour *copy = [[FBBezierContour alloc] init];
+            for (FBBezierCurve *edge in contour.edges)
+                [copy addCurve:[edge clone]];
+            [result addContour:copy];
+        }
+    }
+    return result;
+}
 
-    // Walk the crossings and actually compute the final result for the intersecting parts
-    FBBezierGraph *allParts = [self bezierGraphFromIntersections];
-    [self unionNonintersectingPartsIntoGraph:allParts withGraph:graph];
+- (NSDictionary *) bezierGraphsWithOperations:(FBBooleanOperations)operations bezierGraph:(FBBezierGraph *)graph
+{
+    // Finding and cleaning up the crossings is the expensive part of all the operations,
+    //  and doesn't depend on the operation. So do it once, then walk the crossings once
+    //  for each of the requested results. XOR is made from the union and the intersect,
+    //  so those get computed for it even if they weren't asked for.
+    if ( [self usesPolygonClipperWithBezierGraph:graph] )
+        return [self polygonGraphsWithOperations:operations bezierGraph:graph];
     
-    [self markAllCrossingsAsUnprocessed];
-    [graph markAllCrossingsAsUnprocessed];
+    NSMutableDictionary *results = [NSMutableDictionary dictionaryWithCapacity:4];
+    [self insertCrossingsForOperationsWithBezierGraph:graph];
     
-    // Handle the parts of the graphs that intersect first. Mark the parts
-    //  of the graphs that are inside the other for the final result.
-    [self markCrossingsAsEntryOrExitWithBezierGraph:graph markInside:YES];
-    [graph markCrossingsAsEntryOrExitWithBezierGraph:self markInside:YES];
+    BOOL needsUnion = (operations & (FBBooleanOperationsUnion | FBBooleanOperationsXOR)) != 0;
+    BOOL needsIntersect = (operations & (FBBooleanOperationsIntersect | FBBooleanOperationsXOR)) != 0;
+    BOOL needsDifference = (operations & FBBooleanOperationsDifference) != 0;
+    FBBezierGraph *unionResult = nil;
+    FBBezierGraph *intersectResult = nil;
+    BOOL walkedCrossings = NO;
+    if ( needsUnion ) {
+        unionResult = [self unionFromCrossingsWithBezierGraph:graph];
+        walkedCrossings = YES;
+    }
+    if ( needsIntersect ) {
+        if ( walkedCrossings ) {
+            [self markAllCrossingsAsUnprocessed];
+            [graph markAllCrossingsAsUnprocessed];
+        }
+        intersectResult = [self intersectFromCrossingsWithBezierGraph:graph];
+        walkedCrossings = YES;
+    }
+    if ( needsDifference ) {
+        if ( walkedCrossings ) {
+            [self markAllCrossingsAsUnprocessed];
+            [graph markAllCrossingsAsUnprocessed];
+        }
+        results[@(FBBooleanOperationDifference)] = [self differenceFromCrossingsWithBezierGraph:graph];
+    }
+    
+    // Only where the graphs overlap do the union and the intersect share edges. Then XOR
+    //  has to subtract one from the other for real.
+    BOOL hasOverlaps = [self hasOverlaps];
+    
+    [self removeCrossingsForOperationsWithBezierGraph:graph];
+
+    if ( (operations & FBBooleanOperationsUnion) != 0 )
+        results[@(FBBooleanOperationUnion)] = unionResult;
+    if ( (operations & FBBooleanOperationsIntersect) != 0 )
+        results[@(FBBooleanOperationIntersect)] = intersectResult;
+    if ( (operations & FBBooleanOperationsXOR) != 0 ) {
+        // The subtraction is done after the crossings are gone from the inputs, because
+        //  the results share the contours that didn't cross anything with them.
+        if ( hasOverlaps )
+            results[@(FBBooleanOperationXOR)] = [unionResult differenceWithBezierGraph:intersectResult];
+        else
+            results[@(FBBooleanOperationXOR)] = [self xorWithUnion:unionResult intersect:intersectResult];
+    }
+    
+    return results;
+}
 
-    FBBezierGraph *intersectingParts = [self bezierGraphFromIntersections];
-    [self intersectNonintersectingPartsIntoGraph:intersectingParts withGraph:graph];
+- (void) insertCrossingsForOperationsWithBezierGraph:(FBBezierGraph *)graph
+{
+    // First insert FBEdgeCrossings into both graphs where the graphs cross.
+    FBProfileMark mark = FBProfileBeginPhase(FBProfilePhaseCrossingInsertion);
+    [self insertCrossingsWithBezierGraph:graph];
+    FBProfileEndPhase(FBProfilePhaseCrossingInsertion, mark);
     
+    mark = FBProfileBeginPhase(FBProfilePhaseSelfCrossings);
+    [self insertSelfCrossings];
+    [graph insertSelfCrossings];
+    FBProfileEndPhase(FBProfilePhaseSelfCrossings, mark);
+    
+    mark = FBProfileBeginPhase(FBProfilePhaseCleanup);
+    [self cleanupCrossingsWithBezierGraph:graph];
+    FBProfileEndPhase(FBProfilePhaseCleanup, mark);
+}
+
+- (void) removeCrossingsForOperationsWithBezierGraph:(FBBezierGraph *)graph
+{
     // Clean up crossings so the graphs can be reused, e.g. XOR will reuse graphs.
     [self removeCrossings];
     [graph removeCrossings];
     [self removeOverlaps];
     [graph removeOverlaps];
+}
 
-    return [allParts differenceWithBezierGraph:intersectingParts];
+- (FBBezierGraph *) bezierGraphWithOperation:(FBBooleanOperation)operation bezierGraph:(FBBezierGraph *)graph
+{
+    switch (operation) {
+        case FBBooleanOperationUnion:
+            return [self unionWithBezierGraph:graph];
+        case FBBooleanOperationIntersect:
+            return [self intersectWithBezierGraph:graph];
+        case FBBooleanOperationDifference:
+            return [self differenceWithBezierGraph:graph];
+        case FBBooleanOperationXOR:
+            return [self xorWithBezierGraph:graph];
+    }
+    return nil;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Polygons
+//
+// When every edge of both graphs is a straight line, none of the curve
+//  machinery is needed. The graphs are handed to FBPolygonClipper as plain
+//  points instead, which splits the segments where they meet and sweeps
+//  across them once per operation, and the result comes back as a graph of
+//  lines like any other.
+//
+// The same goes for curves when the result only has to be good to some
+//  tolerance, like for a preview: the curves are first cut into lines close
+//  to them.
+//
+// Polygons too big for one go, like maps, are combined in tiles, see
+//  FBPolygonCreateWithOperationInTiles().
+//
+// The approximate and the tiled operations always take the clipper. The
+//  regular operations only do when it's switched on, see
+//  FBBezierGraph+Benchmark.h, as the clipper starts the result's contours at
+//  other points and puts them in another order than the curve code does.
+//
+
+- (BOOL) usesPolygonClipperWithBezierGraph:(FBBezierGraph *)graph
+{
+    // A prepared graph keeps its work for the curve code, which the clipper wouldn't use
+    if ( !FBBezierGraphUsesPolygonClipper || self.isPrepared || graph.isPrepared )
+        return NO;
+    return self.isPolygon && graph.isPolygon;
+}
+
+- (BOOL) isPolygon
+{
+    for (FBBezierContour *contour in _contours) {
+        for (FBBezierCurve *edge in contour.edges) {
+            if ( !edge.isStraightLine )
+                return NO;
+        }
+    }
+    return YES;
+}
+
+- (FBPolygonRef) createPolygon
+{
+    return [self createPolygonWithTolerance:0.0];
+}
+
+- (FBPolygonRef) createPolygonWithTolerance:(CGFloat)tolerance
+{
+    // Curves are cut into lines that stay within tolerance of them. Returns NULL if some
+    //  curve would take so many lines that the exact operation is cheaper.
+    NSUInteger pointCount = 0;
+    for (FBBezierContour *contour in _contours) {
+        for (FBBezierCurve *edge in contour.edges) {
+            FBBezierCurveData data = edge.data;
+            NSUInteger segmentCount = FBBezierCurveDataGetFlatteningSegmentCount(&data, tolerance);
+            if ( segmentCount > FBBezierGraphMaximumFlatteningSegmentCount )
+                return NULL;
+            pointCount += segmentCount;
+        }
+    }
+    
+    CGPoint *points = malloc(MAX(pointCount, (NSUInteger)1) * sizeof(CGPoint));
+    NSUInteger *contourPointCounts = malloc(MAX(_contours.count, (NSUInteger)1) * sizeof(NSUInteger));
+    NSUInteger pointIndex = 0;
+    for (NSUInteger contourIndex = 0; contourIndex < _contours.count; contourIndex++) {
+        NSUInteger contourStart = pointIndex;
+        for (FBBezierCurve *edge in [_contours[contourIndex] edges]) {
+            FBBezierCurveData data = edge.data;
+            NSUInteger segmentCount = FBBezierCurveDataGetFlatteningSegmentCount(&data, tolerance);
+            points[pointIndex++] = data.endPoint1;
+            for (NSUInteger i = 1; i < segmentCount; i++)
+                points[pointIndex++] = FBBezierCurveDataPointAtParameter(data, (CGFloat)i / segmentCount, NULL, NULL);
+        }
+        contourPointCounts[contourIndex] = pointIndex - contourStart;
+    }
+    FBPolygonRef polygon = FBPolygonCreate(points, contourPointCounts, _contours.count);
+    free(points);
+    free(contourPointCounts);
+    return polygon;
+}
+
++ (FBBezierGraph *) bezierGraphWithPolygon:(FBPolygonRef)polygon
+{
+    FBBezierGraph *graph = [FBBezierGraph bezierGraph];
+    for (NSUInteger contourIndex = 0; contourIndex < FBPolygonGetContourCount(polygon); contourIndex++) {
+        NSUInteger count = 0;
+        const CGPoint *points = FBPolygonGetContourPoints(polygon, contourIndex, &count);
+        FBBezierContour *contour = [[FBBezierContour alloc] init];
+        for (NSUInteger i = 0; i < count; i++)
+            [contour addCurve:[FBBezierCurve bezierCurveWithLineStartPoint:points[i] endPoint:points[(i + 1) % count]]];
+        [graph addContour:contour];
+    }
+    return graph;
+}
+
+- (NSDictionary *) polygonGraphsWithOperations:(FBBooleanOperations)operations bezierGraph:(FBBezierGraph *)graph
+{
+    NSMutableDictionary *results = [NSMutableDictionary dictionaryWithCapacity:4];
+    FBProfileMark mark = FBProfileBeginPhase(FBProfilePhasePolygonClipping);
+    FBPolygonRef polygon1 = [self createPolygon];
+    FBPolygonRef polygon2 = [graph createPolygon];
+    for (FBBooleanOperation operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+        if ( (operations & (1 << operation)) == 0 )
+            continue;
+        FBPolygonRef result = FBPolygonCreateWithOperation(polygon1, polygon2, operation);
+        results[@(operation)] = [FBBezierGraph bezierGraphWithPolygon:result];
+        FBPolygonRelease(result);
+    }
+    FBPolygonRelease(polygon1);
+    FBPolygonRelease(polygon2);
+    FBProfileEndPhase(FBProfilePhasePolygonClipping, mark);
+    return results;
+}
+
+- (FBBezierGraph *) bezierGraphWithOperation:(FBBooleanOperation)operation bezierGraph:(FBBezierGraph *)graph tolerance:(CGFloat)tolerance
+{
+    if ( tolerance <= 0.0 )
+        return [self bezierGraphWithOperation:operation bezierGraph:graph];
+    
+    // Flattening moves every outline by no more than tolerance, and the polygons are then
+    //  combined exactly, so that's all the error there is. There are no crossings to converge
+    //  on and no overlaps to detect, which is where the exact operation spends its time.
+    FBBezierGraph *result = nil;
+    FBProfileMark mark = FBProfileBeginPhase(FBProfilePhasePolygonClipping);
+    FBPolygonRef polygon1 = [self createPolygonWithTolerance:tolerance];
+    FBPolygonRef polygon2 = polygon1 != NULL ? [graph createPolygonWithTolerance:tolerance] : NULL;
+    if ( polygon1 != NULL && polygon2 != NULL ) {
+        FBPolygonRef polygon = FBPolygonCreateWithOperation(polygon1, polygon2, operation);
+        result = [FBBezierGraph bezierGraphWithPolygon:polygon];
+        FBPolygonRelease(polygon);
+    }
+    FBPolygonRelease(polygon1);
+    FBPolygonRelease(polygon2);
+    FBProfileEndPhase(FBProfilePhasePolygonClipping, mark);
+    
+    if ( result == nil )
+        result = [self bezierGraphWithOperation:operation bezierGraph:graph];
+    return result;
+}
+
+- (FBBezierGraph *) bezierGraphWithOperation:(FBBooleanOperation)operation bezierGraph:(FBBezierGraph *)graph tileSize:(CGFloat)tileSize
+{
+    if ( tileSize <= 0.0 || !self.isPolygon || !graph.isPolygon )
+        return [self bezierGraphWithOperation:operation bezierGraph:graph];
+    
+    // The tiles are combined one at a time per processor, so only that many tiles' worth
+    //  of pieces are ever swept at once, however big the polygons are
+    FBProfileMark mark = FBProfileBeginPhase(FBProfilePhasePolygonClipping);
+    FBPolygonRef polygon1 = [self createPolygon];
+    FBPolygonRef polygon2 = [graph createPolygon];
+    FBPolygonRef polygon = FBPolygonCreateWithOperationInTiles(polygon1, polygon2, operation, tileSize, FBThreadPoolGetShared());
+    FBBezierGraph *result = [FBBezierGraph bezierGraphWithPolygon:polygon];
+    FBPolygonRelease(polygon);
+    FBPolygonRelease(polygon1);
+    FBPolygonRelease(polygon2);
+    FBProfileEndPhase(FBProfilePhasePolygonClipping, mark);
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Combining many graphs
+//
+// Chaining two graph operations over N graphs intersects the growing result with
+//  every new graph, so the total work is quadratic in N. Union, intersect and XOR
+//  don't care about the order of their operands, so instead we sort the graphs
+//  so neighbors are close together, and combine them pairwise in a balanced tree.
+//  Each graph then only takes part in log N operations, and most of those are
+//  between small, nearby results rather than against everything seen so far.
+//  The results of one level are used as graphs directly for the next, without
+//  going through a CGPath.
+//
+
++ (FBBezierGraph *) bezierGraphByCombiningGraphs:(NSArray *)graphs operation:(FBBooleanOperation)operation
+{
+    if ( graphs.count == 0 )
+        return [FBBezierGraph bezierGraph];
+    if ( graphs.count == 1 )
+        return graphs[0];
+    
+    // A difference is the first graph minus everything else
+    if ( operation == FBBooleanOperationDifference ) {
+        FBBezierGraph *others = [self bezierGraphByCombiningGraphs:[graphs subarrayWithRange:NSMakeRange(1, graphs.count - 1)] operation:FBBooleanOperationUnion];
+        return [graphs[0] differenceWithBezierGraph:others];
+    }
+    
+    // Sort the graphs along the longer side of the bounds of all of them
+    CGRect bounds = CGRectNull;
+    for (FBBezierGraph *graph in graphs)
+        bounds = CGRectUnion(bounds, graph.bounds);
+    BOOL sortByX = CGRectGetWidth(bounds) >= CGRectGetHeight(bounds);
+    NSArray *sortedGraphs = [graphs sortedArrayUsingComparator:^NSComparisonResult(FBBezierGraph *graph1, FBBezierGraph *graph2) {
+        CGFloat center1 = sortByX ? CGRectGetMidX(graph1.bounds) : CGRectGetMidY(graph1.bounds);
+        CGFloat center2 = sortByX ? CGRectGetMidX(graph2.bounds) : CGRectGetMidY(graph2.bounds);
+        if ( center1 < center2 )
+            return NSOrderedAscending;
+        return center1 > center2 ? NSOrderedDescending : NSOrderedSame;
+    }];
+    
+    return [self bezierGraphByCombiningGraphs:sortedGraphs inRange:NSMakeRange(0, sortedGraphs.count) operation:operation];
+}
+
++ (FBBezierGraph *) bezierGraphByCombiningGraphs:(NSArray *)graphs inRange:(NSRange)range operation:(FBBooleanOperation)operation
+{
+    if ( range.length == 1 )
+        return graphs[range.location];
+    
+    NSUInteger half = range.length / 2;
+    FBBezierGraph *left = [self bezierGraphByCombiningGraphs:graphs inRange:NSMakeRange(range.location, half) operation:operation];
+    
+    // Once an intersection is empty, it stays empty
+    if ( operation == FBBooleanOperationIntersect && left.contours.count == 0 )
+        return left;
+    
+    FBBezierGraph *right = [self bezierGraphByCombiningGraphs:graphs inRange:NSMakeRange(range.location + half, range.length - half) operation:operation];
+    if ( operation == FBBooleanOperationIntersect && (right.contours.count == 0 || !FBLineBoundsMightOverlap(left.bounds, right.bounds)) )
+        return [FBBezierGraph bezierGraph];
+    
+    return [left bezierGraphWithOperation:operation bezierGraph:right];
 }
 
 - (CGPathRef) path
 {
-    // Convert this graph into a bezier path. This is straightforward, each contour
-    //  starting with a move to and each subsequent edge being translated by doing
-    //  a curve to.
     // Be sure to mark the winding rule as even odd, or interior contours (holes)
     //  won't get filled/left alone properly.
     CGMutablePathRef path = CGPathCreateMutable();
 //    path.windingRule = NSEvenOddWindingRule;
+    [self enumeratePathElementsUsingFunction:FBBezierGraphAppendPathElementToCGPath context:path];
+    return path;
+}
 
-    for (FBBezierContour *contour in _contours) 
-	{
-        BOOL firstPoint = YES;        
-        for (FBBezierCurve *edge in contour.edges)
-		{
+- (void) enumeratePathElementsUsingFunction:(FBPathElementFunction)function context:(void *)context
+{
+    // Convert this graph into path elements. This is straightforward, each contour
+    //  starting with a move to and each subsequent edge being translated by doing
+    //  a curve to. The elements are handed out as they're made, so nothing has to
+    //  hold on to all of them.
+    for (FBBezierContour *contour in _contours) {
+        BOOL firstPoint = YES;
+        for (FBBezierCurve *edge in contour.edges) {
             if ( firstPoint ) {
-				CGPathMoveToPoint(path, NULL, edge.endPoint1.x, edge.endPoint1.y);
+                FBPathElement moveTo = { FBPathElementMoveToPoint, { edge.endPoint1 } };
+                function(&moveTo, context);
                 firstPoint = NO;
             }
             
-			if( edge.isStraightLine)
-				CGPathAddLineToPoint(path, NULL, edge.endPoint2.x, edge.endPoint2.y);
-			else
-				CGPathAddCurveToPoint(path, NULL, edge.controlPoint1.x, edge.controlPoint1.y, edge.controlPoint2.x, edge.controlPoint2.y, edge.endPoint2.x, edge.endPoint2.y);
+            if ( edge.isStraightLine ) {
+                FBPathElement lineTo = { FBPathElementAddLineToPoint, { edge.endPoint2 } };
+                function(&lineTo, context);
+            } else {
+                FBPathElement curveTo = { FBPathElementAddCurveToPoint, { edge.controlPoint1, edge.controlPoint2, edge.endPoint2 } };
+                function(&curveTo, context);
+            }
         }
-		CGPathCloseSubpath(path);	// GPC: close each contour
+        FBPathElement close = { FBPathElementCloseSubpath };
+        function(&close, context);	// GPC: close each contour
     }
-    
-    return path;
 }
 
 - (void) insertCrossingsWithBezierGraph:(FBBezierGraph *)other
 {
     // Find all intersections and, if they cross the other graph, create crossings for them, and insert
-    //  them into each graph's edges.
-    for (FBBezierContour *ourContour in self.contours) {
-        for (FBBezierContour *theirContour in other.contours) {
-            FBContourOverlap *overlap = [FBContourOverlap contourOverlap];
-
-            for (FBBezierCurve *ourEdge in ourContour.edges) {
-               for (FBBezierCurve *theirEdge in theirContour.edges) {
-                    // Find all intersections between these two edges (curves)
-                    FBBezierIntersectRange *intersectRange = nil;
-                    [ourEdge intersectionsWithBezierCurve:theirEdge overlapRange:&intersectRange withBlock:^(FBBezierIntersection *intersection, BOOL *stop) {
-                        // If this intersection happens at one of the ends of the edges, then mark
-                        //  that on the edge. We do this here because not all intersections create
-                        //  crossings, but we still need to know when the intersections fall on end points
-                        //  later on in the algorithm.
-                        if ( intersection.isAtStartOfCurve1 )
-                            ourEdge.startShared = YES;
-                        if ( intersection.isAtStopOfCurve1 )
-                            ourEdge.next.startShared = YES;
-                        if ( intersection.isAtStartOfCurve2 )
-                            theirEdge.startShared = YES;
-                        if ( intersection.isAtStopOfCurve2 )
-                            theirEdge.next.startShared = YES;
-                        
-                        // Don't add a crossing unless one edge actually crosses the other
-                        if ( ![ourEdge crossesEdge:theirEdge atIntersection:intersection] )
-                            return;
-                        
-                        // Add crossings to both graphs for this intersection, and point them at each other
-                        FBEdgeCrossing *ourCrossing = [FBEdgeCrossing crossingWithIntersection:intersection];
-                        FBEdgeCrossing *theirCrossing = [FBEdgeCrossing crossingWithIntersection:intersection];
-                        ourCrossing.counterpart = theirCrossing;
-                        theirCrossing.counterpart = ourCrossing;
-                        [ourEdge addCrossing:ourCrossing];
-                        [theirEdge addCrossing:theirCrossing];
-
-                    }];
-                    if ( intersectRange != nil )
-                        [overlap addOverlap:intersectRange forEdge1:ourEdge edge2:theirEdge];
-                } // end theirEdges                
-            } //end ourEdges
-            
-            // At this point we've found all intersections/overlaps between ourContour and theirContour
+    //  them into each graph's edges. Instead of comparing every edge to every other edge, we ask the
+    //  edge indexes for just the pairs of edges whose bounds overlap. Those are then sorted back into
+    //  the order a contour by contour, edge by edge walk would visit them in, because building up
+    //  the overlap runs depends on seeing the edges in order.
+    //
+    // The intersections themselves are all computed up front on plain curve data, spread over
+    //  all the processors. The scratch memory for that lives in this thread's arena, which is
+    //  reset in one go when we're done, keeping its memory around for the next operation.
+    //  Creating the crossings has to happen in order, since it changes the edges, so that
+    //  part stays on this thread.
+    FBArenaRef arena = FBArenaGetForCurrentThread();
+    NSUInteger pairCount = 0;
+    FBEdgeIndexPair *pairs = FBEdgeIndexCopyOverlappingPairs([self edgeIndex], [other edgeIndex], &pairCount);
+    qsort(pairs, pairCount, sizeof(FBEdgeIndexPair), FBCompareEdgePairsByContour);
+    
+    FBEdgeIntersections intersections = {};
+    FBEdgeIntersectionsFindConcurrently(arena, [self edgeTableInArena:arena], [other edgeTableInArena:arena], pairs, pairCount, YES, FBThreadPoolGetShared(), &intersections);
+    
+    NSUInteger pairIndex = 0;
+    NSUInteger intersectionIndex = 0;
+    while ( pairIndex < pairCount ) {
+        NSUInteger ourContourIndex = pairs[pairIndex].contourIndex1;
+        NSUInteger theirContourIndex = pairs[pairIndex].contourIndex2;
+        FBBezierContour *ourContour = _contours[ourContourIndex];
+        FBBezierContour *theirContour = other->_contours[theirContourIndex];
+        FBContourOverlap *overlap = [FBContourOverlap contourOverlap];
+
+        // All the edge pairs for these two contours are next to each other in the sorted list
+        for (; pairIndex < pairCount && pairs[pairIndex].contourIndex1 == ourContourIndex && pairs[pairIndex].contourIndex2 == theirContourIndex; pairIndex++) {
+            FBBezierCurve *ourEdge = ourContour.edges[pairs[pairIndex].edgeIndex1];
+            FBBezierCurve *theirEdge = theirContour.edges[pairs[pairIndex].edgeIndex2];
             
-            // Determine if the overlaps constitute crossings
-            if ( ![overlap isComplete] ) {
-                // The contours aren't equivalent so see if they're crossings
-                [overlap runsWithBlock:^(FBEdgeOverlapRun *run, BOOL *stop) {
-                    if ( ![run isCrossing] )
-                        return;
-                    
-                    // The two ends of the overlap run should serve as crossings
-                    [run addCrossings];
-                }];
+            // Go through all intersections between these two edges (curves)
+            for (; intersectionIndex < intersections.count && intersections.intersections[intersectionIndex].pairIndex == pairIndex; intersectionIndex++) {
+                FBEdgeIntersection *edgeIntersection = &intersections.intersections[intersectionIndex];
+                FBBezierIntersection *intersection = [FBBezierIntersection intersectionWithCurve1:ourEdge parameter1:edgeIntersection->parameter1 curve2:theirEdge parameter2:edgeIntersection->parameter2];
+                
+                // If this intersection happens at one of the ends of the edges, then mark
+                //  that on the edge. We do this here because not all intersections create
+                //  crossings, but we still need to know when the intersections fall on end points
+                //  later on in the algorithm.
+                if ( intersection.isAtStartOfCurve1 )
+                    ourEdge.startShared = YES;
+                if ( intersection.isAtStopOfCurve1 )
+                    ourEdge.next.startShared = YES;
+                if ( intersection.isAtStartOfCurve2 )
+                    theirEdge.startShared = YES;
+                if ( intersection.isAtStopOfCurve2 )
+                    theirEdge.next.startShared = YES;
+                
+                // Don't add a crossing unless one edge actually crosses the other
+                if ( ![ourEdge crossesEdge:theirEdge atIntersection:intersection] )
+                    continue;
+                
+                // Add crossings to both graphs for this intersection, and point them at each other
+                FBEdgeCrossing *ourCrossing = [FBEdgeCrossing crossingWithIntersection:intersection];
+                FBEdgeCrossing *theirCrossing = [FBEdgeCrossing crossingWithIntersection:intersection];
+                ourCrossing.counterpart = theirCrossing;
+                theirCrossing.counterpart = ourCrossing;
+                [ourEdge addCrossing:ourCrossing];
+                [theirEdge addCrossing:theirCrossing];
             }
             
-            [ourContour addOverlap:overlap];
-            [theirContour addOverlap:overlap];
-        } // end theirContours
-    } // end ourContours 
+            FBBezierCurveDataOverlap *edgeOverlap = &intersections.overlaps[pairIndex];
+            if ( edgeOverlap->hasOverlap ) {
+                FBBezierIntersectRange *intersectRange = [FBBezierIntersectRange intersectRangeWithCurve1:ourEdge parameterRange1:edgeOverlap->parameterRange1 curve2:theirEdge parameterRange2:edgeOverlap->parameterRange2 reversed:edgeOverlap->reversed];
+                [overlap addOverlap:intersectRange forEdge1:ourEdge edge2:theirEdge];
+            }
+        } // end edge pairs
+        
+        // At this point we've found all intersections/overlaps between ourContour and theirContour
+        
+        // Determine if the overlaps constitute crossings
+        if ( ![overlap isComplete] ) {
+            // The contours aren't equivalent so see if they're crossings
+            [overlap runsWithBlock:^(FBEdgeOverlapRun *run, BOOL *stop) {
+                if ( ![run isCrossing] )
+                    return;
+                
+                // The two ends of the overlap run should serve as crossings
+                [run addCrossings];
+            }];
+        }
+        
+        [ourContour addOverlap:overlap];
+        [theirContour addOverlap:overlap];
+    } // end contour pairs
+    
+    free(pairs);
+    FBArenaReset(arena);
 }
 
 - (void) cleanupCrossingsWithBezierGraph:(FBBezierGraph *)other
@@ -704,64 +1354,111 @@
 
 - (void) insertSelfCrossings
 {
-    // Find all intersections and, if they cross other contours in this graph, create crossings for them, and insert
-    //  them into each contour's edges.
-    NSMutableArray *remainingContours = [self.contours mutableCopy];
-    while ( remainingContours.count > 0 ) {
-        FBBezierContour *firstContour = remainingContours.lastObject;
-        for (FBBezierContour *secondContour in remainingContours) {
-            // We don't handle self-intersections on the contour this way, so skip them here
-            if ( firstContour == secondContour )
-                continue;
-
-            if ( !FBLineBoundsMightOverlap(firstContour.boundingRect, secondContour.boundingRect) || !FBLineBoundsMightOverlap(firstContour.bounds, secondContour.bounds) )
-                continue;
-            
-            // Compare all the edges between these two contours looking for crossings
-            for (FBBezierCurve *firstEdge in firstContour.edges) {
-                for (FBBezierCurve *secondEdge in secondContour.edges) {
-                    // Find all intersections between these two edges (curves)
-                    [firstEdge intersectionsWithBezierCurve:secondEdge overlapRange:nil withBlock:^(FBBezierIntersection *intersection, BOOL *stop) {
-                        // If this intersection happens at one of the ends of the edges, then mark
-                        //  that on the edge. We do this here because not all intersections create
-                        //  crossings, but we still need to know when the intersections fall on end points
-                        //  later on in the algorithm.
-                        if ( intersection.isAtStartOfCurve1 )
-                            firstEdge.startShared = YES;
-                        else if ( intersection.isAtStopOfCurve1 )
-                            firstEdge.next.startShared = YES;
-                        if ( intersection.isAtStartOfCurve2 )
-                            secondEdge.startShared = YES;
-                        else if ( intersection.isAtStopOfCurve2 )
-                            secondEdge.next.startShared = YES;
-                        
-                        // Don't add a crossing unless one edge actually crosses the other
-                        if ( ![firstEdge crossesEdge:secondEdge atIntersection:intersection] )
-                            return;
-                        
-                        // Add crossings to both graphs for this intersection, and point them at each other
-                        FBEdgeCrossing *firstCrossing = [FBEdgeCrossing crossingWithIntersection:intersection];
-                        FBEdgeCrossing *secondCrossing = [FBEdgeCrossing crossingWithIntersection:intersection];
-                        firstCrossing.selfCrossing = YES;
-                        secondCrossing.selfCrossing = YES;
-                        firstCrossing.counterpart = secondCrossing;
-                        secondCrossing.counterpart = firstCrossing;
-                        [firstEdge addCrossing:firstCrossing];
-                        [secondEdge addCrossing:secondCrossing];
-                    }];
-                }
-            }
-        }
-        
-        // We just compared this contour to all the others, so we don't need to do it again
-        [remainingContours removeLastObject]; // do this at the end of the loop when we're done with it
+    // A prepared graph already knows where it crosses or touches itself and which of its
+    //  contours are holes, so it only has to put the crossings and the shared starts back.
+    //  The holes are set again anyway, in case a contour shared with a result graph was
+    //  classified in there since.
+    if ( self.isPrepared ) {
+        [self addSelfCrossingsWithIntersections:_preparedSelfIntersections];
+        for (FBBezierCurve *edge in _preparedSharedStarts)
+            edge.startShared = YES;
+        for (NSUInteger contourIndex = 0; contourIndex < _contours.count; contourIndex++)
+            [_contours[contourIndex] setInside:(FBContourInside)[_preparedInsides[contourIndex] integerValue]];
+        return;
     }
+    
+    [self addSelfCrossingsWithIntersections:[self selfCrossingIntersections]];
         
     // Go through and mark each contour if its a hole or filled region
     for (FBBezierContour *contour in _contours)
         contour.inside = [self contourInsides:contour];
 }
 
+- (NSArray *) selfCrossingIntersections
+{
+    // Find all intersections where contours in this graph cross each other. Like insertCrossingsWithBezierGraph:,
+    //  only the edge pairs the edge index says might overlap are tested. Each pair of contours is compared once,
+    //  starting with the last contour and comparing it to all the ones before it.
+    FBArenaRef arena = FBArenaGetForCurrentThread();
+    NSUInteger pairCount = 0;
+    FBEdgeIndexPair *pairs = FBEdgeIndexCopyOverlappingPairs([self edgeIndex], [self edgeIndex], &pairCount);
+    qsort(pairs, pairCount, sizeof(FBEdgeIndexPair), FBCompareEdgePairsBySelfContour);
+    
+    // Throw out the pairs we don't need to look at before computing any intersections
+    NSUInteger testCount = 0;
+    NSUInteger pairIndex = 0;
+    while ( pairIndex < pairCount ) {
+        NSUInteger firstContourIndex = pairs[pairIndex].contourIndex1;
+        NSUInteger secondContourIndex = pairs[pairIndex].contourIndex2;
+        
+        // We don't handle self-intersections on the contour this way, and we only need
+        //  to compare two contours one way round, so skip the rest here.
+        BOOL mightOverlap = NO;
+        if ( firstContourIndex > secondContourIndex ) {
+            FBBezierContour *firstContour = _contours[firstContourIndex];
+            FBBezierContour *secondContour = _contours[secondContourIndex];
+            mightOverlap = FBLineBoundsMightOverlap(firstContour.boundingRect, secondContour.boundingRect) && FBLineBoundsMightOverlap(firstContour.bounds, secondContour.bounds);
+        }
+        
+        for (; pairIndex < pairCount && pairs[pairIndex].contourIndex1 == firstContourIndex && pairs[pairIndex].contourIndex2 == secondContourIndex; pairIndex++) {
+            if ( mightOverlap )
+                pairs[testCount++] = pairs[pairIndex];
+        }
+    }
+    
+    FBEdgeTable *edgeTable = [self edgeTableInArena:arena];
+    FBEdgeIntersections intersections = {};
+    FBEdgeIntersectionsFindConcurrently(arena, edgeTable, edgeTable, pairs, testCount, NO, FBThreadPoolGetShared(), &intersections);
+    
+    // Go through the intersections between the remaining edge pairs looking for crossings
+    NSMutableArray *crossingIntersections = [NSMutableArray arrayWithCapacity:intersections.count];
+    for (NSUInteger intersectionIndex = 0; intersectionIndex < intersections.count; intersectionIndex++) {
+        FBEdgeIntersection *edgeIntersection = &intersections.intersections[intersectionIndex];
+        FBEdgeIndexPair *pair = &pairs[edgeIntersection->pairIndex];
+        FBBezierCurve *firstEdge = [_contours[pair->contourIndex1] edges][pair->edgeIndex1];
+        FBBezierCurve *secondEdge = [_contours[pair->contourIndex2] edges][pair->edgeIndex2];
+        FBBezierIntersection *intersection = [FBBezierIntersection intersectionWithCurve1:firstEdge parameter1:edgeIntersection->parameter1 curve2:secondEdge parameter2:edgeIntersection->parameter2];
+        
+        // If this intersection happens at one of the ends of the edges, then mark
+        //  that on the edge. We do this here because not all intersections create
+        //  crossings, but we still need to know when the intersections fall on end points
+        //  later on in the algorithm.
+        if ( intersection.isAtStartOfCurve1 )
+            firstEdge.startShared = YES;
+        else if ( intersection.isAtStopOfCurve1 )
+            firstEdge.next.startShared = YES;
+        if ( intersection.isAtStartOfCurve2 )
+            secondEdge.startShared = YES;
+        else if ( intersection.isAtStopOfCurve2 )
+            secondEdge.next.startShared = YES;
+        
+        // Don't add a crossing unless one edge actually crosses the other
+        if ( ![firstEdge crossesEdge:secondEdge atIntersection:intersection] )
+            continue;
+        
+        [crossingIntersections addObject:intersection];
+    }
+    
+    free(pairs);
+    FBArenaReset(arena);
+    return crossingIntersections;
+}
+
+- (void) addSelfCrossingsWithIntersections:(NSArray *)intersections
+{
+    for (FBBezierIntersection *intersection in intersections) {
+        // Add crossings to both contours for this intersection, and point them at each other
+        FBEdgeCrossing *firstCrossing = [FBEdgeCrossing crossingWithIntersection:intersection];
+        FBEdgeCrossing *secondCrossing = [FBEdgeCrossing crossingWithIntersection:intersection];
+        firstCrossing.selfCrossing = YES;
+        secondCrossing.selfCrossing = YES;
+        firstCrossing.counterpart = secondCrossing;
+        secondCrossing.counterpart = firstCrossing;
+        [intersection.curve1 addCrossing:firstCrossing];
+        [intersection.curve2 addCrossing:secondCrossing];
+    }
+}
+
 - (CGRect) bounds
 {
     // Compute the bounds of the graph by unioning together the bounds of the individual contours
@@ -792,9 +1489,15 @@
     CGPoint testPoint = testContour.testPointForContainment;
     CGPoint lineEndPoint = CGPointMake(testPoint.x > NSMinX(self.bounds) ? NSMinX(self.bounds) - 10 : NSMaxX(self.bounds) + 10, testPoint.y); /* just move us outside the bounds of the graph */
     FBBezierCurve *testCurve = [FBBezierCurve bezierCurveWithLineStartPoint:testPoint endPoint:lineEndPoint];
+    FBStatisticsIncrement(FBStatisticRaysCast);
+
+    // Only contours with an edge the ray passes near can be crossed by it
+    NSSet *nearContours = [self contoursNearRay:testCurve];
 
     NSUInteger intersectCount = 0;
     for (FBBezierContour *contour in self.contours) {
+        if ( ![nearContours containsObject:contour] )
+            continue;
         if ( contour == testContour || [contour crossesOwnContour:testContour] )
             continue; // don't test self intersections        
 
@@ -805,20 +1508,48 @@
 
 - (FBCurveLocation *) closestLocationToPoint:(CGPoint)point
 {
-    FBCurveLocation *closestLocation = nil;
+    // Only the edges whose bounds are nearer than the closest edge found so far are
+    //  projected onto, which the edge index narrows down to a handful.
+    const FBBezierCurveData *curves = [self edgeCurves];
+    FBBezierGraphClosestContext context = { curves, _edgeCurveOffsets, { NSNotFound, NSNotFound, {} } };
+    FBBezierGraphFindClosestEdge([self edgeIndex], point, &context);
+    return [self curveLocationWithClosestEdge:context.closestEdge];
+}
+
+- (NSArray *) closestLocationsToPoints:(const CGPoint *)points count:(NSUInteger)count
+{
+    FBEdgeIndexRef index = [self edgeIndex];
+    if ( FBEdgeIndexGetCount(index) == 0 )
+        return nil;
     
-    for (FBBezierContour *contour in _contours) {
-        FBCurveLocation *contourLocation = [contour closestLocationToPoint:point];
-        if ( contourLocation != nil && (closestLocation == nil || contourLocation.distance < closestLocation.distance) ) {
-            closestLocation = contourLocation;
-        }
-    }
+    const FBBezierCurveData *curves = [self edgeCurves];
+    FBBezierGraphClosestBatch batch = { index, curves, _edgeCurveOffsets, points, count, NULL };
+    batch.closestEdges = malloc(MAX(count, (NSUInteger)1) * sizeof(FBBezierGraphClosestEdge));
+    NSUInteger iterations = (count + FBBezierGraphClosestPointsPerIteration - 1) / FBBezierGraphClosestPointsPerIteration;
+    FBThreadPoolApply(FBThreadPoolGetShared(), iterations, FBBezierGraphFindClosestEdges, &batch);
     
-    if ( closestLocation == nil )
+    NSMutableArray *locations = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++)
+        [locations addObject:[self curveLocationWithClosestEdge:batch.closestEdges[i]]];
+    free(batch.closestEdges);
+    return locations;
+}
+
+- (void) containsPoints:(const CGPoint *)points count:(NSUInteger)count fillRule:(FBFillRule)fillRule results:(BOOL *)results
+{
+    FBScanlineIndexContainsPoints([self scanlineIndex], points, count, fillRule, FBThreadPoolGetShared(), results);
+}
+
+- (FBCurveLocation *) curveLocationWithClosestEdge:(FBBezierGraphClosestEdge)closestEdge
+{
+    if ( closestEdge.contourIndex == NSNotFound )
         return nil;
     
-    closestLocation.graph = self;
-    return closestLocation;
+    FBBezierContour *contour = _contours[closestEdge.contourIndex];
+    FBCurveLocation *curveLocation = [FBCurveLocation curveLocationWithEdge:contour.edges[closestEdge.edgeIndex] parameter:closestEdge.location.parameter distance:closestEdge.location.distance];
+    curveLocation.contour = contour;
+    curveLocation.graph = self;
+    return curveLocation;
 }
 
 - (CGPathRef) debugPathForContainmentOfContour:(FBBezierContour *)testContour
@@ -947,6 +1678,7 @@
         for (CGFloat y = NSMinY(testContour.bounds) + verticalSpacing; y < NSMaxY(testContour.bounds); y += verticalSpacing) {
             // Construct a line that will reach outside both ends of both the test contour and graph
             FBBezierCurve *ray = [FBBezierCurve bezierCurveWithLineStartPoint:CGPointMake(MIN(NSMinX(self.bounds), NSMinX(testContour.bounds)) - FBRayOverlap, y) endPoint:CGPointMake(MAX(NSMaxX(self.bounds), NSMaxX(testContour.bounds)) + FBRayOverlap, y)];
+            FBStatisticsIncrement(FBStatisticRaysCast);
             // Eliminate any contours that aren't containers. It's possible for this method to fail, so check the return
             BOOL eliminated = [self eliminateContainers:containers thatDontContainContour:testContour usingRay:ray];
             if ( eliminated )
@@ -958,6 +1690,7 @@
         for (CGFloat x = NSMinX(testContour.bounds) + horizontalSpacing; x < NSMaxX(testContour.bounds); x += horizontalSpacing) {
             // Construct a line that will reach outside both ends of both the test contour and graph
             FBBezierCurve *ray = [FBBezierCurve bezierCurveWithLineStartPoint:CGPointMake(x, MIN(NSMinY(self.bounds), NSMinY(testContour.bounds)) - FBRayOverlap) endPoint:CGPointMake(x, MAX(NSMaxY(self.bounds), NSMaxY(testContour.bounds)) + FBRayOverlap)];
+            FBStatisticsIncrement(FBStatisticRaysCast);
             // Eliminate any contours that aren't containers. It's possible for this method to fail, so check the return
             BOOL eliminated = [self eliminateContainers:containers thatDontContainContour:testContour usingRay:ray];
             if ( eliminated )
@@ -989,7 +1722,7 @@
     // First find all the intersections with the ray
     NSMutableArray *rayIntersections = [NSMutableArray arrayWithCapacity:9];
     for (FBBezierCurve *edge in testContour.edges) {
-        [ray intersectionsWithBezierCurve:edge overlapRange:nil withBlock:^(FBBezierIntersection *intersection, BOOL *stop) {
+        [ray rayIntersectionsWithBezierCurve:edge overlapRange:nil withBlock:^(FBBezierIntersection *intersection, BOOL *stop) {
             [rayIntersections addObject:intersection];
         }];
     }
@@ -1024,11 +1757,14 @@
 
     // Walk through each possible container, one at a time and see where it intersects
     NSMutableArray *ambiguousCrossings = [NSMutableArray arrayWithCapacity:10];
+    NSSet *nearContainers = [self contoursNearRay:ray];
     for (FBBezierContour *container in containers) {
+        if ( ![nearContainers containsObject:container] )
+            continue; // the ray doesn't come near any of its edges
         for (FBBezierCurve *containerEdge in container.edges) {
             // See where the ray intersects this particular edge
             __block BOOL ambigious = NO;
-            [ray intersectionsWithBezierCurve:containerEdge overlapRange:nil withBlock:^(FBBezierIntersection *intersection, BOOL *stop) {
+            [ray rayIntersectionsWithBezierCurve:containerEdge overlapRange:nil withBlock:^(FBBezierIntersection *intersection, BOOL *stop) {
                 if ( intersection.isTangent )
                     return; // tangents don't count
                 
@@ -1217,27 +1953,19 @@
         }
 }
 
-- (FBEdgeCrossing *) firstUnprocessedCrossing
+- (NSArray *) nonselfCrossings
 {
-    // Find the first crossing in our graph that has yet to be processed by the bezierGraphFromIntersections
-    //  method.
-    
+    // Collect the crossings with the other graph, in the order of our contours and edges
+    NSMutableArray *crossings = [NSMutableArray array];
     for (FBBezierContour *contour in _contours) {
         for (FBBezierCurve *edge in contour.edges) {
-            __block FBEdgeCrossing *unprocessedCrossing = nil;
             [edge crossingsWithBlock:^(FBEdgeCrossing *crossing, BOOL *stop) {
-                if ( crossing.isSelfCrossing )
-                    return;
-                if ( !crossing.isProcessed ) {
-                    unprocessedCrossing = crossing;
-                    *stop = YES;
-                }
+                if ( !crossing.isSelfCrossing )
+                    [crossings addObject:crossing];
             }];
-            if ( unprocessedCrossing != nil )
-                return unprocessedCrossing;
         }
     }
-    return nil;
+    return crossings;
 }
 
 - (FBBezierGraph *) bezierGraphFromIntersections
@@ -1251,8 +1979,15 @@
     
     FBBezierGraph *result = [FBBezierGraph bezierGraph];
     
+    // Crossings only ever go from unprocessed to processed while we walk. So rather than searching
+    //  all the edges from the start for an unprocessed crossing after each contour, gather the
+    //  crossings once and move through them with an index that never goes back. That finds the
+    //  same crossings in the same order, but in linear instead of quadratic time.
+    NSArray *crossings = [self nonselfCrossings];
+    NSUInteger crossingIndex = 0;
+    
     // Find the first crossing to start one
-    FBEdgeCrossing *crossing = [self firstUnprocessedCrossing];
+    FBEdgeCrossing *crossing = FBNextUnprocessedCrossing(crossings, &crossingIndex);
     while ( crossing != nil ) {
         // This is the start of a contour, so create one
         FBBezierContour *contour = [[FBBezierContour alloc] init];
@@ -1304,7 +2039,7 @@
         }
         
         // See if there's another contour that we need to handle
-        crossing = [self firstUnprocessedCrossing];
+        crossing = FBNextUnprocessedCrossing(crossings, &crossingIndex);
     }
     
     return result;
@@ -1313,10 +2048,15 @@
 - (void) removeCrossings
 {
     // Crossings only make sense for the intersection between two specific graphs. In order for this
-    //  graph to be usable in the future, remove all the crossings
-    for (FBBezierContour *contour in _contours)
-        for (FBBezierCurve *edge in contour.edges)
+    //  graph to be usable in the future, remove all the crossings, and forget which edges start
+    //  where the other graph touched them too. Self crossings and touches mark theirs again when
+    //  they're put back.
+    for (FBBezierContour *contour in _contours) {
+        for (FBBezierCurve *edge in contour.edges) {
             [edge removeAllCrossings];
+            edge.startShared = NO;
+        }
+    }
 }
 
 - (void) removeOverlaps
@@ -1325,11 +2065,137 @@
         [contour removeAllOverlaps];
 }
 
+- (BOOL) hasOverlaps
+{
+    // Is any part of an edge of ours on top of an edge of the other graph?
+    __block BOOL hasOverlaps = NO;
+    for (FBBezierContour *contour in _contours) {
+        [contour forEachEdgeOverlapDo:^(FBEdgeOverlap *overlap) {
+            hasOverlaps = YES;
+        }];
+        if ( hasOverlaps )
+            return YES;
+    }
+    return NO;
+}
+
 - (void) addContour:(FBBezierContour *)contour
 {
-    // Add a contour to ouselves, and force the bounds to be recalculated
+    // Add a contour to ouselves, and force the bounds and edge index to be recalculated
     [_contours addObject:contour];
     _bounds = CGRectZero;
+    FBEdgeIndexRelease(_edgeIndex);
+    _edgeIndex = NULL;
+    free(_edgeCurves);
+    _edgeCurves = NULL;
+    free(_edgeCurveOffsets);
+    _edgeCurveOffsets = NULL;
+    FBScanlineIndexRelease(_scanlineIndex);
+    _scanlineIndex = NULL;
+    [self unprepare];
+}
+
+- (FBEdgeIndexRef) edgeIndex
+{
+    // The edge index is built lazily, the first time a boolean operation needs it, and then
+    //  kept until another contour is added. By the time anyone asks for it the graph has
+    //  been fully built, so the edges aren't going to change underneath it.
+    if ( _edgeIndex != NULL )
+        return _edgeIndex;
+    
+    NSUInteger count = 0;
+    for (FBBezierContour *contour in _contours)
+        count += contour.edges.count;
+    
+    FBEdgeIndexEntry *entries = malloc(MAX(count, (NSUInteger)1) * sizeof(FBEdgeIndexEntry));
+    NSUInteger entryIndex = 0;
+    for (NSUInteger contourIndex = 0; contourIndex < _contours.count; contourIndex++) {
+        NSArray *edges = [_contours[contourIndex] edges];
+        for (NSUInteger edgeIndex = 0; edgeIndex < edges.count; edgeIndex++) {
+            FBBezierCurve *edge = edges[edgeIndex];
+            entries[entryIndex].bounds = edge.boundingRect;
+            entries[entryIndex].contourIndex = contourIndex;
+            entries[entryIndex].edgeIndex = edgeIndex;
+            entryIndex++;
+        }
+    }
+    _edgeIndex = FBEdgeIndexCreate(entries, count);
+    free(entries);
+    
+    return _edgeIndex;
+}
+
+- (const FBBezierCurveData *) edgeCurves
+{
+    // A copy of the curve data of every edge, contour by contour, so the closest point
+    //  searches can run on any thread without going through the edge objects. Like the
+    //  edge index, it's built the first time it's needed and kept until a contour is added.
+    if ( _edgeCurves != NULL )
+        return _edgeCurves;
+    
+    NSUInteger count = 0;
+    _edgeCurveOffsets = malloc(MAX(_contours.count, (NSUInteger)1) * sizeof(NSUInteger));
+    for (NSUInteger contourIndex = 0; contourIndex < _contours.count; contourIndex++) {
+        _edgeCurveOffsets[contourIndex] = count;
+        count += [_contours[contourIndex] edges].count;
+    }
+    
+    _edgeCurveCount = count;
+    _edgeCurves = malloc(MAX(count, (NSUInteger)1) * sizeof(FBBezierCurveData));
+    for (NSUInteger contourIndex = 0; contourIndex < _contours.count; contourIndex++) {
+        NSArray *edges = [_contours[contourIndex] edges];
+        for (NSUInteger edgeIndex = 0; edgeIndex < edges.count; edgeIndex++)
+            _edgeCurves[_edgeCurveOffsets[contourIndex] + edgeIndex] = [edges[edgeIndex] data];
+    }
+    
+    return _edgeCurves;
+}
+
+- (FBScanlineIndexRef) scanlineIndex
+{
+    // Built from the edge curves the first time points are tested, and kept with them
+    if ( _scanlineIndex != NULL )
+        return _scanlineIndex;
+    
+    const FBBezierCurveData *curves = [self edgeCurves];
+    _scanlineIndex = FBScanlineIndexCreate(curves, _edgeCurveCount);
+    return _scanlineIndex;
+}
+
+- (NSSet *) contoursNearRay:(FBBezierCurve *)ray
+{
+    // The containment tests cast a lot of rays through the graph, and most contours aren't
+    //  anywhere near any one ray. Ask the edge index which edges the ray could hit, and
+    //  return the contours they belong to, so only those have to be tested edge by edge.
+    NSMutableSet *nearContours = [NSMutableSet setWithCapacity:8];
+    FBBezierGraphRayContext context = { _contours, nearContours };
+    FBEdgeIndexEnumerateEntriesInRect([self edgeIndex], ray.boundingRect, FBBezierGraphCollectContourNearRay, &context);
+    return nearContours;
+}
+
+- (FBEdgeTable *) edgeTableInArena:(FBArenaRef)arena
+{
+    // Copy the curve data of every edge into one flat table, so the intersection code
+    //  can run over it without going through the edge objects. A prepared graph made
+    //  its table once, in its own arena, and hands out that one.
+    if ( _preparedEdgeTable != NULL )
+        return _preparedEdgeTable;
+    
+    NSUInteger *edgeCounts = FBArenaAllocate(arena, MAX(_contours.count, (NSUInteger)1) * sizeof(NSUInteger));
+    for (NSUInteger contourIndex = 0; contourIndex < _contours.count; contourIndex++)
+        edgeCounts[contourIndex] = [_contours[contourIndex] edges].count;
+    
+    FBEdgeTable *table = FBEdgeTableCreate(arena, edgeCounts, _contours.count);
+    for (NSUInteger contourIndex = 0; contourIndex < _contours.count; contourIndex++) {
+        NSArray *edges = [_contours[contourIndex] edges];
+        for (NSUInteger edgeIndex = 0; edgeIndex < edges.count; edgeIndex++)
+            *FBEdgeTableGetCurve(table, contourIndex, edgeIndex) = [edges[edgeIndex] data];
+    }
+    
+    // Curves with bulges or loops are cheaper to intersect piece by piece
+    FBEdgeTableSplitIntoMonotonePieces(arena, table);
+    
+    return table;
 }
 
 - (NSArray *) nonintersectingContours
@@ -1415,3 +2281,17 @@
 }
 
 @end
+
+@implementation FBBezierGraph (Benchmark)
+
++ (BOOL) usesPolygonClipper
+{
+    return FBBezierGraphUsesPolygonClipper;
+}
+
++ (void) setUsesPolygonClipper:(BOOL)usesPolygonClipper
+{
+    FBBezierGraphUsesPolygonClipper = usesPolygonClipper;
+}
+
+@end
@@ -8,21 +8,27 @@
 
 #import <Foundation/Foundation.h>
 #import <CoreGraphics/CoreGraphics.h>
+#import "FBBezierCurveData.h"
 
 @class FBBezierCurve;
 
 // FBBezierIntersection stores where two bezier curves intersect. Initially it just stores
 //  the curves and the parameter values where they intersect. It can lazily compute
 //  the 2D point where they intersect, the left and right parts of the curves relative to
-//  the intersection point, if the intersection is tangent. 
+//  the intersection point, if the intersection is tangent. The left and right parts are
+//  kept as plain curve data, and only wrapped in FBBezierCurve objects if someone asks.
 @interface FBBezierIntersection : NSObject {
     CGPoint _location;
     FBBezierCurve *_curve1;
     CGFloat _parameter1;
+    FBBezierCurveData _curve1LeftData;
+    FBBezierCurveData _curve1RightData;
     FBBezierCurve *_curve1LeftBezier;
     FBBezierCurve *_curve1RightBezier;
     FBBezierCurve *_curve2;
     CGFloat _parameter2;
+    FBBezierCurveData _curve2LeftData;
+    FBBezierCurveData _curve2RightData;
     FBBezierCurve *_curve2LeftBezier;
     FBBezierCurve *_curve2RightBezier;    
     BOOL _tangent;
@@ -66,10 +66,10 @@ const CGFloat FBParameterCloseThreshold = 1e-4;
 
     
     // Compute the tangents at the intersection. 
-    CGPoint curve1LeftTangent = FBNormalizePoint(FBSubtractPoint(_curve1LeftBezier.controlPoint2, _curve1LeftBezier.endPoint2));
-    CGPoint curve1RightTangent = FBNormalizePoint(FBSubtractPoint(_curve1RightBezier.controlPoint1, _curve1RightBezier.endPoint1));
-    CGPoint curve2LeftTangent = FBNormalizePoint(FBSubtractPoint(_curve2LeftBezier.controlPoint2, _curve2LeftBezier.endPoint2));
-    CGPoint curve2RightTangent = FBNormalizePoint(FBSubtractPoint(_curve2RightBezier.controlPoint1, _curve2RightBezier.endPoint1));
+    CGPoint curve1LeftTangent = FBNormalizePoint(FBSubtractPoint(_curve1LeftData.controlPoint2, _curve1LeftData.endPoint2));
+    CGPoint curve1RightTangent = FBNormalizePoint(FBSubtractPoint(_curve1RightData.controlPoint1, _curve1RightData.endPoint1));
+    CGPoint curve2LeftTangent = FBNormalizePoint(FBSubtractPoint(_curve2LeftData.controlPoint2, _curve2LeftData.endPoint2));
+    CGPoint curve2RightTangent = FBNormalizePoint(FBSubtractPoint(_curve2RightData.controlPoint1, _curve2RightData.endPoint1));
         
     // See if the tangents are the same. If so, then we're tangent at the intersection point
     return FBArePointsCloseWithOptions(curve1LeftTangent, curve2LeftTangent, FBPointCloseThreshold) || FBArePointsCloseWithOptions(curve1LeftTangent, curve2RightTangent, FBPointCloseThreshold) || FBArePointsCloseWithOptions(curve1RightTangent, curve2LeftTangent, FBPointCloseThreshold) || FBArePointsCloseWithOptions(curve1RightTangent, curve2RightTangent, FBPointCloseThreshold);
@@ -78,24 +78,32 @@ const CGFloat FBParameterCloseThreshold = 1e-4;
 - (FBBezierCurve *) curve1LeftBezier
 {
     [self computeCurve1];
+    if ( _curve1LeftBezier == nil )
+        _curve1LeftBezier = [FBBezierCurve bezierCurveWithBezierCurveData:_curve1LeftData];
     return _curve1LeftBezier;
 }
 
 - (FBBezierCurve *) curve1RightBezier
 {
     [self computeCurve1];
+    if ( _curve1RightBezier == nil )
+        _curve1RightBezier = [FBBezierCurve bezierCurveWithBezierCurveData:_curve1RightData];
     return _curve1RightBezier;
 }
 
 - (FBBezierCurve *) curve2LeftBezier
 {
     [self computeCurve2];
+    if ( _curve2LeftBezier == nil )
+        _curve2LeftBezier = [FBBezierCurve bezierCurveWithBezierCurveData:_curve2LeftData];
     return _curve2LeftBezier;
 }
 
 - (FBBezierCurve *) curve2RightBezier
 {
     [self computeCurve2];
+    if ( _curve2RightBezier == nil )
+        _curve2RightBezier = [FBBezierCurve bezierCurveWithBezierCurveData:_curve2RightData];
     return _curve2RightBezier;
 }
 
@@ -139,11 +147,7 @@ const CGFloat FBParameterCloseThreshold = 1e-4;
     if ( !_needToComputeCurve1 )
         return;
 	
-	FBBezierCurve *curve1LeftBezier;
-	FBBezierCurve *curve1RightBezier;
-    _location = [_curve1 pointAtParameter:_parameter1 leftBezierCurve:&curve1LeftBezier rightBezierCurve:&curve1RightBezier];
-    _curve1LeftBezier = curve1LeftBezier;
-    _curve1RightBezier = curve1RightBezier;
+    _location = FBBezierCurveDataPointAtParameter(_curve1.data, _parameter1, &_curve1LeftData, &_curve1RightData);
     
     _needToComputeCurve1 = NO;
 }
@@ -153,11 +157,7 @@ const CGFloat FBParameterCloseThreshold = 1e-4;
     if ( !_needToComputeCurve2 )
         return;
 	
-	FBBezierCurve *curve2LeftBezier;
-	FBBezierCurve *curve2RightBezier;
-    [_curve2 pointAtParameter:_parameter2 leftBezierCurve:&curve2LeftBezier rightBezierCurve:&curve2RightBezier];
-    _curve2LeftBezier = curve2LeftBezier;
-    _curve2RightBezier = curve2RightBezier;
+    FBBezierCurveDataPointAtParameter(_curve2.data, _parameter2, &_curve2LeftData, &_curve2RightData);
     
     _needToComputeCurve2 = NO;
 }
@@ -1,14 +1,14 @@
 //
-//  FBConvexHull.m
+//  FBConvexHull.c
 //  VectorBoolean
 //
 //  Created by Stephan Michels on 18.07.14.
 //  Copyright (c) 2014 Fortunate Bear, LLC. All rights reserved.
 //
 
-#import "FBConvexHull.h"
-#import "FBGeometry.h"
-#import "FBBezierCurveHelper.h"
+#include "FBConvexHull.h"
+#include "FBGeometry.h"
+#include "FBBezierCurveHelper.h"
 
 #pragma mark Convex Hull
 
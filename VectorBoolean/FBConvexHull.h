@@ -6,6 +6,11 @@
 //  Copyright (c) 2014 Fortunate Bear, LLC. All rights reserved.
 //
 
-#import <Foundation/Foundation.h>
+#ifndef FBCONVEXHULL_H
+#define FBCONVEXHULL_H
+
+#include "FBTypes.h"
 
 extern void FBConvexHullBuildFromPoints(CGPoint points[4], CGPoint *results, NSUInteger *outLength);
+
+#endif
@@ -14,7 +14,10 @@
 // FBEdgeCrossing is used by the boolean operations code to hold data about
 //  where two edges actually cross (as opposed to just intersect). The main
 //  piece of data is the intersection, but it also holds a pointer to the
-//  crossing's counterpart in the other FBBezierGraph
+//  crossing's counterpart in the other FBBezierGraph.
+//
+// The back pointers are weak: crossings are kept in arrays of their own, like
+//  the nonself crossings of a contour, which can outlive the edge they're on.
 @interface FBEdgeCrossing : NSObject {
     FBBezierIntersection *_intersection;
     __weak FBBezierCurve *_edge;
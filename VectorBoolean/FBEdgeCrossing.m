@@ -10,6 +10,7 @@
 #import "FBBezierCurve.h"
 #import "FBBezierCurve+Edge.h"
 #import "FBBezierIntersection.h"
+#import "FBStatistics.h"
 
 @implementation FBEdgeCrossing
 
@@ -32,6 +33,7 @@
     
     if ( self != nil ) {
         _intersection = intersection;
+        FBStatisticsIncrement(FBStatisticCrossingsCreated);
     }
     
     return self;
@@ -40,6 +42,8 @@
 
 - (void) removeFromEdge
 {
+    // Crossings only come off their edge one by one when they turn out to be redundant
+    FBStatisticsIncrement(FBStatisticCrossingsDiscarded);
     [_edge removeCrossing:self];
 }
 
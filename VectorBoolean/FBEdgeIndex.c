@@ -0,0 +1,278 @@
+//
+//  FBEdgeIndex.c
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include "FBEdgeIndex.h"
+#include "FBGeometry.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Leaves hold a handful of entries. Testing four boxes directly is cheaper than
+//  descending another two levels of the tree.
+static const NSUInteger FBEdgeIndexMaximumLeafSize = 4;
+
+typedef struct FBEdgeIndexNode {
+    CGRect bounds;
+    NSUInteger firstEntry;
+    NSUInteger entryCount; // zero for interior nodes
+    NSUInteger leftChild;
+    NSUInteger rightChild;
+} FBEdgeIndexNode;
+
+struct FBEdgeIndex {
+    FBEdgeIndexEntry *entries;
+    NSUInteger count;
+    FBEdgeIndexNode *nodes;
+    NSUInteger nodeCount;
+};
+
+typedef struct FBEdgeIndexPairList {
+    FBEdgeIndexPair *pairs;
+    NSUInteger count;
+    NSUInteger capacity;
+} FBEdgeIndexPairList;
+
+#pragma mark Building
+
+//////////////////////////////////////////////////////////////////////////////////
+// Building
+//
+// The tree is built top down. Each node's entries are sorted by the center of
+//  their bounds along the longer axis of the node, and split in half. That gives
+//  a balanced tree, which is all we need since the index is rebuilt rather than
+//  updated when the graph changes.
+//
+
+static CGRect FBEdgeIndexBoundsOfEntries(const FBEdgeIndexEntry *entries, NSUInteger count)
+{
+    CGFloat minX = CGRectGetMinX(entries[0].bounds);
+    CGFloat minY = CGRectGetMinY(entries[0].bounds);
+    CGFloat maxX = CGRectGetMaxX(entries[0].bounds);
+    CGFloat maxY = CGRectGetMaxY(entries[0].bounds);
+    for (NSUInteger i = 1; i < count; i++) {
+        minX = MIN(minX, CGRectGetMinX(entries[i].bounds));
+        minY = MIN(minY, CGRectGetMinY(entries[i].bounds));
+        maxX = MAX(maxX, CGRectGetMaxX(entries[i].bounds));
+        maxY = MAX(maxY, CGRectGetMaxY(entries[i].bounds));
+    }
+    return CGRectMake(minX, minY, maxX - minX, maxY - minY);
+}
+
+static int FBEdgeIndexCompareEntriesByX(const void *value1, const void *value2)
+{
+    CGFloat center1 = CGRectGetMidX(((const FBEdgeIndexEntry *)value1)->bounds);
+    CGFloat center2 = CGRectGetMidX(((const FBEdgeIndexEntry *)value2)->bounds);
+    if ( center1 < center2 )
+        return -1;
+    return center1 > center2 ? 1 : 0;
+}
+
+static int FBEdgeIndexCompareEntriesByY(const void *value1, const void *value2)
+{
+    CGFloat center1 = CGRectGetMidY(((const FBEdgeIndexEntry *)value1)->bounds);
+    CGFloat center2 = CGRectGetMidY(((const FBEdgeIndexEntry *)value2)->bounds);
+    if ( center1 < center2 )
+        return -1;
+    return center1 > center2 ? 1 : 0;
+}
+
+static NSUInteger FBEdgeIndexBuildNode(FBEdgeIndexRef index, NSUInteger firstEntry, NSUInteger entryCount)
+{
+    NSUInteger nodeIndex = index->nodeCount++;
+    FBEdgeIndexNode node = {};
+    node.bounds = FBEdgeIndexBoundsOfEntries(&index->entries[firstEntry], entryCount);
+    node.firstEntry = firstEntry;
+
+    if ( entryCount <= FBEdgeIndexMaximumLeafSize ) {
+        node.entryCount = entryCount;
+        index->nodes[nodeIndex] = node;
+        return nodeIndex;
+    }
+
+    // Split along the longer side
+    if ( CGRectGetWidth(node.bounds) >= CGRectGetHeight(node.bounds) )
+        qsort(&index->entries[firstEntry], entryCount, sizeof(FBEdgeIndexEntry), FBEdgeIndexCompareEntriesByX);
+    else
+        qsort(&index->entries[firstEntry], entryCount, sizeof(FBEdgeIndexEntry), FBEdgeIndexCompareEntriesByY);
+
+    NSUInteger leftCount = entryCount / 2;
+    node.leftChild = FBEdgeIndexBuildNode(index, firstEntry, leftCount);
+    node.rightChild = FBEdgeIndexBuildNode(index, firstEntry + leftCount, entryCount - leftCount);
+    index->nodes[nodeIndex] = node;
+    return nodeIndex;
+}
+
+FBEdgeIndexRef FBEdgeIndexCreate(const FBEdgeIndexEntry *entries, NSUInteger count)
+{
+    FBEdgeIndexRef index = calloc(1, sizeof(struct FBEdgeIndex));
+    if ( count == 0 )
+        return index;
+
+    index->entries = malloc(count * sizeof(FBEdgeIndexEntry));
+    memcpy(index->entries, entries, count * sizeof(FBEdgeIndexEntry));
+    index->count = count;
+    // A binary tree with count leaves (at most) has fewer than 2 * count nodes
+    index->nodes = malloc(2 * count * sizeof(FBEdgeIndexNode));
+    FBEdgeIndexBuildNode(index, 0, count);
+
+    return index;
+}
+
+void FBEdgeIndexRelease(FBEdgeIndexRef index)
+{
+    if ( index == NULL )
+        return;
+    free(index->entries);
+    free(index->nodes);
+    free(index);
+}
+
+NSUInteger FBEdgeIndexGetCount(FBEdgeIndexRef index)
+{
+    return index->count;
+}
+
+CGRect FBEdgeIndexGetBounds(FBEdgeIndexRef index)
+{
+    if ( index->nodeCount == 0 )
+        return CGRectZero;
+    return index->nodes[0].bounds;
+}
+
+#pragma mark Queries
+
+//////////////////////////////////////////////////////////////////////////////////
+// Queries
+//
+// All the box tests go through FBLineBoundsMightOverlap so the index rejects
+//  exactly what -[FBBezierCurve intersectionsWithBezierCurve:...] would have
+//  rejected itself, and nothing more.
+//
+
+static void FBEdgeIndexEnumerateNode(FBEdgeIndexRef index, NSUInteger nodeIndex, CGRect rect, FBEdgeIndexEntryFunction function, void *context)
+{
+    const FBEdgeIndexNode *node = &index->nodes[nodeIndex];
+    if ( !FBLineBoundsMightOverlap(node->bounds, rect) )
+        return;
+
+    if ( node->entryCount > 0 ) {
+        for (NSUInteger i = node->firstEntry; i < node->firstEntry + node->entryCount; i++) {
+            if ( FBLineBoundsMightOverlap(index->entries[i].bounds, rect) )
+                function(&index->entries[i], context);
+        }
+        return;
+    }
+
+    FBEdgeIndexEnumerateNode(index, node->leftChild, rect, function, context);
+    FBEdgeIndexEnumerateNode(index, node->rightChild, rect, function, context);
+}
+
+void FBEdgeIndexEnumerateEntriesInRect(FBEdgeIndexRef index, CGRect rect, FBEdgeIndexEntryFunction function, void *context)
+{
+    if ( index->nodeCount == 0 )
+        return;
+    FBEdgeIndexEnumerateNode(index, 0, rect, function, context);
+}
+
+static void FBEdgeIndexEnumerateNearestNode(FBEdgeIndexRef index, NSUInteger nodeIndex, CGPoint point, FBEdgeIndexDistanceFunction function, void *context, CGFloat *nearestDistance)
+{
+    const FBEdgeIndexNode *node = &index->nodes[nodeIndex];
+    if ( node->entryCount > 0 ) {
+        for (NSUInteger i = node->firstEntry; i < node->firstEntry + node->entryCount; i++) {
+            if ( FBDistancePointToRect(point, index->entries[i].bounds) > *nearestDistance )
+                continue;
+            CGFloat distance = function(&index->entries[i], point, context);
+            if ( distance < *nearestDistance )
+                *nearestDistance = distance;
+        }
+        return;
+    }
+
+    // Going into the nearer child first finds a close edge early, which then rules out
+    //  most of the farther child without looking at its edges.
+    NSUInteger nearChild = node->leftChild;
+    NSUInteger farChild = node->rightChild;
+    CGFloat nearDistance = FBDistancePointToRect(point, index->nodes[nearChild].bounds);
+    CGFloat farDistance = FBDistancePointToRect(point, index->nodes[farChild].bounds);
+    if ( farDistance < nearDistance ) {
+        NSUInteger swapChild = nearChild;
+        nearChild = farChild;
+        farChild = swapChild;
+        CGFloat swapDistance = nearDistance;
+        nearDistance = farDistance;
+        farDistance = swapDistance;
+    }
+
+    if ( nearDistance <= *nearestDistance )
+        FBEdgeIndexEnumerateNearestNode(index, nearChild, point, function, context, nearestDistance);
+    if ( farDistance <= *nearestDistance )
+        FBEdgeIndexEnumerateNearestNode(index, farChild, point, function, context, nearestDistance);
+}
+
+CGFloat FBEdgeIndexEnumerateNearestEntries(FBEdgeIndexRef index, CGPoint point, CGFloat maximumDistance, FBEdgeIndexDistanceFunction function, void *context)
+{
+    CGFloat nearestDistance = maximumDistance;
+    if ( index->nodeCount > 0 && FBDistancePointToRect(point, index->nodes[0].bounds) <= nearestDistance )
+        FBEdgeIndexEnumerateNearestNode(index, 0, point, function, context, &nearestDistance);
+    return nearestDistance;
+}
+
+static void FBEdgeIndexPairListAdd(FBEdgeIndexPairList *list, const FBEdgeIndexEntry *entry1, const FBEdgeIndexEntry *entry2)
+{
+    if ( list->count == list->capacity ) {
+        list->capacity = MAX(list->capacity * 2, (NSUInteger)64);
+        list->pairs = realloc(list->pairs, list->capacity * sizeof(FBEdgeIndexPair));
+    }
+    FBEdgeIndexPair *pair = &list->pairs[list->count++];
+    pair->contourIndex1 = entry1->contourIndex;
+    pair->edgeIndex1 = entry1->edgeIndex;
+    pair->contourIndex2 = entry2->contourIndex;
+    pair->edgeIndex2 = entry2->edgeIndex;
+}
+
+static void FBEdgeIndexFindPairs(FBEdgeIndexRef index1, NSUInteger nodeIndex1, FBEdgeIndexRef index2, NSUInteger nodeIndex2, FBEdgeIndexPairList *list)
+{
+    const FBEdgeIndexNode *node1 = &index1->nodes[nodeIndex1];
+    const FBEdgeIndexNode *node2 = &index2->nodes[nodeIndex2];
+    if ( !FBLineBoundsMightOverlap(node1->bounds, node2->bounds) )
+        return;
+
+    BOOL isLeaf1 = node1->entryCount > 0;
+    BOOL isLeaf2 = node2->entryCount > 0;
+    if ( isLeaf1 && isLeaf2 ) {
+        for (NSUInteger i = node1->firstEntry; i < node1->firstEntry + node1->entryCount; i++) {
+            for (NSUInteger j = node2->firstEntry; j < node2->firstEntry + node2->entryCount; j++) {
+                if ( FBLineBoundsMightOverlap(index1->entries[i].bounds, index2->entries[j].bounds) )
+                    FBEdgeIndexPairListAdd(list, &index1->entries[i], &index2->entries[j]);
+            }
+        }
+        return;
+    }
+
+    // Descend into the bigger of the two nodes first, so both sides shrink at about the same rate
+    BOOL descendFirst = isLeaf2 || (!isLeaf1 && CGRectGetWidth(node1->bounds) * CGRectGetHeight(node1->bounds) >= CGRectGetWidth(node2->bounds) * CGRectGetHeight(node2->bounds));
+    if ( descendFirst ) {
+        NSUInteger leftChild = node1->leftChild;
+        NSUInteger rightChild = node1->rightChild;
+        FBEdgeIndexFindPairs(index1, leftChild, index2, nodeIndex2, list);
+        FBEdgeIndexFindPairs(index1, rightChild, index2, nodeIndex2, list);
+    } else {
+        NSUInteger leftChild = node2->leftChild;
+        NSUInteger rightChild = node2->rightChild;
+        FBEdgeIndexFindPairs(index1, nodeIndex1, index2, leftChild, list);
+        FBEdgeIndexFindPairs(index1, nodeIndex1, index2, rightChild, list);
+    }
+}
+
+FBEdgeIndexPair *FBEdgeIndexCopyOverlappingPairs(FBEdgeIndexRef index1, FBEdgeIndexRef index2, NSUInteger *outCount)
+{
+    FBEdgeIndexPairList list = {};
+    if ( index1->nodeCount > 0 && index2->nodeCount > 0 )
+        FBEdgeIndexFindPairs(index1, 0, index2, 0, &list);
+    *outCount = list.count;
+    return list.pairs;
+}
@@ -0,0 +1,74 @@
+//
+//  FBEdgeIndex.h
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#ifndef FBEDGEINDEX_H
+#define FBEDGEINDEX_H
+
+#include "FBTypes.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Edge index
+//
+// FBEdgeIndex is a bounding volume hierarchy (BVH) over the bounding rects
+//  of all the edges in a graph. Finding the intersections between two graphs
+//  used to mean running every edge of one graph against every edge of the
+//  other. With an index over each graph we can walk both trees at the same time
+//  and only hand the edge pairs whose boxes actually overlap to the (expensive)
+//  bezier clipping code.
+//
+// Entries refer to edges by contour index and edge index so the index doesn't
+//  need to know anything about the objects that own the curves.
+//
+
+typedef struct FBEdgeIndexEntry {
+    CGRect bounds;
+    NSUInteger contourIndex;
+    NSUInteger edgeIndex;
+} FBEdgeIndexEntry;
+
+// An edge pair whose bounds might overlap. The first half comes from the
+//  first index passed in, the second half from the second.
+typedef struct FBEdgeIndexPair {
+    NSUInteger contourIndex1;
+    NSUInteger edgeIndex1;
+    NSUInteger contourIndex2;
+    NSUInteger edgeIndex2;
+} FBEdgeIndexPair;
+
+typedef struct FBEdgeIndex *FBEdgeIndexRef;
+
+typedef void (*FBEdgeIndexEntryFunction)(const FBEdgeIndexEntry *entry, void *context);
+
+// Returns the distance from the point to the edge of the entry
+typedef CGFloat (*FBEdgeIndexDistanceFunction)(const FBEdgeIndexEntry *entry, CGPoint point, void *context);
+
+// Creates an index from the entries. The entries are copied, so the caller
+//  retains ownership of the array passed in.
+extern FBEdgeIndexRef FBEdgeIndexCreate(const FBEdgeIndexEntry *entries, NSUInteger count);
+extern void FBEdgeIndexRelease(FBEdgeIndexRef index);
+
+extern NSUInteger FBEdgeIndexGetCount(FBEdgeIndexRef index);
+extern CGRect FBEdgeIndexGetBounds(FBEdgeIndexRef index);
+
+// Calls the function with every entry whose bounds might overlap the rect.
+extern void FBEdgeIndexEnumerateEntriesInRect(FBEdgeIndexRef index, CGRect rect, FBEdgeIndexEntryFunction function, void *context);
+
+// Calls the function with the entries that could hold the edge nearest to the point,
+//  nearest bounds first. An edge is never nearer than its bounds, so entries whose
+//  bounds are farther away than the smallest distance the function has returned so
+//  far, or than maximumDistance, are skipped. Ties are not skipped. Returns the
+//  smallest distance, or maximumDistance if no entry came closer than that.
+extern CGFloat FBEdgeIndexEnumerateNearestEntries(FBEdgeIndexRef index, CGPoint point, CGFloat maximumDistance, FBEdgeIndexDistanceFunction function, void *context);
+
+// Finds all the pairs of entries, one from each index, whose bounds might overlap.
+//  The pairs are returned in a malloc'ed array that the caller must free. They
+//  are in no particular order. The same index can be passed in for both, in
+//  which case each pair is reported in both orders (and against itself).
+extern FBEdgeIndexPair *FBEdgeIndexCopyOverlappingPairs(FBEdgeIndexRef index1, FBEdgeIndexRef index2, NSUInteger *outCount);
+
+#endif
@@ -0,0 +1,270 @@
+//
+//  FBEdgeIntersections.c
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include "FBEdgeIntersections.h"
+#include "FBGeometry.h"
+#include "FBStatistics.h"
+#include <string.h>
+
+// Enough pairs per batch that handing out a batch costs little compared to running it,
+//  and few enough that the batches balance out between threads.
+static const NSUInteger FBEdgeIntersectionsBatchSize = 32;
+
+typedef struct FBEdgeIntersectionsContext {
+    FBArenaRef arena;
+    FBEdgeIntersections *intersections;
+    NSUInteger capacity;
+    NSUInteger pairIndex;
+    FBRange range1; // the pieces being intersected, so parameters can be mapped back
+    FBRange range2;
+} FBEdgeIntersectionsContext;
+
+// The same threshold the clipping code converges to, so it treats an intersection
+//  found twice, at the end of one piece and the start of the next, as one.
+static const CGFloat FBEdgeIntersectionsPieceThreshold = 1e-6;
+
+static const FBRange FBEdgeIntersectionsWholeRange = { 0.0, 1.0 };
+
+FBEdgeTable *FBEdgeTableCreate(FBArenaRef arena, const NSUInteger *edgeCounts, NSUInteger contourCount)
+{
+    FBEdgeTable *table = FBArenaAllocate(arena, sizeof(FBEdgeTable));
+    table->contourCount = contourCount;
+    table->contourStarts = FBArenaAllocate(arena, (contourCount + 1) * sizeof(NSUInteger));
+    NSUInteger curveCount = 0;
+    for (NSUInteger i = 0; i < contourCount; i++) {
+        table->contourStarts[i] = curveCount;
+        curveCount += edgeCounts[i];
+    }
+    table->contourStarts[contourCount] = curveCount;
+    table->curves = FBArenaAllocate(arena, curveCount * sizeof(FBBezierCurveData));
+    return table;
+}
+
+FBBezierCurveData *FBEdgeTableGetCurve(FBEdgeTable *table, NSUInteger contourIndex, NSUInteger edgeIndex)
+{
+    return &table->curves[table->contourStarts[contourIndex] + edgeIndex];
+}
+
+void FBEdgeTableSplitIntoMonotonePieces(FBArenaRef arena, FBEdgeTable *table)
+{
+    NSUInteger curveCount = table->contourStarts[table->contourCount];
+    table->pieceStarts = FBArenaAllocate(arena, (curveCount + 1) * sizeof(NSUInteger));
+    table->pieces = FBArenaAllocate(arena, MAX(curveCount, 1) * sizeof(FBBezierCurveData));
+    table->pieceRanges = FBArenaAllocate(arena, MAX(curveCount, 1) * sizeof(FBRange));
+    NSUInteger capacity = MAX(curveCount, 1);
+    
+    NSUInteger pieceCount = 0;
+    for (NSUInteger i = 0; i < curveCount; i++) {
+        FBBezierCurveData curvePieces[5];
+        FBRange curveRanges[5];
+        NSUInteger curvePieceCount = FBBezierCurveDataSplitIntoMonotonePieces(table->curves[i], curvePieces, curveRanges);
+        if ( pieceCount + curvePieceCount > capacity ) {
+            NSUInteger newCapacity = MAX(capacity * 2, pieceCount + curvePieceCount);
+            table->pieces = FBArenaReallocate(arena, table->pieces, capacity * sizeof(FBBezierCurveData), newCapacity * sizeof(FBBezierCurveData));
+            table->pieceRanges = FBArenaReallocate(arena, table->pieceRanges, capacity * sizeof(FBRange), newCapacity * sizeof(FBRange));
+            capacity = newCapacity;
+        }
+        
+        table->pieceStarts[i] = pieceCount;
+        for (NSUInteger j = 0; j < curvePieceCount; j++) {
+            table->pieces[pieceCount] = curvePieces[j];
+            table->pieceRanges[pieceCount] = curveRanges[j];
+            pieceCount++;
+        }
+    }
+    table->pieceStarts[curveCount] = pieceCount;
+}
+
+static NSUInteger FBEdgeTableGetPieces(FBEdgeTable *table, NSUInteger contourIndex, NSUInteger edgeIndex, FBBezierCurveData **pieces, const FBRange **ranges)
+{
+    // A table that wasn't split has one piece per curve: the curve itself
+    NSUInteger curveIndex = table->contourStarts[contourIndex] + edgeIndex;
+    if ( table->pieces == NULL ) {
+        *pieces = &table->curves[curveIndex];
+        *ranges = &FBEdgeIntersectionsWholeRange;
+        return 1;
+    }
+    
+    *pieces = &table->pieces[table->pieceStarts[curveIndex]];
+    *ranges = &table->pieceRanges[table->pieceStarts[curveIndex]];
+    return table->pieceStarts[curveIndex + 1] - table->pieceStarts[curveIndex];
+}
+
+static void FBEdgeIntersectionsAdd(CGFloat parameter1, CGFloat parameter2, void *context, BOOL *stop)
+{
+    FBEdgeIntersectionsContext *intersectionsContext = context;
+    FBEdgeIntersections *intersections = intersectionsContext->intersections;
+    if ( intersections->count == intersectionsContext->capacity ) {
+        NSUInteger capacity = MAX(intersectionsContext->capacity * 2, 16);
+        intersections->intersections = FBArenaReallocate(intersectionsContext->arena, intersections->intersections, intersectionsContext->capacity * sizeof(FBEdgeIntersection), capacity * sizeof(FBEdgeIntersection));
+        intersectionsContext->capacity = capacity;
+    }
+    
+    FBEdgeIntersection *intersection = &intersections->intersections[intersections->count++];
+    intersection->pairIndex = intersectionsContext->pairIndex;
+    intersection->parameter1 = FBRangeScaleNormalizedValue(intersectionsContext->range1, parameter1);
+    intersection->parameter2 = FBRangeScaleNormalizedValue(intersectionsContext->range2, parameter2);
+}
+
+static void FBEdgeTableComputeCaches(FBEdgeTable *table)
+{
+    // The intersection code fills in the cached values of the curves it's handed as it
+    //  goes. Fill them in up front so the pairs can all work from copies, which means
+    //  they never write to the table and can safely run on different threads.
+    NSUInteger curveCount = table->contourStarts[table->contourCount];
+    for (NSUInteger i = 0; i < curveCount; i++) {
+        FBBezierCurveDataBoundingRect(&table->curves[i]);
+        FBBezierCurveDataBounds(&table->curves[i]);
+        FBBezierCurveDataIsPoint(&table->curves[i]);
+    }
+    
+    NSUInteger pieceCount = table->pieces != NULL ? table->pieceStarts[curveCount] : 0;
+    for (NSUInteger i = 0; i < pieceCount; i++) {
+        FBBezierCurveDataBoundingRect(&table->pieces[i]);
+        FBBezierCurveDataBounds(&table->pieces[i]);
+        FBBezierCurveDataIsPoint(&table->pieces[i]);
+    }
+}
+
+static BOOL FBEdgeIntersectionsFindBetweenPieces(FBEdgeIntersectionsContext *context, FBBezierCurveData *pieces1, const FBRange *ranges1, NSUInteger pieceCount1, FBBezierCurveData *pieces2, const FBRange *ranges2, NSUInteger pieceCount2)
+{
+    // Intersect every piece with every other piece whose bounds it overlaps. If any of
+    //  them overlap, give up, and let the caller run the whole curves instead, since
+    //  stitching overlap ranges across pieces isn't worth it for something this rare.
+    FBEdgeIntersections *intersections = context->intersections;
+    NSUInteger firstIntersection = intersections->count;
+    for (NSUInteger i = 0; i < pieceCount1; i++) {
+        for (NSUInteger j = 0; j < pieceCount2; j++) {
+            FBBezierCurveData piece1 = pieces1[i];
+            FBBezierCurveData piece2 = pieces2[j];
+            if ( !FBLineBoundsMightOverlap(FBBezierCurveDataBounds(&piece1), FBBezierCurveDataBounds(&piece2)) ) {
+                FBStatisticsIncrement(FBStatisticEdgePairTests);
+                FBStatisticsIncrement(FBStatisticBoundsRejections);
+                continue;
+            }
+            
+            FBBezierCurveDataOverlap overlap = {};
+            context->range1 = ranges1[i];
+            context->range2 = ranges2[j];
+            FBBezierCurveDataIntersectionsWithBezierCurve(&piece1, &piece2, &overlap, FBEdgeIntersectionsAdd, context);
+            if ( overlap.hasOverlap ) {
+                intersections->count = firstIntersection;
+                return NO;
+            }
+        }
+    }
+    
+    // Pieces share their end points, so an intersection right there is found once from each side
+    NSUInteger count = firstIntersection;
+    for (NSUInteger i = firstIntersection; i < intersections->count; i++) {
+        FBEdgeIntersection *intersection = &intersections->intersections[i];
+        BOOL isDuplicate = NO;
+        for (NSUInteger j = firstIntersection; j < count && !isDuplicate; j++)
+            isDuplicate = FBAreValuesCloseWithOptions(intersection->parameter1, intersections->intersections[j].parameter1, FBEdgeIntersectionsPieceThreshold) && FBAreValuesCloseWithOptions(intersection->parameter2, intersections->intersections[j].parameter2, FBEdgeIntersectionsPieceThreshold);
+        if ( !isDuplicate )
+            intersections->intersections[count++] = *intersection;
+    }
+    intersections->count = count;
+    return YES;
+}
+
+static void FBEdgeIntersectionsFindInRange(FBArenaRef arena, FBEdgeTable *table1, FBEdgeTable *table2, const FBEdgeIndexPair *pairs, NSUInteger firstPair, NSUInteger lastPair, FBBezierCurveDataOverlap *overlaps, FBEdgeIntersections *intersections)
+{
+    FBEdgeIntersectionsContext context = { arena, intersections, 0, 0, FBEdgeIntersectionsWholeRange, FBEdgeIntersectionsWholeRange };
+    for (NSUInteger i = firstPair; i < lastPair; i++) {
+        context.pairIndex = i;
+        
+        // Curves that were split into monotone pieces go piece by piece
+        FBBezierCurveData *pieces1 = NULL;
+        FBBezierCurveData *pieces2 = NULL;
+        const FBRange *ranges1 = NULL;
+        const FBRange *ranges2 = NULL;
+        NSUInteger pieceCount1 = FBEdgeTableGetPieces(table1, pairs[i].contourIndex1, pairs[i].edgeIndex1, &pieces1, &ranges1);
+        NSUInteger pieceCount2 = FBEdgeTableGetPieces(table2, pairs[i].contourIndex2, pairs[i].edgeIndex2, &pieces2, &ranges2);
+        if ( (pieceCount1 > 1 || pieceCount2 > 1) && FBEdgeIntersectionsFindBetweenPieces(&context, pieces1, ranges1, pieceCount1, pieces2, ranges2, pieceCount2) )
+            continue;
+        
+        FBBezierCurveData curve1 = *FBEdgeTableGetCurve(table1, pairs[i].contourIndex1, pairs[i].edgeIndex1);
+        FBBezierCurveData curve2 = *FBEdgeTableGetCurve(table2, pairs[i].contourIndex2, pairs[i].edgeIndex2);
+        context.range1 = FBEdgeIntersectionsWholeRange;
+        context.range2 = FBEdgeIntersectionsWholeRange;
+        FBBezierCurveDataIntersectionsWithBezierCurve(&curve1, &curve2, overlaps != NULL ? &overlaps[i] : NULL, FBEdgeIntersectionsAdd, &context);
+    }
+}
+
+void FBEdgeIntersectionsFind(FBArenaRef arena, FBEdgeTable *table1, FBEdgeTable *table2, const FBEdgeIndexPair *pairs, NSUInteger pairCount, BOOL findOverlaps, FBEdgeIntersections *intersections)
+{
+    intersections->intersections = NULL;
+    intersections->count = 0;
+    intersections->overlaps = findOverlaps ? FBArenaAllocate(arena, MAX(pairCount, 1) * sizeof(FBBezierCurveDataOverlap)) : NULL;
+    
+    FBEdgeTableComputeCaches(table1);
+    if ( table2 != table1 )
+        FBEdgeTableComputeCaches(table2);
+    FBEdgeIntersectionsFindInRange(arena, table1, table2, pairs, 0, pairCount, intersections->overlaps, intersections);
+}
+
+typedef struct FBEdgeIntersectionsBatches {
+    FBEdgeTable *table1;
+    FBEdgeTable *table2;
+    const FBEdgeIndexPair *pairs;
+    NSUInteger pairCount;
+    FBBezierCurveDataOverlap *overlaps;
+    FBArenaRef *threadArenas; // one per thread, so batches don't contend for memory
+    FBEdgeIntersections *batchIntersections;
+} FBEdgeIntersectionsBatches;
+
+static void FBEdgeIntersectionsFindBatch(NSUInteger batch, NSUInteger threadIndex, void *context)
+{
+    FBEdgeIntersectionsBatches *batches = context;
+    NSUInteger firstPair = batch * FBEdgeIntersectionsBatchSize;
+    NSUInteger lastPair = MIN(firstPair + FBEdgeIntersectionsBatchSize, batches->pairCount);
+    FBEdgeIntersectionsFindInRange(batches->threadArenas[threadIndex], batches->table1, batches->table2, batches->pairs, firstPair, lastPair, batches->overlaps, &batches->batchIntersections[batch]);
+}
+
+void FBEdgeIntersectionsFindConcurrently(FBArenaRef arena, FBEdgeTable *table1, FBEdgeTable *table2, const FBEdgeIndexPair *pairs, NSUInteger pairCount, BOOL findOverlaps, FBThreadPoolRef pool, FBEdgeIntersections *intersections)
+{
+    NSUInteger batchCount = (pairCount + FBEdgeIntersectionsBatchSize - 1) / FBEdgeIntersectionsBatchSize;
+    NSUInteger concurrency = pool != NULL ? FBThreadPoolGetConcurrency(pool) : 1;
+    if ( batchCount <= 1 || concurrency <= 1 ) {
+        FBEdgeIntersectionsFind(arena, table1, table2, pairs, pairCount, findOverlaps, intersections);
+        return;
+    }
+    
+    intersections->intersections = NULL;
+    intersections->count = 0;
+    intersections->overlaps = findOverlaps ? FBArenaAllocate(arena, pairCount * sizeof(FBBezierCurveDataOverlap)) : NULL;
+    
+    FBEdgeTableComputeCaches(table1);
+    if ( table2 != table1 )
+        FBEdgeTableComputeCaches(table2);
+    
+    FBEdgeIntersectionsBatches batches = { table1, table2, pairs, pairCount, intersections->overlaps, NULL, NULL };
+    batches.threadArenas = FBArenaAllocate(arena, concurrency * sizeof(FBArenaRef));
+    for (NSUInteger i = 0; i < concurrency; i++)
+        batches.threadArenas[i] = FBArenaCreate(0);
+    batches.batchIntersections = FBArenaAllocate(arena, batchCount * sizeof(FBEdgeIntersections));
+    
+    FBThreadPoolApply(pool, batchCount, FBEdgeIntersectionsFindBatch, &batches);
+    
+    // Stitch the batches back together in order. Each batch holds the results for
+    //  a consecutive run of pairs, so this gives exactly what the serial version does.
+    NSUInteger count = 0;
+    for (NSUInteger i = 0; i < batchCount; i++)
+        count += batches.batchIntersections[i].count;
+    intersections->intersections = FBArenaAllocate(arena, MAX(count, 1) * sizeof(FBEdgeIntersection));
+    for (NSUInteger i = 0; i < batchCount; i++) {
+        FBEdgeIntersections *batchIntersections = &batches.batchIntersections[i];
+        if ( batchIntersections->count > 0 )
+            memcpy(&intersections->intersections[intersections->count], batchIntersections->intersections, batchIntersections->count * sizeof(FBEdgeIntersection));
+        intersections->count += batchIntersections->count;
+    }
+    
+    for (NSUInteger i = 0; i < concurrency; i++)
+        FBArenaRelease(batches.threadArenas[i]);
+}
@@ -0,0 +1,76 @@
+//
+//  FBEdgeIntersections.h
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#ifndef FBEDGEINTERSECTIONS_H
+#define FBEDGEINTERSECTIONS_H
+
+#include "FBTypes.h"
+#include "FBArena.h"
+#include "FBBezierCurveData.h"
+#include "FBEdgeIndex.h"
+#include "FBThreadPool.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Edge intersections
+//
+// Finding where two graphs intersect is split in two. First the curve data of
+//  every edge is copied into a flat table, and all the candidate edge pairs are
+//  run through the bezier clipping code, which only produces plain values: the
+//  parameters of each intersection and the overlap of each pair. Nothing here
+//  touches an object, and everything lives in the operation's arena. Then the
+//  graph walks the results and creates crossings for the ones that matter.
+//
+
+// The curves of a graph, contour after contour. Edges are looked up by the
+//  same contour and edge indexes FBEdgeIndex uses.
+typedef struct FBEdgeTable {
+    FBBezierCurveData *curves;
+    NSUInteger *contourStarts; // contourCount + 1 entries, the last is the number of curves
+    NSUInteger contourCount;
+    
+    // Only there after FBEdgeTableSplitIntoMonotonePieces(), NULL before
+    FBBezierCurveData *pieces;
+    FBRange *pieceRanges; // the range of the original curve each piece covers
+    NSUInteger *pieceStarts; // one per curve, plus one for the end
+} FBEdgeTable;
+
+typedef struct FBEdgeIntersection {
+    NSUInteger pairIndex;
+    CGFloat parameter1;
+    CGFloat parameter2;
+} FBEdgeIntersection;
+
+typedef struct FBEdgeIntersections {
+    FBEdgeIntersection *intersections; // in pair order
+    NSUInteger count;
+    FBBezierCurveDataOverlap *overlaps; // one per pair, or NULL if overlaps weren't asked for
+} FBEdgeIntersections;
+
+// Creates a table with room for the given number of edges in each contour. The
+//  caller fills in the curves.
+extern FBEdgeTable *FBEdgeTableCreate(FBArenaRef arena, const NSUInteger *edgeCounts, NSUInteger contourCount);
+extern FBBezierCurveData *FBEdgeTableGetCurve(FBEdgeTable *table, NSUInteger contourIndex, NSUInteger edgeIndex);
+
+// Optionally splits every curve of a filled in table into pieces that are monotone in
+//  x and y. Two monotone pieces can only cross where their bounds overlap, and they're
+//  rejected on their bounds much more often than whole curves with a bulge or loop in
+//  them, and clipping them converges faster. The intersections found are stitched back
+//  onto the original curves, so the results look the same as without splitting.
+extern void FBEdgeTableSplitIntoMonotonePieces(FBArenaRef arena, FBEdgeTable *table);
+
+// Intersects the first edge of each pair, looked up in table1, with the second, looked up
+//  in table2. The results are allocated in the arena.
+extern void FBEdgeIntersectionsFind(FBArenaRef arena, FBEdgeTable *table1, FBEdgeTable *table2, const FBEdgeIndexPair *pairs, NSUInteger pairCount, BOOL findOverlaps, FBEdgeIntersections *intersections);
+
+// Same as FBEdgeIntersectionsFind(), but spreads the pairs over the threads of the pool.
+//  Each pair is independent, so the pairs are cut into batches that each collect their
+//  own results, and the batches are then stitched back together in pair order. The
+//  results are identical to the serial version, no matter how many threads run.
+extern void FBEdgeIntersectionsFindConcurrently(FBArenaRef arena, FBEdgeTable *table1, FBEdgeTable *table2, const FBEdgeIndexPair *pairs, NSUInteger pairCount, BOOL findOverlaps, FBThreadPoolRef pool, FBEdgeIntersections *intersections);
+
+#endif
@@ -1,16 +1,16 @@
 //
-//  Geometry.m
+//  FBGeometry.c
 //  VectorBrush
 //
 //  Created by Andrew Finnell on 5/28/11.
 //  Copyright 2011 Fortunate Bear, LLC. All rights reserved.
 //
 
-#import "FBGeometry.h"
+#include "FBGeometry.h"
 
-static const CGFloat FBPointClosenessThreshold = 1e-10;
-static const CGFloat FBTangentClosenessThreshold = 1e-12;
-static const CGFloat FBBoundsClosenessThreshold = 1e-9;
+static const CGFloat FBPointClosenessThreshold = FBPrecisionThreshold(4e-5, 1e-10, 8e-13);
+static const CGFloat FBTangentClosenessThreshold = FBPrecisionThreshold(5e-6, 1e-12, 3e-15);
+static const CGFloat FBBoundsClosenessThreshold = FBPrecisionThreshold(1e-4, 1e-9, 1e-11);
 
 
 CGFloat FBDistanceBetweenPoints(CGPoint point1, CGPoint point2)
@@ -30,6 +30,13 @@ CGFloat FBDistancePointToLine(CGPoint point, CGPoint lineStartPoint, CGPoint lin
     return FBDistanceBetweenPoints(point, intersectionPoint);
 }
 
+CGFloat FBDistancePointToRect(CGPoint point, CGRect rect)
+{
+    CGFloat xDelta = MAX(MAX(CGRectGetMinX(rect) - point.x, point.x - CGRectGetMaxX(rect)), 0.0);
+    CGFloat yDelta = MAX(MAX(CGRectGetMinY(rect) - point.y, point.y - CGRectGetMaxY(rect)), 0.0);
+    return sqrt(xDelta * xDelta + yDelta * yDelta);
+}
+
 CGPoint FBAddPoint(CGPoint point1, CGPoint point2)
 {
     return CGPointMake(point1.x + point2.x, point1.y + point2.y);
@@ -107,22 +114,22 @@ CGPoint FBLineMidpoint(CGPoint lineStart, CGPoint lineEnd)
 
 CGPoint FBRectGetTopLeft(CGRect rect)
 {
-    return CGPointMake(NSMinX(rect), NSMinY(rect));
+    return CGPointMake(CGRectGetMinX(rect), CGRectGetMinY(rect));
 }
 
 CGPoint FBRectGetTopRight(CGRect rect)
 {
-    return CGPointMake(NSMaxX(rect), NSMinY(rect));
+    return CGPointMake(CGRectGetMaxX(rect), CGRectGetMinY(rect));
 }
 
 CGPoint FBRectGetBottomLeft(CGRect rect)
 {
-    return CGPointMake(NSMinX(rect), NSMaxY(rect));
+    return CGPointMake(CGRectGetMinX(rect), CGRectGetMaxY(rect));
 }
 
 CGPoint FBRectGetBottomRight(CGRect rect)
 {
-    return CGPointMake(NSMaxX(rect), NSMaxY(rect));
+    return CGPointMake(CGRectGetMaxX(rect), CGRectGetMaxY(rect));
 }
 
 void FBExpandBoundsByPoint(CGPoint *topLeft, CGPoint *bottomRight, CGPoint point)
@@ -338,11 +345,11 @@ BOOL FBTangentsCross(CGPoint edge1Tangents[2], CGPoint edge2Tangents[2])
 
 BOOL FBLineBoundsMightOverlap(CGRect bounds1, CGRect bounds2)
 {
-    CGFloat left = MAX(NSMinX(bounds1), NSMinX(bounds2));
-    CGFloat right = MIN(NSMaxX(bounds1), NSMaxX(bounds2));
+    CGFloat left = MAX(CGRectGetMinX(bounds1), CGRectGetMinX(bounds2));
+    CGFloat right = MIN(CGRectGetMaxX(bounds1), CGRectGetMaxX(bounds2));
     if ( FBIsValueGreaterThanWithOptions(left, right, FBBoundsClosenessThreshold) )
         return NO; // no horizontal overlap
-    CGFloat top = MAX(NSMinY(bounds1), NSMinY(bounds2));
-    CGFloat bottom = MIN(NSMaxY(bounds1), NSMaxY(bounds2));
+    CGFloat top = MAX(CGRectGetMinY(bounds1), CGRectGetMinY(bounds2));
+    CGFloat bottom = MIN(CGRectGetMaxY(bounds1), CGRectGetMaxY(bounds2));
     return FBIsValueLessThanEqualWithOptions(top, bottom, FBBoundsClosenessThreshold);
 }
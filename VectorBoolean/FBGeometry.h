@@ -6,12 +6,15 @@
 //  Copyright 2011 Fortunate Bear, LLC. All rights reserved.
 //
 
-#import <Foundation/Foundation.h>
-#import <CoreGraphics/CoreGraphics.h>
+#ifndef FBGEOMETRY_H
+#define FBGEOMETRY_H
+
+#include "FBTypes.h"
 
 
 CGFloat FBDistanceBetweenPoints(CGPoint point1, CGPoint point2);
 CGFloat FBDistancePointToLine(CGPoint point, CGPoint lineStartPoint, CGPoint lineEndPoint);
+CGFloat FBDistancePointToRect(CGPoint point, CGRect rect); // zero inside the rect
 CGPoint FBLineNormal(CGPoint lineStart, CGPoint lineEnd);
 CGPoint FBLineMidpoint(CGPoint lineStart, CGPoint lineEnd);
 
@@ -79,3 +82,5 @@ extern FBRange FBRangeUnion(FBRange range1, FBRange range2);
 
 extern BOOL FBTangentsCross(CGPoint edge1Tangents[2], CGPoint edge2Tangents[2]);
 extern BOOL FBAreTangentsAmbigious(CGPoint edge1Tangents[2], CGPoint edge2Tangents[2]);
+
+#endif
@@ -0,0 +1,38 @@
+//
+//  FBIncrementalBooleanOperation.h
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+#import "CGPath+Boolean.h"
+
+// FBIncrementalBooleanOperation recomputes one boolean operation on two paths that
+//  change a little at a time, like the shapes in an editor while a point is dragged.
+//  Contours can only affect each other if their bounds overlap, so the contours of
+//  both paths fall apart into clusters that don't touch, and the result is simply
+//  the results of the clusters put together. An update only combines the clusters
+//  again that have a contour that was added, removed or changed, and reuses the
+//  results of all the others from the previous update.
+@interface FBIncrementalBooleanOperation : NSObject {
+    FBBooleanOperation _operation;
+    NSUInteger _clusterCount;
+    NSUInteger _reusedClusterCount;
+    NSCountedSet *_contours[2];
+    NSDictionary *_clustersByContour[2];
+    NSArray *_clusterResults;
+}
+
+- (instancetype) initWithOperation:(FBBooleanOperation)operation;
+
+// The result for the new versions of the paths. The caller owns it.
+- (CGPathRef) resultWithPath:(CGPathRef)path1 path:(CGPathRef)path2;
+
+@property (readonly) FBBooleanOperation operation;
+@property (readonly) NSUInteger clusterCount; // in the last result
+@property (readonly) NSUInteger reusedClusterCount; // of those, how many came from the update before
+
+@end
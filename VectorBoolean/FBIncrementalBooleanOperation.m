@@ -0,0 +1,229 @@
+//
+//  FBIncrementalBooleanOperation.m
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#import "FBIncrementalBooleanOperation.h"
+#import "FBBezierGraph.h"
+#import "FBEdgeIndex.h"
+#import "FBGeometry.h"
+
+// CGPathElementType and FBPathElementType list the element types in the same order
+static const NSUInteger FBIncrementalPointCounts[] = { 1, 1, 2, 3, 0 };
+
+static void FBIncrementalAddCGPathElement(void *info, const CGPathElement *element)
+{
+    // Each contour is kept as the bytes of its path elements, so a contour that didn't
+    //  change is recognized by comparing the bytes. That includes the padding, so clear it.
+    FBPathElement pathElement;
+    memset(&pathElement, 0, sizeof(pathElement));
+    pathElement.type = (FBPathElementType)element->type;
+    for (NSUInteger i = 0; i < FBIncrementalPointCounts[element->type]; i++)
+        pathElement.points[i] = element->points[i];
+
+    NSMutableArray *contours = (__bridge NSMutableArray *)info;
+    if ( element->type == kCGPathElementMoveToPoint || contours.count == 0 )
+        [contours addObject:[NSMutableData dataWithCapacity:8 * sizeof(FBPathElement)]];
+    [contours.lastObject appendBytes:&pathElement length:sizeof(pathElement)];
+}
+
+static CGRect FBIncrementalContourBounds(NSData *contour)
+{
+    // The curves lie within their control points, so the bounds of all the points do too
+    const FBPathElement *elements = contour.bytes;
+    NSUInteger count = contour.length / sizeof(FBPathElement);
+    CGPoint topLeft = CGPointZero;
+    CGPoint bottomRight = CGPointZero;
+    BOOL isFirstPoint = YES;
+    for (NSUInteger i = 0; i < count; i++) {
+        for (NSUInteger j = 0; j < FBIncrementalPointCounts[elements[i].type]; j++) {
+            if ( isFirstPoint ) {
+                topLeft = bottomRight = elements[i].points[j];
+                isFirstPoint = NO;
+            } else
+                FBExpandBoundsByPoint(&topLeft, &bottomRight, elements[i].points[j]);
+        }
+    }
+    return CGRectMake(topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y);
+}
+
+static NSUInteger FBIncrementalFindCluster(NSUInteger *parents, NSUInteger contourIndex)
+{
+    while ( parents[contourIndex] != contourIndex ) {
+        parents[contourIndex] = parents[parents[contourIndex]];
+        contourIndex = parents[contourIndex];
+    }
+    return contourIndex;
+}
+
+static void FBIncrementalJoinClusters(NSUInteger *parents, NSUInteger contourIndex1, NSUInteger contourIndex2)
+{
+    // The lower index wins, so clusters come out in the order of their first contour
+    NSUInteger cluster1 = FBIncrementalFindCluster(parents, contourIndex1);
+    NSUInteger cluster2 = FBIncrementalFindCluster(parents, contourIndex2);
+    if ( cluster1 < cluster2 )
+        parents[cluster2] = cluster1;
+    else if ( cluster2 < cluster1 )
+        parents[cluster1] = cluster2;
+}
+
+// The contours of one cluster, from both paths
+@interface FBIncrementalCluster : NSObject
+
+@property (readonly) NSMutableData *elements1;
+@property (readonly) NSMutableData *elements2;
+@property BOOL changed;
+@property NSUInteger previousIndex;
+
+@end
+
+@implementation FBIncrementalCluster
+
+- (instancetype) init
+{
+    self = [super init];
+
+    if ( self != nil ) {
+        _elements1 = [[NSMutableData alloc] init];
+        _elements2 = [[NSMutableData alloc] init];
+        _previousIndex = NSNotFound;
+    }
+
+    return self;
+}
+
+@end
+
+@implementation FBIncrementalBooleanOperation
+
+@synthesize operation=_operation;
+@synthesize clusterCount=_clusterCount;
+@synthesize reusedClusterCount=_reusedClusterCount;
+
+- (instancetype) initWithOperation:(FBBooleanOperation)operation
+{
+    self = [super init];
+
+    if ( self != nil ) {
+        _operation = operation;
+        for (NSUInteger operand = 0; operand < 2; operand++) {
+            _contours[operand] = [[NSCountedSet alloc] init];
+            _clustersByContour[operand] = [NSDictionary dictionary];
+        }
+        _clusterResults = [NSArray array];
+    }
+
+    return self;
+}
+
+- (CGPathRef) resultWithPath:(CGPathRef)path1 path:(CGPathRef)path2
+{
+    NSMutableArray *contours[2] = { [NSMutableArray array], [NSMutableArray array] };
+    CGPathApply(path1, (__bridge void *)contours[0], FBIncrementalAddCGPathElement);
+    CGPathApply(path2, (__bridge void *)contours[1], FBIncrementalAddCGPathElement);
+
+    // Wherever a contour went away, or changed, which is the same thing, whatever used to
+    //  be near it has to be combined again.
+    NSCountedSet *newContours[2];
+    NSMutableData *dirtyBounds = [NSMutableData data];
+    for (NSUInteger operand = 0; operand < 2; operand++) {
+        newContours[operand] = [[NSCountedSet alloc] initWithArray:contours[operand]];
+        for (NSData *contour in _contours[operand]) {
+            if ( [newContours[operand] countForObject:contour] < [_contours[operand] countForObject:contour] ) {
+                CGRect bounds = FBIncrementalContourBounds(contour);
+                [dirtyBounds appendBytes:&bounds length:sizeof(CGRect)];
+            }
+        }
+    }
+    const CGRect *dirtyRects = dirtyBounds.bytes;
+    NSUInteger dirtyRectCount = dirtyBounds.length / sizeof(CGRect);
+
+    // Contours whose bounds overlap end up in the same cluster. The edge index finds
+    //  the overlapping pairs, here with one entry per contour instead of per edge.
+    NSUInteger count = contours[0].count + contours[1].count;
+    FBEdgeIndexEntry *entries = malloc(MAX(count, (NSUInteger)1) * sizeof(FBEdgeIndexEntry));
+    NSUInteger *parents = malloc(MAX(count, (NSUInteger)1) * sizeof(NSUInteger));
+    for (NSUInteger contourIndex = 0; contourIndex < count; contourIndex++) {
+        NSUInteger operand = contourIndex < contours[0].count ? 0 : 1;
+        NSData *contour = contours[operand][contourIndex - (operand == 0 ? 0 : contours[0].count)];
+        entries[contourIndex].bounds = FBIncrementalContourBounds(contour);
+        entries[contourIndex].contourIndex = contourIndex;
+        entries[contourIndex].edgeIndex = operand;
+        parents[contourIndex] = contourIndex;
+    }
+    FBEdgeIndexRef index = FBEdgeIndexCreate(entries, count);
+    NSUInteger pairCount = 0;
+    FBEdgeIndexPair *pairs = FBEdgeIndexCopyOverlappingPairs(index, index, &pairCount);
+    for (NSUInteger i = 0; i < pairCount; i++)
+        FBIncrementalJoinClusters(parents, pairs[i].contourIndex1, pairs[i].contourIndex2);
+    free(pairs);
+    FBEdgeIndexRelease(index);
+
+    // Sort the contours into their clusters. A cluster has to be redone if any of its
+    //  contours is new, or is near where one went away. Otherwise it's made up of exactly
+    //  the same contours as a cluster of the previous update, and that result still stands.
+    NSMutableArray *clusters = [NSMutableArray array];
+    NSMutableDictionary *clustersByContour[2] = { [NSMutableDictionary dictionary], [NSMutableDictionary dictionary] };
+    NSUInteger *clusterIndexes = malloc(MAX(count, (NSUInteger)1) * sizeof(NSUInteger));
+    for (NSUInteger contourIndex = 0; contourIndex < count; contourIndex++) {
+        NSUInteger root = FBIncrementalFindCluster(parents, contourIndex);
+        if ( root == contourIndex ) {
+            clusterIndexes[contourIndex] = clusters.count;
+            [clusters addObject:[[FBIncrementalCluster alloc] init]];
+        } else
+            clusterIndexes[contourIndex] = clusterIndexes[root];
+        FBIncrementalCluster *cluster = clusters[clusterIndexes[contourIndex]];
+
+        NSUInteger operand = entries[contourIndex].edgeIndex;
+        NSData *contour = contours[operand][contourIndex - (operand == 0 ? 0 : contours[0].count)];
+        NSMutableData *elements = operand == 0 ? cluster.elements1 : cluster.elements2;
+        [elements appendData:contour];
+        clustersByContour[operand][contour] = @(clusterIndexes[contourIndex]);
+
+        NSNumber *previousIndex = _clustersByContour[operand][contour];
+        if ( previousIndex == nil )
+            cluster.changed = YES;
+        else
+            cluster.previousIndex = previousIndex.unsignedIntegerValue;
+        for (NSUInteger i = 0; i < dirtyRectCount && !cluster.changed; i++) {
+            if ( FBLineBoundsMightOverlap(entries[contourIndex].bounds, dirtyRects[i]) )
+                cluster.changed = YES;
+        }
+    }
+    free(clusterIndexes);
+    free(parents);
+    free(entries);
+
+    NSMutableArray *clusterResults = [NSMutableArray arrayWithCapacity:clusters.count];
+    CGMutablePathRef result = CGPathCreateMutable();
+    _reusedClusterCount = 0;
+    for (FBIncrementalCluster *cluster in clusters) {
+        CGPathRef clusterResult = NULL;
+        if ( !cluster.changed && cluster.previousIndex != NSNotFound ) {
+            clusterResult = (__bridge CGPathRef)_clusterResults[cluster.previousIndex];
+            [clusterResults addObject:(__bridge id)clusterResult];
+            _reusedClusterCount++;
+        } else {
+            @autoreleasepool {
+                FBBezierGraph *graph1 = [FBBezierGraph bezierGraphWithPathElements:cluster.elements1.bytes count:cluster.elements1.length / sizeof(FBPathElement)];
+                FBBezierGraph *graph2 = [FBBezierGraph bezierGraphWithPathElements:cluster.elements2.bytes count:cluster.elements2.length / sizeof(FBPathElement)];
+                clusterResult = [[graph1 bezierGraphWithOperation:_operation bezierGraph:graph2] path];
+                [clusterResults addObject:(__bridge_transfer id)clusterResult];
+            }
+        }
+        CGPathAddPath(result, NULL, clusterResult);
+    }
+
+    _contours[0] = newContours[0];
+    _contours[1] = newContours[1];
+    _clustersByContour[0] = clustersByContour[0];
+    _clustersByContour[1] = clustersByContour[1];
+    _clusterResults = clusterResults;
+    _clusterCount = clusters.count;
+    return result;
+}
+
+@end
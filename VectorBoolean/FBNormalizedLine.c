@@ -1,12 +1,12 @@
 //
-//  FBNormalizedLine.m
+//  FBNormalizedLine.c
 //  VectorBoolean
 //
 //  Created by Stephan Michels on 18.07.14.
 //  Copyright (c) 2014 Fortunate Bear, LLC. All rights reserved.
 //
 
-#import "FBNormalizedLine.h"
+#include "FBNormalizedLine.h"
 
 //////////////////////////////////////////////////////////////////////////////////
 // Normalized lines
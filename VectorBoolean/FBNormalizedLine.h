@@ -6,7 +6,10 @@
 //  Copyright (c) 2014 Fortunate Bear, LLC. All rights reserved.
 //
 
-#import <Foundation/Foundation.h>
+#ifndef FBNORMALIZEDLINE_H
+#define FBNORMALIZEDLINE_H
+
+#include "FBTypes.h"
 
 typedef struct FBNormalizedLine {
     CGFloat a; // * x +
@@ -19,3 +22,5 @@ FBNormalizedLine FBNormalizedLineMakeWithCoefficients(CGFloat a, CGFloat b, CGFl
 FBNormalizedLine FBNormalizedLineOffset(FBNormalizedLine line, CGFloat offset);
 CGFloat FBNormalizedLineDistanceFromPoint(FBNormalizedLine line, CGPoint point);
 CGPoint FBNormalizedLineIntersection(FBNormalizedLine line1, FBNormalizedLine line2);
+
+#endif
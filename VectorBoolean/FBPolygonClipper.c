@@ -0,0 +1,1254 @@
+//
+//  FBPolygonClipper.c
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include "FBPolygonClipper.h"
+#include "FBEdgeIndex.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Crossings closer than this, relative to the largest coordinate, are taken to be
+//  the same point. Three segments through one point cross at three slightly different
+//  points otherwise, with tiny pieces in between the sweep can't order reliably.
+static const CGFloat FBPolygonSnapThreshold = FBPrecisionThreshold(4e-5, 1e-10, 8e-13);
+
+// Snapping a crossing moves the pieces a little, which can make them cross others.
+//  Those are found by going over the pieces again, up to this many times.
+static const NSUInteger FBPolygonMaximumCrossingPasses = 4;
+
+// Marks a contour that can't go on, which only happens if rounding broke it
+static const NSUInteger FBPolygonNoEdge = (NSUInteger)-1;
+
+// Tiles small enough to make more than this many are made bigger, so the grid itself
+//  doesn't take up more memory than the tiles are meant to save
+static const NSUInteger FBPolygonMaximumTileCount = 1 << 20;
+
+// Marks a point that isn't on any of the seams between the tiles
+static const NSUInteger FBPolygonNoSeam = (NSUInteger)-1;
+
+struct FBPolygon {
+    CGPoint *points;
+    NSUInteger pointCount;
+    NSUInteger *contourStarts; // contour i goes from contourStarts[i] up to contourStarts[i + 1]
+    NSUInteger contourCount;
+};
+
+// A point a piece has to be split at, and how far along the piece it is
+typedef struct FBPolygonSplit {
+    NSUInteger pieceIndex;
+    CGFloat parameter;
+    CGPoint point;
+} FBPolygonSplit;
+
+typedef struct FBPolygonSplitList {
+    FBPolygonSplit *splits;
+    NSUInteger count;
+    NSUInteger capacity;
+} FBPolygonSplitList;
+
+// A part of a segment, which after splitting doesn't cross anything. Pieces lying on top of each other
+//  are merged into one, which remembers for each polygon whether an odd number of them
+//  came from it. That's whether going across the piece goes in or out of that polygon.
+typedef struct FBPolygonPiece {
+    CGPoint left; // the smaller end, by x and then by y
+    CGPoint right;
+    NSUInteger leftVertex;
+    NSUInteger rightVertex;
+    BOOL flips[2];
+    BOOL insideBelow[2]; // inside each polygon just below the piece, to the right for vertical ones
+} FBPolygonPiece;
+
+typedef struct FBPolygonEvent {
+    CGPoint point;
+    CGPoint otherPoint; // the other end of the piece
+    BOOL isLeft;
+    NSUInteger pieceIndex;
+} FBPolygonEvent;
+
+// A piece of the boundary of the result, going counterclockwise around what's filled
+typedef struct FBPolygonEdge {
+    NSUInteger from;
+    NSUInteger to;
+    BOOL used;
+} FBPolygonEdge;
+
+// The part of a contour of one of the polygons inside one tile, in the tiling's points
+typedef struct FBPolygonTileContour {
+    NSUInteger tileIndex;
+    NSUInteger polygonIndex;
+    NSUInteger pointStart;
+    NSUInteger pointCount;
+} FBPolygonTileContour;
+
+// The grid of tiles a tiled operation works on. The seams between the tiles are at
+//  the same place for the tiles on both sides, see FBPolygonTilingGetSeam().
+typedef struct FBPolygonTiling {
+    FBPolygonRef polygons[2];
+    FBBooleanOperation operation;
+    CGPoint minimum;
+    CGPoint maximum;
+    CGFloat tileSize;
+    NSUInteger counts[2]; // how many columns and rows
+    CGPoint *contourBounds; // the minimum and maximum of each contour, with the second polygon's after the first's
+    CGPoint *tilePoints; // the points of the contours cut to the tiles, one contour after the other
+    NSUInteger tilePointCount;
+    NSUInteger tilePointCapacity;
+    FBPolygonTileContour *tileContours; // sorted by tile, the first polygon's before the second's in each
+    NSUInteger tileContourCount;
+    NSUInteger tileContourCapacity;
+    NSUInteger *tileContourStarts; // the contours of tile i go from tileContourStarts[i] up to tileContourStarts[i + 1]
+    FBPolygonRef *results;
+} FBPolygonTiling;
+
+// The part of a contour inside one column or row of tiles, while it's being cut up
+typedef struct FBPolygonStrip {
+    CGPoint *points;
+    NSUInteger count;
+    NSUInteger capacity;
+} FBPolygonStrip;
+
+// A point of some tile's result on a seam between two tiles. The seams across x come
+//  first, then those across y.
+typedef struct FBPolygonSeamPoint {
+    NSUInteger seamIndex;
+    CGFloat value; // how far along the seam
+    CGFloat snappedValue; // where it ends up, the same for the tiles on both sides
+    BOOL isCorner; // where the seam meets another one
+} FBPolygonSeamPoint;
+
+// Where the edges lying on a seam start and end. Along the seam, change adds up to
+//  how many more of them go up (or right) than down (or left).
+typedef struct FBPolygonSeamEvent {
+    NSUInteger seamIndex;
+    CGFloat value;
+    NSInteger change;
+} FBPolygonSeamEvent;
+
+// An edge of some tile's result, before it's known whether it stays
+typedef struct FBPolygonTileEdge {
+    CGPoint from;
+    CGPoint to;
+} FBPolygonTileEdge;
+
+#pragma mark Polygons
+
+FBPolygonRef FBPolygonCreate(const CGPoint *points, const NSUInteger *contourPointCounts, NSUInteger contourCount)
+{
+    FBPolygonRef polygon = calloc(1, sizeof(struct FBPolygon));
+    polygon->contourCount = contourCount;
+    polygon->contourStarts = malloc((contourCount + 1) * sizeof(NSUInteger));
+    for (NSUInteger i = 0; i < contourCount; i++) {
+        polygon->contourStarts[i] = polygon->pointCount;
+        polygon->pointCount += contourPointCounts[i];
+    }
+    polygon->contourStarts[contourCount] = polygon->pointCount;
+    polygon->points = malloc(MAX(polygon->pointCount, (NSUInteger)1) * sizeof(CGPoint));
+    if ( polygon->pointCount > 0 )
+        memcpy(polygon->points, points, polygon->pointCount * sizeof(CGPoint));
+    return polygon;
+}
+
+void FBPolygonRelease(FBPolygonRef polygon)
+{
+    if ( polygon == NULL )
+        return;
+    free(polygon->points);
+    free(polygon->contourStarts);
+    free(polygon);
+}
+
+NSUInteger FBPolygonGetContourCount(FBPolygonRef polygon)
+{
+    return polygon->contourCount;
+}
+
+const CGPoint *FBPolygonGetContourPoints(FBPolygonRef polygon, NSUInteger contourIndex, NSUInteger *outCount)
+{
+    *outCount = polygon->contourStarts[contourIndex + 1] - polygon->contourStarts[contourIndex];
+    return polygon->points + polygon->contourStarts[contourIndex];
+}
+
+#pragma mark Geometry
+
+static int FBPolygonComparePoints(CGPoint point1, CGPoint point2)
+{
+    if ( point1.x != point2.x )
+        return point1.x < point2.x ? -1 : 1;
+    if ( point1.y != point2.y )
+        return point1.y < point2.y ? -1 : 1;
+    return 0;
+}
+
+static int FBPolygonComparePieces(const void *value1, const void *value2)
+{
+    const FBPolygonPiece *piece1 = value1;
+    const FBPolygonPiece *piece2 = value2;
+    int order = FBPolygonComparePoints(piece1->left, piece2->left);
+    if ( order != 0 )
+        return order;
+    return FBPolygonComparePoints(piece1->right, piece2->right);
+}
+
+// Positive if point3 is to the left of the line going from point1 to point2
+static CGFloat FBPolygonOrientation(CGPoint point1, CGPoint point2, CGPoint point3)
+{
+    return (point2.x - point1.x) * (point3.y - point1.y) - (point2.y - point1.y) * (point3.x - point1.x);
+}
+
+#pragma mark Splitting
+
+static void FBPolygonAddSplit(FBPolygonSplitList *list, const FBPolygonPiece *pieces, NSUInteger pieceIndex, CGPoint point, BOOL isOnPiece)
+{
+    // isOnPiece says the point is known to lie on the piece, like where two pieces cross.
+    //  It's split there even when the parameter rounds to an end, or the other piece's
+    //  split at the point would have nothing on this one to meet.
+    const FBPolygonPiece *piece = &pieces[pieceIndex];
+    if ( CGPointEqualToPoint(point, piece->left) || CGPointEqualToPoint(point, piece->right) )
+        return;
+    CGFloat deltaX = piece->right.x - piece->left.x;
+    CGFloat deltaY = piece->right.y - piece->left.y;
+    CGFloat parameter = ((point.x - piece->left.x) * deltaX + (point.y - piece->left.y) * deltaY) / (deltaX * deltaX + deltaY * deltaY);
+    if ( isOnPiece )
+        parameter = MIN(MAX(parameter, 0.0), 1.0);
+    else if ( parameter <= 0.0 || parameter >= 1.0 )
+        return; // beyond the ends, where collinear pieces don't overlap
+
+    if ( list->count == list->capacity ) {
+        list->capacity = MAX(list->capacity * 2, (NSUInteger)64);
+        list->splits = realloc(list->splits, list->capacity * sizeof(FBPolygonSplit));
+    }
+    FBPolygonSplit *split = &list->splits[list->count++];
+    split->pieceIndex = pieceIndex;
+    split->parameter = parameter;
+    split->point = point;
+}
+
+static CGPoint FBPolygonSnapToEnd(CGPoint point, const FBPolygonPiece *piece, CGFloat threshold)
+{
+    if ( fabs(point.x - piece->left.x) <= threshold && fabs(point.y - piece->left.y) <= threshold )
+        return piece->left;
+    if ( fabs(point.x - piece->right.x) <= threshold && fabs(point.y - piece->right.y) <= threshold )
+        return piece->right;
+    return point;
+}
+
+static void FBPolygonIntersectPieces(const FBPolygonPiece *pieces, NSUInteger pieceIndex1, NSUInteger pieceIndex2, BOOL findCrossings, CGFloat snapThreshold, FBPolygonSplitList *list)
+{
+    // Which of the two comes first mustn't change the point they cross at
+    if ( FBPolygonComparePieces(&pieces[pieceIndex1], &pieces[pieceIndex2]) > 0 ) {
+        NSUInteger pieceIndex = pieceIndex1;
+        pieceIndex1 = pieceIndex2;
+        pieceIndex2 = pieceIndex;
+    }
+    CGPoint left1 = pieces[pieceIndex1].left;
+    CGPoint right1 = pieces[pieceIndex1].right;
+    CGPoint left2 = pieces[pieceIndex2].left;
+    CGPoint right2 = pieces[pieceIndex2].right;
+
+    CGFloat left2Side = FBPolygonOrientation(left1, right1, left2);
+    CGFloat right2Side = FBPolygonOrientation(left1, right1, right2);
+    if ( left2Side == 0.0 && right2Side == 0.0 ) {
+        // On the same line, so they overlap between the ends that lie on both
+        FBPolygonAddSplit(list, pieces, pieceIndex1, left2, NO);
+        FBPolygonAddSplit(list, pieces, pieceIndex1, right2, NO);
+        FBPolygonAddSplit(list, pieces, pieceIndex2, left1, NO);
+        FBPolygonAddSplit(list, pieces, pieceIndex2, right1, NO);
+        return;
+    }
+    if ( (left2Side > 0.0 && right2Side > 0.0) || (left2Side < 0.0 && right2Side < 0.0) )
+        return;
+    CGFloat left1Side = FBPolygonOrientation(left2, right2, left1);
+    CGFloat right1Side = FBPolygonOrientation(left2, right2, right1);
+    if ( (left1Side > 0.0 && right1Side > 0.0) || (left1Side < 0.0 && right1Side < 0.0) )
+        return;
+
+    // Where an end lies on the other piece, that's where they meet
+    if ( left2Side == 0.0 || right2Side == 0.0 || left1Side == 0.0 || right1Side == 0.0 ) {
+        if ( left2Side == 0.0 )
+            FBPolygonAddSplit(list, pieces, pieceIndex1, left2, NO);
+        if ( right2Side == 0.0 )
+            FBPolygonAddSplit(list, pieces, pieceIndex1, right2, NO);
+        if ( left1Side == 0.0 )
+            FBPolygonAddSplit(list, pieces, pieceIndex2, left1, NO);
+        if ( right1Side == 0.0 )
+            FBPolygonAddSplit(list, pieces, pieceIndex2, right1, NO);
+        return;
+    }
+    if ( !findCrossings )
+        return;
+
+    // They cross. Both are split at the very same point, so their pieces meet exactly.
+    //  Rounding can't be allowed to move it out of either piece's bounds.
+    CGFloat parameter = left1Side / (left1Side - right1Side);
+    CGPoint point = CGPointMake(left1.x + (right1.x - left1.x) * parameter, left1.y + (right1.y - left1.y) * parameter);
+    point.x = MIN(MAX(point.x, MAX(left1.x, left2.x)), MIN(right1.x, right2.x));
+    point.y = MIN(MAX(point.y, MAX(MIN(left1.y, right1.y), MIN(left2.y, right2.y))), MIN(MAX(left1.y, right1.y), MAX(left2.y, right2.y)));
+    point = FBPolygonSnapToEnd(point, &pieces[pieceIndex1], snapThreshold);
+    point = FBPolygonSnapToEnd(point, &pieces[pieceIndex2], snapThreshold);
+    FBPolygonAddSplit(list, pieces, pieceIndex1, point, YES);
+    FBPolygonAddSplit(list, pieces, pieceIndex2, point, YES);
+}
+
+static int FBPolygonCompareSplits(const void *value1, const void *value2)
+{
+    const FBPolygonSplit *split1 = value1;
+    const FBPolygonSplit *split2 = value2;
+    if ( split1->pieceIndex != split2->pieceIndex )
+        return split1->pieceIndex < split2->pieceIndex ? -1 : 1;
+    if ( split1->parameter != split2->parameter )
+        return split1->parameter < split2->parameter ? -1 : 1;
+    return 0;
+}
+
+static void FBPolygonAddPiece(FBPolygonPiece *pieces, NSUInteger *count, CGPoint point1, CGPoint point2, const BOOL flips[2])
+{
+    int order = FBPolygonComparePoints(point1, point2);
+    if ( order == 0 )
+        return;
+    FBPolygonPiece *piece = &pieces[(*count)++];
+    memset(piece, 0, sizeof(FBPolygonPiece));
+    piece->left = order < 0 ? point1 : point2;
+    piece->right = order < 0 ? point2 : point1;
+    piece->flips[0] = flips[0];
+    piece->flips[1] = flips[1];
+}
+
+static NSUInteger FBPolygonMergePieces(FBPolygonPiece *pieces, NSUInteger count)
+{
+    // Merge the pieces that lie on top of each other. Where they cancel out, going
+    //  across doesn't change anything, and they're dropped altogether.
+    if ( count > 0 )
+        qsort(pieces, count, sizeof(FBPolygonPiece), FBPolygonComparePieces);
+    NSUInteger mergedCount = 0;
+    for (NSUInteger i = 0; i < count; ) {
+        FBPolygonPiece merged = pieces[i++];
+        for (; i < count && FBPolygonComparePieces(&merged, &pieces[i]) == 0; i++) {
+            merged.flips[0] = merged.flips[0] != pieces[i].flips[0];
+            merged.flips[1] = merged.flips[1] != pieces[i].flips[1];
+        }
+        if ( merged.flips[0] || merged.flips[1] )
+            pieces[mergedCount++] = merged;
+    }
+    return mergedCount;
+}
+
+static int FBPolygonCompareSplitsByPoint(const void *value1, const void *value2)
+{
+    const FBPolygonSplit *split1 = *(const FBPolygonSplit **)value1;
+    const FBPolygonSplit *split2 = *(const FBPolygonSplit **)value2;
+    return FBPolygonComparePoints(split1->point, split2->point);
+}
+
+static void FBPolygonSnapSplits(FBPolygonSplitList *list, CGFloat threshold)
+{
+    // Move each split onto the first one before it, by x, that's closer than the threshold
+    FBPolygonSplit **sortedSplits = malloc(MAX(list->count, (NSUInteger)1) * sizeof(FBPolygonSplit *));
+    for (NSUInteger i = 0; i < list->count; i++)
+        sortedSplits[i] = &list->splits[i];
+    if ( list->count > 0 )
+        qsort(sortedSplits, list->count, sizeof(FBPolygonSplit *), FBPolygonCompareSplitsByPoint);
+    for (NSUInteger i = 1; i < list->count; i++) {
+        FBPolygonSplit *split = sortedSplits[i];
+        for (NSUInteger j = i; j > 0 && split->point.x - sortedSplits[j - 1]->point.x <= threshold; j--) {
+            CGPoint point = sortedSplits[j - 1]->point;
+            if ( fabs(split->point.y - point.y) <= threshold ) {
+                split->point = point;
+                break;
+            }
+        }
+    }
+    free(sortedSplits);
+}
+
+static FBPolygonPiece *FBPolygonSplitPieces(FBPolygonPiece *pieces, NSUInteger *count, BOOL findCrossings, CGFloat snapThreshold, BOOL *outDidSplit)
+{
+    // Find the pieces that meet, each other as well as those of the same polygon, so
+    //  self intersecting polygons come out right too. The edge index hands out every
+    //  pair in both orders, only look at one of them.
+    FBEdgeIndexEntry *entries = malloc(MAX(*count, (NSUInteger)1) * sizeof(FBEdgeIndexEntry));
+    for (NSUInteger i = 0; i < *count; i++) {
+        CGPoint left = pieces[i].left;
+        CGPoint right = pieces[i].right;
+        entries[i].bounds = CGRectMake(left.x, MIN(left.y, right.y), right.x - left.x, fabs(right.y - left.y));
+        entries[i].contourIndex = 0;
+        entries[i].edgeIndex = i;
+    }
+    FBEdgeIndexRef index = FBEdgeIndexCreate(entries, *count);
+    free(entries);
+    NSUInteger pairCount = 0;
+    FBEdgeIndexPair *pairs = FBEdgeIndexCopyOverlappingPairs(index, index, &pairCount);
+    FBEdgeIndexRelease(index);
+    FBPolygonSplitList list = { NULL, 0, 0 };
+    for (NSUInteger i = 0; i < pairCount; i++) {
+        if ( pairs[i].edgeIndex1 < pairs[i].edgeIndex2 )
+            FBPolygonIntersectPieces(pieces, pairs[i].edgeIndex1, pairs[i].edgeIndex2, findCrossings, snapThreshold, &list);
+    }
+    free(pairs);
+    if ( findCrossings )
+        FBPolygonSnapSplits(&list, snapThreshold);
+    *outDidSplit = list.count > 0;
+
+    // Cut the pieces at the splits
+    if ( list.count > 0 )
+        qsort(list.splits, list.count, sizeof(FBPolygonSplit), FBPolygonCompareSplits);
+    FBPolygonPiece *splitPieces = malloc(MAX(*count + list.count, (NSUInteger)1) * sizeof(FBPolygonPiece));
+    NSUInteger splitCount = 0;
+    NSUInteger splitIndex = 0;
+    for (NSUInteger i = 0; i < *count; i++) {
+        CGPoint previousPoint = pieces[i].left;
+        for (; splitIndex < list.count && list.splits[splitIndex].pieceIndex == i; splitIndex++) {
+            FBPolygonAddPiece(splitPieces, &splitCount, previousPoint, list.splits[splitIndex].point, pieces[i].flips);
+            previousPoint = list.splits[splitIndex].point;
+        }
+        FBPolygonAddPiece(splitPieces, &splitCount, previousPoint, pieces[i].right, pieces[i].flips);
+    }
+    free(list.splits);
+    free(pieces);
+
+    *count = FBPolygonMergePieces(splitPieces, splitCount);
+    return splitPieces;
+}
+
+#pragma mark Sweep
+
+static int FBPolygonCompareEvents(const void *value1, const void *value2)
+{
+    // At the same point pieces end before others start, so a piece starting where
+    //  another ends never finds it in the sweep line. Pieces starting together go in
+    //  from the bottom up, so the one below each is already there when it looks.
+    const FBPolygonEvent *event1 = value1;
+    const FBPolygonEvent *event2 = value2;
+    int order = FBPolygonComparePoints(event1->point, event2->point);
+    if ( order != 0 )
+        return order;
+    if ( event1->isLeft != event2->isLeft )
+        return event1->isLeft ? 1 : -1;
+    if ( event1->isLeft ) {
+        CGFloat side = FBPolygonOrientation(event1->point, event2->otherPoint, event1->otherPoint);
+        if ( side != 0.0 )
+            return side < 0.0 ? -1 : 1;
+    }
+    if ( event1->pieceIndex != event2->pieceIndex )
+        return event1->pieceIndex < event2->pieceIndex ? -1 : 1;
+    return 0;
+}
+
+static BOOL FBPolygonIsPieceBelow(const FBPolygonPiece *piece1, const FBPolygonPiece *piece2)
+{
+    // Both pieces are in the sweep line, so whichever started first spans where the
+    //  other starts, and which side of it that start is on orders the two.
+    if ( CGPointEqualToPoint(piece1->left, piece2->left) )
+        return FBPolygonOrientation(piece2->left, piece2->right, piece1->right) < 0.0;
+    if ( FBPolygonComparePoints(piece1->left, piece2->left) < 0 ) {
+        CGFloat side = FBPolygonOrientation(piece1->left, piece1->right, piece2->left);
+        if ( side == 0.0 )
+            side = FBPolygonOrientation(piece1->left, piece1->right, piece2->right);
+        return side > 0.0;
+    }
+    CGFloat side = FBPolygonOrientation(piece2->left, piece2->right, piece1->left);
+    if ( side == 0.0 )
+        side = FBPolygonOrientation(piece2->left, piece2->right, piece1->right);
+    return side < 0.0;
+}
+
+static NSUInteger FBPolygonFindInSweepLine(FBPolygonPiece **sweepLine, NSUInteger count, const FBPolygonPiece *piece)
+{
+    // The first piece in the sweep line that isn't below the piece
+    NSUInteger low = 0;
+    NSUInteger high = count;
+    while ( low < high ) {
+        NSUInteger middle = (low + high) / 2;
+        if ( FBPolygonIsPieceBelow(sweepLine[middle], piece) )
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+static void FBPolygonSweep(FBPolygonPiece *pieces, const FBPolygonEvent *events, NSUInteger eventCount)
+{
+    // The sweep line holds the pieces it's crossing, from the bottom up. Pieces don't
+    //  cross each other, so their order doesn't change while they're in it, and the piece
+    //  right below a new one tells which polygons the new one starts inside of.
+    FBPolygonPiece **sweepLine = malloc(MAX(eventCount / 2, (NSUInteger)1) * sizeof(FBPolygonPiece *));
+    NSUInteger count = 0;
+    for (NSUInteger i = 0; i < eventCount; i++) {
+        FBPolygonPiece *piece = &pieces[events[i].pieceIndex];
+        NSUInteger position = FBPolygonFindInSweepLine(sweepLine, count, piece);
+        if ( events[i].isLeft ) {
+            if ( position > 0 ) {
+                const FBPolygonPiece *below = sweepLine[position - 1];
+                for (NSUInteger polygonIndex = 0; polygonIndex < 2; polygonIndex++)
+                    piece->insideBelow[polygonIndex] = below->insideBelow[polygonIndex] != below->flips[polygonIndex];
+            }
+            memmove(sweepLine + position + 1, sweepLine + position, (count - position) * sizeof(FBPolygonPiece *));
+            sweepLine[position] = piece;
+            count++;
+        } else {
+            // Rounding can leave pieces out of order, then look for it the slow way
+            if ( position >= count || sweepLine[position] != piece ) {
+                for (position = 0; position < count && sweepLine[position] != piece; position++)
+                    ;
+            }
+            if ( position < count ) {
+                memmove(sweepLine + position, sweepLine + position + 1, (count - position - 1) * sizeof(FBPolygonPiece *));
+                count--;
+            }
+        }
+    }
+    free(sweepLine);
+}
+
+#pragma mark Contours
+
+static BOOL FBPolygonIsFilled(const BOOL inside[2], FBBooleanOperation operation)
+{
+    switch (operation) {
+        case FBBooleanOperationUnion:
+            return inside[0] || inside[1];
+        case FBBooleanOperationIntersect:
+            return inside[0] && inside[1];
+        case FBBooleanOperationDifference:
+            return inside[0] && !inside[1];
+        case FBBooleanOperationXOR:
+            return inside[0] != inside[1];
+    }
+    return NO;
+}
+
+static NSUInteger FBPolygonRemoveCollinearPoints(CGPoint *points, NSUInteger count)
+{
+    // Splitting leaves points in the middle of straight runs, take them out again
+    NSUInteger keptCount = 0;
+    for (NSUInteger i = 0; i < count; i++) {
+        while ( keptCount >= 2 && FBPolygonOrientation(points[keptCount - 2], points[keptCount - 1], points[i]) == 0.0 )
+            keptCount--;
+        points[keptCount++] = points[i];
+    }
+
+    // The contour is closed, so a run can go around from its last point to its first
+    NSUInteger first = 0;
+    while ( keptCount - first >= 3 ) {
+        if ( FBPolygonOrientation(points[keptCount - 2], points[keptCount - 1], points[first]) == 0.0 )
+            keptCount--;
+        else if ( FBPolygonOrientation(points[keptCount - 1], points[first], points[first + 1]) == 0.0 )
+            first++;
+        else
+            break;
+    }
+    memmove(points, points + first, (keptCount - first) * sizeof(CGPoint));
+    return keptCount - first;
+}
+
+static NSUInteger FBPolygonNextEdge(const FBPolygonEdge *edges, const NSUInteger *outgoing, const NSUInteger *outgoingStarts, const CGPoint *vertices, const FBPolygonEdge *edge)
+{
+    // Where several contours of the result touch, turning left as far as possible
+    //  stays on the same one, so they come out as separate contours.
+    CGPoint direction = CGPointMake(vertices[edge->to].x - vertices[edge->from].x, vertices[edge->to].y - vertices[edge->from].y);
+    NSUInteger nextEdge = FBPolygonNoEdge;
+    CGFloat largestTurn = 0.0;
+    for (NSUInteger i = outgoingStarts[edge->to]; i < outgoingStarts[edge->to + 1]; i++) {
+        const FBPolygonEdge *candidate = &edges[outgoing[i]];
+        if ( candidate->used )
+            continue;
+        CGPoint nextDirection = CGPointMake(vertices[candidate->to].x - vertices[candidate->from].x, vertices[candidate->to].y - vertices[candidate->from].y);
+        CGFloat turn = atan2(direction.x * nextDirection.y - direction.y * nextDirection.x, direction.x * nextDirection.x + direction.y * nextDirection.y);
+        if ( nextEdge == FBPolygonNoEdge || turn > largestTurn ) {
+            nextEdge = outgoing[i];
+            largestTurn = turn;
+        }
+    }
+    return nextEdge;
+}
+
+static FBPolygonRef FBPolygonCreateFromEdges(FBPolygonEdge *edges, NSUInteger edgeCount, const CGPoint *vertices, NSUInteger vertexCount)
+{
+    // Sort the edges by the vertex they leave from
+    NSUInteger *outgoingStarts = calloc(vertexCount + 1, sizeof(NSUInteger));
+    NSUInteger *outgoing = malloc(MAX(edgeCount, (NSUInteger)1) * sizeof(NSUInteger));
+    for (NSUInteger i = 0; i < edgeCount; i++)
+        outgoingStarts[edges[i].from + 1]++;
+    for (NSUInteger i = 0; i < vertexCount; i++)
+        outgoingStarts[i + 1] += outgoingStarts[i];
+    NSUInteger *positions = malloc(MAX(vertexCount, (NSUInteger)1) * sizeof(NSUInteger));
+    memcpy(positions, outgoingStarts, vertexCount * sizeof(NSUInteger));
+    for (NSUInteger i = 0; i < edgeCount; i++)
+        outgoing[positions[edges[i].from]++] = i;
+    free(positions);
+
+    // Every vertex has as many edges going in as going out, so following the edges
+    //  from any one always leads back to where it started.
+    CGPoint *points = malloc(MAX(edgeCount, (NSUInteger)1) * sizeof(CGPoint));
+    NSUInteger *contourPointCounts = malloc(MAX(edgeCount, (NSUInteger)1) * sizeof(NSUInteger));
+    NSUInteger pointCount = 0;
+    NSUInteger contourCount = 0;
+    for (NSUInteger i = 0; i < edgeCount; i++) {
+        if ( edges[i].used )
+            continue;
+        NSUInteger contourStart = pointCount;
+        NSUInteger edgeIndex = i;
+        while ( edgeIndex != FBPolygonNoEdge ) {
+            FBPolygonEdge *edge = &edges[edgeIndex];
+            edge->used = YES;
+            points[pointCount++] = vertices[edge->from];
+            if ( edge->to == edges[i].from )
+                break;
+            edgeIndex = FBPolygonNextEdge(edges, outgoing, outgoingStarts, vertices, edge);
+        }
+        NSUInteger contourPointCount = FBPolygonRemoveCollinearPoints(points + contourStart, pointCount - contourStart);
+        if ( contourPointCount >= 3 ) {
+            pointCount = contourStart + contourPointCount;
+            contourPointCounts[contourCount++] = contourPointCount;
+        } else
+            pointCount = contourStart;
+    }
+
+    FBPolygonRef polygon = FBPolygonCreate(points, contourPointCounts, contourCount);
+    free(points);
+    free(contourPointCounts);
+    free(outgoing);
+    free(outgoingStarts);
+    return polygon;
+}
+
+#pragma mark Operations
+
+FBPolygonRef FBPolygonCreateWithOperation(FBPolygonRef polygon1, FBPolygonRef polygon2, FBBooleanOperation operation)
+{
+    // Every segment of both polygons starts out as a piece of its own
+    FBPolygonRef polygons[2] = { polygon1, polygon2 };
+    FBPolygonPiece *pieces = malloc(MAX(polygon1->pointCount + polygon2->pointCount, (NSUInteger)1) * sizeof(FBPolygonPiece));
+    NSUInteger pieceCount = 0;
+    for (NSUInteger polygonIndex = 0; polygonIndex < 2; polygonIndex++) {
+        FBPolygonRef polygon = polygons[polygonIndex];
+        BOOL flips[2] = { polygonIndex == 0, polygonIndex == 1 };
+        for (NSUInteger contourIndex = 0; contourIndex < polygon->contourCount; contourIndex++) {
+            NSUInteger start = polygon->contourStarts[contourIndex];
+            NSUInteger end = polygon->contourStarts[contourIndex + 1];
+            for (NSUInteger i = start; i < end; i++)
+                FBPolygonAddPiece(pieces, &pieceCount, polygon->points[i], polygon->points[i + 1 < end ? i + 1 : start], flips);
+        }
+    }
+
+    // Split where segments overlap or an end touches another segment first. Those
+    //  splits are at points that were there already, and afterwards overlapping segments
+    //  have turned into the same pieces. Only then are crossings computed, so a crossing
+    //  is computed once for all the segments on top of each other.
+    CGFloat largestCoordinate = 1.0;
+    for (NSUInteger i = 0; i < pieceCount; i++)
+        largestCoordinate = MAX(largestCoordinate, MAX(MAX(fabs(pieces[i].left.x), fabs(pieces[i].left.y)), MAX(fabs(pieces[i].right.x), fabs(pieces[i].right.y))));
+    CGFloat snapThreshold = largestCoordinate * FBPolygonSnapThreshold;
+    BOOL didSplit = NO;
+    pieceCount = FBPolygonMergePieces(pieces, pieceCount);
+    pieces = FBPolygonSplitPieces(pieces, &pieceCount, NO, snapThreshold, &didSplit);
+    for (NSUInteger pass = 0; pass < FBPolygonMaximumCrossingPasses; pass++) {
+        pieces = FBPolygonSplitPieces(pieces, &pieceCount, YES, snapThreshold, &didSplit);
+        if ( !didSplit )
+            break;
+    }
+
+    // Sort the ends of the pieces for the sweep. Equal points end up next to each
+    //  other, which numbers the vertices along the way.
+    NSUInteger eventCount = pieceCount * 2;
+    FBPolygonEvent *events = malloc(MAX(eventCount, (NSUInteger)1) * sizeof(FBPolygonEvent));
+    for (NSUInteger i = 0; i < pieceCount; i++) {
+        events[2 * i] = (FBPolygonEvent){ pieces[i].left, pieces[i].right, YES, i };
+        events[2 * i + 1] = (FBPolygonEvent){ pieces[i].right, pieces[i].left, NO, i };
+    }
+    if ( eventCount > 0 )
+        qsort(events, eventCount, sizeof(FBPolygonEvent), FBPolygonCompareEvents);
+    CGPoint *vertices = malloc(MAX(eventCount, (NSUInteger)1) * sizeof(CGPoint));
+    NSUInteger vertexCount = 0;
+    for (NSUInteger i = 0; i < eventCount; i++) {
+        if ( vertexCount == 0 || !CGPointEqualToPoint(vertices[vertexCount - 1], events[i].point) )
+            vertices[vertexCount++] = events[i].point;
+        if ( events[i].isLeft )
+            pieces[events[i].pieceIndex].leftVertex = vertexCount - 1;
+        else
+            pieces[events[i].pieceIndex].rightVertex = vertexCount - 1;
+    }
+
+    FBPolygonSweep(pieces, events, eventCount);
+    free(events);
+
+    // A piece with the result filled on one side only is part of its boundary. Point
+    //  it so what's filled is on its left; above is on the left going left to right.
+    FBPolygonEdge *edges = malloc(MAX(pieceCount, (NSUInteger)1) * sizeof(FBPolygonEdge));
+    NSUInteger edgeCount = 0;
+    for (NSUInteger i = 0; i < pieceCount; i++) {
+        const FBPolygonPiece *piece = &pieces[i];
+        BOOL insideAbove[2] = { piece->insideBelow[0] != piece->flips[0], piece->insideBelow[1] != piece->flips[1] };
+        BOOL filledBelow = FBPolygonIsFilled(piece->insideBelow, operation);
+        BOOL filledAbove = FBPolygonIsFilled(insideAbove, operation);
+        if ( filledBelow == filledAbove )
+            continue;
+        edges[edgeCount].from = filledAbove ? piece->leftVertex : piece->rightVertex;
+        edges[edgeCount].to = filledAbove ? piece->rightVertex : piece->leftVertex;
+        edges[edgeCount].used = NO;
+        edgeCount++;
+    }
+    free(pieces);
+
+    FBPolygonRef result = FBPolygonCreateFromEdges(edges, edgeCount, vertices, vertexCount);
+    free(edges);
+    free(vertices);
+    return result;
+}
+
+#pragma mark Tiles
+
+static CGFloat FBPolygonGetCoordinate(CGPoint point, NSUInteger axis)
+{
+    return axis == 0 ? point.x : point.y;
+}
+
+static CGFloat FBPolygonTilingGetSeam(const FBPolygonTiling *tiling, NSUInteger axis, NSUInteger index)
+{
+    // Seam index is where tile index starts along the axis. The last one is the edge of
+    //  the bounds, not where a whole tile would end.
+    CGFloat maximum = FBPolygonGetCoordinate(tiling->maximum, axis);
+    if ( index >= tiling->counts[axis] )
+        return maximum;
+    return MIN(FBPolygonGetCoordinate(tiling->minimum, axis) + index * tiling->tileSize, maximum);
+}
+
+static NSUInteger FBPolygonTilingFindSeam(const FBPolygonTiling *tiling, NSUInteger axis, CGFloat value)
+{
+    // Only the seams between two tiles count, not the edges of the bounds
+    CGFloat position = floor((value - FBPolygonGetCoordinate(tiling->minimum, axis)) / tiling->tileSize + 0.5);
+    if ( position < 1.0 || position >= tiling->counts[axis] )
+        return FBPolygonNoSeam;
+    NSUInteger index = (NSUInteger)position;
+    if ( FBPolygonTilingGetSeam(tiling, axis, index) != value )
+        return FBPolygonNoSeam;
+    return axis == 0 ? index - 1 : tiling->counts[0] - 1 + index - 1;
+}
+
+static CGPoint FBPolygonTilingGetPointOnSeam(const FBPolygonTiling *tiling, NSUInteger seamIndex, CGFloat value)
+{
+    if ( seamIndex < tiling->counts[0] - 1 )
+        return CGPointMake(FBPolygonTilingGetSeam(tiling, 0, seamIndex + 1), value);
+    return CGPointMake(value, FBPolygonTilingGetSeam(tiling, 1, seamIndex - (tiling->counts[0] - 1) + 1));
+}
+
+static void FBPolygonTilingGetTileRange(const FBPolygonTiling *tiling, NSUInteger axis, CGFloat minimum, CGFloat maximum, NSUInteger *first, NSUInteger *last)
+{
+    // Dividing can round to the wrong side of a seam, the seams themselves have the last word
+    NSUInteger count = tiling->counts[axis];
+    CGFloat origin = FBPolygonGetCoordinate(tiling->minimum, axis);
+    *first = (NSUInteger)MIN(MAX(floor((minimum - origin) / tiling->tileSize), 0.0), (CGFloat)(count - 1));
+    *last = (NSUInteger)MIN(MAX(floor((maximum - origin) / tiling->tileSize), 0.0), (CGFloat)(count - 1));
+    while ( *first > 0 && FBPolygonTilingGetSeam(tiling, axis, *first) > minimum )
+        (*first)--;
+    while ( *last + 1 < count && FBPolygonTilingGetSeam(tiling, axis, *last + 1) <= maximum )
+        (*last)++;
+}
+
+static CGPoint FBPolygonCrossingWithSeam(CGPoint point1, CGPoint point2, NSUInteger axis, CGFloat value)
+{
+    // Always computed from the smaller end, so the tiles on both sides of a seam get the
+    //  same point for the same segment
+    if ( FBPolygonComparePoints(point2, point1) < 0 ) {
+        CGPoint point = point1;
+        point1 = point2;
+        point2 = point;
+    }
+    if ( axis == 0 )
+        return CGPointMake(value, point1.y + (point2.y - point1.y) * (value - point1.x) / (point2.x - point1.x));
+    return CGPointMake(point1.x + (point2.x - point1.x) * (value - point1.y) / (point2.y - point1.y), value);
+}
+
+static CGPoint *FBPolygonReservePoints(CGPoint *points, NSUInteger *capacity, NSUInteger count)
+{
+    if ( count > *capacity ) {
+        *capacity = MAX(count, *capacity * 2);
+        points = realloc(points, *capacity * sizeof(CGPoint));
+    }
+    return points;
+}
+
+static void FBPolygonAddPointToStrip(FBPolygonStrip *strip, CGPoint point)
+{
+    if ( strip->count > 0 && CGPointEqualToPoint(strip->points[strip->count - 1], point) )
+        return;
+    strip->points = FBPolygonReservePoints(strip->points, &strip->capacity, strip->count + 1);
+    strip->points[strip->count++] = point;
+}
+
+static CGPoint FBPolygonGetPointOnSegment(CGPoint point1, CGPoint point2, NSUInteger axis, CGFloat value)
+{
+    // The ends are taken as they are, only the points in between are computed
+    if ( FBPolygonGetCoordinate(point1, axis) == value )
+        return point1;
+    if ( FBPolygonGetCoordinate(point2, axis) == value )
+        return point2;
+    return FBPolygonCrossingWithSeam(point1, point2, axis, value);
+}
+
+static void FBPolygonCutContourIntoStrips(const FBPolygonTiling *tiling, const CGPoint *points, NSUInteger count, NSUInteger axis, NSUInteger firstStrip, FBPolygonStrip *strips)
+{
+    // Every segment goes to the strips of tiles it passes through, cut at the seams between
+    //  them, so each strip gets the parts of the contour inside it, in order. Where the contour
+    //  leaves a strip, it comes back on the same side, and closing the gap along the seam is
+    //  what clipping the contour to the strip would do (Sutherland-Hodgman). This way, all the
+    //  strips take one pass over the contour, instead of one each. A segment that only touches
+    //  a strip on its seam, with an end or lying on it, adds nothing there but points along the
+    //  seam, which closing the gap takes care of. So it's skipped: a vertex on a seam only goes
+    //  to the tiles its segments pass through, and a segment on a seam to none, rather than
+    //  leaving the same contact in the tiles on both sides.
+    for (NSUInteger i = 0; i < count; i++) {
+        CGPoint point = points[i];
+        CGPoint nextPoint = points[i + 1 < count ? i + 1 : 0];
+        CGFloat value = FBPolygonGetCoordinate(point, axis);
+        CGFloat nextValue = FBPolygonGetCoordinate(nextPoint, axis);
+        CGFloat minimum = MIN(value, nextValue);
+        CGFloat maximum = MAX(value, nextValue);
+        NSUInteger first = 0;
+        NSUInteger last = 0;
+        FBPolygonTilingGetTileRange(tiling, axis, minimum, maximum, &first, &last);
+        for (NSUInteger index = first; index <= last; index++) {
+            CGFloat lower = FBPolygonTilingGetSeam(tiling, axis, index);
+            CGFloat upper = FBPolygonTilingGetSeam(tiling, axis, index + 1);
+            if ( lower >= maximum || upper <= minimum )
+                continue;
+            CGFloat entry = value <= nextValue ? MAX(minimum, lower) : MIN(maximum, upper);
+            CGFloat exit = value <= nextValue ? MIN(maximum, upper) : MAX(minimum, lower);
+            FBPolygonStrip *strip = &strips[index - firstStrip];
+            FBPolygonAddPointToStrip(strip, FBPolygonGetPointOnSegment(point, nextPoint, axis, entry));
+            FBPolygonAddPointToStrip(strip, FBPolygonGetPointOnSegment(point, nextPoint, axis, exit));
+        }
+    }
+}
+
+static void FBPolygonTilingAddContour(FBPolygonTiling *tiling, NSUInteger tileIndex, NSUInteger polygonIndex, const FBPolygonStrip *strip)
+{
+    // The last point is the first again if the contour was closed in the strip
+    NSUInteger count = strip->count;
+    if ( count > 1 && CGPointEqualToPoint(strip->points[count - 1], strip->points[0]) )
+        count--;
+    if ( count < 3 )
+        return;
+    tiling->tilePoints = FBPolygonReservePoints(tiling->tilePoints, &tiling->tilePointCapacity, tiling->tilePointCount + count);
+    memcpy(tiling->tilePoints + tiling->tilePointCount, strip->points, count * sizeof(CGPoint));
+    if ( tiling->tileContourCount == tiling->tileContourCapacity ) {
+        tiling->tileContourCapacity = MAX(tiling->tileContourCapacity * 2, (NSUInteger)16);
+        tiling->tileContours = realloc(tiling->tileContours, tiling->tileContourCapacity * sizeof(FBPolygonTileContour));
+    }
+    tiling->tileContours[tiling->tileContourCount++] = (FBPolygonTileContour){ tileIndex, polygonIndex, tiling->tilePointCount, count };
+    tiling->tilePointCount += count;
+}
+
+static FBPolygonStrip *FBPolygonReserveStrips(FBPolygonStrip *strips, NSUInteger *capacity, NSUInteger count)
+{
+    if ( count > *capacity ) {
+        strips = realloc(strips, count * sizeof(FBPolygonStrip));
+        memset(strips + *capacity, 0, (count - *capacity) * sizeof(FBPolygonStrip));
+        *capacity = count;
+    }
+    for (NSUInteger i = 0; i < count; i++)
+        strips[i].count = 0;
+    return strips;
+}
+
+static void FBPolygonTilingCutContours(FBPolygonTiling *tiling)
+{
+    // Cut every contour into columns, and the part in each column into rows, which gives
+    //  the part in each tile. The bits of the seams the cutting adds either cancel each
+    //  other out when the pieces are merged, or they're where the tile is inside the polygon
+    //  up to its side. It takes time for the points, and for the seams the segments cross,
+    //  but not for the tiles the segments don't reach.
+    FBPolygonStrip *columns = NULL;
+    NSUInteger columnCapacity = 0;
+    FBPolygonStrip *rows = NULL;
+    NSUInteger rowCapacity = 0;
+    NSUInteger contourIndex = 0;
+    for (NSUInteger polygonIndex = 0; polygonIndex < 2; polygonIndex++) {
+        FBPolygonRef polygon = tiling->polygons[polygonIndex];
+        for (NSUInteger polygonContourIndex = 0; polygonContourIndex < polygon->contourCount; polygonContourIndex++, contourIndex++) {
+            const CGPoint *bounds = &tiling->contourBounds[2 * contourIndex];
+            if ( bounds[0].x > bounds[1].x )
+                continue; // no points
+            NSUInteger count = 0;
+            const CGPoint *points = FBPolygonGetContourPoints(polygon, polygonContourIndex, &count);
+            NSUInteger firstColumn = 0;
+            NSUInteger lastColumn = 0;
+            FBPolygonTilingGetTileRange(tiling, 0, bounds[0].x, bounds[1].x, &firstColumn, &lastColumn);
+            columns = FBPolygonReserveStrips(columns, &columnCapacity, lastColumn - firstColumn + 1);
+            FBPolygonCutContourIntoStrips(tiling, points, count, 0, firstColumn, columns);
+            
+            for (NSUInteger column = firstColumn; column <= lastColumn; column++) {
+                const FBPolygonStrip *columnStrip = &columns[column - firstColumn];
+                if ( columnStrip->count < 3 )
+                    continue;
+                CGFloat minimum = INFINITY;
+                CGFloat maximum = -INFINITY;
+                for (NSUInteger i = 0; i < columnStrip->count; i++) {
+                    minimum = MIN(minimum, columnStrip->points[i].y);
+                    maximum = MAX(maximum, columnStrip->points[i].y);
+                }
+                NSUInteger firstRow = 0;
+                NSUInteger lastRow = 0;
+                FBPolygonTilingGetTileRange(tiling, 1, minimum, maximum, &firstRow, &lastRow);
+                rows = FBPolygonReserveStrips(rows, &rowCapacity, lastRow - firstRow + 1);
+                FBPolygonCutContourIntoStrips(tiling, columnStrip->points, columnStrip->count, 1, firstRow, rows);
+                for (NSUInteger row = firstRow; row <= lastRow; row++)
+                    FBPolygonTilingAddContour(tiling, row * tiling->counts[0] + column, polygonIndex, &rows[row - firstRow]);
+            }
+        }
+    }
+    for (NSUInteger i = 0; i < columnCapacity; i++)
+        free(columns[i].points);
+    free(columns);
+    for (NSUInteger i = 0; i < rowCapacity; i++)
+        free(rows[i].points);
+    free(rows);
+    
+    // Sort the contours by tile, keeping their order otherwise. The first pass counts
+    //  them, the second puts them in place.
+    NSUInteger tileCount = tiling->counts[0] * tiling->counts[1];
+    tiling->tileContourStarts = calloc(tileCount + 1, sizeof(NSUInteger));
+    for (NSUInteger i = 0; i < tiling->tileContourCount; i++)
+        tiling->tileContourStarts[tiling->tileContours[i].tileIndex + 1]++;
+    for (NSUInteger i = 0; i < tileCount; i++)
+        tiling->tileContourStarts[i + 1] += tiling->tileContourStarts[i];
+    NSUInteger *positions = malloc(tileCount * sizeof(NSUInteger));
+    memcpy(positions, tiling->tileContourStarts, tileCount * sizeof(NSUInteger));
+    FBPolygonTileContour *sortedContours = malloc(MAX(tiling->tileContourCount, (NSUInteger)1) * sizeof(FBPolygonTileContour));
+    for (NSUInteger i = 0; i < tiling->tileContourCount; i++)
+        sortedContours[positions[tiling->tileContours[i].tileIndex]++] = tiling->tileContours[i];
+    free(positions);
+    free(tiling->tileContours);
+    tiling->tileContours = sortedContours;
+}
+
+static void FBPolygonOperateOnTile(NSUInteger iteration, NSUInteger threadIndex, void *context)
+{
+    // The contours are already cut to the tile, so this is just the operation on them
+    FBPolygonTiling *tiling = context;
+    NSUInteger listStart = tiling->tileContourStarts[iteration];
+    NSUInteger listEnd = tiling->tileContourStarts[iteration + 1];
+    NSUInteger pointCount = 0;
+    for (NSUInteger listIndex = listStart; listIndex < listEnd; listIndex++)
+        pointCount += tiling->tileContours[listIndex].pointCount;
+    CGPoint *points = malloc(MAX(pointCount, (NSUInteger)1) * sizeof(CGPoint));
+    NSUInteger *contourPointCounts = malloc(MAX(listEnd - listStart, (NSUInteger)1) * sizeof(NSUInteger));
+    FBPolygonRef clippedPolygons[2] = {};
+    NSUInteger listIndex = listStart;
+    for (NSUInteger polygonIndex = 0; polygonIndex < 2; polygonIndex++) {
+        NSUInteger polygonPointCount = 0;
+        NSUInteger contourCount = 0;
+        for (; listIndex < listEnd && tiling->tileContours[listIndex].polygonIndex == polygonIndex; listIndex++) {
+            const FBPolygonTileContour *tileContour = &tiling->tileContours[listIndex];
+            memcpy(points + polygonPointCount, tiling->tilePoints + tileContour->pointStart, tileContour->pointCount * sizeof(CGPoint));
+            polygonPointCount += tileContour->pointCount;
+            contourPointCounts[contourCount++] = tileContour->pointCount;
+        }
+        clippedPolygons[polygonIndex] = FBPolygonCreate(points, contourPointCounts, contourCount);
+    }
+    free(points);
+    free(contourPointCounts);
+
+    tiling->results[iteration] = FBPolygonCreateWithOperation(clippedPolygons[0], clippedPolygons[1], tiling->operation);
+    FBPolygonRelease(clippedPolygons[0]);
+    FBPolygonRelease(clippedPolygons[1]);
+}
+
+static int FBPolygonCompareSeamPoints(const void *value1, const void *value2)
+{
+    const FBPolygonSeamPoint *point1 = value1;
+    const FBPolygonSeamPoint *point2 = value2;
+    if ( point1->seamIndex != point2->seamIndex )
+        return point1->seamIndex < point2->seamIndex ? -1 : 1;
+    if ( point1->value != point2->value )
+        return point1->value < point2->value ? -1 : 1;
+    return 0;
+}
+
+static int FBPolygonCompareSeamEvents(const void *value1, const void *value2)
+{
+    const FBPolygonSeamEvent *event1 = value1;
+    const FBPolygonSeamEvent *event2 = value2;
+    if ( event1->seamIndex != event2->seamIndex )
+        return event1->seamIndex < event2->seamIndex ? -1 : 1;
+    if ( event1->value != event2->value )
+        return event1->value < event2->value ? -1 : 1;
+    return 0;
+}
+
+static int FBPolygonCompareVertices(const void *value1, const void *value2)
+{
+    return FBPolygonComparePoints(*(const CGPoint *)value1, *(const CGPoint *)value2);
+}
+
+static CGFloat FBPolygonSnapToSide(CGFloat value, CGFloat side, CGFloat threshold)
+{
+    return fabs(value - side) <= threshold ? side : value;
+}
+
+static CGPoint FBPolygonSnapToSeamPoints(const FBPolygonTiling *tiling, const FBPolygonSeamPoint *seamPoints, NSUInteger seamPointCount, CGPoint point)
+{
+    // Along the seams across x first. A point that's moved onto a corner there is on a
+    //  seam across y too, where the corner is found again.
+    for (NSUInteger axis = 0; axis < 2; axis++) {
+        FBPolygonSeamPoint key = {};
+        key.seamIndex = FBPolygonTilingFindSeam(tiling, axis, FBPolygonGetCoordinate(point, axis));
+        if ( key.seamIndex == FBPolygonNoSeam )
+            continue;
+        key.value = FBPolygonGetCoordinate(point, 1 - axis);
+        const FBPolygonSeamPoint *seamPoint = bsearch(&key, seamPoints, seamPointCount, sizeof(FBPolygonSeamPoint), FBPolygonCompareSeamPoints);
+        if ( seamPoint == NULL )
+            continue;
+        if ( axis == 0 )
+            point.y = seamPoint->snappedValue;
+        else
+            point.x = seamPoint->snappedValue;
+    }
+    return point;
+}
+
+static FBPolygonRef FBPolygonStitchTiles(const FBPolygonTiling *tiling)
+{
+    // Points closer than this to a seam, or to each other along one, are taken to be
+    //  the same, like crossings in the operation
+    CGFloat largestCoordinate = MAX(1.0, MAX(MAX(fabs(tiling->minimum.x), fabs(tiling->minimum.y)), MAX(fabs(tiling->maximum.x), fabs(tiling->maximum.y))));
+    CGFloat snapThreshold = largestCoordinate * FBPolygonSnapThreshold;
+    NSUInteger tileCount = tiling->counts[0] * tiling->counts[1];
+
+    // Gather the edges of the results of all the tiles. Points the operation moved a little
+    //  off the sides of their tile are put back.
+    NSUInteger edgeCount = 0;
+    for (NSUInteger tileIndex = 0; tileIndex < tileCount; tileIndex++)
+        edgeCount += tiling->results[tileIndex]->pointCount;
+    FBPolygonTileEdge *tileEdges = malloc(MAX(edgeCount, (NSUInteger)1) * sizeof(FBPolygonTileEdge));
+    edgeCount = 0;
+    for (NSUInteger tileIndex = 0; tileIndex < tileCount; tileIndex++) {
+        NSUInteger column = tileIndex % tiling->counts[0];
+        NSUInteger row = tileIndex / tiling->counts[0];
+        CGPoint tileMinimum = CGPointMake(FBPolygonTilingGetSeam(tiling, 0, column), FBPolygonTilingGetSeam(tiling, 1, row));
+        CGPoint tileMaximum = CGPointMake(FBPolygonTilingGetSeam(tiling, 0, column + 1), FBPolygonTilingGetSeam(tiling, 1, row + 1));
+        FBPolygonRef result = tiling->results[tileIndex];
+        for (NSUInteger contourIndex = 0; contourIndex < result->contourCount; contourIndex++) {
+            NSUInteger firstEdge = edgeCount;
+            for (NSUInteger i = result->contourStarts[contourIndex]; i < result->contourStarts[contourIndex + 1]; i++) {
+                CGPoint point = result->points[i];
+                point.x = FBPolygonSnapToSide(FBPolygonSnapToSide(point.x, tileMinimum.x, snapThreshold), tileMaximum.x, snapThreshold);
+                point.y = FBPolygonSnapToSide(FBPolygonSnapToSide(point.y, tileMinimum.y, snapThreshold), tileMaximum.y, snapThreshold);
+                if ( edgeCount > firstEdge )
+                    tileEdges[edgeCount - 1].to = point;
+                tileEdges[edgeCount++].from = point;
+            }
+            if ( edgeCount > firstEdge )
+                tileEdges[edgeCount - 1].to = tileEdges[firstEdge].from;
+        }
+    }
+
+    // The tiles on both sides of a seam each put their own points on it. Those closer
+    //  together than the threshold are moved onto one, a corner where two seams meet if
+    //  there is one among them, so the edges from both sides end up meeting.
+    NSUInteger cornerCount = (tiling->counts[0] - 1) * (tiling->counts[1] + 1) + (tiling->counts[1] - 1) * (tiling->counts[0] + 1);
+    FBPolygonSeamPoint *seamPoints = malloc(MAX(2 * edgeCount + cornerCount, (NSUInteger)1) * sizeof(FBPolygonSeamPoint));
+    NSUInteger seamPointCount = 0;
+    for (NSUInteger i = 0; i < edgeCount; i++) {
+        for (NSUInteger axis = 0; axis < 2; axis++) {
+            NSUInteger seamIndex = FBPolygonTilingFindSeam(tiling, axis, FBPolygonGetCoordinate(tileEdges[i].from, axis));
+            if ( seamIndex != FBPolygonNoSeam )
+                seamPoints[seamPointCount++] = (FBPolygonSeamPoint){ seamIndex, FBPolygonGetCoordinate(tileEdges[i].from, 1 - axis), 0.0, NO };
+        }
+    }
+    for (NSUInteger column = 1; column < tiling->counts[0]; column++) {
+        for (NSUInteger row = 0; row <= tiling->counts[1]; row++)
+            seamPoints[seamPointCount++] = (FBPolygonSeamPoint){ column - 1, FBPolygonTilingGetSeam(tiling, 1, row), 0.0, YES };
+    }
+    for (NSUInteger row = 1; row < tiling->counts[1]; row++) {
+        for (NSUInteger column = 0; column <= tiling->counts[0]; column++)
+            seamPoints[seamPointCount++] = (FBPolygonSeamPoint){ tiling->counts[0] - 1 + row - 1, FBPolygonTilingGetSeam(tiling, 0, column), 0.0, YES };
+    }
+    qsort(seamPoints, seamPointCount, sizeof(FBPolygonSeamPoint), FBPolygonCompareSeamPoints);
+    for (NSUInteger i = 0; i < seamPointCount; ) {
+        NSUInteger clusterEnd = i + 1;
+        CGFloat snappedValue = seamPoints[i].value;
+        BOOL hasCorner = seamPoints[i].isCorner;
+        for (; clusterEnd < seamPointCount && seamPoints[clusterEnd].seamIndex == seamPoints[i].seamIndex && seamPoints[clusterEnd].value - seamPoints[clusterEnd - 1].value <= snapThreshold; clusterEnd++) {
+            if ( seamPoints[clusterEnd].isCorner && !hasCorner ) {
+                snappedValue = seamPoints[clusterEnd].value;
+                hasCorner = YES;
+            }
+        }
+        for (; i < clusterEnd; i++)
+            seamPoints[i].snappedValue = snappedValue;
+    }
+
+    // Edges on a seam are where the result of a tile was cut off. Where the results on both
+    //  sides are filled, the edges going along the seam one way and the other cancel out.
+    //  Where only one side is, its edges are part of the boundary. All other edges stay.
+    FBPolygonSeamEvent *events = malloc(MAX(2 * edgeCount, (NSUInteger)1) * sizeof(FBPolygonSeamEvent));
+    NSUInteger eventCount = 0;
+    NSUInteger keptCount = 0;
+    for (NSUInteger i = 0; i < edgeCount; i++) {
+        CGPoint from = FBPolygonSnapToSeamPoints(tiling, seamPoints, seamPointCount, tileEdges[i].from);
+        CGPoint to = FBPolygonSnapToSeamPoints(tiling, seamPoints, seamPointCount, tileEdges[i].to);
+        if ( CGPointEqualToPoint(from, to) )
+            continue;
+        NSUInteger seamIndex = FBPolygonNoSeam;
+        if ( from.x == to.x )
+            seamIndex = FBPolygonTilingFindSeam(tiling, 0, from.x);
+        else if ( from.y == to.y )
+            seamIndex = FBPolygonTilingFindSeam(tiling, 1, from.y);
+        if ( seamIndex == FBPolygonNoSeam ) {
+            tileEdges[keptCount++] = (FBPolygonTileEdge){ from, to };
+            continue;
+        }
+        NSUInteger axis = from.x == to.x ? 1 : 0;
+        CGFloat fromValue = FBPolygonGetCoordinate(from, axis);
+        CGFloat toValue = FBPolygonGetCoordinate(to, axis);
+        NSInteger change = toValue > fromValue ? 1 : -1;
+        events[eventCount++] = (FBPolygonSeamEvent){ seamIndex, MIN(fromValue, toValue), change };
+        events[eventCount++] = (FBPolygonSeamEvent){ seamIndex, MAX(fromValue, toValue), -change };
+    }
+    free(seamPoints);
+    if ( eventCount > 0 )
+        qsort(events, eventCount, sizeof(FBPolygonSeamEvent), FBPolygonCompareSeamEvents);
+    tileEdges = realloc(tileEdges, MAX(keptCount + eventCount, (NSUInteger)1) * sizeof(FBPolygonTileEdge));
+    NSInteger direction = 0;
+    for (NSUInteger i = 0; i + 1 < eventCount; i++) {
+        direction += events[i].change;
+        if ( direction == 0 || events[i + 1].seamIndex != events[i].seamIndex || events[i + 1].value == events[i].value )
+            continue;
+        CGPoint start = FBPolygonTilingGetPointOnSeam(tiling, events[i].seamIndex, events[i].value);
+        CGPoint end = FBPolygonTilingGetPointOnSeam(tiling, events[i].seamIndex, events[i + 1].value);
+        tileEdges[keptCount++] = direction > 0 ? (FBPolygonTileEdge){ start, end } : (FBPolygonTileEdge){ end, start };
+    }
+    free(events);
+
+    // Number the points, and chain the edges into contours like for a single operation
+    CGPoint *vertices = malloc(MAX(2 * keptCount, (NSUInteger)1) * sizeof(CGPoint));
+    for (NSUInteger i = 0; i < keptCount; i++) {
+        vertices[2 * i] = tileEdges[i].from;
+        vertices[2 * i + 1] = tileEdges[i].to;
+    }
+    if ( keptCount > 0 )
+        qsort(vertices, 2 * keptCount, sizeof(CGPoint), FBPolygonCompareVertices);
+    NSUInteger vertexCount = 0;
+    for (NSUInteger i = 0; i < 2 * keptCount; i++) {
+        if ( vertexCount == 0 || !CGPointEqualToPoint(vertices[vertexCount - 1], vertices[i]) )
+            vertices[vertexCount++] = vertices[i];
+    }
+    FBPolygonEdge *edges = malloc(MAX(keptCount, (NSUInteger)1) * sizeof(FBPolygonEdge));
+    for (NSUInteger i = 0; i < keptCount; i++) {
+        const CGPoint *from = bsearch(&tileEdges[i].from, vertices, vertexCount, sizeof(CGPoint), FBPolygonCompareVertices);
+        const CGPoint *to = bsearch(&tileEdges[i].to, vertices, vertexCount, sizeof(CGPoint), FBPolygonCompareVertices);
+        edges[i] = (FBPolygonEdge){ from - vertices, to - vertices, NO };
+    }
+    free(tileEdges);
+
+    // A segment crossing a seam was cut in two there, at a point that's only on the line
+    //  through both halves up to rounding, so chaining would keep it. Join the halves
+    //  again where nothing else goes through the point.
+    NSUInteger *incomingEdges = malloc(MAX(vertexCount, (NSUInteger)1) * sizeof(NSUInteger));
+    NSUInteger *outgoingEdges = malloc(MAX(vertexCount, (NSUInteger)1) * sizeof(NSUInteger));
+    NSUInteger *degrees = calloc(MAX(vertexCount, (NSUInteger)1), sizeof(NSUInteger));
+    for (NSUInteger i = 0; i < keptCount; i++) {
+        incomingEdges[edges[i].to] = i;
+        outgoingEdges[edges[i].from] = i;
+        degrees[edges[i].to]++;
+        degrees[edges[i].from]++;
+    }
+    for (NSUInteger vertex = 0; vertex < vertexCount; vertex++) {
+        CGPoint point = vertices[vertex];
+        if ( degrees[vertex] != 2 || (FBPolygonTilingFindSeam(tiling, 0, point.x) == FBPolygonNoSeam && FBPolygonTilingFindSeam(tiling, 1, point.y) == FBPolygonNoSeam) )
+            continue;
+        FBPolygonEdge *incoming = &edges[incomingEdges[vertex]];
+        FBPolygonEdge *outgoing = &edges[outgoingEdges[vertex]];
+        CGPoint from = vertices[incoming->from];
+        CGPoint to = vertices[outgoing->to];
+        CGPoint delta = CGPointMake(to.x - from.x, to.y - from.y);
+        BOOL isBetween = (point.x - from.x) * delta.x + (point.y - from.y) * delta.y > 0.0 && (to.x - point.x) * delta.x + (to.y - point.y) * delta.y > 0.0;
+        if ( !isBetween || fabs(FBPolygonOrientation(from, to, point)) > snapThreshold * sqrt(delta.x * delta.x + delta.y * delta.y) )
+            continue;
+        incoming->to = outgoing->to;
+        incomingEdges[outgoing->to] = incomingEdges[vertex];
+        outgoing->used = YES;
+    }
+    NSUInteger joinedCount = 0;
+    for (NSUInteger i = 0; i < keptCount; i++) {
+        if ( !edges[i].used )
+            edges[joinedCount++] = edges[i];
+    }
+    free(degrees);
+    free(outgoingEdges);
+    free(incomingEdges);
+
+    FBPolygonRef result = FBPolygonCreateFromEdges(edges, joinedCount, vertices, vertexCount);
+    free(edges);
+    free(vertices);
+    return result;
+}
+
+FBPolygonRef FBPolygonCreateWithOperationInTiles(FBPolygonRef polygon1, FBPolygonRef polygon2, FBBooleanOperation operation, CGFloat tileSize, FBThreadPoolRef pool)
+{
+    if ( tileSize <= 0.0 || polygon1->pointCount + polygon2->pointCount == 0 )
+        return FBPolygonCreateWithOperation(polygon1, polygon2, operation);
+
+    // The bounds of every contour, and of both polygons together
+    FBPolygonTiling tiling = { { polygon1, polygon2 }, operation };
+    NSUInteger contourCount = polygon1->contourCount + polygon2->contourCount;
+    tiling.contourBounds = malloc(MAX(2 * contourCount, (NSUInteger)1) * sizeof(CGPoint));
+    tiling.minimum = CGPointMake(INFINITY, INFINITY);
+    tiling.maximum = CGPointMake(-INFINITY, -INFINITY);
+    for (NSUInteger contourIndex = 0; contourIndex < contourCount; contourIndex++) {
+        BOOL isFirst = contourIndex < polygon1->contourCount;
+        NSUInteger count = 0;
+        const CGPoint *points = FBPolygonGetContourPoints(isFirst ? polygon1 : polygon2, isFirst ? contourIndex : contourIndex - polygon1->contourCount, &count);
+        CGPoint minimum = CGPointMake(INFINITY, INFINITY);
+        CGPoint maximum = CGPointMake(-INFINITY, -INFINITY);
+        for (NSUInteger i = 0; i < count; i++) {
+            minimum = CGPointMake(MIN(minimum.x, points[i].x), MIN(minimum.y, points[i].y));
+            maximum = CGPointMake(MAX(maximum.x, points[i].x), MAX(maximum.y, points[i].y));
+        }
+        tiling.contourBounds[2 * contourIndex] = minimum;
+        tiling.contourBounds[2 * contourIndex + 1] = maximum;
+        tiling.minimum = CGPointMake(MIN(tiling.minimum.x, minimum.x), MIN(tiling.minimum.y, minimum.y));
+        tiling.maximum = CGPointMake(MAX(tiling.maximum.x, maximum.x), MAX(tiling.maximum.y, maximum.y));
+    }
+
+    // A grid of tiles covering the bounds
+    CGFloat columnCount = MAX(ceil((tiling.maximum.x - tiling.minimum.x) / tileSize), 1.0);
+    CGFloat rowCount = MAX(ceil((tiling.maximum.y - tiling.minimum.y) / tileSize), 1.0);
+    while ( columnCount * rowCount > FBPolygonMaximumTileCount ) {
+        tileSize *= 2.0;
+        columnCount = MAX(ceil((tiling.maximum.x - tiling.minimum.x) / tileSize), 1.0);
+        rowCount = MAX(ceil((tiling.maximum.y - tiling.minimum.y) / tileSize), 1.0);
+    }
+    tiling.tileSize = tileSize;
+    tiling.counts[0] = (NSUInteger)columnCount;
+    tiling.counts[1] = (NSUInteger)rowCount;
+    NSUInteger tileCount = tiling.counts[0] * tiling.counts[1];
+    if ( tileCount == 1 ) {
+        free(tiling.contourBounds);
+        return FBPolygonCreateWithOperation(polygon1, polygon2, operation);
+    }
+
+    FBPolygonTilingCutContours(&tiling);
+    free(tiling.contourBounds);
+
+    tiling.results = calloc(tileCount, sizeof(FBPolygonRef));
+    if ( pool == NULL ) {
+        for (NSUInteger tileIndex = 0; tileIndex < tileCount; tileIndex++)
+            FBPolygonOperateOnTile(tileIndex, 0, &tiling);
+    } else
+        FBThreadPoolApply(pool, tileCount, FBPolygonOperateOnTile, &tiling);
+    free(tiling.tileContours);
+    free(tiling.tileContourStarts);
+    free(tiling.tilePoints);
+
+    FBPolygonRef result = FBPolygonStitchTiles(&tiling);
+    for (NSUInteger tileIndex = 0; tileIndex < tileCount; tileIndex++)
+        FBPolygonRelease(tiling.results[tileIndex]);
+    free(tiling.results);
+    return result;
+}
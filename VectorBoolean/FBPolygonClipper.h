@@ -0,0 +1,63 @@
+//
+//  FBPolygonClipper.h
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#ifndef FBPOLYGONCLIPPER_H
+#define FBPOLYGONCLIPPER_H
+
+#include "FBTypes.h"
+#include "FBThreadPool.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Polygon clipper
+//
+// Lots of shapes are nothing but straight lines, like map footprints and
+//  CAD outlines. The general code treats every line as a bezier curve and
+//  goes through curve clipping, overlap detection and containment rays for
+//  them. Here the segments of both polygons are split wherever they cross
+//  or touch, with the edge index finding the pairs, and then one sweep from
+//  left to right across the pieces tells for each which side is inside
+//  which polygon. The pieces with the result on one side only are chained
+//  into the contours of the result.
+//
+// Both polygons are filled by the even odd rule, like the bezier graphs.
+//  The contours of the result go counterclockwise around what's filled
+//  (in a y up coordinate system), so holes go the other way round.
+//
+
+typedef struct FBPolygon *FBPolygonRef;
+
+// Creates a polygon from contours laid out one after the other in points.
+//  contourPointCounts has the number of points of each contour. The contours are
+//  closed, the last point connects to the first. Everything is copied.
+extern FBPolygonRef FBPolygonCreate(const CGPoint *points, const NSUInteger *contourPointCounts, NSUInteger contourCount);
+extern void FBPolygonRelease(FBPolygonRef polygon);
+
+extern NSUInteger FBPolygonGetContourCount(FBPolygonRef polygon);
+// The points of one contour, which stay owned by the polygon
+extern const CGPoint *FBPolygonGetContourPoints(FBPolygonRef polygon, NSUInteger contourIndex, NSUInteger *outCount);
+
+// Creates the polygon the operation makes of the two
+extern FBPolygonRef FBPolygonCreateWithOperation(FBPolygonRef polygon1, FBPolygonRef polygon2, FBBooleanOperation operation);
+
+// The same, for polygons too big to take on in one go, like maps with millions of
+//  segments. Both polygons are cut into a grid of square tiles, tileSize across,
+//  the operation runs on every tile on its own, spread over the pool, and the
+//  results of the tiles are stitched back together along the seams between them.
+//  A tile leaves out the segments that only touch its sides, with an end or lying on
+//  one, so the result covers the same area as the operation above, up to rounding
+//  where segments cross the seams. Its contours can come in another order and start
+//  at other points.
+//  What the tiles bound is the splitting and the sweep: a thread only ever works
+//  on one tile's worth of pieces at a time, which is where the single operation
+//  takes most of its time and memory. The rest still grows with the polygons: the
+//  contours cut to the tiles and the results of all the tiles are kept until the
+//  stitching, which works on the whole result. The pool can be NULL to do all the
+//  tiles on the calling thread, and a tileSize of 0 is the operation above.
+extern FBPolygonRef FBPolygonCreateWithOperationInTiles(FBPolygonRef polygon1, FBPolygonRef polygon2, FBBooleanOperation operation, CGFloat tileSize, FBThreadPoolRef pool);
+
+#endif
@@ -0,0 +1,118 @@
+//
+//  FBProfile.c
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include "FBProfile.h"
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#if __GLIBC_PREREQ(2, 33)
+#define FB_PROFILE_MALLINFO2 1
+#endif
+#endif
+
+static __thread FBProfile *FBProfileCurrent = NULL;
+
+static const char *FBProfilePhaseNames[FBProfilePhaseCount] = {
+    "graphConstruction",
+    "crossingInsertion",
+    "selfCrossings",
+    "cleanup",
+    "marking",
+    "extraction",
+    "containment",
+    "polygonClipping",
+};
+
+static double FBProfileGetTime(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static void FBProfileGetHeapUsage(long long *allocatedBytes, long long *allocations)
+{
+#if defined(__APPLE__)
+    malloc_statistics_t statistics = {};
+    malloc_zone_statistics(NULL, &statistics);
+    *allocatedBytes = statistics.size_in_use;
+    *allocations = statistics.blocks_in_use;
+#elif defined(FB_PROFILE_MALLINFO2)
+    struct mallinfo2 info = mallinfo2();
+    *allocatedBytes = info.uordblks + info.hblkhd;
+    *allocations = 0; // glibc doesn't count blocks
+#else
+    *allocatedBytes = 0;
+    *allocations = 0;
+#endif
+}
+
+static size_t FBProfileGetPeakMemory(void)
+{
+    struct rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss; // bytes
+#else
+    return usage.ru_maxrss * 1024; // kilobytes
+#endif
+}
+
+void FBProfileReset(FBProfile *profile)
+{
+    memset(profile, 0, sizeof(FBProfile));
+}
+
+FBProfile *FBProfileGetCurrent(void)
+{
+    return FBProfileCurrent;
+}
+
+void FBProfileSetCurrent(FBProfile *profile)
+{
+    FBProfileCurrent = profile;
+}
+
+FBProfileMark FBProfileBeginPhase(FBProfilePhase phase)
+{
+    FBProfileMark mark = { FBProfileCurrent };
+    if ( mark.profile == NULL )
+        return mark;
+
+    FBProfileGetHeapUsage(&mark.allocatedBytes, &mark.allocations);
+    mark.time = FBProfileGetTime();
+    return mark;
+}
+
+void FBProfileEndPhase(FBProfilePhase phase, FBProfileMark mark)
+{
+    // The profile could have changed in between, the phase goes to the one it started in
+    if ( mark.profile == NULL )
+        return;
+
+    double time = FBProfileGetTime();
+    long long allocatedBytes = 0;
+    long long allocations = 0;
+    FBProfileGetHeapUsage(&allocatedBytes, &allocations);
+
+    FBProfilePhaseStatistics *statistics = &mark.profile->phases[phase];
+    statistics->calls++;
+    statistics->duration += time - mark.time;
+    statistics->allocatedBytes += allocatedBytes - mark.allocatedBytes;
+    statistics->allocations += allocations - mark.allocations;
+    statistics->peakMemory = MAX(statistics->peakMemory, FBProfileGetPeakMemory());
+}
+
+const char *FBProfilePhaseGetName(FBProfilePhase phase)
+{
+    return FBProfilePhaseNames[phase];
+}
@@ -0,0 +1,68 @@
+//
+//  FBProfile.h
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#ifndef FBPROFILE_H
+#define FBPROFILE_H
+
+#include "FBTypes.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Profile
+//
+// A boolean operation goes through a fixed sequence of phases. FBProfile
+//  collects the wall time and memory use of each of them, so a benchmark can
+//  tell which phase a slow input is slow in. A profile is only filled in while
+//  it is the current profile of the thread running the operation. Otherwise
+//  marking a phase costs one thread local read.
+//
+
+typedef enum FBProfilePhase {
+    FBProfilePhaseGraphConstruction,
+    FBProfilePhaseCrossingInsertion,
+    FBProfilePhaseSelfCrossings,
+    FBProfilePhaseCleanup,
+    FBProfilePhaseMarking,
+    FBProfilePhaseExtraction,
+    FBProfilePhaseContainment,
+    FBProfilePhasePolygonClipping,      // all of it, when both graphs are polygons or are flattened
+    FBProfilePhaseCount
+} FBProfilePhase;
+
+typedef struct FBProfilePhaseStatistics {
+    NSUInteger calls;
+    double duration;            // wall time, in seconds
+    long long allocatedBytes;   // net change of the heap in use
+    long long allocations;      // net change of the number of heap blocks, where the platform tells
+    size_t peakMemory;          // peak resident size of the process at the end of the phase
+} FBProfilePhaseStatistics;
+
+typedef struct FBProfile {
+    FBProfilePhaseStatistics phases[FBProfilePhaseCount];
+} FBProfile;
+
+// What a phase started from, to be handed back to FBProfileEndPhase()
+typedef struct FBProfileMark {
+    FBProfile *profile;
+    double time;
+    long long allocatedBytes;
+    long long allocations;
+} FBProfileMark;
+
+extern void FBProfileReset(FBProfile *profile);
+
+// The profile the calling thread records into, or NULL
+extern FBProfile *FBProfileGetCurrent(void);
+extern void FBProfileSetCurrent(FBProfile *profile);
+
+extern FBProfileMark FBProfileBeginPhase(FBProfilePhase phase);
+extern void FBProfileEndPhase(FBProfilePhase phase, FBProfileMark mark);
+
+// A short camel case name, for reports
+extern const char *FBProfilePhaseGetName(FBProfilePhase phase);
+
+#endif
@@ -0,0 +1,357 @@
+//
+//  FBScanlineIndex.c
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include "FBScanlineIndex.h"
+#include <stdlib.h>
+#include <string.h>
+
+// The bands start out as many as there are pieces, and are halved until each piece
+//  falls into about this many of them. Tall shapes would use up a lot of memory otherwise.
+static const NSUInteger FBScanlineMaximumBandsPerPiece = 8;
+
+// Enough points to make an iteration worth handing to another thread
+static const NSUInteger FBScanlinePointsPerIteration = 256;
+
+// Solving stops once the parameter moves less than this
+static const CGFloat FBScanlineParameterThreshold = FBPrecisionThreshold(5e-6, 1e-12, 3e-15);
+static const NSUInteger FBScanlineMaximumIterations = 64;
+
+// A part of a curve that only goes up or only goes down. The polynomials are the
+//  ones of the whole curve, so the pieces of one curve meet exactly.
+typedef struct FBScanlinePiece {
+    CGFloat x[4]; // x(t) = ((x[0] t + x[1]) t + x[2]) t + x[3]
+    CGFloat y[4];
+    CGFloat bottomParameter;
+    CGFloat topParameter;
+    CGFloat bottom;
+    CGFloat top;
+    NSInteger direction; // 1 if it goes up, -1 if it goes down
+} FBScanlinePiece;
+
+// A piece in one band, with how far left and right it gets within the band
+typedef struct FBScanlineEntry {
+    NSUInteger pieceIndex;
+    CGFloat minimumX;
+    CGFloat maximumX;
+} FBScanlineEntry;
+
+// The extrema in x of the curve a piece came from, only needed while building
+typedef struct FBScanlineExtrema {
+    CGFloat parameters[2];
+    NSUInteger count;
+} FBScanlineExtrema;
+
+struct FBScanlineIndex {
+    FBScanlinePiece *pieces;
+    NSUInteger pieceCount;
+    CGFloat bottom;
+    CGFloat top;
+    CGFloat bandHeight;
+    NSUInteger bandCount;
+    NSUInteger *bandStarts; // the entries of band i go from bandStarts[i] up to bandStarts[i + 1]
+    FBScanlineEntry *entries;
+};
+
+typedef struct FBScanlineBatch {
+    FBScanlineIndexRef index;
+    const CGPoint *points;
+    NSUInteger count;
+    FBFillRule fillRule;
+    BOOL *results;
+} FBScanlineBatch;
+
+#pragma mark Polynomials
+
+static void FBScanlineMakePolynomial(CGFloat p0, CGFloat p1, CGFloat p2, CGFloat p3, BOOL isStraightLine, CGFloat coefficients[4])
+{
+    if ( isStraightLine ) {
+        // The control points of a line can sit anywhere on it, leave them out
+        coefficients[0] = 0.0;
+        coefficients[1] = 0.0;
+        coefficients[2] = p3 - p0;
+        coefficients[3] = p0;
+        return;
+    }
+    coefficients[0] = -p0 + 3.0 * p1 - 3.0 * p2 + p3;
+    coefficients[1] = 3.0 * p0 - 6.0 * p1 + 3.0 * p2;
+    coefficients[2] = -3.0 * p0 + 3.0 * p1;
+    coefficients[3] = p0;
+}
+
+static inline CGFloat FBScanlineEvaluate(const CGFloat coefficients[4], CGFloat parameter)
+{
+    return ((coefficients[0] * parameter + coefficients[1]) * parameter + coefficients[2]) * parameter + coefficients[3];
+}
+
+static inline CGFloat FBScanlineEvaluateDerivative(const CGFloat coefficients[4], CGFloat parameter)
+{
+    return (3.0 * coefficients[0] * parameter + 2.0 * coefficients[1]) * parameter + coefficients[2];
+}
+
+// The parameters strictly between 0 and 1 where the derivative is zero, in increasing order
+static NSUInteger FBScanlineFindExtrema(const CGFloat coefficients[4], CGFloat parameters[2])
+{
+    CGFloat a = 3.0 * coefficients[0];
+    CGFloat b = 2.0 * coefficients[1];
+    CGFloat c = coefficients[2];
+    CGFloat roots[2] = {};
+    NSUInteger rootCount = 0;
+    if ( a == 0.0 ) {
+        if ( b != 0.0 )
+            roots[rootCount++] = -c / b;
+    } else {
+        CGFloat discriminant = b * b - 4.0 * a * c;
+        if ( discriminant >= 0.0 ) {
+            // The form that doesn't subtract two numbers that are nearly the same
+            CGFloat q = -0.5 * (b + copysign(sqrt(discriminant), b));
+            roots[rootCount++] = q / a;
+            if ( q != 0.0 )
+                roots[rootCount++] = c / q;
+        }
+    }
+
+    NSUInteger count = 0;
+    for (NSUInteger i = 0; i < rootCount; i++) {
+        if ( roots[i] > 0.0 && roots[i] < 1.0 )
+            parameters[count++] = roots[i];
+    }
+    if ( count == 2 && parameters[0] > parameters[1] ) {
+        CGFloat swap = parameters[0];
+        parameters[0] = parameters[1];
+        parameters[1] = swap;
+    }
+    if ( count == 2 && parameters[0] == parameters[1] )
+        count = 1;
+    return count;
+}
+
+// The parameter where the piece is at the height. The piece only goes one way, so
+//  there's a bracket around the parameter to fall back to when a Newton step leaves it.
+static CGFloat FBScanlineSolve(const FBScanlinePiece *piece, CGFloat y)
+{
+    if ( y <= piece->bottom )
+        return piece->bottomParameter;
+    if ( y >= piece->top )
+        return piece->topParameter;
+
+    CGFloat below = piece->bottomParameter;
+    CGFloat above = piece->topParameter;
+    CGFloat parameter = below + (above - below) * (y - piece->bottom) / (piece->top - piece->bottom);
+    for (NSUInteger i = 0; i < FBScanlineMaximumIterations; i++) {
+        CGFloat value = FBScanlineEvaluate(piece->y, parameter) - y;
+        if ( value == 0.0 )
+            return parameter;
+        if ( value < 0.0 )
+            below = parameter;
+        else
+            above = parameter;
+
+        CGFloat slope = FBScanlineEvaluateDerivative(piece->y, parameter);
+        CGFloat nextParameter = parameter - value / slope;
+        if ( !(nextParameter > MIN(below, above) && nextParameter < MAX(below, above)) )
+            nextParameter = (below + above) / 2.0;
+        if ( fabs(nextParameter - parameter) < FBScanlineParameterThreshold )
+            return nextParameter;
+        parameter = nextParameter;
+    }
+    return parameter;
+}
+
+#pragma mark Building
+
+//////////////////////////////////////////////////////////////////////////////////
+// Building
+//
+// The bands are all the same height, from the bottom of the shape to the top, so
+//  finding a point's band is a division. Each piece goes into every band it
+//  reaches into, with the part of it in that band measured in x.
+//
+
+static void FBScanlineAddPieces(FBBezierCurveData curve, FBScanlinePiece *pieces, FBScanlineExtrema *extrema, NSUInteger *pieceCount)
+{
+    FBScanlinePiece piece = {};
+    FBScanlineMakePolynomial(curve.endPoint1.x, curve.controlPoint1.x, curve.controlPoint2.x, curve.endPoint2.x, curve.kind == FBBezierCurveKindLine, piece.x);
+    FBScanlineMakePolynomial(curve.endPoint1.y, curve.controlPoint1.y, curve.controlPoint2.y, curve.endPoint2.y, curve.kind == FBBezierCurveKindLine, piece.y);
+
+    FBScanlineExtrema curveExtrema = {};
+    curveExtrema.count = FBScanlineFindExtrema(piece.x, curveExtrema.parameters);
+
+    // Split where the curve turns around in y. The end points are taken as they
+    //  are, so the pieces of neighboring curves meet at exactly the same height.
+    CGFloat splits[4] = { 0.0 };
+    CGFloat heights[4] = { curve.endPoint1.y };
+    NSUInteger splitCount = 1;
+    NSUInteger extremaCount = FBScanlineFindExtrema(piece.y, &splits[1]);
+    for (NSUInteger i = 0; i < extremaCount; i++) {
+        heights[splitCount] = FBScanlineEvaluate(piece.y, splits[splitCount]);
+        splitCount++;
+    }
+    splits[splitCount] = 1.0;
+    heights[splitCount] = curve.endPoint2.y;
+    splitCount++;
+
+    for (NSUInteger i = 0; i + 1 < splitCount; i++) {
+        if ( heights[i] == heights[i + 1] )
+            continue; // horizontal, never crossed by a horizontal ray
+        piece.direction = heights[i] < heights[i + 1] ? 1 : -1;
+        piece.bottomParameter = piece.direction > 0 ? splits[i] : splits[i + 1];
+        piece.topParameter = piece.direction > 0 ? splits[i + 1] : splits[i];
+        piece.bottom = MIN(heights[i], heights[i + 1]);
+        piece.top = MAX(heights[i], heights[i + 1]);
+        extrema[*pieceCount] = curveExtrema;
+        pieces[(*pieceCount)++] = piece;
+    }
+}
+
+static NSUInteger FBScanlineIndexGetBand(FBScanlineIndexRef index, CGFloat y)
+{
+    CGFloat band = floor((y - index->bottom) / index->bandHeight);
+    if ( !(band > 0.0) )
+        return 0;
+    return MIN((NSUInteger)band, index->bandCount - 1);
+}
+
+static NSUInteger FBScanlineIndexCountEntries(FBScanlineIndexRef index)
+{
+    NSUInteger count = 0;
+    for (NSUInteger i = 0; i < index->pieceCount; i++)
+        count += FBScanlineIndexGetBand(index, index->pieces[i].top) - FBScanlineIndexGetBand(index, index->pieces[i].bottom) + 1;
+    return count;
+}
+
+static FBScanlineEntry FBScanlineMakeEntry(const FBScanlinePiece *piece, const FBScanlineExtrema *extrema, NSUInteger pieceIndex, CGFloat bottom, CGFloat top)
+{
+    CGFloat parameter1 = FBScanlineSolve(piece, MAX(bottom, piece->bottom));
+    CGFloat parameter2 = FBScanlineSolve(piece, MIN(top, piece->top));
+    CGFloat x1 = FBScanlineEvaluate(piece->x, parameter1);
+    CGFloat x2 = FBScanlineEvaluate(piece->x, parameter2);
+
+    FBScanlineEntry entry = { pieceIndex, MIN(x1, x2), MAX(x1, x2) };
+    for (NSUInteger i = 0; i < extrema->count; i++) {
+        if ( extrema->parameters[i] <= MIN(parameter1, parameter2) || extrema->parameters[i] >= MAX(parameter1, parameter2) )
+            continue;
+        CGFloat x = FBScanlineEvaluate(piece->x, extrema->parameters[i]);
+        entry.minimumX = MIN(entry.minimumX, x);
+        entry.maximumX = MAX(entry.maximumX, x);
+    }
+    return entry;
+}
+
+FBScanlineIndexRef FBScanlineIndexCreate(const FBBezierCurveData *curves, NSUInteger count)
+{
+    FBScanlineIndexRef index = calloc(1, sizeof(struct FBScanlineIndex));
+
+    // A curve turns around in y at most twice, so it makes at most three pieces
+    index->pieces = malloc(MAX(3 * count, (NSUInteger)1) * sizeof(FBScanlinePiece));
+    FBScanlineExtrema *extrema = malloc(MAX(3 * count, (NSUInteger)1) * sizeof(FBScanlineExtrema));
+    for (NSUInteger i = 0; i < count; i++)
+        FBScanlineAddPieces(curves[i], index->pieces, extrema, &index->pieceCount);
+    if ( index->pieceCount == 0 ) {
+        free(extrema);
+        return index;
+    }
+
+    index->bottom = index->pieces[0].bottom;
+    index->top = index->pieces[0].top;
+    for (NSUInteger i = 1; i < index->pieceCount; i++) {
+        index->bottom = MIN(index->bottom, index->pieces[i].bottom);
+        index->top = MAX(index->top, index->pieces[i].top);
+    }
+
+    index->bandCount = index->pieceCount;
+    index->bandHeight = (index->top - index->bottom) / index->bandCount;
+    NSUInteger entryCount = FBScanlineIndexCountEntries(index);
+    while ( index->bandCount > 1 && entryCount > FBScanlineMaximumBandsPerPiece * index->pieceCount ) {
+        index->bandCount /= 2;
+        index->bandHeight = (index->top - index->bottom) / index->bandCount;
+        entryCount = FBScanlineIndexCountEntries(index);
+    }
+
+    // Count the entries of each band, turn the counts into starts, then fill them in
+    index->bandStarts = calloc(index->bandCount + 1, sizeof(NSUInteger));
+    index->entries = malloc(entryCount * sizeof(FBScanlineEntry));
+    for (NSUInteger i = 0; i < index->pieceCount; i++) {
+        NSUInteger lastBand = FBScanlineIndexGetBand(index, index->pieces[i].top);
+        for (NSUInteger band = FBScanlineIndexGetBand(index, index->pieces[i].bottom); band <= lastBand; band++)
+            index->bandStarts[band + 1]++;
+    }
+    for (NSUInteger band = 0; band < index->bandCount; band++)
+        index->bandStarts[band + 1] += index->bandStarts[band];
+
+    NSUInteger *positions = malloc(index->bandCount * sizeof(NSUInteger));
+    memcpy(positions, index->bandStarts, index->bandCount * sizeof(NSUInteger));
+    for (NSUInteger i = 0; i < index->pieceCount; i++) {
+        NSUInteger lastBand = FBScanlineIndexGetBand(index, index->pieces[i].top);
+        for (NSUInteger band = FBScanlineIndexGetBand(index, index->pieces[i].bottom); band <= lastBand; band++) {
+            CGFloat bandBottom = index->bottom + band * index->bandHeight;
+            index->entries[positions[band]++] = FBScanlineMakeEntry(&index->pieces[i], &extrema[i], i, bandBottom, bandBottom + index->bandHeight);
+        }
+    }
+    free(positions);
+    free(extrema);
+
+    return index;
+}
+
+void FBScanlineIndexRelease(FBScanlineIndexRef index)
+{
+    if ( index == NULL )
+        return;
+    free(index->pieces);
+    free(index->bandStarts);
+    free(index->entries);
+    free(index);
+}
+
+#pragma mark Queries
+
+NSInteger FBScanlineIndexGetWindingNumber(FBScanlineIndexRef index, CGPoint point)
+{
+    if ( index->bandCount == 0 || point.y < index->bottom || point.y >= index->top )
+        return 0;
+
+    NSInteger windingNumber = 0;
+    NSUInteger band = FBScanlineIndexGetBand(index, point.y);
+    for (NSUInteger i = index->bandStarts[band]; i < index->bandStarts[band + 1]; i++) {
+        const FBScanlineEntry *entry = &index->entries[i];
+        const FBScanlinePiece *piece = &index->pieces[entry->pieceIndex];
+        if ( point.y < piece->bottom || point.y >= piece->top || point.x >= entry->maximumX )
+            continue; // not level with the point, or entirely to its left
+        if ( point.x < entry->minimumX || point.x < FBScanlineEvaluate(piece->x, FBScanlineSolve(piece, point.y)) )
+            windingNumber += piece->direction;
+    }
+    return windingNumber;
+}
+
+BOOL FBScanlineIndexContainsPoint(FBScanlineIndexRef index, CGPoint point, FBFillRule fillRule)
+{
+    NSInteger windingNumber = FBScanlineIndexGetWindingNumber(index, point);
+    if ( fillRule == FBFillRuleNonZero )
+        return windingNumber != 0;
+    return (windingNumber & 1) != 0;
+}
+
+static void FBScanlineContainsPoints(NSUInteger iteration, NSUInteger threadIndex, void *context)
+{
+    FBScanlineBatch *batch = context;
+    NSUInteger end = MIN((iteration + 1) * FBScanlinePointsPerIteration, batch->count);
+    for (NSUInteger i = iteration * FBScanlinePointsPerIteration; i < end; i++)
+        batch->results[i] = FBScanlineIndexContainsPoint(batch->index, batch->points[i], batch->fillRule);
+}
+
+void FBScanlineIndexContainsPoints(FBScanlineIndexRef index, const CGPoint *points, NSUInteger count, FBFillRule fillRule, FBThreadPoolRef pool, BOOL *results)
+{
+    FBScanlineBatch batch = { index, points, count, fillRule, results };
+    NSUInteger iterations = (count + FBScanlinePointsPerIteration - 1) / FBScanlinePointsPerIteration;
+    if ( pool == NULL ) {
+        for (NSUInteger iteration = 0; iteration < iterations; iteration++)
+            FBScanlineContainsPoints(iteration, 0, &batch);
+        return;
+    }
+    FBThreadPoolApply(pool, iterations, FBScanlineContainsPoints, &batch);
+}
@@ -0,0 +1,48 @@
+//
+//  FBScanlineIndex.h
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#ifndef FBSCANLINEINDEX_H
+#define FBSCANLINEINDEX_H
+
+#include "FBTypes.h"
+#include "FBBezierCurveData.h"
+#include "FBThreadPool.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Scanline index
+//
+// FBScanlineIndex answers whether points are inside a shape, for code that
+//  asks about lots of points, like hatch fills, scattering and mask lookups.
+//  -[FBBezierContour containsPoint:] makes a ray for every point and runs it
+//  through the general intersection code against every edge. Here the edges
+//  are split once into pieces that only ever go up or only ever go down, and
+//  the pieces are sorted into horizontal bands. A point only looks at the
+//  pieces in its band, and most of those are entirely to its left or right,
+//  so only the few it could be level with need the curve to be solved.
+//
+// The winding number counts the pieces crossing the horizontal ray from the
+//  point to the right, plus one for each that goes up and minus one for each
+//  that goes down. A piece covers the heights from its bottom up to, but not
+//  including, its top, so a ray through a vertex counts it once.
+//
+
+typedef struct FBScanlineIndex *FBScanlineIndexRef;
+
+// Creates an index over the curves, which have to make up closed contours.
+//  The curves are copied, so the caller keeps ownership of the array.
+extern FBScanlineIndexRef FBScanlineIndexCreate(const FBBezierCurveData *curves, NSUInteger count);
+extern void FBScanlineIndexRelease(FBScanlineIndexRef index);
+
+extern NSInteger FBScanlineIndexGetWindingNumber(FBScanlineIndexRef index, CGPoint point);
+extern BOOL FBScanlineIndexContainsPoint(FBScanlineIndexRef index, CGPoint point, FBFillRule fillRule);
+
+// Sets results[i] to whether points[i] is inside, running the points on the pool.
+//  The pool can be NULL to do all of them on the calling thread.
+extern void FBScanlineIndexContainsPoints(FBScanlineIndexRef index, const CGPoint *points, NSUInteger count, FBFillRule fillRule, FBThreadPoolRef pool, BOOL *results);
+
+#endif
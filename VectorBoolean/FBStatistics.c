@@ -0,0 +1,128 @@
+//
+//  FBStatistics.c
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include "FBStatistics.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *FBStatisticNames[FBStatisticCount] = {
+    "edgePairTests",
+    "boundsRejections",
+    "solvedPairs",
+    "clipIterations",
+    "clipIterationLimits",
+    "subdivisions",
+    "overlapRanges",
+    "raysCast",
+    "crossingsCreated",
+    "crossingsDiscarded",
+};
+
+#if FB_STATISTICS
+
+// The blocks of all live threads are linked together, so a snapshot can add them up.
+//  When a thread exits, its counts go into the retired total and its block is freed.
+typedef struct FBStatisticsBlock {
+    FBStatistics statistics;
+    struct FBStatisticsBlock *previous;
+    struct FBStatisticsBlock *next;
+} FBStatisticsBlock;
+
+__thread NSUInteger *FBStatisticsThreadCounts = NULL;
+
+static pthread_mutex_t FBStatisticsMutex = PTHREAD_MUTEX_INITIALIZER;
+static FBStatisticsBlock *FBStatisticsBlocks = NULL;
+static FBStatistics FBStatisticsRetired = {};
+static pthread_key_t FBStatisticsThreadKey;
+static pthread_once_t FBStatisticsThreadKeyOnce = PTHREAD_ONCE_INIT;
+
+static void FBStatisticsAddCounts(FBStatistics *statistics, const FBStatistics *other)
+{
+    for (NSUInteger i = 0; i < FBStatisticCount; i++)
+        statistics->counts[i] += __atomic_load_n(&other->counts[i], __ATOMIC_RELAXED);
+}
+
+static void FBStatisticsRetireThread(void *data)
+{
+    FBStatisticsBlock *block = data;
+    pthread_mutex_lock(&FBStatisticsMutex);
+    FBStatisticsAddCounts(&FBStatisticsRetired, &block->statistics);
+    if ( block->previous != NULL )
+        block->previous->next = block->next;
+    else
+        FBStatisticsBlocks = block->next;
+    if ( block->next != NULL )
+        block->next->previous = block->previous;
+    pthread_mutex_unlock(&FBStatisticsMutex);
+
+    FBStatisticsThreadCounts = NULL;
+    free(block);
+}
+
+static void FBStatisticsCreateThreadKey(void)
+{
+    pthread_key_create(&FBStatisticsThreadKey, FBStatisticsRetireThread);
+}
+
+NSUInteger *FBStatisticsRegisterThread(void)
+{
+    pthread_once(&FBStatisticsThreadKeyOnce, FBStatisticsCreateThreadKey);
+    FBStatisticsBlock *block = calloc(1, sizeof(FBStatisticsBlock));
+    pthread_mutex_lock(&FBStatisticsMutex);
+    block->next = FBStatisticsBlocks;
+    if ( FBStatisticsBlocks != NULL )
+        FBStatisticsBlocks->previous = block;
+    FBStatisticsBlocks = block;
+    pthread_mutex_unlock(&FBStatisticsMutex);
+
+    pthread_setspecific(FBStatisticsThreadKey, block);
+    FBStatisticsThreadCounts = block->statistics.counts;
+    return FBStatisticsThreadCounts;
+}
+
+void FBStatisticsGetSnapshot(FBStatistics *statistics)
+{
+    pthread_mutex_lock(&FBStatisticsMutex);
+    *statistics = FBStatisticsRetired;
+    for (FBStatisticsBlock *block = FBStatisticsBlocks; block != NULL; block = block->next)
+        FBStatisticsAddCounts(statistics, &block->statistics);
+    pthread_mutex_unlock(&FBStatisticsMutex);
+}
+
+void FBStatisticsGetThreadSnapshot(FBStatistics *statistics)
+{
+    memset(statistics, 0, sizeof(FBStatistics));
+    if ( FBStatisticsThreadCounts != NULL )
+        memcpy(statistics->counts, FBStatisticsThreadCounts, sizeof(statistics->counts));
+}
+
+#else
+
+void FBStatisticsGetSnapshot(FBStatistics *statistics)
+{
+    memset(statistics, 0, sizeof(FBStatistics));
+}
+
+void FBStatisticsGetThreadSnapshot(FBStatistics *statistics)
+{
+    memset(statistics, 0, sizeof(FBStatistics));
+}
+
+#endif
+
+void FBStatisticsSubtract(const FBStatistics *after, const FBStatistics *before, FBStatistics *difference)
+{
+    for (NSUInteger i = 0; i < FBStatisticCount; i++)
+        difference->counts[i] = after->counts[i] - before->counts[i];
+}
+
+const char *FBStatisticGetName(FBStatistic statistic)
+{
+    return FBStatisticNames[statistic];
+}
@@ -0,0 +1,85 @@
+//
+//  FBStatistics.h
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#ifndef FBSTATISTICS_H
+#define FBSTATISTICS_H
+
+#include "FBTypes.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Statistics
+//
+// Counters in the hot paths of the engine: how many edge pairs were tested,
+//  how often bezier clipping iterated and subdivided, how many rays the
+//  containment tests cast. Where FBProfile says which phase is slow, these
+//  say why. Each thread counts into its own block, so counting is a plain
+//  add without contention. Build with FB_STATISTICS=0 to compile them out.
+//
+
+#ifndef FB_STATISTICS
+#define FB_STATISTICS 1
+#endif
+
+typedef enum FBStatistic {
+    FBStatisticEdgePairTests,           // pairs of edges (or monotone pieces of them) intersected
+    FBStatisticBoundsRejections,        // pairs dismissed because their bounds don't overlap
+    FBStatisticSolvedPairs,             // pairs intersected directly, without bezier clipping
+    FBStatisticClipIterations,          // rounds of bezier clipping
+    FBStatisticClipIterationLimits,     // times clipping gave up without converging
+    FBStatisticSubdivisions,            // times clipping split a curve in half and recursed
+    FBStatisticOverlapRanges,           // coincident curve ranges found
+    FBStatisticRaysCast,                // rays cast by the containment tests
+    FBStatisticCrossingsCreated,
+    FBStatisticCrossingsDiscarded,      // duplicates and crossings inside overlaps
+    FBStatisticCount
+} FBStatistic;
+
+typedef struct FBStatistics {
+    NSUInteger counts[FBStatisticCount];
+} FBStatistics;
+
+#if FB_STATISTICS
+
+// The calling thread's counters, registered the first time they're needed
+extern __thread NSUInteger *FBStatisticsThreadCounts;
+extern NSUInteger *FBStatisticsRegisterThread(void);
+
+// Other threads only ever read the counters, so a relaxed load and store is enough
+static inline void FBStatisticsAddToThread(FBStatistic statistic, NSUInteger amount)
+{
+    NSUInteger *counts = FBStatisticsThreadCounts;
+    if ( counts == NULL )
+        counts = FBStatisticsRegisterThread();
+    __atomic_store_n(&counts[statistic], __atomic_load_n(&counts[statistic], __ATOMIC_RELAXED) + amount, __ATOMIC_RELAXED);
+}
+
+#define FBStatisticsAdd(statistic, amount) FBStatisticsAddToThread((statistic), (amount))
+
+#else
+
+#define FBStatisticsAdd(statistic, amount) ((void)0)
+
+#endif
+
+#define FBStatisticsIncrement(statistic) FBStatisticsAdd((statistic), 1)
+
+// The counts of all threads, including the ones that have exited since. To get the
+//  statistics of one operation, take a snapshot before and after and subtract them.
+extern void FBStatisticsGetSnapshot(FBStatistics *statistics);
+
+// The counts of the calling thread only. An operation run on one thread, like a job of
+//  CGPathPerformBooleanJobs(), can be measured with these while others run alongside.
+extern void FBStatisticsGetThreadSnapshot(FBStatistics *statistics);
+
+// Sets difference to after minus before
+extern void FBStatisticsSubtract(const FBStatistics *after, const FBStatistics *before, FBStatistics *difference);
+
+// A short camel case name, for reports
+extern const char *FBStatisticGetName(FBStatistic statistic);
+
+#endif
@@ -0,0 +1,180 @@
+//
+//  FBThreadPool.c
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include "FBThreadPool.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+struct FBThreadPool {
+    pthread_t *threads;
+    NSUInteger threadCount;
+    
+    pthread_mutex_t applyMutex; // held for the duration of an apply
+    pthread_mutex_t mutex; // protects everything below
+    pthread_cond_t workCondition;
+    pthread_cond_t doneCondition;
+    
+    FBThreadPoolFunction function;
+    void *context;
+    NSUInteger iterations;
+    NSUInteger nextIteration; // claimed atomically
+    NSUInteger busyThreads;
+    NSUInteger generation;
+    BOOL shuttingDown;
+};
+
+typedef struct FBThreadPoolWorker {
+    FBThreadPoolRef pool;
+    NSUInteger threadIndex;
+} FBThreadPoolWorker;
+
+// Set while a thread runs iterations of any pool. Loops started from inside an iteration
+//  run serially, since all the threads are already busy with the outer loop.
+static __thread BOOL FBThreadPoolIsRunningIteration = NO;
+
+static void FBThreadPoolRunIterations(FBThreadPoolRef pool, NSUInteger threadIndex)
+{
+    FBThreadPoolIsRunningIteration = YES;
+    while ( YES ) {
+        NSUInteger iteration = __atomic_fetch_add(&pool->nextIteration, 1, __ATOMIC_RELAXED);
+        if ( iteration >= pool->iterations )
+            break;
+        pool->function(iteration, threadIndex, pool->context);
+    }
+    FBThreadPoolIsRunningIteration = NO;
+}
+
+static void *FBThreadPoolWorkerMain(void *argument)
+{
+    FBThreadPoolWorker *worker = argument;
+    FBThreadPoolRef pool = worker->pool;
+    NSUInteger threadIndex = worker->threadIndex;
+    free(worker);
+    
+    NSUInteger seenGeneration = 0;
+    while ( YES ) {
+        pthread_mutex_lock(&pool->mutex);
+        while ( !pool->shuttingDown && pool->generation == seenGeneration )
+            pthread_cond_wait(&pool->workCondition, &pool->mutex);
+        if ( pool->shuttingDown ) {
+            pthread_mutex_unlock(&pool->mutex);
+            break;
+        }
+        seenGeneration = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+        
+        FBThreadPoolRunIterations(pool, threadIndex);
+        
+        pthread_mutex_lock(&pool->mutex);
+        pool->busyThreads--;
+        if ( pool->busyThreads == 0 )
+            pthread_cond_signal(&pool->doneCondition);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+    
+    return NULL;
+}
+
+FBThreadPoolRef FBThreadPoolCreate(NSUInteger threadCount)
+{
+    FBThreadPoolRef pool = calloc(1, sizeof(struct FBThreadPool));
+    if ( pool == NULL )
+        return NULL;
+    pthread_mutex_init(&pool->applyMutex, NULL);
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->workCondition, NULL);
+    pthread_cond_init(&pool->doneCondition, NULL);
+    
+    pool->threads = calloc(MAX(threadCount, 1), sizeof(pthread_t));
+    for (NSUInteger i = 0; i < threadCount; i++) {
+        FBThreadPoolWorker *worker = malloc(sizeof(FBThreadPoolWorker));
+        worker->pool = pool;
+        worker->threadIndex = i + 1; // the calling thread is always zero
+        if ( pthread_create(&pool->threads[i], NULL, FBThreadPoolWorkerMain, worker) != 0 ) {
+            free(worker);
+            break;
+        }
+        pool->threadCount++;
+    }
+    
+    return pool;
+}
+
+void FBThreadPoolRelease(FBThreadPoolRef pool)
+{
+    if ( pool == NULL )
+        return;
+    
+    pthread_mutex_lock(&pool->mutex);
+    pool->shuttingDown = YES;
+    pthread_cond_broadcast(&pool->workCondition);
+    pthread_mutex_unlock(&pool->mutex);
+    for (NSUInteger i = 0; i < pool->threadCount; i++)
+        pthread_join(pool->threads[i], NULL);
+    
+    pthread_cond_destroy(&pool->doneCondition);
+    pthread_cond_destroy(&pool->workCondition);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_mutex_destroy(&pool->applyMutex);
+    free(pool->threads);
+    free(pool);
+}
+
+static FBThreadPoolRef FBThreadPoolShared = NULL;
+static pthread_once_t FBThreadPoolSharedOnce = PTHREAD_ONCE_INIT;
+
+static void FBThreadPoolCreateShared(void)
+{
+    long processorCount = sysconf(_SC_NPROCESSORS_ONLN);
+    FBThreadPoolShared = FBThreadPoolCreate(processorCount > 1 ? (NSUInteger)processorCount - 1 : 0);
+}
+
+FBThreadPoolRef FBThreadPoolGetShared(void)
+{
+    pthread_once(&FBThreadPoolSharedOnce, FBThreadPoolCreateShared);
+    return FBThreadPoolShared;
+}
+
+NSUInteger FBThreadPoolGetConcurrency(FBThreadPoolRef pool)
+{
+    return pool->threadCount + 1;
+}
+
+void FBThreadPoolApply(FBThreadPoolRef pool, NSUInteger iterations, FBThreadPoolFunction function, void *context)
+{
+    // Run on the calling thread if there's no point in waking the workers, or they're busy
+    if ( pool->threadCount == 0 || iterations <= 1 || FBThreadPoolIsRunningIteration || pthread_mutex_trylock(&pool->applyMutex) != 0 ) {
+        // These are iterations too, so loops started from them stay on this thread
+        BOOL wasRunningIteration = FBThreadPoolIsRunningIteration;
+        FBThreadPoolIsRunningIteration = YES;
+        for (NSUInteger i = 0; i < iterations; i++)
+            function(i, 0, context);
+        FBThreadPoolIsRunningIteration = wasRunningIteration;
+        return;
+    }
+    
+    pthread_mutex_lock(&pool->mutex);
+    pool->function = function;
+    pool->context = context;
+    pool->iterations = iterations;
+    pool->nextIteration = 0;
+    pool->busyThreads = pool->threadCount;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->workCondition);
+    pthread_mutex_unlock(&pool->mutex);
+    
+    FBThreadPoolRunIterations(pool, 0);
+    
+    pthread_mutex_lock(&pool->mutex);
+    while ( pool->busyThreads > 0 )
+        pthread_cond_wait(&pool->doneCondition, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+    
+    pthread_mutex_unlock(&pool->applyMutex);
+}
@@ -0,0 +1,50 @@
+//
+//  FBThreadPool.h
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#ifndef FBTHREADPOOL_H
+#define FBTHREADPOOL_H
+
+#include "FBTypes.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Thread pool
+//
+// FBThreadPool runs the iterations of a loop on a fixed set of worker threads.
+//  The threads claim iterations one at a time from a shared counter, so a thread
+//  that finishes early just takes more work instead of waiting on the others.
+//  The calling thread works along with the pool until the loop is done.
+//
+// If the pool is already busy, or the loop is started from inside an iteration
+//  of any pool, the loop runs on the calling thread instead. That keeps nested
+//  use from deadlocking or starting more threads than there are processors.
+//  Iterations run that way count as iterations all the same, so a loop that
+//  was meant for one thread keeps everything nested in it on that thread.
+//
+
+typedef struct FBThreadPool *FBThreadPoolRef;
+
+// threadIndex is less than FBThreadPoolGetConcurrency(), and no two iterations
+//  with the same threadIndex run at the same time, so it can be used to pick
+//  per thread scratch space.
+typedef void (*FBThreadPoolFunction)(NSUInteger iteration, NSUInteger threadIndex, void *context);
+
+// Creates a pool with the given number of worker threads, not counting the
+//  calling thread. Zero makes a pool that runs everything on the calling thread.
+extern FBThreadPoolRef FBThreadPoolCreate(NSUInteger threadCount);
+extern void FBThreadPoolRelease(FBThreadPoolRef pool);
+
+// A process wide pool with one thread per processor, created on first use.
+extern FBThreadPoolRef FBThreadPoolGetShared(void);
+
+// The number of threads that can run iterations, including the calling thread.
+extern NSUInteger FBThreadPoolGetConcurrency(FBThreadPoolRef pool);
+
+// Calls the function for every iteration and returns once they have all finished.
+extern void FBThreadPoolApply(FBThreadPoolRef pool, NSUInteger iterations, FBThreadPoolFunction function, void *context);
+
+#endif
@@ -0,0 +1,185 @@
+//
+//  FBTypes.h
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#ifndef FBTYPES_H
+#define FBTYPES_H
+
+//////////////////////////////////////////////////////////////////////////
+// Portable types
+//
+// The geometry core (FBGeometry, FBBezierCurveData and the helpers they use)
+//  is plain C, so it can be built and tested without Foundation, for example
+//  on Linux with the CMake build. On Apple platforms it uses the CoreGraphics
+//  types directly, which means the Objective-C classes can hand their data to
+//  the core without converting anything. Everywhere else this header defines
+//  layout compatible stand-ins for the few types and functions the core needs.
+//
+
+#include <math.h>
+#include <stddef.h>
+#include <sys/param.h> // MIN and MAX
+
+//////////////////////////////////////////////////////////////////////////
+// Precision
+//
+// The scalar type of the core is picked when it's built, with FB_PRECISION:
+//  single precision for throughput on jobs that end up rasterized anyway,
+//  double, the default, and extended (long double) for exports that have to
+//  hold up at CAD scale. The Objective-C classes share CGFloat with
+//  CoreGraphics, so they take double; the other two are for the C core on its
+//  own, with the stand-in types below even on Apple platforms. The thresholds
+//  that stand for rounding error change with the precision, see
+//  FBPrecisionThreshold() below.
+//
+#define FB_PRECISION_SINGLE 1
+#define FB_PRECISION_DOUBLE 2
+#define FB_PRECISION_EXTENDED 3
+
+#ifndef FB_PRECISION
+#define FB_PRECISION FB_PRECISION_DOUBLE
+#endif
+
+// So that sqrt(), fabs() and the rest work in the precision of CGFloat, not double
+#if FB_PRECISION != FB_PRECISION_DOUBLE
+#include <tgmath.h>
+#endif
+
+// Thresholds that absorb rounding error are tuned for double. Builds of the other
+//  precisions take the value that leaves the same share of their digits: a double
+//  threshold of 10^-n becomes about 10^-0.44n in single and 10^-1.21n in extended,
+//  which is how their epsilons compare with double's. Thresholds of geometry, like
+//  how short a piece is worth splitting off, are the same in every precision.
+#if FB_PRECISION == FB_PRECISION_SINGLE
+#define FBPrecisionThreshold(singleThreshold, doubleThreshold, extendedThreshold) ((CGFloat)(singleThreshold))
+#elif FB_PRECISION == FB_PRECISION_EXTENDED
+#define FBPrecisionThreshold(singleThreshold, doubleThreshold, extendedThreshold) ((CGFloat)(extendedThreshold))
+#else
+#define FBPrecisionThreshold(singleThreshold, doubleThreshold, extendedThreshold) ((CGFloat)(doubleThreshold))
+#endif
+
+#if defined(__APPLE__) && FB_PRECISION == FB_PRECISION_DOUBLE
+
+#include <CoreGraphics/CGGeometry.h>
+#include <objc/objc.h>
+#include <objc/NSObjCRuntime.h>
+
+#else
+
+#if FB_PRECISION == FB_PRECISION_SINGLE
+typedef float CGFloat;
+#elif FB_PRECISION == FB_PRECISION_EXTENDED
+typedef long double CGFloat;
+#else
+typedef double CGFloat;
+#endif
+typedef long NSInteger;
+typedef unsigned long NSUInteger;
+
+typedef signed char BOOL;
+#define YES ((BOOL)1)
+#define NO ((BOOL)0)
+
+typedef struct CGPoint {
+    CGFloat x;
+    CGFloat y;
+} CGPoint;
+
+typedef struct CGSize {
+    CGFloat width;
+    CGFloat height;
+} CGSize;
+
+typedef struct CGRect {
+    CGPoint origin;
+    CGSize size;
+} CGRect;
+
+static const CGPoint CGPointZero = { 0, 0 };
+static const CGRect CGRectZero = { { 0, 0 }, { 0, 0 } };
+
+static inline CGPoint CGPointMake(CGFloat x, CGFloat y)
+{
+    CGPoint point = { x, y };
+    return point;
+}
+
+static inline CGRect CGRectMake(CGFloat x, CGFloat y, CGFloat width, CGFloat height)
+{
+    CGRect rect = { { x, y }, { width, height } };
+    return rect;
+}
+
+static inline BOOL CGPointEqualToPoint(CGPoint point1, CGPoint point2)
+{
+    return point1.x == point2.x && point1.y == point2.y;
+}
+
+static inline BOOL CGRectEqualToRect(CGRect rect1, CGRect rect2)
+{
+    return CGPointEqualToPoint(rect1.origin, rect2.origin) && rect1.size.width == rect2.size.width && rect1.size.height == rect2.size.height;
+}
+
+// Like CoreGraphics, these assume the rects are standardized (non-negative sizes),
+//  which every rect the core builds is.
+static inline CGFloat CGRectGetMinX(CGRect rect) { return rect.origin.x; }
+static inline CGFloat CGRectGetMinY(CGRect rect) { return rect.origin.y; }
+static inline CGFloat CGRectGetMaxX(CGRect rect) { return rect.origin.x + rect.size.width; }
+static inline CGFloat CGRectGetMaxY(CGRect rect) { return rect.origin.y + rect.size.height; }
+static inline CGFloat CGRectGetMidX(CGRect rect) { return rect.origin.x + rect.size.width / 2.0; }
+static inline CGFloat CGRectGetMidY(CGRect rect) { return rect.origin.y + rect.size.height / 2.0; }
+static inline CGFloat CGRectGetWidth(CGRect rect) { return rect.size.width; }
+static inline CGFloat CGRectGetHeight(CGRect rect) { return rect.size.height; }
+
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// Path elements
+//
+// A path is a flat array of elements, each with up to three points, which
+//  mirrors CGPathElement without needing a CGPath to hold them.
+//
+typedef enum FBPathElementType {
+    FBPathElementMoveToPoint,
+    FBPathElementAddLineToPoint,
+    FBPathElementAddQuadCurveToPoint,
+    FBPathElementAddCurveToPoint,
+    FBPathElementCloseSubpath
+} FBPathElementType;
+
+typedef struct FBPathElement {
+    FBPathElementType type;
+    CGPoint points[3];
+} FBPathElement;
+
+// Receives path elements one at a time, for code that streams paths in or out
+typedef void (*FBPathElementFunction)(const FBPathElement *element, void *context);
+
+// Which points a path fills. Even odd is what the boolean operations assume.
+typedef enum FBFillRule {
+    FBFillRuleEvenOdd,
+    FBFillRuleNonZero
+} FBFillRule;
+
+// The operations combining two shapes. Declared here so the C core can take them too.
+typedef enum FBBooleanOperation {
+    FBBooleanOperationUnion,
+    FBBooleanOperationIntersect,
+    FBBooleanOperationDifference,
+    FBBooleanOperationXOR
+} FBBooleanOperation;
+
+// A set of operations, for computing several results for the same two paths
+typedef enum FBBooleanOperations {
+    FBBooleanOperationsUnion = 1 << FBBooleanOperationUnion,
+    FBBooleanOperationsIntersect = 1 << FBBooleanOperationIntersect,
+    FBBooleanOperationsDifference = 1 << FBBooleanOperationDifference,
+    FBBooleanOperationsXOR = 1 << FBBooleanOperationXOR,
+    FBBooleanOperationsAll = FBBooleanOperationsUnion | FBBooleanOperationsIntersect | FBBooleanOperationsDifference | FBBooleanOperationsXOR
+} FBBooleanOperations;
+
+#endif
@@ -0,0 +1,198 @@
+//
+//  FBVectorKernels.c
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include "FBVectorKernels.h"
+#include "FBGeometry.h"
+#include "FBBezierCurveHelper.h"
+#include <string.h>
+
+const char *FBVectorKernelsGetInstructionSet(void)
+{
+#if !FB_VECTOR_KERNELS
+    return "scalar";
+#elif defined(__AVX__)
+    return "AVX";
+#elif defined(__SSE2__)
+    return "SSE2";
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return "NEON";
+#else
+    return "generic vector";
+#endif
+}
+
+#if FB_VECTOR_KERNELS
+
+// Comparing two vectors gives a vector of lane masks, all ones where the comparison holds
+typedef __typeof__((FBVector2){} < (FBVector2){}) FBVectorMask2;
+
+static inline FBVector2 FBVector2Make(CGPoint point)
+{
+    FBVector2 vector;
+    memcpy(&vector, &point, sizeof(vector));
+    return vector;
+}
+
+static inline CGPoint FBVector2GetPoint(FBVector2 vector)
+{
+    CGPoint point;
+    memcpy(&point, &vector, sizeof(point));
+    return point;
+}
+
+static inline FBVector2 FBVector2Select(FBVectorMask2 mask, FBVector2 value1, FBVector2 value2)
+{
+    return (FBVector2)(((FBVectorMask2)value1 & mask) | ((FBVectorMask2)value2 & ~mask));
+}
+
+// Same as the MIN() and MAX() macros, lane by lane, including which value wins a tie
+static inline FBVector2 FBVector2Min(FBVector2 value1, FBVector2 value2)
+{
+    return FBVector2Select(value1 < value2, value1, value2);
+}
+
+static inline FBVector2 FBVector2Max(FBVector2 value1, FBVector2 value2)
+{
+    return FBVector2Select(value1 > value2, value1, value2);
+}
+
+static inline FBVector2 FBVector2Lerp(FBVector2 point1, FBVector2 point2, CGFloat parameter)
+{
+    return (1.0 - parameter) * point1 + parameter * point2;
+}
+
+static inline FBVector2 FBVector2PointOnCubic(const FBVector2 points[4], CGFloat parameter)
+{
+    FBVector2 point01 = FBVector2Lerp(points[0], points[1], parameter);
+    FBVector2 point12 = FBVector2Lerp(points[1], points[2], parameter);
+    FBVector2 point23 = FBVector2Lerp(points[2], points[3], parameter);
+    return FBVector2Lerp(FBVector2Lerp(point01, point12, parameter), FBVector2Lerp(point12, point23, parameter), parameter);
+}
+
+CGPoint FBVectorSplitCubic(const CGPoint points[4], CGFloat parameter, CGPoint leftCurve[4], CGPoint rightCurve[4])
+{
+    FBVector2 point0 = FBVector2Make(points[0]);
+    FBVector2 point3 = FBVector2Make(points[3]);
+    FBVector2 point01 = FBVector2Lerp(point0, FBVector2Make(points[1]), parameter);
+    FBVector2 point12 = FBVector2Lerp(FBVector2Make(points[1]), FBVector2Make(points[2]), parameter);
+    FBVector2 point23 = FBVector2Lerp(FBVector2Make(points[2]), point3, parameter);
+    FBVector2 point012 = FBVector2Lerp(point01, point12, parameter);
+    FBVector2 point123 = FBVector2Lerp(point12, point23, parameter);
+    FBVector2 point0123 = FBVector2Lerp(point012, point123, parameter);
+
+    if ( leftCurve != NULL ) {
+        leftCurve[0] = points[0];
+        leftCurve[1] = FBVector2GetPoint(point01);
+        leftCurve[2] = FBVector2GetPoint(point012);
+        leftCurve[3] = FBVector2GetPoint(point0123);
+    }
+    if ( rightCurve != NULL ) {
+        rightCurve[0] = FBVector2GetPoint(point0123);
+        rightCurve[1] = FBVector2GetPoint(point123);
+        rightCurve[2] = FBVector2GetPoint(point23);
+        rightCurve[3] = points[3];
+    }
+    return FBVector2GetPoint(point0123);
+}
+
+void FBVectorDistancesFromLine(FBNormalizedLine line, const CGPoint points[4], CGFloat distances[4])
+{
+    FBVector4 x = { points[0].x, points[1].x, points[2].x, points[3].x };
+    FBVector4 y = { points[0].y, points[1].y, points[2].y, points[3].y };
+    FBVector4 result = line.a * x + line.b * y + line.c;
+    memcpy(distances, &result, sizeof(result));
+}
+
+CGRect FBVectorCurveBounds(const CGPoint points[4])
+{
+    FBVector2 vectors[4] = { FBVector2Make(points[0]), FBVector2Make(points[1]), FBVector2Make(points[2]), FBVector2Make(points[3]) };
+
+    // Start with the end points
+    FBVector2 topLeft = FBVector2PointOnCubic(vectors, 0);
+    FBVector2 bottomRight = topLeft;
+    FBVector2 lastPoint = FBVector2PointOnCubic(vectors, 1);
+    topLeft = FBVector2Min(lastPoint, topLeft);
+    bottomRight = FBVector2Max(lastPoint, bottomRight);
+
+    // The extrema are the roots of the derivative, which FBComputeCubicFirstDerivativeRoots()
+    //  finds one coordinate at a time. Here x is in the first lane and y in the second.
+    FBVector2 a = vectors[0];
+    FBVector2 b = vectors[1];
+    FBVector2 c = vectors[2];
+    FBVector2 d = vectors[3];
+    FBVector2 denominator = -a + 3.0 * b - 3.0 * c + d;
+    FBVector2 numeratorLeft = -a + 2.0 * b - c;
+    FBVector2 radicand = -a * (c - d) + b * b - b * (c + d) + c * c;
+    FBVector2 numeratorRight = { -sqrt(radicand[0]), -sqrt(radicand[1]) };
+    FBVector2 roots1 = (numeratorLeft + numeratorRight) / denominator;
+    FBVector2 roots2 = (numeratorLeft - numeratorRight) / denominator;
+    FBVector2 fallbackRoots = (a - b) / (2.0 * (a - 2.0 * b + c));
+
+    CGFloat roots[4] = {};
+    NSUInteger rootsCount = 0;
+    for (NSUInteger lane = 0; lane < 2; lane++) {
+        if ( !FBAreValuesClose(denominator[lane], 0.0) ) {
+            roots[rootsCount++] = roots1[lane];
+            roots[rootsCount++] = roots2[lane];
+        } else
+            roots[rootsCount++] = fallbackRoots[lane];
+    }
+
+    for (NSUInteger i = 0; i < rootsCount; i++) {
+        CGFloat t = roots[i];
+        if ( t < 0 || t > 1 )
+            continue;
+
+        FBVector2 location = FBVector2PointOnCubic(vectors, t);
+        topLeft = FBVector2Min(location, topLeft);
+        bottomRight = FBVector2Max(location, bottomRight);
+    }
+
+    CGPoint min = FBVector2GetPoint(topLeft);
+    CGPoint max = FBVector2GetPoint(bottomRight);
+    return CGRectMake(min.x, min.y, max.x - min.x, max.y - min.y);
+}
+
+#else
+
+CGPoint FBVectorSplitCubic(const CGPoint points[4], CGFloat parameter, CGPoint leftCurve[4], CGPoint rightCurve[4])
+{
+    return BezierWithPoints(3, (CGPoint *)points, parameter, leftCurve, rightCurve);
+}
+
+void FBVectorDistancesFromLine(FBNormalizedLine line, const CGPoint points[4], CGFloat distances[4])
+{
+    for (NSUInteger i = 0; i < 4; i++)
+        distances[i] = FBNormalizedLineDistanceFromPoint(line, points[i]);
+}
+
+CGRect FBVectorCurveBounds(const CGPoint points[4])
+{
+    // Start with the end points
+    CGPoint topLeft = BezierWithPoints(3, (CGPoint *)points, 0, NULL, NULL);
+    CGPoint bottomRight = topLeft;
+    FBExpandBoundsByPoint(&topLeft, &bottomRight, BezierWithPoints(3, (CGPoint *)points, 1, NULL, NULL));
+
+    // Find the roots, which should be the extremities
+    CGFloat roots[4] = {};
+    NSUInteger xRootsCount = 0;
+    NSUInteger yRootsCount = 0;
+    FBComputeCubicFirstDerivativeRoots(points[0].x, points[1].x, points[2].x, points[3].x, &roots[0], &xRootsCount);
+    FBComputeCubicFirstDerivativeRoots(points[0].y, points[1].y, points[2].y, points[3].y, &roots[xRootsCount], &yRootsCount);
+    for (NSUInteger i = 0; i < xRootsCount + yRootsCount; i++) {
+        CGFloat t = roots[i];
+        if ( t < 0 || t > 1 )
+            continue;
+
+        FBExpandBoundsByPoint(&topLeft, &bottomRight, BezierWithPoints(3, (CGPoint *)points, t, NULL, NULL));
+    }
+
+    return CGRectMake(topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y);
+}
+
+#endif
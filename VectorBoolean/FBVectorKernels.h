@@ -0,0 +1,51 @@
+//
+//  FBVectorKernels.h
+//  VectorBoolean
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#ifndef FBVECTORKERNELS_H
+#define FBVECTORKERNELS_H
+
+#include "FBTypes.h"
+#include "FBNormalizedLine.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Vector kernels
+//
+// The innermost loops of the intersection code evaluate, split and bound
+//  cubic curves one coordinate at a time. These kernels do the same math on
+//  the x and y channels together, and for the fat line distances on all four
+//  points of a curve together, using the compiler's vector extensions. The
+//  compiler turns those into whatever the target has: SSE2 or AVX on Intel,
+//  NEON on ARM. Compilers without vector extensions get plain scalar code.
+//
+// The kernels do the exact same operations in the same order as the scalar
+//  code they replace, so the results are the same bit for bit. That takes the
+//  scalar code's double arithmetic, so builds of another FB_PRECISION get the
+//  scalar code.
+//
+
+#if (defined(__GNUC__) || defined(__clang__)) && FB_PRECISION == FB_PRECISION_DOUBLE
+#define FB_VECTOR_KERNELS 1
+typedef CGFloat FBVector2 __attribute__((vector_size(2 * sizeof(CGFloat))));
+typedef CGFloat FBVector4 __attribute__((vector_size(4 * sizeof(CGFloat))));
+#endif
+
+// The instruction set the kernels were built for, for benchmarks and logging
+extern const char *FBVectorKernelsGetInstructionSet(void);
+
+// De Casteljau evaluation of a cubic at parameter. Fills in the two halves of the
+//  split if leftCurve and rightCurve aren't NULL. Same as BezierWithPoints() with a
+//  degree of 3.
+extern CGPoint FBVectorSplitCubic(const CGPoint points[4], CGFloat parameter, CGPoint leftCurve[4], CGPoint rightCurve[4]);
+
+// The signed distances of all four points from the line
+extern void FBVectorDistancesFromLine(FBNormalizedLine line, const CGPoint points[4], CGFloat distances[4]);
+
+// The tight bounds of the curve, end points and extrema
+extern CGRect FBVectorCurveBounds(const CGPoint points[4]);
+
+#endif
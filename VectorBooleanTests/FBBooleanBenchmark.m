@@ -0,0 +1,331 @@
+//
+//  FBBooleanBenchmark.m
+//  VectorBooleanTests
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+#import "FBBezierGraph.h"
+#import "FBBezierGraph+Benchmark.h"
+#import "FBBezierContour.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "FBProfile.h"
+#include "FBStatistics.h"
+#include "FBVectorKernels.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Boolean benchmark
+//
+// Runs every boolean operation on generated shapes of growing size, and
+//  prints the wall time and memory use of each phase of the operations as
+//  JSON, so the numbers can be kept and compared between builds. Not a test:
+//  run it by hand, with the build type you care about.
+//
+//  FBBooleanBenchmark [--sizes 25,100,400] [--runs 3] [--shape name] [--tolerance 0.25]
+//
+// The generators are seeded, so every run sees the same shapes. When both
+//  shapes are polygons the operations are also timed through the polygon
+//  clipper, which is printed as polygonWallTime next to the general path.
+//  --shape polygons --sizes 100000 gives two polygons of 100k vertices each.
+//  With --tolerance, the approximate operation is timed as well and printed
+//  as approximateWallTime.
+//
+
+typedef void (*FBBenchmarkGenerator)(NSUInteger size, CGMutablePathRef path1, CGMutablePathRef path2);
+
+typedef struct FBBenchmarkShape {
+    const char *name;
+    FBBenchmarkGenerator generator;
+} FBBenchmarkShape;
+
+static const char *FBBenchmarkOperationNames[] = { "union", "intersect", "difference", "xor" };
+
+static uint64_t FBBenchmarkRandomState = 1;
+
+static double FBBenchmarkGetTime(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// xorshift64*, so the shapes don't depend on the platform's rand()
+static CGFloat FBBenchmarkRandom(CGFloat minimum, CGFloat maximum)
+{
+    FBBenchmarkRandomState ^= FBBenchmarkRandomState >> 12;
+    FBBenchmarkRandomState ^= FBBenchmarkRandomState << 25;
+    FBBenchmarkRandomState ^= FBBenchmarkRandomState >> 27;
+    uint64_t value = FBBenchmarkRandomState * 2685821657736338717ULL;
+    return minimum + (maximum - minimum) * ((value >> 11) / 9007199254740992.0);
+}
+
+static NSUInteger FBBenchmarkGridSide(NSUInteger size)
+{
+    return (NSUInteger)ceil(sqrt(size));
+}
+
+static void FBBenchmarkRandomCircles(NSUInteger size, CGMutablePathRef path1, CGMutablePathRef path2)
+{
+    // The square grows with the count, so the density and the number of overlaps per
+    //  circle stay about the same
+    CGFloat side = sqrt(size) * 40;
+    CGMutablePathRef paths[] = { path1, path2 };
+    for (NSUInteger i = 0; i < 2; i++) {
+        for (NSUInteger j = 0; j < size; j++) {
+            CGFloat radius = FBBenchmarkRandom(5, 25);
+            CGPoint center = CGPointMake(FBBenchmarkRandom(0, side), FBBenchmarkRandom(0, side));
+            CGPathAddEllipseInRect(paths[i], NULL, CGRectMake(center.x - radius, center.y - radius, radius * 2, radius * 2));
+        }
+    }
+}
+
+static void FBBenchmarkRectanglesWithHoles(NSUInteger size, CGMutablePathRef path1, CGMutablePathRef path2)
+{
+    // Two grids of framed squares, the second one shifted so its frames cross the first one's
+    NSUInteger side = FBBenchmarkGridSide(size);
+    CGMutablePathRef paths[] = { path1, path2 };
+    CGPoint offsets[] = { CGPointMake(0, 0), CGPointMake(20, 13) };
+    for (NSUInteger i = 0; i < 2; i++) {
+        for (NSUInteger j = 0; j < size; j++) {
+            CGPoint origin = CGPointMake(offsets[i].x + (j % side) * 50, offsets[i].y + (j / side) * 50);
+            CGPathAddRect(paths[i], NULL, CGRectMake(origin.x, origin.y, 40, 40));
+            CGPathAddRect(paths[i], NULL, CGRectMake(origin.x + 10, origin.y + 10, 20, 20));
+        }
+    }
+}
+
+static void FBBenchmarkAddBlob(CGMutablePathRef path, CGPoint center, CGFloat radius, CGFloat wobble)
+{
+    // A smooth closed outline through eight points at random distances from the center
+    CGPoint points[8];
+    CGPoint tangents[8];
+    NSUInteger pointCount = sizeof(points) / sizeof(points[0]);
+    for (NSUInteger i = 0; i < pointCount; i++) {
+        CGFloat angle = 2 * M_PI * i / pointCount;
+        CGFloat distance = radius * FBBenchmarkRandom(1 - wobble, 1 + wobble);
+        points[i] = CGPointMake(center.x + distance * cos(angle), center.y + distance * sin(angle));
+        // The handle length that makes eight cubics approximate a circle
+        CGFloat handle = distance * 0.265;
+        tangents[i] = CGPointMake(-handle * sin(angle), handle * cos(angle));
+    }
+    CGPathMoveToPoint(path, NULL, points[0].x, points[0].y);
+    for (NSUInteger i = 0; i < pointCount; i++) {
+        NSUInteger next = (i + 1) % pointCount;
+        CGPathAddCurveToPoint(path, NULL, points[i].x + tangents[i].x, points[i].y + tangents[i].y, points[next].x - tangents[next].x, points[next].y - tangents[next].y, points[next].x, points[next].y);
+    }
+    CGPathCloseSubpath(path);
+}
+
+static void FBBenchmarkGlyphs(NSUInteger size, CGMutablePathRef path1, CGMutablePathRef path2)
+{
+    // Curvy outlines with a counter, like the letters of a line of text. The second
+    //  line is set half a letter over, so every letter overlaps two of the other line.
+    NSUInteger side = FBBenchmarkGridSide(size);
+    CGMutablePathRef paths[] = { path1, path2 };
+    for (NSUInteger i = 0; i < 2; i++) {
+        for (NSUInteger j = 0; j < size; j++) {
+            CGPoint center = CGPointMake(i * 22 + (j % side) * 44, i * 5 + (j / side) * 60);
+            FBBenchmarkAddBlob(paths[i], center, 24, 0.2);
+            FBBenchmarkAddBlob(paths[i], center, 10, 0.3);
+        }
+    }
+}
+
+static void FBBenchmarkNearlyCoincidentEdges(NSUInteger size, CGMutablePathRef path1, CGMutablePathRef path2)
+{
+    // Squares half a square over, and a hair off vertically, so the top and bottom edges
+    //  nearly lie on top of each other. This is what trips up the overlap detection.
+    NSUInteger side = FBBenchmarkGridSide(size);
+    for (NSUInteger j = 0; j < size; j++) {
+        CGPoint origin = CGPointMake((j % side) * 50, (j / side) * 50);
+        CGPathAddRect(path1, NULL, CGRectMake(origin.x, origin.y, 30, 30));
+        CGPathAddRect(path2, NULL, CGRectMake(origin.x + 15, origin.y + FBBenchmarkRandom(-1e-6, 1e-6), 30, 30));
+    }
+}
+
+static void FBBenchmarkPolygons(NSUInteger size, CGMutablePathRef path1, CGMutablePathRef path2)
+{
+    // One jagged ring of size vertices each, like a coastline or a long footprint.
+    //  The second sits a bit over, so the two cross all the way round.
+    CGMutablePathRef paths[] = { path1, path2 };
+    for (NSUInteger i = 0; i < 2; i++) {
+        for (NSUInteger j = 0; j < size; j++) {
+            CGFloat angle = 2 * M_PI * j / size;
+            CGFloat distance = 1000 * FBBenchmarkRandom(0.98, 1.02);
+            CGPoint point = CGPointMake(i * 300 + distance * cos(angle), distance * sin(angle));
+            if ( j == 0 )
+                CGPathMoveToPoint(paths[i], NULL, point.x, point.y);
+            else
+                CGPathAddLineToPoint(paths[i], NULL, point.x, point.y);
+        }
+        CGPathCloseSubpath(paths[i]);
+    }
+}
+
+static const FBBenchmarkShape FBBenchmarkShapes[] = {
+    { "randomCircles", FBBenchmarkRandomCircles },
+    { "rectanglesWithHoles", FBBenchmarkRectanglesWithHoles },
+    { "glyphs", FBBenchmarkGlyphs },
+    { "nearlyCoincidentEdges", FBBenchmarkNearlyCoincidentEdges },
+    { "polygons", FBBenchmarkPolygons },
+};
+
+static NSUInteger FBBenchmarkEdgeCount(FBBezierGraph *graph)
+{
+    NSUInteger count = 0;
+    for (FBBezierContour *contour in graph.contours)
+        count += contour.edges.count;
+    return count;
+}
+
+static void FBBenchmarkPrintPhase(FBProfilePhaseStatistics statistics, NSUInteger runs)
+{
+    printf("{\"calls\": %.1f, \"wallTime\": %.9f, \"allocatedBytes\": %lld, \"allocations\": %lld, \"peakMemory\": %zu}",
+           (double)statistics.calls / runs, statistics.duration / runs, statistics.allocatedBytes / (long long)runs, statistics.allocations / (long long)runs, statistics.peakMemory);
+}
+
+static void FBBenchmarkRun(const FBBenchmarkShape *shape, NSUInteger size, FBBooleanOperation operation, NSUInteger runs, CGFloat tolerance, BOOL first)
+{
+    CGMutablePathRef path1 = CGPathCreateMutable();
+    CGMutablePathRef path2 = CGPathCreateMutable();
+    FBBenchmarkRandomState = 1 + size;
+    shape->generator(size, path1, path2);
+    NSUInteger edgeCount = 0;
+    @autoreleasepool {
+        edgeCount = FBBenchmarkEdgeCount([FBBezierGraph bezierGraphWithPath:path1]) + FBBenchmarkEdgeCount([FBBezierGraph bezierGraphWithPath:path2]);
+    }
+
+    // The crossing search can run on the shared pool's threads, so count across all of them
+    FBProfile profile;
+    FBProfileReset(&profile);
+    FBProfileSetCurrent(&profile);
+    FBStatistics startStatistics = {};
+    FBStatisticsGetSnapshot(&startStatistics);
+    double wallTime = 0;
+    NSUInteger resultContourCount = 0;
+    for (NSUInteger run = 0; run < runs; run++) {
+        @autoreleasepool {
+            double start = FBBenchmarkGetTime();
+            FBBezierGraph *graph1 = [FBBezierGraph bezierGraphWithPath:path1];
+            FBBezierGraph *graph2 = [FBBezierGraph bezierGraphWithPath:path2];
+            FBBezierGraph *result = [graph1 bezierGraphWithOperation:operation bezierGraph:graph2];
+            wallTime += FBBenchmarkGetTime() - start;
+            resultContourCount = result.contours.count;
+        }
+    }
+    FBProfileSetCurrent(NULL);
+    FBStatistics endStatistics = {};
+    FBStatisticsGetSnapshot(&endStatistics);
+    FBStatistics statistics = {};
+    FBStatisticsSubtract(&endStatistics, &startStatistics, &statistics);
+
+    // Polygons can take the polygon clipper instead, so time that on them too
+    double polygonWallTime = 0;
+    BOOL isPolygon = NO;
+    @autoreleasepool {
+        isPolygon = [FBBezierGraph bezierGraphWithPath:path1].isPolygon && [FBBezierGraph bezierGraphWithPath:path2].isPolygon;
+    }
+    if ( isPolygon ) {
+        FBBezierGraph.usesPolygonClipper = YES;
+        for (NSUInteger run = 0; run < runs; run++) {
+            @autoreleasepool {
+                double start = FBBenchmarkGetTime();
+                FBBezierGraph *graph1 = [FBBezierGraph bezierGraphWithPath:path1];
+                FBBezierGraph *graph2 = [FBBezierGraph bezierGraphWithPath:path2];
+                [graph1 bezierGraphWithOperation:operation bezierGraph:graph2];
+                polygonWallTime += FBBenchmarkGetTime() - start;
+            }
+        }
+        FBBezierGraph.usesPolygonClipper = NO;
+    }
+
+    double approximateWallTime = 0;
+    for (NSUInteger run = 0; run < runs && tolerance > 0.0; run++) {
+        @autoreleasepool {
+            double start = FBBenchmarkGetTime();
+            FBBezierGraph *graph1 = [FBBezierGraph bezierGraphWithPath:path1];
+            FBBezierGraph *graph2 = [FBBezierGraph bezierGraphWithPath:path2];
+            [graph1 bezierGraphWithOperation:operation bezierGraph:graph2 tolerance:tolerance];
+            approximateWallTime += FBBenchmarkGetTime() - start;
+        }
+    }
+
+    size_t peakMemory = 0;
+    for (NSUInteger phase = 0; phase < FBProfilePhaseCount; phase++)
+        peakMemory = MAX(peakMemory, profile.phases[phase].peakMemory);
+
+    printf("%s    {\"shape\": \"%s\", \"size\": %lu, \"operation\": \"%s\", \"edges\": %lu, \"resultContours\": %lu, \"wallTime\": %.9f, \"peakMemory\": %zu, ",
+           first ? "" : ",\n", shape->name, (unsigned long)size, FBBenchmarkOperationNames[operation], (unsigned long)edgeCount, (unsigned long)resultContourCount, wallTime / runs, peakMemory);
+    if ( isPolygon )
+        printf("\"polygonWallTime\": %.9f, ", polygonWallTime / runs);
+    if ( tolerance > 0.0 )
+        printf("\"approximateWallTime\": %.9f, ", approximateWallTime / runs);
+    printf("\"phases\": {");
+    for (NSUInteger phase = 0; phase < FBProfilePhaseCount; phase++) {
+        printf("%s\"%s\": ", phase == 0 ? "" : ", ", FBProfilePhaseGetName((FBProfilePhase)phase));
+        FBBenchmarkPrintPhase(profile.phases[phase], runs);
+    }
+    printf("}, \"counters\": {");
+    for (NSUInteger statistic = 0; statistic < FBStatisticCount; statistic++)
+        printf("%s\"%s\": %.1f", statistic == 0 ? "" : ", ", FBStatisticGetName((FBStatistic)statistic), (double)statistics.counts[statistic] / runs);
+    printf("}}");
+    fflush(stdout);
+
+    CGPathRelease(path1);
+    CGPathRelease(path2);
+}
+
+static void FBBenchmarkPrintUsage(const char *name)
+{
+    fprintf(stderr, "usage: %s [--sizes 25,100,400] [--runs 3] [--shape name] [--tolerance 0.25]\n", name);
+    fprintf(stderr, "shapes:");
+    for (NSUInteger i = 0; i < sizeof(FBBenchmarkShapes) / sizeof(FBBenchmarkShapes[0]); i++)
+        fprintf(stderr, " %s", FBBenchmarkShapes[i].name);
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char *argv[])
+{
+    NSUInteger sizes[32] = { 25, 100, 400 };
+    NSUInteger sizeCount = 3;
+    NSUInteger runs = 3;
+    const char *shapeName = NULL;
+    CGFloat tolerance = 0.0;
+    for (int i = 1; i < argc; i++) {
+        if ( strcmp(argv[i], "--sizes") == 0 && i + 1 < argc ) {
+            sizeCount = 0;
+            for (char *size = strtok(argv[++i], ","); size != NULL && sizeCount < 32; size = strtok(NULL, ","))
+                sizes[sizeCount++] = strtoul(size, NULL, 10);
+        } else if ( strcmp(argv[i], "--runs") == 0 && i + 1 < argc )
+            runs = MAX(strtoul(argv[++i], NULL, 10), 1UL);
+        else if ( strcmp(argv[i], "--shape") == 0 && i + 1 < argc )
+            shapeName = argv[++i];
+        else if ( strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc )
+            tolerance = strtod(argv[++i], NULL);
+        else {
+            FBBenchmarkPrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("{\n  \"instructionSet\": \"%s\",\n  \"runs\": %lu,\n  \"results\": [\n", FBVectorKernelsGetInstructionSet(), (unsigned long)runs);
+    BOOL first = YES;
+    for (NSUInteger i = 0; i < sizeof(FBBenchmarkShapes) / sizeof(FBBenchmarkShapes[0]); i++) {
+        if ( shapeName != NULL && strcmp(shapeName, FBBenchmarkShapes[i].name) != 0 )
+            continue;
+        for (NSUInteger j = 0; j < sizeCount; j++) {
+            for (FBBooleanOperation operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+                FBBenchmarkRun(&FBBenchmarkShapes[i], sizes[j], operation, runs, tolerance, first);
+                first = NO;
+            }
+        }
+    }
+    printf("\n  ]\n}\n");
+    return EXIT_SUCCESS;
+}
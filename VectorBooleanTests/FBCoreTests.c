@@ -0,0 +1,1048 @@
+//
+//  FBCoreTests.c
+//  VectorBooleanTests
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <pthread.h>
+#include "FBGeometry.h"
+#include "FBBezierCurveData.h"
+#include "FBEdgeIndex.h"
+#include "FBArena.h"
+#include "FBEdgeIntersections.h"
+#include "FBThreadPool.h"
+#include "FBVectorKernels.h"
+#include "FBBezierCurveHelper.h"
+#include "FBBezierCurveLength.h"
+#include "FBProfile.h"
+#include "FBStatistics.h"
+#include "FBScanlineIndex.h"
+#include "FBPolygonClipper.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Tests for the portable C core
+//
+// These run without Foundation or XCTest, so they can be part of the CMake
+//  build on any platform. Failed checks are printed and counted, and any
+//  failure makes the program exit with an error.
+//
+
+static int FBFailureCount = 0;
+
+#define FBCheck(condition) \
+    do { \
+        if ( !(condition) ) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            FBFailureCount++; \
+        } \
+    } while (0)
+
+#define FBCheckClose(value1, value2, threshold) FBCheck(FBAreValuesCloseWithOptions((value1), (value2), (threshold)))
+
+// The tests are written for double. In a build of another FB_PRECISION a threshold
+//  leaves the same share of the digits, by the rule of FBPrecisionThreshold().
+static CGFloat FBTestThreshold(double doubleThreshold)
+{
+#if FB_PRECISION == FB_PRECISION_SINGLE
+    double epsilon = FLT_EPSILON;
+#elif FB_PRECISION == FB_PRECISION_EXTENDED
+    double epsilon = LDBL_EPSILON;
+#else
+    double epsilon = DBL_EPSILON;
+#endif
+    return pow(doubleThreshold, log(epsilon) / log(DBL_EPSILON));
+}
+
+typedef struct FBTestIntersections {
+    NSUInteger count;
+    CGFloat parameters1[8];
+    CGFloat parameters2[8];
+} FBTestIntersections;
+
+static void FBTestCollectIntersection(CGFloat parameter1, CGFloat parameter2, void *context, BOOL *stop)
+{
+    FBTestIntersections *intersections = context;
+    if ( intersections->count < 8 ) {
+        intersections->parameters1[intersections->count] = parameter1;
+        intersections->parameters2[intersections->count] = parameter2;
+    }
+    intersections->count++;
+}
+
+static void FBTestLineIntersection(void)
+{
+    FBBezierCurveData horizontal = FBBezierCurveDataMakeWithLine(CGPointMake(0, 50), CGPointMake(100, 50));
+    FBBezierCurveData vertical = FBBezierCurveDataMakeWithLine(CGPointMake(25, 0), CGPointMake(25, 100));
+
+    FBTestIntersections intersections = {};
+    FBBezierCurveDataIntersectionsWithBezierCurve(&horizontal, &vertical, NULL, FBTestCollectIntersection, &intersections);
+    FBCheck(intersections.count == 1);
+    FBCheckClose(intersections.parameters1[0], 0.25, FBTestThreshold(1e-6));
+    FBCheckClose(intersections.parameters2[0], 0.5, FBTestThreshold(1e-6));
+
+    FBBezierCurveData parallel = FBBezierCurveDataMakeWithLine(CGPointMake(0, 60), CGPointMake(100, 60));
+    intersections.count = 0;
+    FBBezierCurveDataIntersectionsWithBezierCurve(&horizontal, &parallel, NULL, FBTestCollectIntersection, &intersections);
+    FBCheck(intersections.count == 0);
+}
+
+static void FBTestCurveIntersection(void)
+{
+    // An arch over a horizontal line crosses it twice, symmetrically
+    FBBezierCurveData arch = FBBezierCurveDataMake(CGPointMake(0, 0), CGPointMake(0, 100), CGPointMake(100, 100), CGPointMake(100, 0), NO);
+    FBBezierCurveData line = FBBezierCurveDataMakeWithLine(CGPointMake(-10, 50), CGPointMake(110, 50));
+
+    FBTestIntersections intersections = {};
+    FBBezierCurveDataOverlap overlap = {};
+    FBBezierCurveDataIntersectionsWithBezierCurve(&arch, &line, &overlap, FBTestCollectIntersection, &intersections);
+    FBCheck(!overlap.hasOverlap);
+    FBCheck(intersections.count == 2);
+    for (NSUInteger i = 0; i < intersections.count && i < 8; i++) {
+        CGPoint point1 = FBBezierCurveDataPointAtParameter(arch, intersections.parameters1[i], NULL, NULL);
+        CGPoint point2 = FBBezierCurveDataPointAtParameter(line, intersections.parameters2[i], NULL, NULL);
+        FBCheck(FBArePointsCloseWithOptions(point1, point2, FBTestThreshold(1e-3)));
+        FBCheckClose(point1.y, 50, FBTestThreshold(1e-3));
+    }
+}
+
+static void FBTestOverlap(void)
+{
+    FBBezierCurveData line1 = FBBezierCurveDataMakeWithLine(CGPointMake(0, 0), CGPointMake(100, 0));
+    FBBezierCurveData line2 = FBBezierCurveDataMakeWithLine(CGPointMake(50, 0), CGPointMake(150, 0));
+
+    FBTestIntersections intersections = {};
+    FBBezierCurveDataOverlap overlap = {};
+    FBBezierCurveDataIntersectionsWithBezierCurve(&line1, &line2, &overlap, FBTestCollectIntersection, &intersections);
+    FBCheck(overlap.hasOverlap);
+    FBCheck(!overlap.reversed);
+    FBCheckClose(overlap.parameterRange1.minimum, 0.5, FBTestThreshold(1e-6));
+    FBCheckClose(overlap.parameterRange1.maximum, 1.0, FBTestThreshold(1e-6));
+    FBCheckClose(overlap.parameterRange2.minimum, 0.0, FBTestThreshold(1e-6));
+    FBCheckClose(overlap.parameterRange2.maximum, 0.5, FBTestThreshold(1e-6));
+}
+
+static void FBTestMeasurements(void)
+{
+    FBBezierCurveData line = FBBezierCurveDataMakeWithLine(CGPointMake(0, 0), CGPointMake(30, 40));
+    FBCheckClose(FBBezierCurveDataGetLength(&line), 50, FBTestThreshold(1e-9));
+    FBCheckClose(FBBezierCurveDataGetLengthAtParameter(&line, 0.5), 25, FBTestThreshold(1e-9));
+
+    FBBezierCurveData arch = FBBezierCurveDataMake(CGPointMake(0, 0), CGPointMake(0, 100), CGPointMake(100, 100), CGPointMake(100, 0), NO);
+    CGRect bounds = FBBezierCurveDataBounds(&arch);
+    FBCheckClose(CGRectGetMinX(bounds), 0, FBTestThreshold(1e-6));
+    FBCheckClose(CGRectGetMaxX(bounds), 100, FBTestThreshold(1e-6));
+    FBCheckClose(CGRectGetMaxY(bounds), 75, FBTestThreshold(1e-6));
+
+    FBBezierCurveLocation location = FBBezierCurveDataClosestLocationToPoint(arch, CGPointMake(50, 100));
+    FBCheckClose(location.parameter, 0.5, FBTestThreshold(1e-4));
+    FBCheckClose(location.distance, 25, FBTestThreshold(1e-4));
+
+    FBBezierCurveData reversed = FBBezierCurveDataReversed(arch);
+    FBCheck(FBBezierCurveDataIsEqual(arch, FBBezierCurveDataReversed(reversed)));
+    FBCheck(CGPointEqualToPoint(reversed.endPoint1, arch.endPoint2));
+}
+
+static void FBTestLengthTable(void)
+{
+    // The arch is gentle, so the fixed 24 point rule is as good as exact. The loop
+    //  nearly turns back on itself, which takes more than the first few segments.
+    CGPoint curves[2][4] = {
+        { CGPointMake(0, 0), CGPointMake(0, 100), CGPointMake(100, 100), CGPointMake(100, 0) },
+        { CGPointMake(0, 0), CGPointMake(300, 100), CGPointMake(-200, 100), CGPointMake(100, 0) },
+    };
+    for (NSUInteger i = 0; i < 2; i++) {
+        const CGPoint *points = curves[i];
+        FBBezierCurveLengthTableRef table = FBBezierCurveLengthTableCreate(points[0], points[1], points[2], points[3]);
+        if ( i == 0 )
+            FBCheckClose(FBBezierCurveLengthTableGetLength(table), FBGaussQuadratureComputeCurveLengthForCubic(1.0, 24, points[0], points[1], points[2], points[3]), FBTestThreshold(1e-9));
+#if FB_PRECISION != FB_PRECISION_SINGLE
+        // Single precision's tolerance is loose enough for the first segments
+        else
+            FBCheck(FBBezierCurveLengthTableGetSegmentCount(table) > 8);
+#endif
+
+        CGFloat previousLength = 0.0;
+        for (NSUInteger j = 0; j <= 20; j++) {
+            CGFloat parameter = j / 20.0;
+            CGFloat length = FBBezierCurveLengthTableGetLengthAtParameter(table, parameter);
+            FBCheck(length >= previousLength);
+            if ( i == 0 )
+                FBCheckClose(length, FBGaussQuadratureComputeCurveLengthForCubic(parameter, 24, points[0], points[1], points[2], points[3]), FBTestThreshold(1e-9));
+            FBCheckClose(FBBezierCurveLengthTableGetParameterAtLength(table, length), parameter, FBTestThreshold(1e-9));
+            previousLength = length;
+        }
+        FBCheck(FBBezierCurveLengthTableGetParameterAtLength(table, -1.0) == 0.0);
+        FBCheck(FBBezierCurveLengthTableGetParameterAtLength(table, previousLength + 1.0) == 1.0);
+        FBBezierCurveLengthTableRelease(table);
+    }
+}
+
+static void FBTestAxisAlignedLineIntersections(void)
+{
+    // The analytic ray intersections have to find what bezier clipping finds
+    FBBezierCurveData curves[] = {
+        FBBezierCurveDataMake(CGPointMake(0, 0), CGPointMake(0, 100), CGPointMake(100, 100), CGPointMake(100, 0), NO),
+        FBBezierCurveDataMake(CGPointMake(0, 0), CGPointMake(150, 100), CGPointMake(-50, 100), CGPointMake(100, 0), NO),
+        FBBezierCurveDataMake(CGPointMake(0, 10), CGPointMake(30, 90), CGPointMake(60, -40), CGPointMake(100, 70), NO),
+        FBBezierCurveDataMakeWithLine(CGPointMake(10, 5), CGPointMake(80, 95)),
+    };
+    CGFloat heights[] = { 5, 25, 50, 74, 90 };
+    for (NSUInteger i = 0; i < sizeof(curves) / sizeof(curves[0]); i++) {
+        for (NSUInteger j = 0; j < sizeof(heights) / sizeof(heights[0]); j++) {
+            FBBezierCurveData ray = FBBezierCurveDataMakeWithLine(CGPointMake(-20, heights[j]), CGPointMake(200, heights[j]));
+            FBTestIntersections clipped = {};
+            FBBezierCurveDataIntersectionsWithBezierCurve(&ray, &curves[i], NULL, FBTestCollectIntersection, &clipped);
+            FBTestIntersections solved = {};
+            FBBezierCurveDataIntersectionsWithAxisAlignedLine(&ray, &curves[i], NULL, FBTestCollectIntersection, &solved);
+            FBCheck(solved.count == clipped.count);
+            for (NSUInteger k = 0; k < solved.count && k < 8; k++) {
+                // Solved intersections come back in curve order, so look for the match
+                BOOL found = NO;
+                for (NSUInteger l = 0; l < clipped.count && l < 8; l++)
+                    found = found || (FBAreValuesCloseWithOptions(solved.parameters1[k], clipped.parameters1[l], FBTestThreshold(1e-5)) && FBAreValuesCloseWithOptions(solved.parameters2[k], clipped.parameters2[l], FBTestThreshold(1e-5)));
+                FBCheck(found);
+            }
+        }
+    }
+    
+    // Touching at an extremum counts, and a ray that stops short doesn't reach
+    FBBezierCurveData arch = curves[0];
+    FBBezierCurveData top = FBBezierCurveDataMakeWithLine(CGPointMake(-20, 75), CGPointMake(200, 75));
+    FBTestIntersections intersections = {};
+    FBBezierCurveDataIntersectionsWithAxisAlignedLine(&top, &arch, NULL, FBTestCollectIntersection, &intersections);
+    FBCheck(intersections.count == 1);
+    FBCheckClose(intersections.parameters2[0], 0.5, FBTestThreshold(1e-9));
+    FBBezierCurveData shortRay = FBBezierCurveDataMakeWithLine(CGPointMake(-20, 50), CGPointMake(50, 50));
+    intersections.count = 0;
+    FBBezierCurveDataIntersectionsWithAxisAlignedLine(&shortRay, &arch, NULL, FBTestCollectIntersection, &intersections);
+    FBCheck(intersections.count == 1);
+    
+    // A ray along a line has to be reported as an overlap, like before
+    FBBezierCurveData edge = FBBezierCurveDataMakeWithLine(CGPointMake(10, 50), CGPointMake(60, 50));
+    FBBezierCurveData ray = FBBezierCurveDataMakeWithLine(CGPointMake(-20, 50), CGPointMake(200, 50));
+    FBBezierCurveDataOverlap overlap = {};
+    FBBezierCurveDataIntersectionsWithAxisAlignedLine(&ray, &edge, &overlap, FBTestCollectIntersection, &intersections);
+    FBCheck(overlap.hasOverlap);
+    
+    CGFloat parameters[4] = {};
+    NSUInteger count = 0;
+    FBCheck(!FBBezierCurveDataFindAxisCrossings(&edge, YES, 50, parameters, &count));
+    FBCheck(FBBezierCurveDataFindAxisCrossings(&arch, NO, 50, parameters, &count));
+    FBCheck(count == 1);
+    FBCheckClose(parameters[0], 0.5, FBTestThreshold(1e-9));
+}
+
+static CGRect FBTestScalarCurveBounds(CGPoint points[4])
+{
+    // The scalar code FBVectorCurveBounds() replaced
+    CGPoint topLeft = BezierWithPoints(3, points, 0, NULL, NULL);
+    CGPoint bottomRight = topLeft;
+    FBExpandBoundsByPoint(&topLeft, &bottomRight, BezierWithPoints(3, points, 1, NULL, NULL));
+    CGFloat roots[4] = {};
+    NSUInteger xRootsCount = 0;
+    NSUInteger yRootsCount = 0;
+    FBComputeCubicFirstDerivativeRoots(points[0].x, points[1].x, points[2].x, points[3].x, &roots[0], &xRootsCount);
+    FBComputeCubicFirstDerivativeRoots(points[0].y, points[1].y, points[2].y, points[3].y, &roots[xRootsCount], &yRootsCount);
+    for (NSUInteger i = 0; i < xRootsCount + yRootsCount; i++) {
+        if ( roots[i] >= 0 && roots[i] <= 1 )
+            FBExpandBoundsByPoint(&topLeft, &bottomRight, BezierWithPoints(3, points, roots[i], NULL, NULL));
+    }
+    return CGRectMake(topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y);
+}
+
+static void FBTestVectorKernels(void)
+{
+    // The kernels have to give exactly what the scalar code gives
+    srand(7);
+    for (NSUInteger i = 0; i < 1000; i++) {
+        CGPoint points[4];
+        for (NSUInteger j = 0; j < 4; j++)
+            points[j] = CGPointMake((rand() % 20000) / 100.0 - 100.0, (rand() % 20000) / 100.0 - 100.0);
+        CGFloat parameter = (rand() % 1001) / 1000.0;
+        
+        CGPoint scalarLeft[4] = {}, scalarRight[4] = {}, vectorLeft[4] = {}, vectorRight[4] = {};
+        CGPoint scalarPoint = BezierWithPoints(3, points, parameter, scalarLeft, scalarRight);
+        CGPoint vectorPoint = FBVectorSplitCubic(points, parameter, vectorLeft, vectorRight);
+        FBCheck(memcmp(&scalarPoint, &vectorPoint, sizeof(CGPoint)) == 0);
+        FBCheck(memcmp(scalarLeft, vectorLeft, sizeof(scalarLeft)) == 0);
+        FBCheck(memcmp(scalarRight, vectorRight, sizeof(scalarRight)) == 0);
+        
+        FBNormalizedLine line = FBNormalizedLineMake(points[0], points[3]);
+        CGFloat distances[4] = {};
+        FBVectorDistancesFromLine(line, points, distances);
+        for (NSUInteger j = 0; j < 4; j++)
+            FBCheck(distances[j] == FBNormalizedLineDistanceFromPoint(line, points[j]));
+        
+        CGRect scalarBounds = FBTestScalarCurveBounds(points);
+        CGRect vectorBounds = FBVectorCurveBounds(points);
+        FBCheck(memcmp(&scalarBounds, &vectorBounds, sizeof(CGRect)) == 0);
+    }
+}
+
+static void FBTestEdgeIndex(void)
+{
+    FBEdgeIndexEntry entries1[] = {
+        { CGRectMake(0, 0, 10, 10), 0, 0 },
+        { CGRectMake(20, 0, 10, 10), 0, 1 },
+        { CGRectMake(40, 0, 10, 10), 1, 0 },
+    };
+    FBEdgeIndexEntry entries2[] = {
+        { CGRectMake(5, 5, 20, 2), 0, 0 },
+        { CGRectMake(100, 100, 10, 10), 0, 1 },
+    };
+    FBEdgeIndexRef index1 = FBEdgeIndexCreate(entries1, 3);
+    FBEdgeIndexRef index2 = FBEdgeIndexCreate(entries2, 2);
+    FBCheck(FBEdgeIndexGetCount(index1) == 3);
+
+    NSUInteger count = 0;
+    FBEdgeIndexPair *pairs = FBEdgeIndexCopyOverlappingPairs(index1, index2, &count);
+    FBCheck(count == 2);
+    for (NSUInteger i = 0; i < count; i++) {
+        FBCheck(pairs[i].contourIndex1 == 0);
+        FBCheck(pairs[i].contourIndex2 == 0 && pairs[i].edgeIndex2 == 0);
+    }
+    free(pairs);
+
+    FBEdgeIndexRelease(index1);
+    FBEdgeIndexRelease(index2);
+}
+
+typedef struct FBTestNearestContext {
+    FBBezierCurveData *curves;
+    NSUInteger projectionCount;
+} FBTestNearestContext;
+
+static CGFloat FBTestDistanceToCurve(const FBEdgeIndexEntry *entry, CGPoint point, void *context)
+{
+    FBTestNearestContext *nearestContext = context;
+    nearestContext->projectionCount++;
+    return FBBezierCurveDataClosestLocationToPoint(nearestContext->curves[entry->edgeIndex], point).distance;
+}
+
+static void FBTestNearestEntries(void)
+{
+    // A ring of 100 short curves. Only the few near the point should be projected onto,
+    //  and the answer has to be the same as projecting onto all of them.
+    FBBezierCurveData curves[100];
+    FBEdgeIndexEntry entries[100];
+    for (NSUInteger i = 0; i < 100; i++) {
+        CGFloat angle1 = 2.0 * M_PI * i / 100;
+        CGFloat angle2 = 2.0 * M_PI * (i + 1) / 100;
+        CGPoint endPoint1 = CGPointMake(500 * cos(angle1), 500 * sin(angle1));
+        CGPoint endPoint2 = CGPointMake(500 * cos(angle2), 500 * sin(angle2));
+        CGPoint controlPoint = CGPointMake(510 * cos((angle1 + angle2) / 2), 510 * sin((angle1 + angle2) / 2));
+        curves[i] = FBBezierCurveDataMake(endPoint1, controlPoint, controlPoint, endPoint2, NO);
+        entries[i].bounds = FBBezierCurveDataBoundingRect(&curves[i]);
+        entries[i].contourIndex = 0;
+        entries[i].edgeIndex = i;
+    }
+    FBEdgeIndexRef index = FBEdgeIndexCreate(entries, 100);
+
+    CGPoint points[] = { CGPointMake(0, 0), CGPointMake(480, 30), CGPointMake(-700, 120), CGPointMake(12, -505) };
+    for (NSUInteger i = 0; i < sizeof(points) / sizeof(points[0]); i++) {
+        CGFloat bruteForceDistance = INFINITY;
+        for (NSUInteger j = 0; j < 100; j++)
+            bruteForceDistance = MIN(bruteForceDistance, FBBezierCurveDataClosestLocationToPoint(curves[j], points[i]).distance);
+
+        FBTestNearestContext context = { curves, 0 };
+        CGFloat distance = FBEdgeIndexEnumerateNearestEntries(index, points[i], INFINITY, FBTestDistanceToCurve, &context);
+        FBCheck(distance == bruteForceDistance);
+        // From the center every curve is about as far away, so nothing can be ruled out
+        if ( i > 0 )
+            FBCheck(context.projectionCount < 10);
+    }
+
+    // Nothing is nearer than the maximum distance, so nothing is projected onto
+    FBTestNearestContext context = { curves, 0 };
+    FBCheck(FBEdgeIndexEnumerateNearestEntries(index, CGPointMake(480, 30), 1.0, FBTestDistanceToCurve, &context) == 1.0);
+    FBCheck(context.projectionCount == 0);
+
+    FBEdgeIndexRelease(index);
+}
+
+static void FBTestScanlineIndex(void)
+{
+    // A circle of radius 100 around the origin, with a square inside that goes around the
+    //  same way. Even odd makes the square a hole, non zero fills it.
+    static const CGFloat FBCircleControl = 0.5522847498 * 100;
+    FBBezierCurveData curves[8] = {
+        FBBezierCurveDataMake(CGPointMake(100, 0), CGPointMake(100, FBCircleControl), CGPointMake(FBCircleControl, 100), CGPointMake(0, 100), NO),
+        FBBezierCurveDataMake(CGPointMake(0, 100), CGPointMake(-FBCircleControl, 100), CGPointMake(-100, FBCircleControl), CGPointMake(-100, 0), NO),
+        FBBezierCurveDataMake(CGPointMake(-100, 0), CGPointMake(-100, -FBCircleControl), CGPointMake(-FBCircleControl, -100), CGPointMake(0, -100), NO),
+        FBBezierCurveDataMake(CGPointMake(0, -100), CGPointMake(FBCircleControl, -100), CGPointMake(100, -FBCircleControl), CGPointMake(100, 0), NO),
+        FBBezierCurveDataMakeWithLine(CGPointMake(-30, -30), CGPointMake(30, -30)),
+        FBBezierCurveDataMakeWithLine(CGPointMake(30, -30), CGPointMake(30, 30)),
+        FBBezierCurveDataMakeWithLine(CGPointMake(30, 30), CGPointMake(-30, 30)),
+        FBBezierCurveDataMakeWithLine(CGPointMake(-30, 30), CGPointMake(-30, -30)),
+    };
+    FBScanlineIndexRef index = FBScanlineIndexCreate(curves, 8);
+
+    // Stay off the outlines, which could go either way
+    CGPoint points[35 * 35];
+    BOOL insideCircle[35 * 35];
+    BOOL insideSquare[35 * 35];
+    NSUInteger count = 0;
+    for (NSUInteger row = 0; row < 35; row++) {
+        for (NSUInteger column = 0; column < 35; column++) {
+            CGPoint point = CGPointMake(-119.5 + column * 7, -119.5 + row * 7);
+            CGFloat radius = sqrt(point.x * point.x + point.y * point.y);
+            if ( fabs(radius - 100) < 0.5 )
+                continue;
+            points[count] = point;
+            insideCircle[count] = radius < 100;
+            insideSquare[count] = fabs(point.x) < 30 && fabs(point.y) < 30;
+            count++;
+        }
+    }
+
+    for (NSUInteger i = 0; i < count; i++) {
+        NSInteger expected = (insideCircle[i] ? 1 : 0) + (insideSquare[i] ? 1 : 0);
+        FBCheck(FBScanlineIndexGetWindingNumber(index, points[i]) == expected);
+        FBCheck(FBScanlineIndexContainsPoint(index, points[i], FBFillRuleEvenOdd) == (expected == 1));
+        FBCheck(FBScanlineIndexContainsPoint(index, points[i], FBFillRuleNonZero) == (expected != 0));
+    }
+
+    // The batch gives the same answers, on the pool or not
+    BOOL results[35 * 35];
+    FBThreadPoolRef pool = FBThreadPoolCreate(3);
+    FBScanlineIndexContainsPoints(index, points, count, FBFillRuleEvenOdd, pool, results);
+    for (NSUInteger i = 0; i < count; i++)
+        FBCheck(results[i] == (insideCircle[i] != insideSquare[i]));
+    FBScanlineIndexContainsPoints(index, points, count, FBFillRuleNonZero, NULL, results);
+    for (NSUInteger i = 0; i < count; i++)
+        FBCheck(results[i] == insideCircle[i]);
+    FBThreadPoolRelease(pool);
+
+    // A ray through a vertex crosses there once, and horizontal edges don't count
+    FBCheck(FBScanlineIndexGetWindingNumber(index, CGPointMake(-50, -30)) == 1);
+    FBCheck(FBScanlineIndexGetWindingNumber(index, CGPointMake(0, 0)) == 2);
+    FBCheck(FBScanlineIndexGetWindingNumber(index, CGPointMake(-150, 0)) == 0);
+    FBScanlineIndexRelease(index);
+
+    FBScanlineIndexRef emptyIndex = FBScanlineIndexCreate(NULL, 0);
+    FBCheck(FBScanlineIndexGetWindingNumber(emptyIndex, CGPointMake(0, 0)) == 0);
+    FBScanlineIndexRelease(emptyIndex);
+}
+
+static CGFloat FBTestPolygonArea(FBPolygonRef polygon)
+{
+    // Holes go clockwise, so they take their area away
+    CGFloat area = 0.0;
+    for (NSUInteger contourIndex = 0; contourIndex < FBPolygonGetContourCount(polygon); contourIndex++) {
+        NSUInteger count = 0;
+        const CGPoint *points = FBPolygonGetContourPoints(polygon, contourIndex, &count);
+        for (NSUInteger i = 0; i < count; i++) {
+            CGPoint next = points[(i + 1) % count];
+            area += (points[i].x * next.y - next.x * points[i].y) / 2.0;
+        }
+    }
+    return area;
+}
+
+static FBPolygonRef FBTestCreateSquare(CGFloat x, CGFloat y, CGFloat size)
+{
+    CGPoint points[] = { {x, y}, {x, y + size}, {x + size, y + size}, {x + size, y} };
+    NSUInteger count = 4;
+    return FBPolygonCreate(points, &count, 1);
+}
+
+static void FBTestPolygonOperations(FBPolygonRef polygon1, FBPolygonRef polygon2, const CGFloat areas[4], const NSUInteger contourCounts[4])
+{
+    for (NSUInteger operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+        FBPolygonRef result = FBPolygonCreateWithOperation(polygon1, polygon2, (FBBooleanOperation)operation);
+        FBCheckClose(FBTestPolygonArea(result), areas[operation], FBTestThreshold(1e-9));
+        FBCheck(FBPolygonGetContourCount(result) == contourCounts[operation]);
+        FBPolygonRelease(result);
+    }
+}
+
+static void FBTestPolygonClipper(void)
+{
+    // Two squares overlapping at a corner. Union, intersect, difference, XOR.
+    FBPolygonRef square1 = FBTestCreateSquare(0, 0, 2);
+    FBPolygonRef square2 = FBTestCreateSquare(1, 1, 2);
+    FBTestPolygonOperations(square1, square2, (CGFloat[]){ 7, 1, 3, 6 }, (NSUInteger[]){ 1, 1, 1, 2 });
+
+    FBPolygonRef intersect = FBPolygonCreateWithOperation(square1, square2, FBBooleanOperationIntersect);
+    NSUInteger count = 0;
+    const CGPoint *points = FBPolygonGetContourPoints(intersect, 0, &count);
+    FBCheck(count == 4);
+    for (NSUInteger i = 0; i < count; i++)
+        FBCheck((points[i].x == 1 || points[i].x == 2) && (points[i].y == 1 || points[i].y == 2));
+    FBPolygonRelease(intersect);
+
+    // Squares sharing a side merge into one rectangle, with the points along the side gone
+    FBPolygonRef neighbor = FBTestCreateSquare(2, 0, 2);
+    FBPolygonRef merged = FBPolygonCreateWithOperation(square1, neighbor, FBBooleanOperationUnion);
+    FBCheck(FBPolygonGetContourCount(merged) == 1);
+    FBPolygonGetContourPoints(merged, 0, &count);
+    FBCheck(count == 4);
+    FBCheckClose(FBTestPolygonArea(merged), 8, FBTestThreshold(1e-9));
+    FBPolygonRelease(merged);
+    FBTestPolygonOperations(square1, neighbor, (CGFloat[]){ 8, 0, 4, 8 }, (NSUInteger[]){ 1, 0, 1, 1 });
+
+    // The same square twice, and squares touching only at a corner
+    FBTestPolygonOperations(square1, square1, (CGFloat[]){ 4, 4, 0, 0 }, (NSUInteger[]){ 1, 1, 0, 0 });
+    FBPolygonRef diagonal = FBTestCreateSquare(2, 2, 2);
+    FBTestPolygonOperations(square1, diagonal, (CGFloat[]){ 8, 0, 4, 8 }, (NSUInteger[]){ 2, 0, 1, 2 });
+
+    // A square with a hole, by the even odd rule whichever way the hole goes
+    CGPoint framePoints[] = { {0, 0}, {10, 0}, {10, 10}, {0, 10}, {3, 3}, {7, 3}, {7, 7}, {3, 7} };
+    NSUInteger frameCounts[] = { 4, 4 };
+    FBPolygonRef frame = FBPolygonCreate(framePoints, frameCounts, 2);
+    FBPolygonRef center = FBTestCreateSquare(4, 4, 2);
+    FBTestPolygonOperations(frame, center, (CGFloat[]){ 88, 0, 84, 88 }, (NSUInteger[]){ 3, 0, 2, 3 });
+    FBPolygonRef bar = FBTestCreateSquare(-1, 4, 12);
+    FBPolygonRef band = FBPolygonCreateWithOperation(frame, bar, FBBooleanOperationIntersect);
+    FBCheckClose(FBTestPolygonArea(band), 60 - 12, FBTestThreshold(1e-9));
+    FBPolygonRelease(band);
+
+    // A bow tie crossing itself fills both of its triangles
+    CGPoint bowTiePoints[] = { {0, 0}, {2, 2}, {2, 0}, {0, 2} };
+    NSUInteger bowTieCount = 4;
+    FBPolygonRef bowTie = FBPolygonCreate(bowTiePoints, &bowTieCount, 1);
+    FBPolygonRef empty = FBPolygonCreate(NULL, NULL, 0);
+    FBTestPolygonOperations(bowTie, empty, (CGFloat[]){ 2, 0, 2, 2 }, (NSUInteger[]){ 2, 0, 2, 2 });
+
+    FBPolygonRelease(empty);
+    FBPolygonRelease(bowTie);
+    FBPolygonRelease(bar);
+    FBPolygonRelease(center);
+    FBPolygonRelease(frame);
+    FBPolygonRelease(diagonal);
+    FBPolygonRelease(neighbor);
+    FBPolygonRelease(square2);
+    FBPolygonRelease(square1);
+}
+
+// A jagged ring, so two of them cross all the way round
+static FBPolygonRef FBTestCreateRing(NSUInteger size, CGFloat offset, NSUInteger seed)
+{
+    CGPoint *points = malloc(size * sizeof(CGPoint));
+    for (NSUInteger i = 0; i < size; i++) {
+        CGFloat angle = 2.0 * M_PI * i / size;
+        CGFloat distance = 100 + ((i * 7919 + seed) % 9) - 4.0;
+        points[i] = CGPointMake(offset + distance * cos(angle), distance * sin(angle));
+    }
+    FBPolygonRef polygon = FBPolygonCreate(points, &size, 1);
+    free(points);
+    return polygon;
+}
+
+static void FBTestTiledPolygonOperations(FBPolygonRef polygon1, FBPolygonRef polygon2, CGFloat tileSize, FBThreadPoolRef pool)
+{
+    // Tiling mustn't change the result, only the order of the contours and where they start
+    for (NSUInteger operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+        FBPolygonRef expected = FBPolygonCreateWithOperation(polygon1, polygon2, (FBBooleanOperation)operation);
+        FBPolygonRef result = FBPolygonCreateWithOperationInTiles(polygon1, polygon2, (FBBooleanOperation)operation, tileSize, pool);
+        FBCheckClose(FBTestPolygonArea(result), FBTestPolygonArea(expected), FBTestThreshold(1e-9) * MAX(fabs(FBTestPolygonArea(expected)), 1.0));
+        FBCheck(FBPolygonGetContourCount(result) == FBPolygonGetContourCount(expected));
+        NSUInteger pointCount = 0;
+        NSUInteger expectedPointCount = 0;
+        for (NSUInteger i = 0; i < FBPolygonGetContourCount(result); i++) {
+            NSUInteger count = 0;
+            FBPolygonGetContourPoints(result, i, &count);
+            pointCount += count;
+        }
+        for (NSUInteger i = 0; i < FBPolygonGetContourCount(expected); i++) {
+            NSUInteger count = 0;
+            FBPolygonGetContourPoints(expected, i, &count);
+            expectedPointCount += count;
+        }
+        FBCheck(pointCount == expectedPointCount);
+        FBPolygonRelease(result);
+        FBPolygonRelease(expected);
+    }
+}
+
+static void FBTestTiles(void)
+{
+    // Rings crossing each other in lots of tiles, with the seams anywhere
+    FBThreadPoolRef pool = FBThreadPoolCreate(3);
+    FBPolygonRef ring1 = FBTestCreateRing(997, 0, 0);
+    FBPolygonRef ring2 = FBTestCreateRing(1009, 30, 104729);
+    FBTestTiledPolygonOperations(ring1, ring2, 17.3, NULL);
+    FBTestTiledPolygonOperations(ring1, ring2, 41, pool);
+    FBTestTiledPolygonOperations(ring1, ring2, 1000, pool);
+
+    // Squares with their sides on the seams, and a frame whose hole has a seam through it
+    FBPolygonRef square1 = FBTestCreateSquare(0, 0, 4);
+    FBPolygonRef square2 = FBTestCreateSquare(2, 2, 4);
+    FBTestTiledPolygonOperations(square1, square2, 2, pool);
+    FBPolygonRef neighbor = FBTestCreateSquare(4, 0, 4);
+    FBTestTiledPolygonOperations(square1, neighbor, 2, pool);
+    CGPoint framePoints[] = { {0, 0}, {10, 0}, {10, 10}, {0, 10}, {3, 3}, {7, 3}, {7, 7}, {3, 7} };
+    NSUInteger frameCounts[] = { 4, 4 };
+    FBPolygonRef frame = FBPolygonCreate(framePoints, frameCounts, 2);
+    FBPolygonRef center = FBTestCreateSquare(4, 4, 2);
+    FBTestTiledPolygonOperations(frame, center, 2.5, pool);
+    FBTestTiledPolygonOperations(frame, center, 5, NULL);
+    
+    // Segments running through many tiles, and a U that leaves columns and rows and comes back
+    CGPoint diamondPoints[] = { {50, 0}, {100, 50}, {50, 100}, {0, 50} };
+    NSUInteger diamondCount = 4;
+    FBPolygonRef diamond = FBPolygonCreate(diamondPoints, &diamondCount, 1);
+    CGPoint uPoints[] = { {10, 10}, {90, 10}, {90, 90}, {70, 90}, {70, 30}, {30, 30}, {30, 90}, {10, 90} };
+    NSUInteger uCount = 8;
+    FBPolygonRef u = FBPolygonCreate(uPoints, &uCount, 1);
+    FBTestTiledPolygonOperations(diamond, u, 3.3, pool);
+    FBTestTiledPolygonOperations(u, diamond, 10, NULL);
+    FBPolygonRelease(u);
+    FBPolygonRelease(diamond);
+
+    // On the grid, with vertices and crossings on the seams and segments running along them
+    CGPoint arrowPoints[] = { {90, 50}, {50, 60}, {20, 50}, {20, 20}, {50, 30} };
+    NSUInteger arrowCount = 5;
+    FBPolygonRef arrow = FBPolygonCreate(arrowPoints, &arrowCount, 1);
+    CGPoint zigzagPoints[] = { {60, 50}, {50, 60}, {20, 70}, {20, 50}, {10, 10}, {40, 30}, {80, 10} };
+    NSUInteger zigzagCount = 7;
+    FBPolygonRef zigzag = FBPolygonCreate(zigzagPoints, &zigzagCount, 1);
+    FBTestTiledPolygonOperations(arrow, zigzag, 10, NULL);
+    FBTestTiledPolygonOperations(arrow, zigzag, 5, pool);
+    CGPoint trianglePoints[] = { {70, 70}, {90, 30}, {10, 70} };
+    NSUInteger triangleCount = 3;
+    FBPolygonRef triangle = FBPolygonCreate(trianglePoints, &triangleCount, 1);
+    CGPoint bowtiePoints[] = { {40, 20}, {70, 50}, {40, 40}, {70, 60} };
+    NSUInteger bowtieCount = 4;
+    FBPolygonRef bowtie = FBPolygonCreate(bowtiePoints, &bowtieCount, 1);
+    FBTestTiledPolygonOperations(triangle, bowtie, 10, NULL);
+    FBTestTiledPolygonOperations(triangle, bowtie, 5, pool);
+    FBPolygonRelease(bowtie);
+    FBPolygonRelease(triangle);
+    FBPolygonRelease(zigzag);
+    FBPolygonRelease(arrow);
+
+    // The stitched rectangle has no points left along the seams
+    FBPolygonRef merged = FBPolygonCreateWithOperationInTiles(square1, neighbor, FBBooleanOperationUnion, 1, pool);
+    FBCheck(FBPolygonGetContourCount(merged) == 1);
+    NSUInteger count = 0;
+    FBPolygonGetContourPoints(merged, 0, &count);
+    FBCheck(count == 4);
+    FBCheckClose(FBTestPolygonArea(merged), 32, FBTestThreshold(1e-9));
+    FBPolygonRelease(merged);
+
+    FBPolygonRelease(center);
+    FBPolygonRelease(frame);
+    FBPolygonRelease(neighbor);
+    FBPolygonRelease(square2);
+    FBPolygonRelease(square1);
+    FBPolygonRelease(ring2);
+    FBPolygonRelease(ring1);
+    FBThreadPoolRelease(pool);
+}
+
+static void FBTestArena(void)
+{
+    FBArenaRef arena = FBArenaCreate(256);
+    
+    char *small = FBArenaAllocate(arena, 10);
+    FBCheck(small != NULL && ((size_t)small % 16) == 0);
+    FBCheck(small[0] == 0 && small[9] == 0);
+    
+    // Growing the last allocation happens in place while there's room
+    char *grown = FBArenaReallocate(arena, small, 10, 100);
+    FBCheck(grown == small);
+    FBCheck(FBArenaGetBlockCount(arena) == 1);
+    
+    // Large allocations get a block of their own, and moving keeps the contents
+    grown[0] = 42;
+    char *moved = FBArenaReallocate(arena, grown, 100, 1000);
+    FBCheck(moved != grown && moved[0] == 42);
+    FBCheck(FBArenaGetBlockCount(arena) == 2);
+    
+    FBArenaReset(arena);
+    FBCheck(FBArenaGetBlockCount(arena) == 1);
+    FBArenaRelease(arena);
+    
+    // The thread's arena sticks around
+    FBArenaRef threadArena = FBArenaGetForCurrentThread();
+    FBCheck(threadArena != NULL && threadArena == FBArenaGetForCurrentThread());
+}
+
+static void FBTestEdgeIntersections(void)
+{
+    // A square crossed by a horizontal and a vertical line
+    FBArenaRef arena = FBArenaCreate(0);
+    NSUInteger squareCounts[] = { 4 };
+    FBEdgeTable *square = FBEdgeTableCreate(arena, squareCounts, 1);
+    CGPoint corners[] = { { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 } };
+    for (NSUInteger i = 0; i < 4; i++)
+        *FBEdgeTableGetCurve(square, 0, i) = FBBezierCurveDataMakeWithLine(corners[i], corners[(i + 1) % 4]);
+    
+    NSUInteger lineCounts[] = { 1, 1 };
+    FBEdgeTable *lines = FBEdgeTableCreate(arena, lineCounts, 2);
+    *FBEdgeTableGetCurve(lines, 0, 0) = FBBezierCurveDataMakeWithLine(CGPointMake(-50, 50), CGPointMake(150, 50));
+    *FBEdgeTableGetCurve(lines, 1, 0) = FBBezierCurveDataMakeWithLine(CGPointMake(25, -50), CGPointMake(25, 150));
+    
+    FBEdgeIndexPair pairs[8] = {};
+    NSUInteger pairCount = 0;
+    for (NSUInteger contour = 0; contour < 2; contour++) {
+        for (NSUInteger edge = 0; edge < 4; edge++) {
+            FBEdgeIndexPair pair = { 0, edge, contour, 0 };
+            pairs[pairCount++] = pair;
+        }
+    }
+    
+    FBEdgeIntersections intersections = {};
+    FBEdgeIntersectionsFind(arena, square, lines, pairs, pairCount, YES, &intersections);
+    FBCheck(intersections.count == 4);
+    for (NSUInteger i = 0; i < intersections.count; i++) {
+        FBEdgeIndexPair pair = pairs[intersections.intersections[i].pairIndex];
+        CGPoint point1 = FBBezierCurveDataPointAtParameter(*FBEdgeTableGetCurve(square, pair.contourIndex1, pair.edgeIndex1), intersections.intersections[i].parameter1, NULL, NULL);
+        CGPoint point2 = FBBezierCurveDataPointAtParameter(*FBEdgeTableGetCurve(lines, pair.contourIndex2, pair.edgeIndex2), intersections.intersections[i].parameter2, NULL, NULL);
+        FBCheck(FBArePointsCloseWithOptions(point1, point2, FBTestThreshold(1e-6)));
+        if ( i > 0 )
+            FBCheck(intersections.intersections[i - 1].pairIndex <= intersections.intersections[i].pairIndex);
+    }
+    for (NSUInteger i = 0; i < pairCount; i++)
+        FBCheck(!intersections.overlaps[i].hasOverlap);
+    
+    FBArenaRelease(arena);
+}
+
+static void FBTestMonotonePieces(void)
+{
+    // An S shaped curve has extrema in both directions
+    FBBezierCurveData curve = FBBezierCurveDataMake(CGPointMake(0, 0), CGPointMake(100, 100), CGPointMake(-50, 100), CGPointMake(50, 0), NO);
+    FBBezierCurveData pieces[5];
+    FBRange ranges[5];
+    NSUInteger count = FBBezierCurveDataSplitIntoMonotonePieces(curve, pieces, ranges);
+    FBCheck(count > 1);
+    FBCheck(ranges[0].minimum == 0.0 && ranges[count - 1].maximum == 1.0);
+    for (NSUInteger i = 0; i < count; i++) {
+        if ( i > 0 )
+            FBCheck(ranges[i].minimum == ranges[i - 1].maximum);
+        // Monotone means the end points span the bounds
+        CGRect bounds = FBBezierCurveDataBounds(&pieces[i]);
+        FBCheckClose(CGRectGetWidth(bounds), fabs(pieces[i].endPoint2.x - pieces[i].endPoint1.x), FBTestThreshold(1e-9));
+        FBCheckClose(CGRectGetHeight(bounds), fabs(pieces[i].endPoint2.y - pieces[i].endPoint1.y), FBTestThreshold(1e-9));
+    }
+    FBBezierCurveData line = FBBezierCurveDataMakeWithLine(CGPointMake(0, 0), CGPointMake(10, 10));
+    FBCheck(FBBezierCurveDataSplitIntoMonotonePieces(line, pieces, ranges) == 1);
+    
+    // Splitting the tables can't change what's found, including overlaps
+    FBArenaRef arena = FBArenaCreate(0);
+    NSUInteger edgeCount = 3;
+    FBEdgeTable *table1 = FBEdgeTableCreate(arena, &edgeCount, 1);
+    FBEdgeTable *table2 = FBEdgeTableCreate(arena, &edgeCount, 1);
+    table1->curves[0] = curve;
+    table1->curves[1] = FBBezierCurveDataMake(CGPointMake(0, 0), CGPointMake(0, 100), CGPointMake(100, 100), CGPointMake(100, 0), NO);
+    table1->curves[2] = FBBezierCurveDataMake(CGPointMake(0, 50), CGPointMake(30, 90), CGPointMake(60, -40), CGPointMake(100, 70), NO);
+    table2->curves[0] = FBBezierCurveDataMakeWithLine(CGPointMake(-10, 50), CGPointMake(110, 50));
+    table2->curves[1] = FBBezierCurveDataMake(CGPointMake(0, 90), CGPointMake(30, -20), CGPointMake(70, 120), CGPointMake(100, 10), NO);
+    table2->curves[2] = table1->curves[1];
+    FBEdgeIndexPair pairs[9];
+    for (NSUInteger i = 0; i < 9; i++) {
+        FBEdgeIndexPair pair = { 0, i / 3, 0, i % 3 };
+        pairs[i] = pair;
+    }
+    
+    FBEdgeIntersections whole = {};
+    FBEdgeIntersectionsFind(arena, table1, table2, pairs, 9, YES, &whole);
+    FBEdgeTableSplitIntoMonotonePieces(arena, table1);
+    FBEdgeTableSplitIntoMonotonePieces(arena, table2);
+    FBEdgeIntersections split = {};
+    FBEdgeIntersectionsFind(arena, table1, table2, pairs, 9, YES, &split);
+    FBCheck(whole.count > 0);
+    FBCheck(split.count == whole.count);
+    for (NSUInteger i = 0; i < whole.count && i < split.count; i++) {
+        BOOL found = NO;
+        for (NSUInteger j = 0; j < split.count; j++)
+            found = found || (split.intersections[j].pairIndex == whole.intersections[i].pairIndex && FBAreValuesCloseWithOptions(split.intersections[j].parameter1, whole.intersections[i].parameter1, FBTestThreshold(1e-5)) && FBAreValuesCloseWithOptions(split.intersections[j].parameter2, whole.intersections[i].parameter2, FBTestThreshold(1e-5)));
+        FBCheck(found);
+    }
+    FBCheck(whole.overlaps[5].hasOverlap && split.overlaps[5].hasOverlap);
+    
+    FBArenaRelease(arena);
+}
+
+static void FBTestCountIteration(NSUInteger iteration, NSUInteger threadIndex, void *context)
+{
+    NSUInteger *counts = context;
+    __atomic_fetch_add(&counts[iteration], 1, __ATOMIC_RELAXED);
+}
+
+static void FBTestNestedIteration(NSUInteger iteration, NSUInteger threadIndex, void *context)
+{
+    NSUInteger counts[10] = {};
+    FBThreadPoolApply(context, 10, FBTestCountIteration, counts);
+    for (NSUInteger i = 0; i < 10; i++)
+        FBCheck(counts[i] == 1);
+}
+
+typedef struct FBTestThreadContext {
+    FBThreadPoolRef pool;
+    pthread_t threads[10];
+} FBTestThreadContext;
+
+static void FBTestRecordThread(NSUInteger iteration, NSUInteger threadIndex, void *context)
+{
+    FBTestThreadContext *threadContext = context;
+    threadContext->threads[iteration] = pthread_self();
+}
+
+static void FBTestNestedThread(NSUInteger iteration, NSUInteger threadIndex, void *context)
+{
+    FBTestThreadContext *threadContext = context;
+    FBThreadPoolApply(threadContext->pool, 10, FBTestRecordThread, threadContext);
+    for (NSUInteger i = 0; i < 10; i++)
+        FBCheck(pthread_equal(threadContext->threads[i], pthread_self()));
+}
+
+static void FBTestThreadPool(void)
+{
+    FBThreadPoolRef pool = FBThreadPoolCreate(3);
+    FBCheck(FBThreadPoolGetConcurrency(pool) == 4);
+    
+    // Every iteration runs exactly once, also when the pool is reused
+    NSUInteger counts[1000] = {};
+    for (NSUInteger run = 0; run < 3; run++)
+        FBThreadPoolApply(pool, 1000, FBTestCountIteration, counts);
+    for (NSUInteger i = 0; i < 1000; i++)
+        FBCheck(counts[i] == 3);
+    
+    
+    // A loop started from inside an iteration runs right there, on the same thread
+    FBThreadPoolApply(pool, 4, FBTestNestedIteration, pool);
+    
+    // Also when the outer loop ran on the calling thread, because its pool has no
+    //  threads or it has just one iteration, and the inner loop is on another pool
+    FBThreadPoolRef serialPool = FBThreadPoolCreate(0);
+    FBTestThreadContext threadContext = { pool };
+    FBThreadPoolApply(serialPool, 2, FBTestNestedThread, &threadContext);
+    FBThreadPoolApply(pool, 1, FBTestNestedThread, &threadContext);
+    FBThreadPoolRelease(serialPool);
+    
+    FBThreadPoolRelease(pool);
+}
+
+static void FBTestConcurrentEdgeIntersections(void)
+{
+    // Two sets of wavy curves, criss-crossing each other in a grid. Every curve in one
+    //  set is paired with every curve in the other.
+    FBArenaRef arena = FBArenaCreate(0);
+    NSUInteger counts[] = { 40 };
+    FBEdgeTable *horizontals = FBEdgeTableCreate(arena, counts, 1);
+    FBEdgeTable *verticals = FBEdgeTableCreate(arena, counts, 1);
+    for (NSUInteger i = 0; i < 40; i++) {
+        CGFloat offset = i * 10.0;
+        *FBEdgeTableGetCurve(horizontals, 0, i) = FBBezierCurveDataMake(CGPointMake(0, offset), CGPointMake(130, offset + 30), CGPointMake(260, offset - 30), CGPointMake(400, offset), NO);
+        *FBEdgeTableGetCurve(verticals, 0, i) = FBBezierCurveDataMake(CGPointMake(offset + 5, 0), CGPointMake(offset - 25, 130), CGPointMake(offset + 35, 260), CGPointMake(offset + 5, 400), NO);
+    }
+    FBEdgeIndexPair *pairs = FBArenaAllocate(arena, 40 * 40 * sizeof(FBEdgeIndexPair));
+    for (NSUInteger i = 0; i < 40 * 40; i++) {
+        FBEdgeIndexPair pair = { 0, i / 40, 0, i % 40 };
+        pairs[i] = pair;
+    }
+    
+    FBEdgeIntersections serial = {};
+    FBEdgeIntersectionsFind(arena, horizontals, verticals, pairs, 40 * 40, YES, &serial);
+    FBCheck(serial.count >= 40 * 40 / 2);
+    
+    FBThreadPoolRef pool = FBThreadPoolCreate(7);
+    FBEdgeIntersections concurrent = {};
+    FBEdgeIntersectionsFindConcurrently(arena, horizontals, verticals, pairs, 40 * 40, YES, pool, &concurrent);
+    FBCheck(concurrent.count == serial.count);
+    FBCheck(memcmp(concurrent.intersections, serial.intersections, serial.count * sizeof(FBEdgeIntersection)) == 0);
+    FBCheck(memcmp(concurrent.overlaps, serial.overlaps, 40 * 40 * sizeof(FBBezierCurveDataOverlap)) == 0);
+    FBThreadPoolRelease(pool);
+    
+    FBArenaRelease(arena);
+}
+
+static void FBTestProfile(void)
+{
+    // Nothing is recorded without a current profile
+    FBCheck(FBProfileGetCurrent() == NULL);
+    FBProfileMark mark = FBProfileBeginPhase(FBProfilePhaseCleanup);
+    FBProfileEndPhase(FBProfilePhaseCleanup, mark);
+    
+    FBProfile profile;
+    FBProfileReset(&profile);
+    FBProfileSetCurrent(&profile);
+    mark = FBProfileBeginPhase(FBProfilePhaseExtraction);
+    void *memory = malloc(1 << 20);
+    memset(memory, 1, 1 << 20);
+    FBProfileEndPhase(FBProfilePhaseExtraction, mark);
+    mark = FBProfileBeginPhase(FBProfilePhaseExtraction);
+    free(memory);
+    FBProfileEndPhase(FBProfilePhaseExtraction, mark);
+    FBProfileSetCurrent(NULL);
+    
+    FBCheck(profile.phases[FBProfilePhaseExtraction].calls == 2);
+    FBCheck(profile.phases[FBProfilePhaseExtraction].duration >= 0);
+    FBCheck(profile.phases[FBProfilePhaseExtraction].peakMemory > 0);
+    FBCheck(profile.phases[FBProfilePhaseCleanup].calls == 0);
+    FBCheck(strcmp(FBProfilePhaseGetName(FBProfilePhaseGraphConstruction), "graphConstruction") == 0);
+}
+
+static void FBTestSolvedIntersections(void)
+{
+    // A quadratic keeps its kind and its shape when it's raised to a cubic, split and reversed
+    FBBezierCurveData quadratic = FBBezierCurveDataMakeWithQuadratic(CGPointMake(0, 0), CGPointMake(50, 100), CGPointMake(100, 0));
+    FBCheck(quadratic.kind == FBBezierCurveKindQuadratic);
+    CGPoint middle = FBBezierCurveDataPointAtParameter(quadratic, 0.5, NULL, NULL);
+    FBCheck(FBArePointsCloseWithOptions(middle, CGPointMake(50, 50), FBTestThreshold(1e-12)));
+    FBCheck(FBBezierCurveDataSubcurveWithRange(quadratic, FBRangeMake(0.2, 0.7)).kind == FBBezierCurveKindQuadratic);
+    FBCheck(FBBezierCurveDataReversed(quadratic).kind == FBBezierCurveKindQuadratic);
+    
+    // The solved intersections have to find what bezier clipping finds on the same curves
+    //  marked as cubics, which always go through the clipping
+    FBBezierCurveData curves[][2] = {
+        { quadratic, FBBezierCurveDataMakeWithQuadratic(CGPointMake(0, 60), CGPointMake(50, -40), CGPointMake(100, 60)) },
+        { quadratic, FBBezierCurveDataMakeWithQuadratic(CGPointMake(10, 90), CGPointMake(60, -50), CGPointMake(90, 70)) },
+        { FBBezierCurveDataMakeWithLine(CGPointMake(-10, 20), CGPointMake(110, 40)), quadratic },
+        { FBBezierCurveDataMake(CGPointMake(0, 10), CGPointMake(30, 90), CGPointMake(60, -40), CGPointMake(100, 70), NO), FBBezierCurveDataMakeWithLine(CGPointMake(0, 0), CGPointMake(100, 60)) },
+    };
+    for (NSUInteger i = 0; i < sizeof(curves) / sizeof(curves[0]); i++) {
+        FBBezierCurveData cubics[2] = {};
+        for (NSUInteger j = 0; j < 2; j++)
+            cubics[j] = FBBezierCurveDataMake(curves[i][j].endPoint1, curves[i][j].controlPoint1, curves[i][j].controlPoint2, curves[i][j].endPoint2, NO);
+        FBStatistics before = {};
+        FBStatistics after = {};
+        FBStatisticsGetThreadSnapshot(&before);
+        FBTestIntersections solved = {};
+        FBBezierCurveDataIntersectionsWithBezierCurve(&curves[i][0], &curves[i][1], NULL, FBTestCollectIntersection, &solved);
+        FBStatisticsGetThreadSnapshot(&after);
+#if FB_STATISTICS
+        FBCheck(after.counts[FBStatisticSolvedPairs] == before.counts[FBStatisticSolvedPairs] + 1);
+        FBCheck(after.counts[FBStatisticClipIterations] == before.counts[FBStatisticClipIterations]);
+#endif
+        FBTestIntersections clipped = {};
+        FBBezierCurveDataIntersectionsWithBezierCurve(&cubics[0], &cubics[1], NULL, FBTestCollectIntersection, &clipped);
+        FBCheck(solved.count > 0);
+        FBCheck(solved.count == clipped.count);
+        for (NSUInteger k = 0; k < solved.count && k < 8; k++) {
+            BOOL found = NO;
+            for (NSUInteger l = 0; l < clipped.count && l < 8; l++)
+                found = found || (FBAreValuesCloseWithOptions(solved.parameters1[k], clipped.parameters1[l], FBTestThreshold(1e-5)) && FBAreValuesCloseWithOptions(solved.parameters2[k], clipped.parameters2[l], FBTestThreshold(1e-5)));
+            FBCheck(found);
+        }
+    }
+    
+    // Two pieces of the same quadratic overlap, which is left to the clipping
+    FBBezierCurveData piece1 = FBBezierCurveDataSubcurveWithRange(quadratic, FBRangeMake(0.0, 0.6));
+    FBBezierCurveData piece2 = FBBezierCurveDataSubcurveWithRange(quadratic, FBRangeMake(0.4, 1.0));
+    FBTestIntersections intersections = {};
+    FBBezierCurveDataOverlap overlap = {};
+    FBBezierCurveDataIntersectionsWithBezierCurve(&piece1, &piece2, &overlap, FBTestCollectIntersection, &intersections);
+    FBCheck(overlap.hasOverlap);
+}
+
+static void FBTestFlattening(void)
+{
+    FBBezierCurveData line = FBBezierCurveDataMakeWithLine(CGPointMake(0, 0), CGPointMake(100, 50));
+    FBCheck(FBBezierCurveDataGetFlatteningSegmentCount(&line, 0.01) == 1);
+    
+    // Every point of the curve is within tolerance of the line cut through it at the same
+    //  parameter, and a smaller tolerance takes more lines
+    FBBezierCurveData curve = FBBezierCurveDataMake(CGPointMake(0, 0), CGPointMake(20, 150), CGPointMake(90, -80), CGPointMake(100, 40), NO);
+    CGFloat tolerances[] = { 5.0, 0.5, 0.01 };
+    NSUInteger lastSegmentCount = 0;
+    for (NSUInteger i = 0; i < sizeof(tolerances) / sizeof(tolerances[0]); i++) {
+        NSUInteger segmentCount = FBBezierCurveDataGetFlatteningSegmentCount(&curve, tolerances[i]);
+        FBCheck(segmentCount > lastSegmentCount);
+        lastSegmentCount = segmentCount;
+        CGFloat maximumDistance = 0.0;
+        for (NSUInteger j = 0; j < segmentCount; j++) {
+            CGPoint start = FBBezierCurveDataPointAtParameter(curve, (CGFloat)j / segmentCount, NULL, NULL);
+            CGPoint end = FBBezierCurveDataPointAtParameter(curve, (CGFloat)(j + 1) / segmentCount, NULL, NULL);
+            for (NSUInteger k = 1; k < 16; k++) {
+                CGFloat fraction = k / 16.0;
+                CGPoint point = FBBezierCurveDataPointAtParameter(curve, (j + fraction) / segmentCount, NULL, NULL);
+                CGPoint linePoint = FBAddPoint(start, FBScalePoint(FBSubtractPoint(end, start), fraction));
+                maximumDistance = MAX(maximumDistance, FBDistanceBetweenPoints(point, linePoint));
+            }
+        }
+        FBCheck(maximumDistance <= tolerances[i]);
+        // Not so many more lines than it takes, either
+        FBCheck(maximumDistance > tolerances[i] / 4.0 || segmentCount == 1);
+    }
+}
+
+static void FBTestIntersectArchWithLine(NSUInteger iteration, NSUInteger threadIndex, void *context)
+{
+    FBBezierCurveData arch = FBBezierCurveDataMake(CGPointMake(0, 0), CGPointMake(0, 100), CGPointMake(100, 100), CGPointMake(100, 0), NO);
+    FBBezierCurveData line = FBBezierCurveDataMakeWithLine(CGPointMake(-10, 50), CGPointMake(110, 50));
+    FBTestIntersections intersections = {};
+    FBBezierCurveDataIntersectionsWithBezierCurve(&arch, &line, NULL, FBTestCollectIntersection, &intersections);
+}
+
+static void FBTestStatistics(void)
+{
+    FBStatistics before = {};
+    FBStatistics after = {};
+    FBStatistics difference = {};
+    FBBezierCurveData arch = FBBezierCurveDataMake(CGPointMake(0, 0), CGPointMake(0, 100), CGPointMake(100, 100), CGPointMake(100, 0), NO);
+    FBBezierCurveData farLine = FBBezierCurveDataMakeWithLine(CGPointMake(500, 500), CGPointMake(600, 500));
+    FBBezierCurveData line1 = FBBezierCurveDataMakeWithLine(CGPointMake(0, 0), CGPointMake(100, 0));
+    FBBezierCurveData line2 = FBBezierCurveDataMakeWithLine(CGPointMake(50, 0), CGPointMake(150, 0));
+    
+    FBStatisticsGetThreadSnapshot(&before);
+    FBTestIntersectArchWithLine(0, 0, NULL);
+    FBTestIntersections intersections = {};
+    FBBezierCurveDataIntersectionsWithBezierCurve(&arch, &farLine, NULL, FBTestCollectIntersection, &intersections);
+    FBBezierCurveDataOverlap overlap = {};
+    FBBezierCurveDataIntersectionsWithBezierCurve(&line1, &line2, &overlap, FBTestCollectIntersection, &intersections);
+    FBStatisticsGetThreadSnapshot(&after);
+    FBStatisticsSubtract(&after, &before, &difference);
+#if FB_STATISTICS
+    FBCheck(difference.counts[FBStatisticEdgePairTests] == 3);
+    FBCheck(difference.counts[FBStatisticBoundsRejections] == 1);
+    FBCheck(difference.counts[FBStatisticSolvedPairs] == 1);
+    FBCheck(difference.counts[FBStatisticClipIterations] == 0);
+    FBCheck(difference.counts[FBStatisticOverlapRanges] > 0);
+    FBCheck(difference.counts[FBStatisticRaysCast] == 0);
+#else
+    FBCheck(difference.counts[FBStatisticEdgePairTests] == 0);
+#endif
+    
+    // Counts from other threads show up in the snapshot of all threads, also after the threads exit
+    FBStatisticsGetSnapshot(&before);
+    FBThreadPoolRef pool = FBThreadPoolCreate(3);
+    FBThreadPoolApply(pool, 100, FBTestIntersectArchWithLine, NULL);
+    FBThreadPoolRelease(pool);
+    FBStatisticsGetSnapshot(&after);
+    FBStatisticsSubtract(&after, &before, &difference);
+#if FB_STATISTICS
+    FBCheck(difference.counts[FBStatisticEdgePairTests] == 100);
+#endif
+    FBCheck(strcmp(FBStatisticGetName(FBStatisticRaysCast), "raysCast") == 0);
+}
+
+int main(int argc, char *argv[])
+{
+    FBTestLineIntersection();
+    FBTestCurveIntersection();
+    FBTestOverlap();
+    FBTestMeasurements();
+    FBTestLengthTable();
+    FBTestAxisAlignedLineIntersections();
+    FBTestSolvedIntersections();
+    FBTestFlattening();
+    FBTestVectorKernels();
+    FBTestEdgeIndex();
+    FBTestNearestEntries();
+    FBTestScanlineIndex();
+    FBTestPolygonClipper();
+    FBTestTiles();
+    FBTestArena();
+    FBTestEdgeIntersections();
+    FBTestMonotonePieces();
+    FBTestThreadPool();
+    FBTestConcurrentEdgeIntersections();
+    FBTestProfile();
+    FBTestStatistics();
+
+    if ( FBFailureCount > 0 ) {
+        fprintf(stderr, "%d check(s) failed\n", FBFailureCount);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+//
+//  FBKernelBenchmark.c
+//  VectorBooleanTests
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "FBGeometry.h"
+#include "FBBezierCurveHelper.h"
+#include "FBVectorKernels.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Kernel microbenchmark
+//
+// Times the vector kernels against the scalar code they replaced, on the
+//  same random curves. Not a test: run it by hand, with the build type you
+//  care about, and compare the two columns.
+//
+
+static const NSUInteger FBBenchmarkCurveCount = 4096;
+static const NSUInteger FBBenchmarkRounds = 500;
+
+// Keeps the compiler from throwing away results nobody reads
+static volatile CGFloat FBBenchmarkSink = 0.0;
+
+static double FBBenchmarkGetTime(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static void FBBenchmarkReport(const char *name, double scalarTime, double vectorTime)
+{
+    NSUInteger calls = FBBenchmarkCurveCount * FBBenchmarkRounds;
+    printf("%-20s %10.2f ns %10.2f ns %8.2fx\n", name, scalarTime / calls * 1e9, vectorTime / calls * 1e9, scalarTime / vectorTime);
+}
+
+static CGRect FBBenchmarkScalarCurveBounds(CGPoint points[4])
+{
+    CGPoint topLeft = BezierWithPoints(3, points, 0, NULL, NULL);
+    CGPoint bottomRight = topLeft;
+    FBExpandBoundsByPoint(&topLeft, &bottomRight, BezierWithPoints(3, points, 1, NULL, NULL));
+    CGFloat roots[4] = {};
+    NSUInteger xRootsCount = 0;
+    NSUInteger yRootsCount = 0;
+    FBComputeCubicFirstDerivativeRoots(points[0].x, points[1].x, points[2].x, points[3].x, &roots[0], &xRootsCount);
+    FBComputeCubicFirstDerivativeRoots(points[0].y, points[1].y, points[2].y, points[3].y, &roots[xRootsCount], &yRootsCount);
+    for (NSUInteger i = 0; i < xRootsCount + yRootsCount; i++) {
+        if ( roots[i] >= 0 && roots[i] <= 1 )
+            FBExpandBoundsByPoint(&topLeft, &bottomRight, BezierWithPoints(3, points, roots[i], NULL, NULL));
+    }
+    return CGRectMake(topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y);
+}
+
+int main(int argc, char *argv[])
+{
+    CGPoint (*curves)[4] = malloc(FBBenchmarkCurveCount * sizeof(*curves));
+    srand(1);
+    for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++) {
+        for (NSUInteger j = 0; j < 4; j++)
+            curves[i][j] = CGPointMake(rand() % 1000, rand() % 1000);
+    }
+
+    printf("Vector kernels built for %s\n", FBVectorKernelsGetInstructionSet());
+    printf("%-20s %13s %13s %9s\n", "kernel", "scalar", "vector", "speedup");
+
+    CGPoint left[4], right[4];
+    double start = FBBenchmarkGetTime();
+    for (NSUInteger round = 0; round < FBBenchmarkRounds; round++) {
+        for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++)
+            FBBenchmarkSink += BezierWithPoints(3, curves[i], 0.37, left, right).x + left[2].y + right[1].x;
+    }
+    double scalarTime = FBBenchmarkGetTime() - start;
+    start = FBBenchmarkGetTime();
+    for (NSUInteger round = 0; round < FBBenchmarkRounds; round++) {
+        for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++)
+            FBBenchmarkSink += FBVectorSplitCubic(curves[i], 0.37, left, right).x + left[2].y + right[1].x;
+    }
+    FBBenchmarkReport("split cubic", scalarTime, FBBenchmarkGetTime() - start);
+
+    FBNormalizedLine line = FBNormalizedLineMake(CGPointMake(0, 0), CGPointMake(1000, 700));
+    start = FBBenchmarkGetTime();
+    for (NSUInteger round = 0; round < FBBenchmarkRounds; round++) {
+        for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++) {
+            for (NSUInteger j = 0; j < 4; j++)
+                FBBenchmarkSink += FBNormalizedLineDistanceFromPoint(line, curves[i][j]);
+        }
+    }
+    scalarTime = FBBenchmarkGetTime() - start;
+    start = FBBenchmarkGetTime();
+    for (NSUInteger round = 0; round < FBBenchmarkRounds; round++) {
+        for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++) {
+            CGFloat distances[4];
+            FBVectorDistancesFromLine(line, curves[i], distances);
+            FBBenchmarkSink += distances[0] + distances[1] + distances[2] + distances[3];
+        }
+    }
+    FBBenchmarkReport("fat line distances", scalarTime, FBBenchmarkGetTime() - start);
+
+    start = FBBenchmarkGetTime();
+    for (NSUInteger round = 0; round < FBBenchmarkRounds; round++) {
+        for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++)
+            FBBenchmarkSink += FBBenchmarkScalarCurveBounds(curves[i]).size.width;
+    }
+    scalarTime = FBBenchmarkGetTime() - start;
+    start = FBBenchmarkGetTime();
+    for (NSUInteger round = 0; round < FBBenchmarkRounds; round++) {
+        for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++)
+            FBBenchmarkSink += FBVectorCurveBounds(curves[i]).size.width;
+    }
+    FBBenchmarkReport("curve bounds", scalarTime, FBBenchmarkGetTime() - start);
+
+    free(curves);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+//
+//  FBLengthBenchmark.c
+//  VectorBooleanTests
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "FBGeometry.h"
+#include "FBBezierCurveLength.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Length microbenchmark
+//
+// Times the length queries the overlap code makes, the length up to a
+//  parameter and the parameter at a length, with the fixed 12 point rule
+//  against the length tables, on the same random curves. Not a test: run it
+//  by hand, with the build type you care about, and compare the two columns.
+//
+
+static const NSUInteger FBBenchmarkCurveCount = 4096;
+static const NSUInteger FBBenchmarkRounds = 100;
+static const NSUInteger FBBenchmarkFixedSteps = 12;
+
+// Keeps the compiler from throwing away results nobody reads
+static volatile CGFloat FBBenchmarkSink = 0.0;
+
+static double FBBenchmarkGetTime(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static void FBBenchmarkReport(const char *name, double fixedTime, double tableTime, NSUInteger calls)
+{
+    printf("%-20s %10.2f ns %10.2f ns %8.2fx\n", name, fixedTime / calls * 1e9, tableTime / calls * 1e9, fixedTime / tableTime);
+}
+
+// What finding the parameter at a length takes without a table: bisecting on the
+//  fixed rule, which starts again from the start of the curve every time.
+static CGFloat FBBenchmarkFixedParameterAtLength(const CGPoint *points, CGFloat length)
+{
+    CGFloat below = 0.0;
+    CGFloat above = 1.0;
+    for (NSUInteger i = 0; i < 40; i++) {
+        CGFloat parameter = (below + above) / 2.0;
+        if ( FBGaussQuadratureComputeCurveLengthForCubic(parameter, FBBenchmarkFixedSteps, points[0], points[1], points[2], points[3]) < length )
+            below = parameter;
+        else
+            above = parameter;
+    }
+    return (below + above) / 2.0;
+}
+
+int main(int argc, char *argv[])
+{
+    CGPoint (*curves)[4] = malloc(FBBenchmarkCurveCount * sizeof(*curves));
+    FBBezierCurveLengthTableRef *tables = malloc(FBBenchmarkCurveCount * sizeof(FBBezierCurveLengthTableRef));
+    srand(1);
+    for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++) {
+        for (NSUInteger j = 0; j < 4; j++)
+            curves[i][j] = CGPointMake(rand() % 1000, rand() % 1000);
+    }
+
+    printf("%-20s %13s %13s %9s\n", "query", "fixed rule", "table", "speedup");
+
+    // Building a table against measuring the whole curve once
+    double start = FBBenchmarkGetTime();
+    for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++)
+        FBBenchmarkSink += FBGaussQuadratureComputeCurveLengthForCubic(1.0, FBBenchmarkFixedSteps, curves[i][0], curves[i][1], curves[i][2], curves[i][3]);
+    double fixedTime = FBBenchmarkGetTime() - start;
+    start = FBBenchmarkGetTime();
+    NSUInteger segmentCount = 0;
+    for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++) {
+        tables[i] = FBBezierCurveLengthTableCreate(curves[i][0], curves[i][1], curves[i][2], curves[i][3]);
+        segmentCount += FBBezierCurveLengthTableGetSegmentCount(tables[i]);
+    }
+    FBBenchmarkReport("build vs length", fixedTime, FBBenchmarkGetTime() - start, FBBenchmarkCurveCount);
+
+    NSUInteger calls = FBBenchmarkCurveCount * FBBenchmarkRounds;
+    start = FBBenchmarkGetTime();
+    for (NSUInteger round = 0; round < FBBenchmarkRounds; round++) {
+        CGFloat parameter = (round + 0.5) / FBBenchmarkRounds;
+        for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++)
+            FBBenchmarkSink += FBGaussQuadratureComputeCurveLengthForCubic(parameter, FBBenchmarkFixedSteps, curves[i][0], curves[i][1], curves[i][2], curves[i][3]);
+    }
+    fixedTime = FBBenchmarkGetTime() - start;
+    start = FBBenchmarkGetTime();
+    for (NSUInteger round = 0; round < FBBenchmarkRounds; round++) {
+        CGFloat parameter = (round + 0.5) / FBBenchmarkRounds;
+        for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++)
+            FBBenchmarkSink += FBBezierCurveLengthTableGetLengthAtParameter(tables[i], parameter);
+    }
+    FBBenchmarkReport("length at parameter", fixedTime, FBBenchmarkGetTime() - start, calls);
+
+    // Offsets from either end, like the tangents and test points of the overlap code
+    start = FBBenchmarkGetTime();
+    for (NSUInteger round = 0; round < FBBenchmarkRounds; round++) {
+        for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++) {
+            CGFloat length = FBBezierCurveLengthTableGetLength(tables[i]);
+            FBBenchmarkSink += FBBenchmarkFixedParameterAtLength(curves[i], length * (round + 0.5) / FBBenchmarkRounds);
+        }
+    }
+    fixedTime = FBBenchmarkGetTime() - start;
+    start = FBBenchmarkGetTime();
+    for (NSUInteger round = 0; round < FBBenchmarkRounds; round++) {
+        for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++) {
+            CGFloat length = FBBezierCurveLengthTableGetLength(tables[i]);
+            FBBenchmarkSink += FBBezierCurveLengthTableGetParameterAtLength(tables[i], length * (round + 0.5) / FBBenchmarkRounds);
+        }
+    }
+    FBBenchmarkReport("parameter at length", fixedTime, FBBenchmarkGetTime() - start, calls);
+
+    printf("%.1f segments per table on average\n", (double)segmentCount / FBBenchmarkCurveCount);
+
+    for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++)
+        FBBezierCurveLengthTableRelease(tables[i]);
+    free(tables);
+    free(curves);
+    return EXIT_SUCCESS;
+}
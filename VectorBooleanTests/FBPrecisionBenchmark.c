@@ -0,0 +1,121 @@
+//
+//  FBPrecisionBenchmark.c
+//  VectorBooleanTests
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "FBGeometry.h"
+#include "FBBezierCurveData.h"
+#include "FBPolygonClipper.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Precision benchmark
+//
+// Times curve intersections and a polygon operation, and measures how far
+//  apart the two curves' points of each intersection are, in whatever
+//  FB_PRECISION the core was built with. The CMake build makes one of these
+//  per precision; run them one after the other and compare the rows. Not a
+//  test: run it by hand, with the build type you care about.
+//
+
+static const NSUInteger FBBenchmarkCurveCount = 2048;
+static const NSUInteger FBBenchmarkRounds = 10;
+static const NSUInteger FBBenchmarkPolygonSize = 20000;
+
+static double FBBenchmarkGetTime(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static const char *FBBenchmarkGetPrecisionName(void)
+{
+#if FB_PRECISION == FB_PRECISION_SINGLE
+    return "single";
+#elif FB_PRECISION == FB_PRECISION_EXTENDED
+    return "extended";
+#else
+    return "double";
+#endif
+}
+
+typedef struct FBBenchmarkIntersections {
+    FBBezierCurveData *curve1;
+    FBBezierCurveData *curve2;
+    NSUInteger count;
+    double maximumDistance;
+} FBBenchmarkIntersections;
+
+static void FBBenchmarkCollectIntersection(CGFloat parameter1, CGFloat parameter2, void *context, BOOL *stop)
+{
+    FBBenchmarkIntersections *intersections = context;
+    CGPoint point1 = FBBezierCurveDataPointAtParameter(*intersections->curve1, parameter1, NULL, NULL);
+    CGPoint point2 = FBBezierCurveDataPointAtParameter(*intersections->curve2, parameter2, NULL, NULL);
+    double distance = FBDistanceBetweenPoints(point1, point2);
+    if ( distance > intersections->maximumDistance )
+        intersections->maximumDistance = distance;
+    intersections->count++;
+}
+
+// Two jagged rings crossing all the way round, like the boolean benchmark's polygons
+static FBPolygonRef FBBenchmarkCreateRing(NSUInteger size, CGFloat offset, NSUInteger seed)
+{
+    CGPoint *points = malloc(size * sizeof(CGPoint));
+    for (NSUInteger i = 0; i < size; i++) {
+        CGFloat angle = 2.0 * M_PI * i / size;
+        CGFloat distance = 1000 + ((i * 7919 + seed) % 41) - 20.0;
+        points[i] = CGPointMake(offset + distance * cos(angle), distance * sin(angle));
+    }
+    FBPolygonRef polygon = FBPolygonCreate(points, &size, 1);
+    free(points);
+    return polygon;
+}
+
+int main(int argc, char *argv[])
+{
+    FBBezierCurveData *curves = malloc(FBBenchmarkCurveCount * sizeof(FBBezierCurveData));
+    srand(1);
+    for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++) {
+        CGPoint points[4] = {};
+        for (NSUInteger j = 0; j < 4; j++)
+            points[j] = CGPointMake(rand() % 1000, rand() % 1000);
+        curves[i] = FBBezierCurveDataMake(points[0], points[1], points[2], points[3], NO);
+    }
+
+    // Each curve against the next one, which crosses it a few times on average
+    FBBenchmarkIntersections intersections = {};
+    double start = FBBenchmarkGetTime();
+    for (NSUInteger round = 0; round < FBBenchmarkRounds; round++) {
+        intersections.count = 0;
+        for (NSUInteger i = 0; i < FBBenchmarkCurveCount; i++) {
+            intersections.curve1 = &curves[i];
+            intersections.curve2 = &curves[(i + 1) % FBBenchmarkCurveCount];
+            FBBezierCurveDataIntersectionsWithBezierCurve(intersections.curve1, intersections.curve2, NULL, FBBenchmarkCollectIntersection, &intersections);
+        }
+    }
+    double intersectionTime = (FBBenchmarkGetTime() - start) / (FBBenchmarkRounds * FBBenchmarkCurveCount);
+
+    FBPolygonRef polygon1 = FBBenchmarkCreateRing(FBBenchmarkPolygonSize, 0, 0);
+    FBPolygonRef polygon2 = FBBenchmarkCreateRing(FBBenchmarkPolygonSize, 300, 104729);
+    start = FBBenchmarkGetTime();
+    FBPolygonRef result = FBPolygonCreateWithOperation(polygon1, polygon2, FBBooleanOperationUnion);
+    double polygonTime = FBBenchmarkGetTime() - start;
+    NSUInteger resultContourCount = FBPolygonGetContourCount(result);
+
+    printf("%-10s %12s %14s %16s %14s %10s\n", "precision", "scalar size", "intersection", "intersections", "max distance", "polygons");
+    printf("%-10s %10lu B %11.2f us %16lu %14.3g %8.2f ms\n", FBBenchmarkGetPrecisionName(), (unsigned long)sizeof(CGFloat), intersectionTime * 1e6,
+           (unsigned long)intersections.count, intersections.maximumDistance, polygonTime * 1e3);
+    printf("%lu contours in the union of the polygons\n", (unsigned long)resultContourCount);
+
+    FBPolygonRelease(result);
+    FBPolygonRelease(polygon1);
+    FBPolygonRelease(polygon2);
+    free(curves);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,83 @@
+//
+//  FBTileBenchmark.c
+//  VectorBooleanTests
+//
+//  Created by Stephan Michels on 18.10.26.
+//  Copyright (c) 2026 Fortunate Bear, LLC. All rights reserved.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "FBPolygonClipper.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Tile benchmark
+//
+// Unites two big jagged rings, first in tiles and then in one go, and prints
+//  how long each took and how much memory the process had at its peak after
+//  each. The tiled run goes first, so its peak isn't hidden by the other's.
+//  Pass the number of points of each ring and the tile size to try others.
+//  Not a test: run it by hand, with the build type you care about.
+//
+
+static double FBBenchmarkGetTime(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static double FBBenchmarkGetPeakMemory(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+    return usage.ru_maxrss / 1024.0; // kilobytes
+#endif
+}
+
+static FBPolygonRef FBBenchmarkCreateRing(NSUInteger size, CGFloat offset, NSUInteger seed)
+{
+    CGPoint *points = malloc(size * sizeof(CGPoint));
+    for (NSUInteger i = 0; i < size; i++) {
+        CGFloat angle = 2.0 * M_PI * i / size;
+        CGFloat distance = 1000 + ((i * 7919 + seed) % 41) - 20.0;
+        points[i] = CGPointMake(offset + distance * cos(angle), distance * sin(angle));
+    }
+    FBPolygonRef polygon = FBPolygonCreate(points, &size, 1);
+    free(points);
+    return polygon;
+}
+
+int main(int argc, char *argv[])
+{
+    NSUInteger size = argc > 1 ? strtoul(argv[1], NULL, 10) : 100000;
+    CGFloat tileSize = argc > 2 ? atof(argv[2]) : 200;
+    FBPolygonRef polygon1 = FBBenchmarkCreateRing(size, 0, 0);
+    FBPolygonRef polygon2 = FBBenchmarkCreateRing(size, 300, 104729);
+
+    double start = FBBenchmarkGetTime();
+    FBPolygonRef tiledResult = FBPolygonCreateWithOperationInTiles(polygon1, polygon2, FBBooleanOperationUnion, tileSize, FBThreadPoolGetShared());
+    double tiledTime = FBBenchmarkGetTime() - start;
+    double tiledMemory = FBBenchmarkGetPeakMemory();
+
+    start = FBBenchmarkGetTime();
+    FBPolygonRef result = FBPolygonCreateWithOperation(polygon1, polygon2, FBBooleanOperationUnion);
+    double time = FBBenchmarkGetTime() - start;
+    double memory = FBBenchmarkGetPeakMemory();
+
+    printf("%-10s %12s %10s %14s\n", "mode", "time", "contours", "peak memory");
+    printf("%-10s %9.2f ms %10lu %11.0f MB\n", "tiled", tiledTime * 1e3, (unsigned long)FBPolygonGetContourCount(tiledResult), tiledMemory);
+    printf("%-10s %9.2f ms %10lu %11.0f MB\n", "whole", time * 1e3, (unsigned long)FBPolygonGetContourCount(result), memory);
+    printf("%lu points per ring, tiles %g across, %lu threads\n", (unsigned long)size, (double)tileSize, (unsigned long)FBThreadPoolGetConcurrency(FBThreadPoolGetShared()));
+
+    FBPolygonRelease(result);
+    FBPolygonRelease(tiledResult);
+    FBPolygonRelease(polygon1);
+    FBPolygonRelease(polygon2);
+    return EXIT_SUCCESS;
+}
@@ -13,6 +13,18 @@
 
 @end
 
+static void FBTestAppendPathElement(const FBPathElement *element, void *context)
+{
+    CGMutablePathRef path = context;
+    switch (element->type) {
+        case FBPathElementMoveToPoint: CGPathMoveToPoint(path, NULL, element->points[0].x, element->points[0].y); break;
+        case FBPathElementAddLineToPoint: CGPathAddLineToPoint(path, NULL, element->points[0].x, element->points[0].y); break;
+        case FBPathElementAddQuadCurveToPoint: CGPathAddQuadCurveToPoint(path, NULL, element->points[0].x, element->points[0].y, element->points[1].x, element->points[1].y); break;
+        case FBPathElementAddCurveToPoint: CGPathAddCurveToPoint(path, NULL, element->points[0].x, element->points[0].y, element->points[1].x, element->points[1].y, element->points[2].x, element->points[2].y); break;
+        case FBPathElementCloseSubpath: CGPathCloseSubpath(path); break;
+    }
+}
+
 @implementation VectorBooleanTests
 
 - (void)setUp
@@ -593,6 +605,800 @@
     XCTAssertTrue([self equalsPath:xorPath toPath:expectedXORPath], @"XOR path not equal");
 }
 
+- (void)testUnionPerformanceWithManyEdges
+{
+    // Two grids of 50 x 50 circles, 10,000 edges each, offset so every circle overlaps its neighbors
+    //  in the other grid but none in its own.
+    CGPathRef path1 = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:50 columns:50 radius:6 spacing:15];
+    CGPathRef path2 = [self createPathWithCirclesInGridAtPoint:CGPointMake(7, 7) rows:50 columns:50 radius:6 spacing:15];
+    
+    [self measureBlock:^{
+        CGPathRef unionPath = CGPathUnion(path1, path2);
+        CGPathRelease(unionPath);
+    }];
+    
+    CGPathRelease(path1);
+    CGPathRelease(path2);
+}
+
+- (void)testUnionPerformanceWithManyResultContours
+{
+    // Each circle overlaps just one circle of the other grid, so every pair becomes its own
+    //  contour in the result, 2,500 of them.
+    CGPathRef path1 = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:50 columns:50 radius:5 spacing:15];
+    CGPathRef path2 = [self createPathWithCirclesInGridAtPoint:CGPointMake(4, 4) rows:50 columns:50 radius:5 spacing:15];
+    
+    [self measureBlock:^{
+        CGPathRef unionPath = CGPathUnion(path1, path2);
+        CGPathRelease(unionPath);
+    }];
+    
+    CGPathRelease(path1);
+    CGPathRelease(path2);
+}
+
+- (void)testXORPerformanceWithManyEdges
+{
+    // The same grids as testUnionPerformanceWithManyEdges. XOR is built from the same crossings
+    //  as the union, so it shouldn't take much longer.
+    CGPathRef path1 = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:50 columns:50 radius:6 spacing:15];
+    CGPathRef path2 = [self createPathWithCirclesInGridAtPoint:CGPointMake(7, 7) rows:50 columns:50 radius:6 spacing:15];
+    
+    [self measureBlock:^{
+        CGPathRef xorPath = CGPathXOR(path1, path2);
+        CGPathRelease(xorPath);
+    }];
+    
+    CGPathRelease(path1);
+    CGPathRelease(path2);
+}
+
+- (void)testXORWithSharedEdges
+{
+    // The squares share part of their top and bottom edges, so the union and the intersect
+    //  share edges too
+    CGPathRef path1 = CGPathCreateWithRect(CGRectMake(0, 0, 200, 100), NULL);
+    CGPathRef path2 = CGPathCreateWithRect(CGRectMake(100, 0, 200, 100), NULL);
+    
+    CGPathRef xorPath = CGPathXOR(path1, path2);
+    XCTAssertTrue(CGRectEqualToRect(CGPathGetBoundingBox(xorPath), CGRectMake(0, 0, 300, 100)));
+    XCTAssertTrue(CGPathContainsPoint(xorPath, NULL, CGPointMake(50, 50), YES));
+    XCTAssertFalse(CGPathContainsPoint(xorPath, NULL, CGPointMake(150, 50), YES));
+    XCTAssertTrue(CGPathContainsPoint(xorPath, NULL, CGPointMake(250, 50), YES));
+    
+    CGPathRelease(xorPath);
+    CGPathRelease(path1);
+    CGPathRelease(path2);
+}
+
+- (void)testDifferencePerformanceWithManyContainedContours
+{
+    // Every circle in the second grid sits inside one in the first, so nothing crosses and
+    //  every contour goes through the containment tests instead.
+    CGPathRef path1 = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:30 columns:30 radius:6 spacing:15];
+    CGPathRef path2 = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:30 columns:30 radius:3 spacing:15];
+    
+    [self measureBlock:^{
+        CGPathRef differencePath = CGPathDifference(path1, path2);
+        XCTAssertEqualWithAccuracy(CGPathGetBoundingBox(differencePath).size.width, CGPathGetBoundingBox(path1).size.width, 1e-3);
+        CGPathRelease(differencePath);
+    }];
+    
+    CGPathRelease(path1);
+    CGPathRelease(path2);
+}
+
+- (void)testCombineUnionMatchesChainedUnion
+{
+    CGPathRef paths[3];
+    paths[0] = CGPathCreateWithRect(CGRectMake(0, 0, 100, 100), NULL);
+    paths[1] = CGPathCreateWithRect(CGRectMake(50, 50, 100, 100), NULL);
+    paths[2] = CGPathCreateWithEllipseInRect(CGRectMake(120, 0, 60, 60), NULL);
+    
+    CGPathRef chained = CGPathUnion(paths[0], paths[1]);
+    CGPathRef chainedAll = CGPathUnion(chained, paths[2]);
+    CGPathRef combined = CGPathCombine(paths, 3, FBBooleanOperationUnion);
+    XCTAssertTrue(CGRectEqualToRect(CGPathGetBoundingBox(combined), CGPathGetBoundingBox(chainedAll)));
+    
+    CGPathRef intersection = CGPathCombine(paths, 3, FBBooleanOperationIntersect);
+    XCTAssertTrue(CGPathIsEmpty(intersection));
+    
+    CGPathRelease(chained);
+    CGPathRelease(chainedAll);
+    CGPathRelease(combined);
+    CGPathRelease(intersection);
+    for (NSUInteger i = 0; i < 3; i++)
+        CGPathRelease(paths[i]);
+}
+
+- (void)testChainedUnionPerformanceWithManyPaths
+{
+    // The baseline for testCombineUnionPerformanceWithManyPaths: 400 overlapping circles
+    //  unioned one at a time.
+    NSArray *circles = [self circlePathsInGridWithRows:20 columns:20 radius:10 spacing:15];
+    
+    [self measureBlock:^{
+        CGPathRef result = CGPathCreateMutable();
+        for (id circle in circles) {
+            CGPathRef unionPath = CGPathUnion(result, (__bridge CGPathRef)circle);
+            CGPathRelease(result);
+            result = unionPath;
+        }
+        CGPathRelease(result);
+    }];
+}
+
+- (void)testCombineUnionPerformanceWithManyPaths
+{
+    NSArray *circles = [self circlePathsInGridWithRows:20 columns:20 radius:10 spacing:15];
+    CGPathRef *paths = malloc(circles.count * sizeof(CGPathRef));
+    for (NSUInteger i = 0; i < circles.count; i++)
+        paths[i] = (__bridge CGPathRef)circles[i];
+    
+    [self measureBlock:^{
+        CGPathRef result = CGPathCombine(paths, circles.count, FBBooleanOperationUnion);
+        CGPathRelease(result);
+    }];
+    
+    free(paths);
+}
+
+- (void)testAllOperationsMatchSingleOperations
+{
+    CGMutablePathRef path1 = CGPathCreateMutable();
+    CGPathAddRect(path1, NULL, CGRectMake(50, 50, 350, 300));
+    CGPathAddEllipseInRect(path1, NULL, CGRectMake(85, 75, 250, 250));
+    CGPathRef path2 = CGPathCreateWithRect(CGRectMake(180, 5, 100, 400), NULL);
+    
+    CGPathRef results[4] = {};
+    CGPathPerformBooleanOperations(path1, path2, FBBooleanOperationsAll, results);
+    CGPathRef (*operations[])(CGPathRef, CGPathRef) = { CGPathUnion, CGPathIntersect, CGPathDifference, CGPathXOR };
+    for (FBBooleanOperation operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+        CGPathRef expected = operations[operation](path1, path2);
+        XCTAssertTrue(CGPathEqualToPath(results[operation], expected));
+        CGPathRelease(expected);
+        CGPathRelease(results[operation]);
+    }
+    
+    CGPathPerformBooleanOperations(path1, path2, FBBooleanOperationsIntersect, results);
+    XCTAssertTrue(results[FBBooleanOperationUnion] == NULL);
+    XCTAssertTrue(results[FBBooleanOperationIntersect] != NULL);
+    XCTAssertTrue(results[FBBooleanOperationDifference] == NULL);
+    XCTAssertTrue(results[FBBooleanOperationXOR] == NULL);
+    CGPathRelease(results[FBBooleanOperationIntersect]);
+    
+    CGPathRelease(path1);
+    CGPathRelease(path2);
+}
+
+- (void)testAllOperationsPerformanceWithManyEdges
+{
+    // The same grids as testUnionPerformanceWithManyEdges, but all four results at once
+    CGPathRef path1 = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:50 columns:50 radius:6 spacing:15];
+    CGPathRef path2 = [self createPathWithCirclesInGridAtPoint:CGPointMake(7, 7) rows:50 columns:50 radius:6 spacing:15];
+    
+    [self measureBlock:^{
+        CGPathRef results[4] = {};
+        CGPathPerformBooleanOperations(path1, path2, FBBooleanOperationsAll, results);
+        for (NSUInteger i = 0; i < 4; i++)
+            CGPathRelease(results[i]);
+    }];
+    
+    CGPathRelease(path1);
+    CGPathRelease(path2);
+}
+
+- (void)testBooleanJobsMatchSingleOperations
+{
+    NSArray *circles = [self circlePathsInGridWithRows:4 columns:4 radius:10 spacing:15];
+    FBBooleanJob jobs[15] = {};
+    for (NSUInteger i = 0; i < 15; i++) {
+        jobs[i].path1 = (__bridge CGPathRef)circles[i];
+        jobs[i].path2 = (__bridge CGPathRef)circles[i + 1];
+        jobs[i].operation = (FBBooleanOperation)(i % 4);
+    }
+    
+    CGPathPerformBooleanJobs(jobs, 15, 4);
+    
+    for (NSUInteger i = 0; i < 15; i++) {
+        FBBooleanJob job = jobs[i];
+        CGPathRef expected = NULL;
+        switch (job.operation) {
+            case FBBooleanOperationUnion: expected = CGPathUnion(job.path1, job.path2); break;
+            case FBBooleanOperationIntersect: expected = CGPathIntersect(job.path1, job.path2); break;
+            case FBBooleanOperationDifference: expected = CGPathDifference(job.path1, job.path2); break;
+            case FBBooleanOperationXOR: expected = CGPathXOR(job.path1, job.path2); break;
+        }
+        XCTAssertTrue(CGPathEqualToPath(job.result, expected));
+        XCTAssertGreaterThan(job.duration, 0.0);
+        CGPathRelease(expected);
+        CGPathRelease(job.result);
+    }
+}
+
+- (void)testBooleanJobsOnOneThreadCountEverything
+{
+    // With one thread, nothing a job does may move to other threads, so the job's own
+    //  statistics are all the work done. The grids are big enough that the crossing
+    //  search would otherwise spread out.
+    CGPathRef path1 = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:20 columns:20 radius:6 spacing:15];
+    CGPathRef path2 = [self createPathWithCirclesInGridAtPoint:CGPointMake(7, 7) rows:20 columns:20 radius:6 spacing:15];
+    for (size_t count = 1; count <= 2; count++) {
+        FBBooleanJob jobs[2] = {};
+        for (size_t i = 0; i < count; i++) {
+            jobs[i].path1 = path1;
+            jobs[i].path2 = path2;
+            jobs[i].operation = FBBooleanOperationUnion;
+        }
+        
+        FBStatistics before = {};
+        FBStatistics after = {};
+        FBStatistics difference = {};
+        FBStatisticsGetSnapshot(&before);
+        CGPathPerformBooleanJobs(jobs, count, 1);
+        FBStatisticsGetSnapshot(&after);
+        FBStatisticsSubtract(&after, &before, &difference);
+        
+        for (FBStatistic statistic = 0; statistic < FBStatisticCount; statistic++) {
+            NSUInteger jobCounts = 0;
+            for (size_t i = 0; i < count; i++)
+                jobCounts += jobs[i].statistics.counts[statistic];
+            XCTAssertEqual(jobCounts, difference.counts[statistic]);
+        }
+        XCTAssertGreaterThan(jobs[0].statistics.counts[FBStatisticEdgePairTests], 0);
+        for (size_t i = 0; i < count; i++)
+            CGPathRelease(jobs[i].result);
+    }
+    CGPathRelease(path1);
+    CGPathRelease(path2);
+}
+
+- (void)testBooleanJobsPerformance
+{
+    NSArray *circles = [self circlePathsInGridWithRows:20 columns:20 radius:10 spacing:15];
+    NSUInteger count = circles.count - 1;
+    FBBooleanJob *jobs = calloc(count, sizeof(FBBooleanJob));
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < count; i++) {
+            jobs[i].path1 = (__bridge CGPathRef)circles[i];
+            jobs[i].path2 = (__bridge CGPathRef)circles[i + 1];
+            jobs[i].operation = FBBooleanOperationUnion;
+        }
+        CGPathPerformBooleanJobs(jobs, count, 0);
+        for (NSUInteger i = 0; i < count; i++)
+            CGPathRelease(jobs[i].result);
+    }];
+    
+    free(jobs);
+}
+
+- (void)testPathElementsMatchCGPaths
+{
+    FBPathElement rectangle[] = {
+        { FBPathElementMoveToPoint, { CGPointMake(0, 0) } },
+        { FBPathElementAddLineToPoint, { CGPointMake(100, 0) } },
+        { FBPathElementAddLineToPoint, { CGPointMake(100, 100) } },
+        { FBPathElementAddLineToPoint, { CGPointMake(0, 100) } },
+        { FBPathElementCloseSubpath },
+    };
+    FBPathElement bump[] = {
+        { FBPathElementMoveToPoint, { CGPointMake(50, 50) } },
+        { FBPathElementAddQuadCurveToPoint, { CGPointMake(100, 200), CGPointMake(150, 50) } },
+        { FBPathElementCloseSubpath },
+    };
+    CGMutablePathRef path1 = CGPathCreateMutable();
+    CGMutablePathRef path2 = CGPathCreateMutable();
+    for (NSUInteger i = 0; i < sizeof(rectangle) / sizeof(rectangle[0]); i++)
+        FBTestAppendPathElement(&rectangle[i], path1);
+    for (NSUInteger i = 0; i < sizeof(bump) / sizeof(bump[0]); i++)
+        FBTestAppendPathElement(&bump[i], path2);
+    
+    CGPathRef (*operations[])(CGPathRef, CGPathRef) = { CGPathUnion, CGPathIntersect, CGPathDifference, CGPathXOR };
+    for (FBBooleanOperation operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+        CGMutablePathRef streamed = CGPathCreateMutable();
+        FBPathElementsPerformBooleanOperation(rectangle, 5, bump, 3, operation, FBTestAppendPathElement, streamed);
+        CGPathRef expected = operations[operation](path1, path2);
+        XCTAssertTrue(CGPathEqualToPath(streamed, expected));
+        CGPathRelease(expected);
+        CGPathRelease(streamed);
+    }
+    
+    CGPathRelease(path1);
+    CGPathRelease(path2);
+}
+
+- (void)testPreparedPathMatchesPath
+{
+    // A mask with a hole and two contours that cross each other, so all of the
+    //  preparation gets used: self crossings, holes and filled regions
+    CGMutablePathRef mask = CGPathCreateMutable();
+    CGPathAddRect(mask, NULL, CGRectMake(50, 50, 350, 300));
+    CGPathAddEllipseInRect(mask, NULL, CGRectMake(85, 75, 250, 250));
+    CGPathAddEllipseInRect(mask, NULL, CGRectMake(300, 250, 150, 150));
+    FBPreparedPathRef preparedMask = FBPreparedPathCreate(mask);
+    
+    CGPathRef (*operations[])(CGPathRef, CGPathRef) = { CGPathUnion, CGPathIntersect, CGPathDifference, CGPathXOR };
+    for (NSUInteger i = 0; i < 20; i++) {
+        CGPathRef shape = CGPathCreateWithEllipseInRect(CGRectMake(i * 25, 40 + i * 15, 60, 60), NULL);
+        for (FBBooleanOperation operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+            CGPathRef result = FBPreparedPathPerformBooleanOperation(preparedMask, shape, operation);
+            CGPathRef expected = operations[operation](mask, shape);
+            XCTAssertTrue(CGPathEqualToPath(result, expected));
+            CGPathRelease(expected);
+            CGPathRelease(result);
+        }
+        CGPathRelease(shape);
+    }
+    
+    FBPreparedPathRelease(preparedMask);
+    CGPathRelease(mask);
+}
+
+- (void)testPreparedPathForgetsSharedPoints
+{
+    // The first shape lies on the mask's outline, meeting it at its corner and along
+    //  two of its sides, which marks the edges it touches. None of that may carry over
+    //  to the next shape, which crosses the mask somewhere else.
+    CGMutablePathRef mask = CGPathCreateMutable();
+    CGPathAddRect(mask, NULL, CGRectMake(50, 50, 300, 300));
+    CGPathAddEllipseInRect(mask, NULL, CGRectMake(100, 100, 200, 200));
+    FBPreparedPathRef preparedMask = FBPreparedPathCreate(mask);
+    CGPathRef touchingShape = CGPathCreateWithRect(CGRectMake(50, 50, 150, 100), NULL);
+    CGPathRef crossingShape = CGPathCreateWithEllipseInRect(CGRectMake(20, 200, 60, 60), NULL);
+    
+    CGPathRef (*operations[])(CGPathRef, CGPathRef) = { CGPathUnion, CGPathIntersect, CGPathDifference, CGPathXOR };
+    for (FBBooleanOperation operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+        CGPathRelease(FBPreparedPathPerformBooleanOperation(preparedMask, touchingShape, operation));
+        CGPathRef result = FBPreparedPathPerformBooleanOperation(preparedMask, crossingShape, operation);
+        CGPathRef expected = operations[operation](mask, crossingShape);
+        XCTAssertTrue(CGPathEqualToPath(result, expected));
+        CGPathRelease(expected);
+        CGPathRelease(result);
+    }
+    
+    CGPathRelease(crossingShape);
+    CGPathRelease(touchingShape);
+    FBPreparedPathRelease(preparedMask);
+    CGPathRelease(mask);
+}
+
+- (void)testPreparedPathKeepsSelfTouches
+{
+    // Two squares of the mask touch at a corner without crossing, and the other contour
+    //  touches the outline from the inside. The shapes run through those points, which
+    //  have to be known as shared in every operation, not just in the first one.
+    CGMutablePathRef mask = CGPathCreateMutable();
+    CGPathAddRect(mask, NULL, CGRectMake(50, 50, 150, 150));
+    CGPathAddRect(mask, NULL, CGRectMake(200, 200, 150, 150));
+    CGPathAddEllipseInRect(mask, NULL, CGRectMake(250, 250, 100, 100));
+    FBPreparedPathRef preparedMask = FBPreparedPathCreate(mask);
+    CGPathRef cornerShape = CGPathCreateWithEllipseInRect(CGRectMake(170, 170, 60, 60), NULL);
+    CGPathRef sideShape = CGPathCreateWithRect(CGRectMake(320, 280, 60, 40), NULL);
+    
+    CGPathRef (*operations[])(CGPathRef, CGPathRef) = { CGPathUnion, CGPathIntersect, CGPathDifference, CGPathXOR };
+    for (FBBooleanOperation operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+        for (id shape in @[(__bridge id)cornerShape, (__bridge id)sideShape]) {
+            CGPathRef result = FBPreparedPathPerformBooleanOperation(preparedMask, (__bridge CGPathRef)shape, operation);
+            CGPathRef expected = operations[operation](mask, (__bridge CGPathRef)shape);
+            XCTAssertTrue(CGPathEqualToPath(result, expected));
+            CGPathRelease(expected);
+            CGPathRelease(result);
+        }
+    }
+    
+    CGPathRelease(sideShape);
+    CGPathRelease(cornerShape);
+    FBPreparedPathRelease(preparedMask);
+    CGPathRelease(mask);
+}
+
+- (void)testPreparedPathPerformanceWithManyShapes
+{
+    // A large mask, cut out of many small shapes one at a time
+    CGPathRef mask = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:50 columns:50 radius:10 spacing:15];
+    NSArray *shapes = [self circlePathsInGridWithRows:10 columns:10 radius:4 spacing:70];
+    
+    [self measureBlock:^{
+        FBPreparedPathRef preparedMask = FBPreparedPathCreate(mask);
+        for (id shape in shapes)
+            CGPathRelease(FBPreparedPathPerformBooleanOperation(preparedMask, (__bridge CGPathRef)shape, FBBooleanOperationIntersect));
+        FBPreparedPathRelease(preparedMask);
+    }];
+    
+    CGPathRelease(mask);
+}
+
+- (void)testIncrementalBooleanMatchesFullOperation
+{
+    // Two grids of circles, so each pair of circles is a cluster of its own
+    CGPathRef path1 = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:10 columns:10 radius:10 spacing:40];
+    CGPathRef path2 = [self createPathWithCirclesInGridAtPoint:CGPointMake(8, 8) rows:10 columns:10 radius:10 spacing:40];
+    CGPathRef (*operations[])(CGPathRef, CGPathRef) = { CGPathUnion, CGPathIntersect, CGPathDifference, CGPathXOR };
+    for (FBBooleanOperation operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+        FBIncrementalBooleanRef incrementalBoolean = FBIncrementalBooleanCreate(operation);
+        CGPathRef result = FBIncrementalBooleanUpdate(incrementalBoolean, path1, path2);
+        CGPathRef expected = operations[operation](path1, path2);
+        [self assertPath:result fillsSameAreaAsPath:expected];
+        XCTAssertEqual(FBIncrementalBooleanGetClusterCount(incrementalBoolean), (size_t)100);
+        XCTAssertEqual(FBIncrementalBooleanGetReusedClusterCount(incrementalBoolean), (size_t)0);
+        CGPathRelease(expected);
+        CGPathRelease(result);
+        
+        // Drag one circle of the second path over to the next pair of circles. Only the
+        //  cluster it left and the one it joined are redone.
+        CGMutablePathRef editedPath2 = CGPathCreateMutable();
+        for (NSUInteger row = 0; row < 10; row++) {
+            for (NSUInteger column = 0; column < 10; column++) {
+                CGPoint center = CGPointMake(8 + column * 40, 8 + row * 40);
+                if ( row == 4 && column == 4 )
+                    center.x += 22;
+                CGPathAddEllipseInRect(editedPath2, NULL, CGRectMake(center.x - 10, center.y - 10, 20, 20));
+            }
+        }
+        result = FBIncrementalBooleanUpdate(incrementalBoolean, path1, editedPath2);
+        expected = operations[operation](path1, editedPath2);
+        [self assertPath:result fillsSameAreaAsPath:expected];
+        XCTAssertEqual(FBIncrementalBooleanGetClusterCount(incrementalBoolean), (size_t)100);
+        XCTAssertEqual(FBIncrementalBooleanGetReusedClusterCount(incrementalBoolean), (size_t)98);
+        CGPathRelease(expected);
+        CGPathRelease(result);
+        
+        CGPathRelease(editedPath2);
+        FBIncrementalBooleanRelease(incrementalBoolean);
+    }
+    
+    CGPathRelease(path1);
+    CGPathRelease(path2);
+}
+
+- (void)testClosestPointsOnPreparedPath
+{
+    // Circles with their centers 40 apart, so the closest circle to any point is the
+    //  one whose center is closest, at the distance to the center less the radius
+    CGPathRef path = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:10 columns:10 radius:10 spacing:40];
+    FBPreparedPathRef preparedPath = FBPreparedPathCreate(path);
+    
+    CGPoint points[400];
+    for (NSUInteger i = 0; i < 400; i++)
+        points[i] = CGPointMake(-30 + (i % 20) * 21.3, -30 + (i / 20) * 21.7);
+    CGPoint closestPoints[400];
+    CGFloat distances[400];
+    XCTAssertTrue(FBPreparedPathGetClosestPoints(preparedPath, points, 400, closestPoints, distances));
+    
+    for (NSUInteger i = 0; i < 400; i++) {
+        CGFloat column = MIN(MAX(round(points[i].x / 40), 0), 9);
+        CGFloat row = MIN(MAX(round(points[i].y / 40), 0), 9);
+        CGFloat distanceToCenter = hypot(points[i].x - column * 40, points[i].y - row * 40);
+        // CGPathAddEllipseInRect() approximates the circles with curves, that's the accuracy
+        XCTAssertEqualWithAccuracy(distances[i], fabs(distanceToCenter - 10), 0.01);
+        XCTAssertEqualWithAccuracy(hypot(closestPoints[i].x - points[i].x, closestPoints[i].y - points[i].y), distances[i], 1e-6);
+    }
+    
+    FBPreparedPathRelease(preparedPath);
+    CGPathRelease(path);
+    
+    CGPathRef emptyPath = CGPathCreateMutable();
+    FBPreparedPathRef preparedEmptyPath = FBPreparedPathCreate(emptyPath);
+    XCTAssertFalse(FBPreparedPathGetClosestPoints(preparedEmptyPath, points, 1, closestPoints, distances));
+    FBPreparedPathRelease(preparedEmptyPath);
+    CGPathRelease(emptyPath);
+}
+
+- (void)testClosestPointsPerformanceWithManyPoints
+{
+    // Hit testing a cursor trail against a large document
+    CGPathRef path = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:50 columns:50 radius:6 spacing:15];
+    FBPreparedPathRef preparedPath = FBPreparedPathCreate(path);
+    NSUInteger count = 10000;
+    CGPoint *points = malloc(count * sizeof(CGPoint));
+    for (NSUInteger i = 0; i < count; i++)
+        points[i] = CGPointMake(375 + 300 * cos(i * 0.001), 375 + 300 * sin(i * 0.0013));
+    CGPoint *closestPoints = malloc(count * sizeof(CGPoint));
+    CGFloat *distances = malloc(count * sizeof(CGFloat));
+    
+    [self measureBlock:^{
+        FBPreparedPathGetClosestPoints(preparedPath, points, count, closestPoints, distances);
+    }];
+    
+    free(distances);
+    free(closestPoints);
+    free(points);
+    FBPreparedPathRelease(preparedPath);
+    CGPathRelease(path);
+}
+
+- (void)testPreparedPathContainsPoints
+{
+    // Circles that overlap their neighbors. Even odd leaves out where two overlap,
+    //  non zero fills all of them.
+    CGPathRef path = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:5 columns:5 radius:10 spacing:15];
+    FBPreparedPathRef preparedPath = FBPreparedPathCreate(path);
+    
+    CGPoint points[900];
+    NSUInteger circleCounts[900];
+    NSUInteger count = 0;
+    for (NSUInteger i = 0; i < 900; i++) {
+        CGPoint point = CGPointMake(-15.3 + (i % 30) * 3.1, -15.7 + (i / 30) * 3.1);
+        NSUInteger circleCount = 0;
+        BOOL isNearOutline = NO;
+        for (NSUInteger row = 0; row < 5; row++) {
+            for (NSUInteger column = 0; column < 5; column++) {
+                CGFloat distance = hypot(point.x - column * 15.0, point.y - row * 15.0);
+                if ( distance < 10 )
+                    circleCount++;
+                // CGPathAddEllipseInRect() approximates the circles with curves
+                if ( fabs(distance - 10) < 0.1 )
+                    isNearOutline = YES;
+            }
+        }
+        if ( isNearOutline )
+            continue;
+        points[count] = point;
+        circleCounts[count] = circleCount;
+        count++;
+    }
+    
+    BOOL results[900];
+    FBPreparedPathContainsPoints(preparedPath, points, count, FBFillRuleEvenOdd, results);
+    for (NSUInteger i = 0; i < count; i++)
+        XCTAssertEqual(results[i], (BOOL)((circleCounts[i] & 1) == 1));
+    FBPreparedPathContainsPoints(preparedPath, points, count, FBFillRuleNonZero, results);
+    for (NSUInteger i = 0; i < count; i++)
+        XCTAssertEqual(results[i], (BOOL)(circleCounts[i] > 0));
+    
+    FBPreparedPathRelease(preparedPath);
+    CGPathRelease(path);
+}
+
+- (void)testContainsPointsPerformanceWithManyPoints
+{
+    // A hatch fill of a large document, one sample per unit
+    CGPathRef path = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:50 columns:50 radius:6 spacing:15];
+    FBPreparedPathRef preparedPath = FBPreparedPathCreate(path);
+    NSUInteger count = 750 * 750;
+    CGPoint *points = malloc(count * sizeof(CGPoint));
+    for (NSUInteger i = 0; i < count; i++)
+        points[i] = CGPointMake(i % 750, i / 750);
+    BOOL *results = malloc(count * sizeof(BOOL));
+    
+    [self measureBlock:^{
+        FBPreparedPathContainsPoints(preparedPath, points, count, FBFillRuleEvenOdd, results);
+    }];
+    
+    free(results);
+    free(points);
+    FBPreparedPathRelease(preparedPath);
+    CGPathRelease(path);
+}
+
+- (void)testPolygonClipperMatchesGeneralPath
+{
+    // A frame with a hole, and a triangle poking through the hole and out the side.
+    //  Polygons are flattened to themselves, so the approximate operation combines
+    //  them exactly, only through the polygon clipper instead of the curve code.
+    CGMutablePathRef path1 = CGPathCreateMutable();
+    CGPathAddRect(path1, NULL, CGRectMake(50, 50, 300, 300));
+    CGPathAddRect(path1, NULL, CGRectMake(120, 120, 160, 160));
+    CGMutablePathRef path2 = CGPathCreateMutable();
+    CGPathMoveToPoint(path2, NULL, 200, 20);
+    CGPathAddLineToPoint(path2, NULL, 400, 200);
+    CGPathAddLineToPoint(path2, NULL, 150, 250);
+    CGPathCloseSubpath(path2);
+    
+    CGPathRef (*operations[])(CGPathRef, CGPathRef) = { CGPathUnion, CGPathIntersect, CGPathDifference, CGPathXOR };
+    for (FBBooleanOperation operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+        CGPathRef result = CGPathPerformBooleanOperationWithTolerance(path1, path2, operation, 0.25);
+        CGPathRef expected = operations[operation](path1, path2);
+        [self assertPath:result fillsSameAreaAsPath:expected];
+        CGPathRelease(expected);
+        CGPathRelease(result);
+    }
+    
+    CGPathRelease(path2);
+    CGPathRelease(path1);
+}
+
+- (void)testTiledOperationMatchesWholeOperation
+{
+    // A frame with a hole and a jagged ring, cut into tiles that don't line up with
+    //  anything, and into tiles with seams right on the sides of the frame
+    CGMutablePathRef path1 = CGPathCreateMutable();
+    CGPathAddRect(path1, NULL, CGRectMake(50, 50, 300, 300));
+    CGPathAddRect(path1, NULL, CGRectMake(120, 120, 160, 160));
+    CGMutablePathRef path2 = CGPathCreateMutable();
+    NSUInteger count = 500;
+    for (NSUInteger i = 0; i < count; i++) {
+        CGFloat angle = 2 * M_PI * i / count;
+        CGFloat distance = 150 + ((i * 7919) % 41) - 20;
+        CGPoint point = CGPointMake(300 + distance * cos(angle), 200 + distance * sin(angle));
+        if ( i == 0 )
+            CGPathMoveToPoint(path2, NULL, point.x, point.y);
+        else
+            CGPathAddLineToPoint(path2, NULL, point.x, point.y);
+    }
+    CGPathCloseSubpath(path2);
+    
+    CGFloat tileSizes[] = { 37.3, 70 };
+    for (NSUInteger i = 0; i < 2; i++) {
+        for (FBBooleanOperation operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+            CGPathRef result = CGPathPerformBooleanOperationInTiles(path1, path2, operation, tileSizes[i]);
+            CGPathRef expected = CGPathPerformBooleanOperationInTiles(path1, path2, operation, 0.0);
+            [self assertPath:result fillsSameAreaAsPath:expected];
+            CGPathRelease(expected);
+            CGPathRelease(result);
+        }
+    }
+    
+    CGPathRelease(path2);
+    CGPathRelease(path1);
+}
+
+- (void)testPolygonClipperPerformanceWithManyVertices
+{
+    // Two jagged rings of 10k vertices each, crossing all the way round
+    CGMutablePathRef paths[2] = { CGPathCreateMutable(), CGPathCreateMutable() };
+    NSUInteger count = 10000;
+    for (NSUInteger i = 0; i < 2; i++) {
+        for (NSUInteger j = 0; j < count; j++) {
+            CGFloat angle = 2 * M_PI * j / count;
+            CGFloat distance = 1000 + ((j * 7919 + i * 104729) % 41) - 20;
+            CGPoint point = CGPointMake(i * 300 + distance * cos(angle), distance * sin(angle));
+            if ( j == 0 )
+                CGPathMoveToPoint(paths[i], NULL, point.x, point.y);
+            else
+                CGPathAddLineToPoint(paths[i], NULL, point.x, point.y);
+        }
+        CGPathCloseSubpath(paths[i]);
+    }
+    
+    [self measureBlock:^{
+        CGPathRef result = CGPathUnion(paths[0], paths[1]);
+        CGPathRelease(result);
+    }];
+    
+    CGPathRelease(paths[0]);
+    CGPathRelease(paths[1]);
+}
+
+- (void)testQuadraticOutlinesMatchCubicOutlines
+{
+    // TrueType style rings of quadratics, against the same rings written as cubics, which
+    //  still go through bezier clipping
+    CGMutablePathRef quadraticPaths[2] = { CGPathCreateMutable(), CGPathCreateMutable() };
+    CGMutablePathRef cubicPaths[2] = { CGPathCreateMutable(), CGPathCreateMutable() };
+    for (NSUInteger i = 0; i < 2; i++) {
+        CGPoint center = CGPointMake(200 + i * 70, 200 + i * 30);
+        NSUInteger count = 8;
+        for (NSUInteger j = 0; j < count; j++) {
+            CGFloat angle = 2 * M_PI * j / count;
+            CGFloat nextAngle = 2 * M_PI * (j + 1) / count;
+            CGFloat controlAngle = (angle + nextAngle) / 2;
+            CGPoint start = CGPointMake(center.x + 100 * cos(angle), center.y + 100 * sin(angle));
+            CGPoint control = CGPointMake(center.x + 110 * cos(controlAngle), center.y + 110 * sin(controlAngle));
+            CGPoint end = CGPointMake(center.x + 100 * cos(nextAngle), center.y + 100 * sin(nextAngle));
+            if ( j == 0 ) {
+                CGPathMoveToPoint(quadraticPaths[i], NULL, start.x, start.y);
+                CGPathMoveToPoint(cubicPaths[i], NULL, start.x, start.y);
+            }
+            CGPathAddQuadCurveToPoint(quadraticPaths[i], NULL, control.x, control.y, end.x, end.y);
+            CGPathAddCurveToPoint(cubicPaths[i], NULL, start.x + (control.x - start.x) * 2 / 3, start.y + (control.y - start.y) * 2 / 3, end.x + (control.x - end.x) * 2 / 3, end.y + (control.y - end.y) * 2 / 3, end.x, end.y);
+        }
+        CGPathCloseSubpath(quadraticPaths[i]);
+        CGPathCloseSubpath(cubicPaths[i]);
+    }
+    
+    CGPathRef (*operations[])(CGPathRef, CGPathRef) = { CGPathUnion, CGPathIntersect, CGPathDifference, CGPathXOR };
+    for (FBBooleanOperation operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+        CGPathRef result = operations[operation](quadraticPaths[0], quadraticPaths[1]);
+        CGPathRef expected = operations[operation](cubicPaths[0], cubicPaths[1]);
+        [self assertPath:result fillsSameAreaAsPath:expected];
+        CGPathRelease(expected);
+        CGPathRelease(result);
+    }
+    
+    for (NSUInteger i = 0; i < 2; i++) {
+        CGPathRelease(quadraticPaths[i]);
+        CGPathRelease(cubicPaths[i]);
+    }
+}
+
+- (void)testApproximateOperationStaysWithinTolerance
+{
+    // Two overlapping grids of circles. Away from the outlines of the operands, by more
+    //  than the tolerance, the approximate results fill what the exact ones do.
+    CGPathRef path1 = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:4 columns:4 radius:30 spacing:50];
+    CGPathRef path2 = [self createPathWithCirclesInGridAtPoint:CGPointMake(25, 20) rows:4 columns:4 radius:30 spacing:50];
+    CGFloat tolerance = 0.5;
+    
+    CGRect bounds = CGRectUnion(CGPathGetBoundingBox(path1), CGPathGetBoundingBox(path2));
+    NSMutableData *pointData = [NSMutableData data];
+    for (CGFloat y = CGRectGetMinY(bounds) + 0.5; y < CGRectGetMaxY(bounds); y += 3.0) {
+        for (CGFloat x = CGRectGetMinX(bounds) + 0.5; x < CGRectGetMaxX(bounds); x += 3.0) {
+            CGPoint point = CGPointMake(x, y);
+            [pointData appendBytes:&point length:sizeof(point)];
+        }
+    }
+    const CGPoint *points = pointData.bytes;
+    size_t count = pointData.length / sizeof(CGPoint);
+    CGPoint *closestPoints = malloc(count * sizeof(CGPoint));
+    CGFloat *distances1 = malloc(count * sizeof(CGFloat));
+    CGFloat *distances2 = malloc(count * sizeof(CGFloat));
+    FBPreparedPathRef preparedPath1 = FBPreparedPathCreate(path1);
+    FBPreparedPathRef preparedPath2 = FBPreparedPathCreate(path2);
+    XCTAssertTrue(FBPreparedPathGetClosestPoints(preparedPath1, points, count, closestPoints, distances1));
+    XCTAssertTrue(FBPreparedPathGetClosestPoints(preparedPath2, points, count, closestPoints, distances2));
+    FBPreparedPathRelease(preparedPath1);
+    FBPreparedPathRelease(preparedPath2);
+    
+    for (FBBooleanOperation operation = FBBooleanOperationUnion; operation <= FBBooleanOperationXOR; operation++) {
+        CGPathRef result = CGPathPerformBooleanOperationWithTolerance(path1, path2, operation, tolerance);
+        CGPathRef expected = CGPathPerformBooleanOperationWithTolerance(path1, path2, operation, 0.0);
+        for (size_t i = 0; i < count; i++) {
+            if ( distances1[i] > tolerance && distances2[i] > tolerance )
+                XCTAssertEqual(CGPathContainsPoint(result, NULL, points[i], YES), CGPathContainsPoint(expected, NULL, points[i], YES));
+        }
+        CGPathRelease(expected);
+        CGPathRelease(result);
+    }
+    
+    free(distances2);
+    free(distances1);
+    free(closestPoints);
+    CGPathRelease(path2);
+    CGPathRelease(path1);
+}
+
+- (void)testApproximateOperationPerformanceWithManyCurves
+{
+    CGPathRef path1 = [self createPathWithCirclesInGridAtPoint:CGPointMake(0, 0) rows:30 columns:30 radius:10 spacing:15];
+    CGPathRef path2 = [self createPathWithCirclesInGridAtPoint:CGPointMake(7, 5) rows:30 columns:30 radius:10 spacing:15];
+    
+    [self measureBlock:^{
+        CGPathRef result = CGPathPerformBooleanOperationWithTolerance(path1, path2, FBBooleanOperationUnion, 0.25);
+        CGPathRelease(result);
+    }];
+    
+    CGPathRelease(path2);
+    CGPathRelease(path1);
+}
+
+- (void)assertPath:(CGPathRef)path fillsSameAreaAsPath:(CGPathRef)expectedPath
+{
+    // The contours can come out in a different order, so compare what they fill
+    CGRect bounds = CGRectUnion(CGPathGetBoundingBox(path), CGPathGetBoundingBox(expectedPath));
+    for (CGFloat y = CGRectGetMinY(bounds) + 0.5; y < CGRectGetMaxY(bounds); y += 3.0) {
+        for (CGFloat x = CGRectGetMinX(bounds) + 0.5; x < CGRectGetMaxX(bounds); x += 3.0) {
+            CGPoint point = CGPointMake(x, y);
+            XCTAssertEqual(CGPathContainsPoint(path, NULL, point, YES), CGPathContainsPoint(expectedPath, NULL, point, YES));
+        }
+    }
+}
+
+- (NSArray *)circlePathsInGridWithRows:(NSUInteger)rows columns:(NSUInteger)columns radius:(CGFloat)radius spacing:(CGFloat)spacing
+{
+    NSMutableArray *circles = [NSMutableArray arrayWithCapacity:rows * columns];
+    for (NSUInteger row = 0; row < rows; row++) {
+        for (NSUInteger column = 0; column < columns; column++) {
+            CGPathRef circle = CGPathCreateWithEllipseInRect(CGRectMake(column * spacing - radius, row * spacing - radius, radius * 2, radius * 2), NULL);
+            [circles addObject:(__bridge_transfer id)circle];
+        }
+    }
+    return circles;
+}
+
+- (CGPathRef)createPathWithCirclesInGridAtPoint:(CGPoint)origin rows:(NSUInteger)rows columns:(NSUInteger)columns radius:(CGFloat)radius spacing:(CGFloat)spacing
+{
+    CGMutablePathRef path = CGPathCreateMutable();
+    for (NSUInteger row = 0; row < rows; row++) {
+        for (NSUInteger column = 0; column < columns; column++) {
+            CGPoint center = CGPointMake(origin.x + column * spacing, origin.y + row * spacing);
+            CGPathAddEllipseInRect(path, NULL, CGRectMake(center.x - radius, center.y - radius, radius * 2, radius * 2));
+        }
+    }
+    return path;
+}
+
 - (NSBezierPath *)pathWithRectangle:(CGRect)rect
 {
     NSBezierPath *rectangle = [NSBezierPath bezierPath];